@@ -102,6 +102,9 @@ FPLATEAUAsyncLoadedFeatureInfoPanel::FPLATEAUAsyncLoadedFeatureInfoPanel(
     const TWeakPtr<FPLATEAUExtentEditorViewportClient> ViewportClient)
     : Owner(Owner)
     , ViewportClient(ViewportClient)
+    , NextProbeIndex(0)
+    , RemainingProbeCount(0)
+    , bCancelled(false)
     , AddedIconComponentCnt(0)
     , AddedDetailedIconComponentCnt(0)
     , DeltaTime(0)
@@ -199,43 +202,64 @@ void FPLATEAUAsyncLoadedFeatureInfoPanel::CreatePanelComponents(const TMap<Prede
 
 void FPLATEAUAsyncLoadedFeatureInfoPanel::LoadMaxLodAsync(const FPLATEAUFeatureInfoPanelInput& Input, const FBox& InBox) {
     Box = InBox;
-    MaxLodTaskStatus = EPLATEAUFeatureInfoPanelStatus::Loading;
 
-    GetMaxLodTask = UE::Tasks::Launch(TEXT("GetMaxLODTask"), [Input]() mutable {
-        TMap<PredefinedCityModelPackage, int> MaxLods;
-
-        for (const auto& Entry : Input) {
-            if (Entry.Value->empty())
-                continue;
-
-            int MaxLod = 0;
-            for (auto& GmlFile : *Entry.Value) {
-                // GMLファイル内を検索して最大LODを取得
-                MaxLod = FMath::Max(GmlFile.getMaxLod(), MaxLod);
-            }
-
-            MaxLods.Add(Entry.Key, MaxLod);
+    Probes.Reset();
+    for (const auto& Entry : Input) {
+        if (Entry.Value == nullptr)
+            continue;
+        for (int32 i = 0; i < static_cast<int32>(Entry.Value->size()); ++i) {
+            Probes.Add({ Entry.Key, Entry.Value, i });
         }
+    }
+    ProbeResults.Init(0, Probes.Num());
+    NextProbeIndex = 0;
+    RemainingProbeCount = Probes.Num();
+    MaxLodTaskStatus = Probes.IsEmpty() ? EPLATEAUFeatureInfoPanelStatus::FullyLoaded : EPLATEAUFeatureInfoPanelStatus::Loading;
+}
 
-        return MaxLods;
+void FPLATEAUAsyncLoadedFeatureInfoPanel::LaunchNextProbe(const TSharedRef<TAtomic<int32>>& InFlightProbeCount) {
+    check(HasPendingProbe());
+
+    const int32 ProbeIndex = NextProbeIndex++;
+    ++(*InFlightProbeCount);
+    UE::Tasks::Launch(TEXT("GetMaxLODTask"), [Panel = AsShared(), ProbeIndex, InFlightProbeCount]() {
+        if (!Panel->bCancelled) {
+            const auto& Probe = Panel->Probes[ProbeIndex];
+            // GMLファイル内を検索して最大LODを取得
+            Panel->ProbeResults[ProbeIndex] = (*Probe.GmlFiles)[Probe.Index].getMaxLod();
+            if (--Panel->RemainingProbeCount == 0)
+                Panel->MaxLodTaskStatus = EPLATEAUFeatureInfoPanelStatus::FullyLoaded;
+        }
+        --(*InFlightProbeCount);
     }, LowLevelTasks::ETaskPriority::BackgroundHigh);
 }
 
+void FPLATEAUAsyncLoadedFeatureInfoPanel::Cancel() {
+    bCancelled = true;
+}
+
+TMap<PredefinedCityModelPackage, int> FPLATEAUAsyncLoadedFeatureInfoPanel::GetMaxLods() const {
+    TMap<PredefinedCityModelPackage, int> MaxLods;
+    for (int32 i = 0; i < Probes.Num(); ++i) {
+        auto& MaxLod = MaxLods.FindOrAdd(Probes[i].Package, 0);
+        MaxLod = FMath::Max(ProbeResults[i], MaxLod);
+    }
+    return MaxLods;
+}
+
 bool FPLATEAUAsyncLoadedFeatureInfoPanel::AddIconComponent() {
     if (AddComponentStatus == EPLATEAUFeatureInfoPanelStatus::FullyLoaded)
         return false;
 
-    if (!GetMaxLodTask.IsValid() || !GetMaxLodTask.IsCompleted())
+    if (bCancelled || MaxLodTaskStatus != EPLATEAUFeatureInfoPanelStatus::FullyLoaded)
         return false;
 
-    MaxLodTaskStatus = EPLATEAUFeatureInfoPanelStatus::FullyLoaded;
-
     const auto PreviewScene = ViewportClient.Pin()->GetPreviewScene();
     if (PreviewScene == nullptr)
         return false;
 
     if (CreateComponentStatus != EPLATEAUFeatureInfoPanelStatus::FullyLoaded) {
-        CreatePanelComponents(GetMaxLodTask.GetResult());
+        CreatePanelComponents(GetMaxLods());
         CreateComponentStatus = EPLATEAUFeatureInfoPanelStatus::FullyLoaded;
     }
 
@@ -29,8 +29,9 @@ enum class EPLATEAUFeatureInfoPanelStatus
 
 /**
  * @brief 各メッシュコード(グリッド)に表示する地物情報のパネルを表します。
+ * 最大LODはGMLファイルごとの読込(プローブ)に分割され、FPLATEAUFeatureInfoDisplayが優先度順に並列実行します。
  */
-class FPLATEAUAsyncLoadedFeatureInfoPanel {
+class FPLATEAUAsyncLoadedFeatureInfoPanel : public TSharedFromThis<FPLATEAUAsyncLoadedFeatureInfoPanel> {
 public:
     explicit FPLATEAUAsyncLoadedFeatureInfoPanel(const TWeakPtr<class FPLATEAUFeatureInfoDisplay> Owner,
                                                  const TWeakPtr<class FPLATEAUExtentEditorViewportClient> ViewportClient);
@@ -50,6 +51,7 @@ public:
     
     /**
      * @brief GMLファイルの一覧を入力として、非同期に地物の最大LOD情報を読み込みます。
+     * 読込はLaunchNextProbeで1ファイルずつ開始されます。
      * パネルの可視化は読み込みが完了した後にTickが呼び出された際に行われます。
      *
      * @param Input GMLファイルの一覧
@@ -57,6 +59,28 @@ public:
      */
     void LoadMaxLodAsync(const FPLATEAUFeatureInfoPanelInput& Input, const FBox& InBox);
 
+    /**
+     * @brief 未開始のGMLファイルの読込が残っているか
+     */
+    bool HasPendingProbe() const {
+        return !bCancelled && NextProbeIndex < Probes.Num();
+    }
+
+    /**
+     * @brief 次のGMLファイルの最大LODの読込を開始します。
+     * @param InFlightProbeCount 実行中の読込数。読込完了時に減算されます
+     */
+    void LaunchNextProbe(const TSharedRef<TAtomic<int32>>& InFlightProbeCount);
+
+    /**
+     * @brief 読込を中止します。実行中の読込は完了を待たずに結果が破棄されます
+     */
+    void Cancel();
+
+    const FBox& GetBox() const {
+        return Box;
+    }
+
     /**
      * @brief アイコンコンポーネント追加
      */
@@ -75,7 +99,18 @@ private:
     TWeakPtr<FPLATEAUFeatureInfoDisplay> Owner;
     TWeakPtr<FPLATEAUExtentEditorViewportClient> ViewportClient;
 
-    UE::Tasks::TTask<TMap<plateau::dataset::PredefinedCityModelPackage, int>> GetMaxLodTask;
+    struct FMaxLodProbe {
+        plateau::dataset::PredefinedCityModelPackage Package;
+        std::shared_ptr<std::vector<plateau::dataset::GmlFile>> GmlFiles;
+        int32 Index;
+    };
+
+    TArray<FMaxLodProbe> Probes;
+    // プローブごとの最大LOD。各要素は担当するタスクのみが書き込みます
+    TArray<int> ProbeResults;
+    int32 NextProbeIndex;
+    TAtomic<int32> RemainingProbeCount;
+    TAtomic<bool> bCancelled;
 
     int AddedIconComponentCnt;
     int AddedDetailedIconComponentCnt;
@@ -93,4 +128,5 @@ private:
 
     void ApplyFeatureInfoVisibility(const TArray<int>& ShowLods) const;
     void CreatePanelComponents(const TMap<plateau::dataset::PredefinedCityModelPackage, int>& MaxLods);
+    TMap<plateau::dataset::PredefinedCityModelPackage, int> GetMaxLods() const;
 };
@@ -17,6 +17,7 @@
 
 #include "AssetViewerSettings.h"
 #include "CameraController.h"
+#include "Components/LineBatchComponent.h"
 #include "EditorViewportClient.h"
 #include "PLATEAUImportSettings.h"
 
@@ -27,14 +28,27 @@ DECLARE_CYCLE_STAT(TEXT("FeatureInfoDisplay"), STAT_FeatureInfoDisplay, STATGROU
 
 namespace {
     /**
-     * @brief 最大パネル読み込み並列数
+     * @brief 1フレーム中の最大パネル作成数
+     * GMLファイルの読込自体はFPLATEAUFeatureInfoDisplayが並列数を制限して行います。
      */
-    constexpr int MaxLoadPanelParallelCount = 1;
+    constexpr int MaxCreatePanelPerFrameCount = 4;
 
     /**
      * @brief 1フレーム中の最大AddComponent数
      */
     constexpr int MaxAddComponentPerFrameCount = 2;
+
+    /**
+     * @brief 格子状のラインと選択エリアを表示するカメラ高さ
+     */
+    constexpr double ShowGridCameraDistance = 10000.0;
+
+    // 作成したコンポーネントはプレビューシーンが保持し、シーンの破棄時に解放される
+    ULineBatchComponent* CreateLineBatch(FPreviewScene& PreviewScene) {
+        const auto LineBatch = NewObject<ULineBatchComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+        PreviewScene.AddComponent(LineBatch, FTransform::Identity);
+        return LineBatch;
+    }
 }
 
 FPLATEAUExtentEditorViewportClient::FPLATEAUExtentEditorViewportClient(const TWeakPtr<FPLATEAUExtentEditor>& InExtentEditor,
@@ -86,6 +100,19 @@ void FPLATEAUExtentEditorViewportClient::Initialize(const std::shared_ptr<platea
             MeshCodeGizmos.Last().SetbSelectedArray(ExtentEditor->GetAreaMeshCodeMap()[UTF8_TO_TCHAR(MeshCode.get().c_str())].GetbSelectedArray());
         }
     }
+
+    TArray<FBox2D> GizmoBounds;
+    GizmoBounds.Reserve(MeshCodeGizmos.Num());
+    ViewQueryMargin = FVector2D::ZeroVector;
+    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
+        GizmoBounds.Emplace(MeshCodeGizmo.GetMin(), MeshCodeGizmo.GetMax());
+        ViewQueryMargin = FVector2D::Max(ViewQueryMargin, MeshCodeGizmo.GetSize());
+    }
+    MeshCodeGizmoIndex.Build(GizmoBounds);
+    VisibleMeshCodeGizmoIndices.Reset();
+
+    BuildMeshCodeGizmoLines();
+    UpdateSelectedAreaMesh();
 }
 
 void FPLATEAUExtentEditorViewportClient::ResetSelectedArea() {
@@ -93,6 +120,41 @@ void FPLATEAUExtentEditorViewportClient::ResetSelectedArea() {
         MeshCodeGizmo.ResetSelectedArea();
         ExtentEditorPtr.Pin()->SetAreaMeshCodeMap(MeshCodeGizmo.GetRegionMeshID(), MeshCodeGizmo);
     }
+    UpdateSelectedAreaMesh();
+}
+
+void FPLATEAUExtentEditorViewportClient::BuildMeshCodeGizmoLines() {
+    if (BorderLineBatch == nullptr) {
+        BorderLineBatch = CreateLineBatch(*PreviewScene);
+        GridLineBatch = CreateLineBatch(*PreviewScene);
+        SelectedAreaBatch = CreateLineBatch(*PreviewScene);
+    }
+
+    TArray<FBatchedLine> BorderLines;
+    TArray<FBatchedLine> GridLines;
+    BorderLines.Reserve(MeshCodeGizmos.Num() * 4);
+    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
+        MeshCodeGizmo.AddBorderLines(BorderLines);
+        MeshCodeGizmo.AddGridLines(GridLines);
+    }
+    BorderLineBatch->Flush();
+    BorderLineBatch->DrawLines(BorderLines);
+    GridLineBatch->Flush();
+    GridLineBatch->DrawLines(GridLines);
+}
+
+void FPLATEAUExtentEditorViewportClient::UpdateSelectedAreaMesh() {
+    if (SelectedAreaBatch == nullptr)
+        return;
+
+    TArray<FVector> Vertices;
+    TArray<int32> Indices;
+    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
+        MeshCodeGizmo.AddSelectedAreaMesh(Vertices, Indices);
+    }
+    SelectedAreaBatch->Flush();
+    if (0 < Indices.Num())
+        SelectedAreaBatch->DrawMesh(Vertices, Indices, FPLATEAUMeshCodeGizmo::GetSelectedAreaColor(), SDPG_Foreground, 0.0f);
 }
 
 void FPLATEAUExtentEditorViewportClient::InitCamera() {
@@ -107,7 +169,14 @@ void FPLATEAUExtentEditorViewportClient::Tick(float DeltaSeconds) {
     if (DatasetAccessor == nullptr)
         return;
 
-    FPLATEAUMeshCodeGizmo::SetShowLevel5Mesh(GetViewTransform().GetLocation().Z < 10000.0);
+    // 格子状のラインと選択エリアは近づいた場合のみ表示
+    if (GridLineBatch != nullptr) {
+        const bool bShowGrid = GetViewTransform().GetLocation().Z < ShowGridCameraDistance;
+        if (GridLineBatch->IsVisible() != bShowGrid) {
+            GridLineBatch->SetVisibility(bShowGrid);
+            SelectedAreaBatch->SetVisibility(bShowGrid);
+        }
+    }
 
     // ベースマップ
     const auto ExtentEditor = ExtentEditorPtr.Pin();
@@ -145,6 +214,7 @@ void FPLATEAUExtentEditorViewportClient::Tick(float DeltaSeconds) {
     MaxCoordinate.longitude = FMath::Max(TempMinCoordinate.longitude, MaxCoordinate.longitude);
 
     Extent = FPLATEAUExtent(plateau::geometry::Extent(MinCoordinate, MaxCoordinate));
+    UpdateVisibleMeshCodeGizmos();
 
     Basemap->UpdateAsync(Extent, DeltaSeconds);
 
@@ -164,13 +234,7 @@ void FPLATEAUExtentEditorViewportClient::Tick(float DeltaSeconds) {
 void FPLATEAUExtentEditorViewportClient::Draw(const FSceneView* View, FPrimitiveDrawInterface* PDI) {
     FEditorViewportClient::Draw(View, PDI);
 
-    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
-        // 範囲内のギズモのみ描画
-        if (GizmoContains(MeshCodeGizmo)) {
-            MeshCodeGizmo.DrawExtent(View, PDI);
-        }
-    }
-
+    // ギズモはプレビューシーンのLineBatchComponentで描画される
     if (IsLeftMouseButtonMoved || IsLeftMouseAndShiftButtonMoved) {
         // ドラッグ中に表示する範囲枠線
         const FBox Box(FVector(TrackingStartedPosition.X, TrackingStartedPosition.Y, 0), FVector(CachedWorldMousePos.X, CachedWorldMousePos.Y, 0));
@@ -186,15 +250,25 @@ void FPLATEAUExtentEditorViewportClient::DrawCanvas(FViewport& InViewport, FScen
         FeatureInfoDisplay = MakeShared<FPLATEAUFeatureInfoDisplay>(ExtentEditorPtr.Pin().Get()->GetGeoReference(), SharedThis(this));
     }
 
-    const int LoadingPanelCnt = FeatureInfoDisplay->CountLoadingPanels();
-    const auto& NearestMeshCodeGizmo = GetNearestMeshCodeGizmo();
-    if (NearestMeshCodeGizmo.GetRegionMeshID() != "" && LoadingPanelCnt < MaxLoadPanelParallelCount && 0 < CameraDistance && CameraDistance < 9000.0) {
-        FeatureInfoDisplay->CreatePanelAsync(NearestMeshCodeGizmo, *DatasetAccessor);
-        FeatureInfoDisplay->AddComponent(NearestMeshCodeGizmo);
+    // 画面外になった読込中のパネルは中止
+    TSet<FString> VisibleRegionMeshIDs;
+    for (const auto Index : VisibleMeshCodeGizmoIndices) {
+        VisibleRegionMeshIDs.Add(MeshCodeGizmos[Index].GetRegionMeshID());
+    }
+    FeatureInfoDisplay->CancelLoadingPanels(VisibleRegionMeshIDs);
+
+    if (0 < CameraDistance && CameraDistance < 9000.0) {
+        for (const auto& MeshCodeGizmo : GetNearestMeshCodeGizmos(MaxCreatePanelPerFrameCount)) {
+            FeatureInfoDisplay->CreatePanelAsync(MeshCodeGizmo, *DatasetAccessor);
+        }
     }
 
+    const auto ViewCenter = ExtentEditorPtr.Pin()->GetGeoReference().GetData().project(Extent.GetNativeData().centerPoint());
+    FeatureInfoDisplay->UpdateLoadingPanels(FVector(ViewCenter.x, ViewCenter.y, ViewCenter.z));
+
     int32 AddedComponentCnt = 0;
-    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
+    for (const auto Index : VisibleMeshCodeGizmoIndices) {
+        const auto& MeshCodeGizmo = MeshCodeGizmos[Index];
         if (const auto ItemCount = FeatureInfoDisplay.Get()->GetItemCount(MeshCodeGizmo); 0 < ItemCount) {
             MeshCodeGizmo.DrawRegionMeshID(InViewport, View, Canvas, MeshCodeGizmo.GetRegionMeshID(), CameraDistance, ItemCount);
         }
@@ -218,11 +292,11 @@ void FPLATEAUExtentEditorViewportClient::DrawCanvas(FViewport& InViewport, FScen
     }
 }
 
-FPLATEAUMeshCodeGizmo FPLATEAUExtentEditorViewportClient::GetNearestMeshCodeGizmo() {
-    // ロードを開始する対象Gizmoの中で最もカメラ中心位置から近いGizmoのロードを開始
-    FPLATEAUMeshCodeGizmo NearestMeshCodeGizmo;
-    double MinSqrDist = MAX_dbl;
-    for (const auto& MeshCodeGizmo : MeshCodeGizmos) {
+TArray<FPLATEAUMeshCodeGizmo> FPLATEAUExtentEditorViewportClient::GetNearestMeshCodeGizmos(const int32 MaxCount) {
+    // ロードを開始する対象Gizmoの中でカメラ中心位置から近い順にロードを開始
+    TArray<TPair<double, int32>> Candidates;
+    for (const auto i : VisibleMeshCodeGizmoIndices) {
+        const auto& MeshCodeGizmo = MeshCodeGizmos[i];
         // 読込済みのものは飛ばす
         if (FeatureInfoDisplay->MeshCodeGizmoContains(MeshCodeGizmo))
             continue;
@@ -234,13 +308,15 @@ FPLATEAUMeshCodeGizmo FPLATEAUExtentEditorViewportClient::GetNearestMeshCodeGizm
         DistFromCenter.longitude *= 0.5;
 
         const auto SqrDist = DistFromCenter.latitude * DistFromCenter.latitude + DistFromCenter.longitude * DistFromCenter.longitude;
-        if (SqrDist < MinSqrDist) {
-            MinSqrDist = SqrDist;
-            NearestMeshCodeGizmo = MeshCodeGizmo;
-        }
+        Candidates.Emplace(SqrDist, i);
     }
+    Candidates.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
 
-    return NearestMeshCodeGizmo;
+    TArray<FPLATEAUMeshCodeGizmo> NearestMeshCodeGizmos;
+    for (int32 i = 0; i < FMath::Min(MaxCount, Candidates.Num()); ++i) {
+        NearestMeshCodeGizmos.Add(MeshCodeGizmos[Candidates[i].Value]);
+    }
+    return NearestMeshCodeGizmos;
 }
 
 void FPLATEAUExtentEditorViewportClient::TrackingStarted(const FInputEventState& InInputState, bool bIsDragging, bool bNudge) {
@@ -289,10 +365,11 @@ void FPLATEAUExtentEditorViewportClient::CapturedMouseMove(FViewport* InViewport
 }
 
 void FPLATEAUExtentEditorViewportClient::TrackingStopped() {
+    bool bSelectionChanged = false;
     if (IsLeftMouseButtonPressed) {
         for (auto& Gizmo : MeshCodeGizmos) {
             CachedWorldMousePos = GetWorldPosition(CachedMouseX, CachedMouseY);
-            Gizmo.ToggleSelectArea(CachedWorldMousePos.X, CachedWorldMousePos.Y);
+            bSelectionChanged |= Gizmo.ToggleSelectArea(CachedWorldMousePos.X, CachedWorldMousePos.Y);
             ExtentEditorPtr.Pin()->SetAreaMeshCodeMap(Gizmo.GetRegionMeshID(), Gizmo);
         }
     } else if (IsLeftMouseButtonMoved || IsLeftMouseAndShiftButtonMoved) {
@@ -308,11 +385,15 @@ void FPLATEAUExtentEditorViewportClient::TrackingStopped() {
         const auto ExtentMax = FVector2d(MaxX, MaxY);
         
         for (auto& Gizmo : MeshCodeGizmos) {
-            Gizmo.SetSelectArea(ExtentMin, ExtentMax, IsLeftMouseButtonMoved);
+            bSelectionChanged |= Gizmo.SetSelectArea(ExtentMin, ExtentMax, IsLeftMouseButtonMoved);
             ExtentEditorPtr.Pin()->SetAreaMeshCodeMap(Gizmo.GetRegionMeshID(), Gizmo);
         }
     }
 
+    // 選択状態が変わった場合のみ塗りつぶしを作り直す
+    if (bSelectionChanged)
+        UpdateSelectedAreaMesh();
+
     IsLeftMouseButtonPressed = false;
     IsLeftMouseAndShiftButtonPressed = false;
     IsLeftMouseButtonMoved = false;
@@ -330,15 +411,25 @@ void FPLATEAUExtentEditorViewportClient::SwitchFeatureInfoDisplay(const int Lod,
 }
 
 bool FPLATEAUExtentEditorViewportClient::GizmoContains(const FPLATEAUMeshCodeGizmo& Gizmo) const {
-    const auto ExtentEditor = ExtentEditorPtr.Pin();
-    const auto RawMin = ExtentEditor->GetGeoReference().GetData().project(Extent.GetNativeData().min);
-    const auto RawMax = ExtentEditor->GetGeoReference().GetData().project(Extent.GetNativeData().max);
-    const auto MinX = FGenericPlatformMath::Min(RawMin.x, RawMax.x);
-    const auto MinY = FGenericPlatformMath::Min(RawMin.y, RawMax.y);
-    const auto MaxX = FGenericPlatformMath::Max(RawMin.x, RawMax.x);
-    const auto MaxY = FGenericPlatformMath::Max(RawMin.y, RawMax.y);
-
-    return MinX <= Gizmo.GetMin().X + Gizmo.GetSize().X && Gizmo.GetMax().X - Gizmo.GetSize().X <= MaxX && MinY <= Gizmo.GetMin().Y + Gizmo.GetSize().Y && Gizmo.GetMax().Y - Gizmo.GetSize().Y <= MaxY;
+    return ViewBox.bIsValid
+        && ViewBox.Min.X <= Gizmo.GetMin().X + Gizmo.GetSize().X && Gizmo.GetMax().X - Gizmo.GetSize().X <= ViewBox.Max.X
+        && ViewBox.Min.Y <= Gizmo.GetMin().Y + Gizmo.GetSize().Y && Gizmo.GetMax().Y - Gizmo.GetSize().Y <= ViewBox.Max.Y;
+}
+
+void FPLATEAUExtentEditorViewportClient::UpdateVisibleMeshCodeGizmos() {
+    // 表示範囲の投影はギズモごとではなくフレームごとに1回のみ行う
+    auto GeoReference = ExtentEditorPtr.Pin()->GetGeoReference();
+    const auto RawMin = GeoReference.GetData().project(Extent.GetNativeData().min);
+    const auto RawMax = GeoReference.GetData().project(Extent.GetNativeData().max);
+    ViewBox = FBox2D(
+        FVector2D(FGenericPlatformMath::Min(RawMin.x, RawMax.x), FGenericPlatformMath::Min(RawMin.y, RawMax.y)),
+        FVector2D(FGenericPlatformMath::Max(RawMin.x, RawMax.x), FGenericPlatformMath::Max(RawMin.y, RawMax.y)));
+
+    // GizmoContainsはギズモのサイズ分だけ広げた範囲で判定するため、その分広げて検索する
+    MeshCodeGizmoIndex.Query(ViewBox.ExpandBy(ViewQueryMargin), VisibleMeshCodeGizmoIndices);
+    VisibleMeshCodeGizmoIndices.RemoveAll([this](const int32 Index) {
+        return !GizmoContains(MeshCodeGizmos[Index]);
+    });
 }
 
 FVector FPLATEAUExtentEditorViewportClient::GetWorldPosition(uint32 X, uint32 Y) {
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "EditorViewportClient.h"
 #include "PLATEAUGeometry.h"
+#include "ExtentEditor/PLATEAUMeshCodeGizmoIndex.h"
 
 namespace plateau::dataset {
     class IDatasetAccessor;
@@ -66,10 +67,23 @@ private:
     FVector TrackingStartedPosition;
     FVector TrackingStartedCameraPosition;
     TArray<class FPLATEAUMeshCodeGizmo> MeshCodeGizmos;
+    FPLATEAUMeshCodeGizmoIndex MeshCodeGizmoIndex;
+    // 表示範囲(平面座標)
+    FBox2D ViewBox = FBox2D(ForceInit);
+    FVector2D ViewQueryMargin = FVector2D::ZeroVector;
+    // 表示範囲内のギズモのインデックス。Tickで更新されます
+    TArray<int32> VisibleMeshCodeGizmoIndices;
+    // ギズモの枠線, 格子状のライン, 選択エリアの塗りつぶし。プレビューシーンに常駐させ、変化があった場合のみ作り直します
+    class ULineBatchComponent* BorderLineBatch = nullptr;
+    class ULineBatchComponent* GridLineBatch = nullptr;
+    class ULineBatchComponent* SelectedAreaBatch = nullptr;
     
     bool GizmoContains(const FPLATEAUMeshCodeGizmo& Gizmo) const;
+    void UpdateVisibleMeshCodeGizmos();
+    void BuildMeshCodeGizmoLines();
+    void UpdateSelectedAreaMesh();
     FVector GetWorldPosition(uint32 X, uint32 Y);
     bool TryGetWorldPositionOfCursor(FVector& Position);
     void InitCamera();
-    FPLATEAUMeshCodeGizmo GetNearestMeshCodeGizmo();
+    TArray<FPLATEAUMeshCodeGizmo> GetNearestMeshCodeGizmos(const int32 MaxCount);
 };
@@ -70,6 +70,11 @@ namespace {
         return Material;
     }
 
+    /**
+     * @brief GMLファイルの最大LODを並列に読み込む数の下限
+     */
+    constexpr int32 MinConcurrentProbes = 2;
+
     std::shared_ptr<std::vector<GmlFile>> FindGmlFiles(
         const IDatasetAccessor& InDatasetAccessor,
         const MeshCode& InMeshCode,
@@ -86,6 +91,8 @@ FPLATEAUFeatureInfoDisplay::FPLATEAUFeatureInfoDisplay(
     const TSharedPtr<FPLATEAUExtentEditorViewportClient> InViewportClient)
     : GeoReference(InGeoReference)
     , ViewportClient(InViewportClient)
+    , InFlightProbeCount(MakeShared<TAtomic<int32>>(0))
+    , MaxConcurrentProbes(FMath::Max(MinConcurrentProbes, FTaskGraphInterface::Get().GetNumWorkerThreads()))
 {
     ShowLods.Reset();
     for (int Lod = 0; Lod <= plateau::Feature::MaxLod; ++Lod) {
@@ -95,7 +102,12 @@ FPLATEAUFeatureInfoDisplay::FPLATEAUFeatureInfoDisplay(
     InitializeMaterials();
 }
 
-FPLATEAUFeatureInfoDisplay::~FPLATEAUFeatureInfoDisplay() {}
+FPLATEAUFeatureInfoDisplay::~FPLATEAUFeatureInfoDisplay() {
+    // 実行中の読込はパネルを保持しているため、結果を破棄させるのみ
+    for (const auto& Panel : LoadingPanels) {
+        Panel->Cancel();
+    }
+}
 
 bool FPLATEAUFeatureInfoDisplay::CreatePanelAsync(const FPLATEAUMeshCodeGizmo& MeshCodeGizmo, const IDatasetAccessor& InDatasetAccessor) {
     // 生成済みの場合はスキップ
@@ -117,17 +129,49 @@ bool FPLATEAUFeatureInfoDisplay::CreatePanelAsync(const FPLATEAUMeshCodeGizmo& M
     const FBox Box{FVector(RawTileMin.x, RawTileMin.y, RawTileMin.z), FVector(RawTileMax.x, RawTileMax.y, RawTileMax.z)};
 
     AsyncLoadedTile->LoadMaxLodAsync(Input, Box);
+    if (AsyncLoadedTile->HasPendingProbe())
+        LoadingPanels.Add(AsyncLoadedTile);
 
     return true;
 }
 
-int FPLATEAUFeatureInfoDisplay::CountLoadingPanels() {
-    int Count = 0;
-    for (const auto& Entry : AsyncLoadedPanels) {
-        if (Entry.Value->GetLoadMaxLodTaskStatus() == EPLATEAUFeatureInfoPanelStatus::Loading)
-            ++Count;
+void FPLATEAUFeatureInfoDisplay::UpdateLoadingPanels(const FVector& ViewCenter) {
+    LoadingPanels.RemoveAll([](const TSharedPtr<FPLATEAUAsyncLoadedFeatureInfoPanel>& Panel) {
+        return !Panel->HasPendingProbe();
+    });
+    if (LoadingPanels.IsEmpty() || MaxConcurrentProbes <= *InFlightProbeCount)
+        return;
+
+    // 画面中心から近いパネルを優先
+    // 横長のディスプレイに映る範囲を優先するため、縦よりも横の距離を小さく見積もる
+    const auto GetSqrDist = [&ViewCenter](const FPLATEAUAsyncLoadedFeatureInfoPanel& Panel) {
+        const auto Offset = Panel.GetBox().GetCenter() - ViewCenter;
+        return FMath::Square(Offset.X * 0.5) + FMath::Square(Offset.Y);
+    };
+    LoadingPanels.StableSort([&GetSqrDist](const TSharedPtr<FPLATEAUAsyncLoadedFeatureInfoPanel>& A, const TSharedPtr<FPLATEAUAsyncLoadedFeatureInfoPanel>& B) {
+        return GetSqrDist(*A) < GetSqrDist(*B);
+    });
+
+    for (const auto& Panel : LoadingPanels) {
+        while (*InFlightProbeCount < MaxConcurrentProbes && Panel->HasPendingProbe()) {
+            Panel->LaunchNextProbe(InFlightProbeCount);
+        }
+        if (MaxConcurrentProbes <= *InFlightProbeCount)
+            break;
+    }
+}
+
+void FPLATEAUFeatureInfoDisplay::CancelLoadingPanels(const TSet<FString>& VisibleRegionMeshIDs) {
+    for (auto It = AsyncLoadedPanels.CreateIterator(); It; ++It) {
+        if (It->Value->GetLoadMaxLodTaskStatus() != EPLATEAUFeatureInfoPanelStatus::Loading)
+            continue;
+        if (VisibleRegionMeshIDs.Contains(It->Key))
+            continue;
+
+        It->Value->Cancel();
+        LoadingPanels.Remove(It->Value);
+        It.RemoveCurrent();
     }
-    return Count;
 }
 
 bool FPLATEAUFeatureInfoDisplay::AddComponent(const FPLATEAUMeshCodeGizmo& MeshCodeGizmo) {
@@ -64,7 +64,15 @@ public:
     bool CreatePanelAsync(const FPLATEAUMeshCodeGizmo& MeshCodeGizmo, const plateau::dataset::IDatasetAccessor& InDatasetAccessor);
     bool AddComponent(const FPLATEAUMeshCodeGizmo& MeshCodeGizmo);
 
-    int CountLoadingPanels();
+    /**
+     * @brief 読込中のパネルのGMLファイルを、ViewCenterに近いパネルから優先して並列に読み込みます。毎Tick呼び出してください。
+     */
+    void UpdateLoadingPanels(const FVector& ViewCenter);
+
+    /**
+     * @brief 画面外になった読込中のパネルを中止し、再度画面内に入った際に読み込み直せるようにします。
+     */
+    void CancelLoadingPanels(const TSet<FString>& VisibleRegionMeshIDs);
 
     UMaterialInstanceDynamic* GetFeatureInfoIconMaterial(const FPLATEAUFeatureInfoMaterialKey& Key);
     UMaterialInstanceDynamic* GetBackPanelMaterial() const;
@@ -112,6 +120,9 @@ private:
 
     EPLATEAUFeatureInfoVisibility Visibility;
     TMap<FString, TSharedPtr<FPLATEAUAsyncLoadedFeatureInfoPanel>> AsyncLoadedPanels;
+    TArray<TSharedPtr<FPLATEAUAsyncLoadedFeatureInfoPanel>> LoadingPanels;
+    TSharedRef<TAtomic<int32>> InFlightProbeCount;
+    int32 MaxConcurrentProbes;
     TMap<FPLATEAUFeatureInfoMaterialKey, UMaterialInstanceDynamic*> FeatureInfoMaterials;
     UMaterialInstanceDynamic* BackPanelMaterial;
     TArray<int> ShowLods;
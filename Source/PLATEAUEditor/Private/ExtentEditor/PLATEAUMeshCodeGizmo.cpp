@@ -10,14 +10,17 @@
 
 #include "CanvasTypes.h"
 #include "Algo/AnyOf.h"
+#include "Components/LineBatchComponent.h"
 #include "Engine/Font.h"
-#include "Materials/MaterialInstanceDynamic.h"
 
 namespace {
     bool IsLevel4OrAbove(const plateau::dataset::MeshCode& MeshCode) {
         return MeshCode.getLevel() >= 4;
     }
 
+    constexpr int MaxNumAreaColumn = 4;
+    constexpr int MaxNumAreaRow = 4;
+
     int GetNumAreaColumnByMeshCode(const plateau::dataset::MeshCode& MeshCode) {
         return IsLevel4OrAbove(MeshCode) ? 2 : 4;
     }
@@ -33,8 +36,8 @@ namespace {
         TEXT("33"), TEXT("34"), TEXT("43"), TEXT("44")};
 
     // 選択色
-    constexpr FColor SelectedColor = FColor(255, 204, 153);
-    constexpr FColor UnselectedColor = FColor(0, 0, 0, 0);
+    constexpr FColor SelectedColor = FColor(255, 204, 153, 128);
+    constexpr FColor LineColor = FColor(10, 10, 130);
 
     int GetRowIndex(const double InMinX, const double InMaxX, const int InNumGrid, const double InValue) {
         const double GridSize = (InMaxX - InMinX) / InNumGrid;
@@ -57,13 +60,11 @@ namespace {
     }
 }
 
-FPLATEAUMeshCodeGizmo::FPLATEAUMeshCodeGizmo() : MeshCode(), Width(0), Height(0), MinX(-500), MinY(-500), MaxX(500), MaxY(500), LineThickness(1.0f) {
-    AreaSelectedMaterial = DuplicateObject(GEngine->ConstraintLimitMaterialPrismatic, nullptr);
-    AreaSelectedMaterial.Get()->SetScalarParameterValue(FName("Desaturation"), 1.0f);
-    AreaSelectedMaterial.Get()->SetVectorParameterValue(FName("Color"), SelectedColor);
-    AreaUnSelectedMaterial = DuplicateObject(GEngine->ConstraintLimitMaterialPrismatic, nullptr);
-    AreaUnSelectedMaterial.Get()->SetScalarParameterValue(FName("Desaturation"), 1.0f);
-    AreaUnSelectedMaterial.Get()->SetVectorParameterValue(FName("Color"), UnselectedColor);
+FPLATEAUMeshCodeGizmo::FPLATEAUMeshCodeGizmo() : MeshCode(), Width(0), Height(0), MinX(-500), MinY(-500), MaxX(500), MaxY(500) {
+}
+
+FColor FPLATEAUMeshCodeGizmo::GetSelectedAreaColor() {
+    return SelectedColor;
 }
 
 bool FPLATEAUMeshCodeGizmo::IsSelectable() const {
@@ -77,59 +78,63 @@ void FPLATEAUMeshCodeGizmo::ResetSelectedArea() {
     }
 }
 
-void FPLATEAUMeshCodeGizmo::DrawExtent(const FSceneView* View, FPrimitiveDrawInterface* PDI) const {
-    const FBox Box(FVector(MinX, MinY, 0), FVector(MaxX, MaxY, 0));
-    const auto Color = FColor(10, 10, 130);
+void FPLATEAUMeshCodeGizmo::AddBorderLines(TArray<FBatchedLine>& OutLines) const {
+    // エリア枠線
+    // 平面の矩形のため、DrawWireBoxの12本ではなく4本の線で描画する
+    const FVector Corners[] = {
+        FVector(MinX, MinY, 0), FVector(MaxX, MinY, 0),
+        FVector(MaxX, MaxY, 0), FVector(MinX, MaxY, 0) };
+    for (int i = 0; i < 4; ++i) {
+        OutLines.Emplace(Corners[i], Corners[(i + 1) % 4], LineColor, 0.0f, 0.0f, SDPG_World);
+    }
+}
+
+void FPLATEAUMeshCodeGizmo::AddGridLines(TArray<FBatchedLine>& OutLines) const {
     const int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
     const int NumAreaRow = GetNumAreaRowByMeshCode(MeshCode);
+    constexpr auto Z = 0.0;
 
-    // エリア枠線
-    DrawWireBox(PDI, Box, Color, SDPG_World, LineThickness, 0, true);
-
-    if (!bShowLevel5Mesh)
-        return;
-   
     // 格子状のライン
-    for (int i = 1; i <= NumAreaColumn -1; ++i) {
-        const auto X1 = (Box.Min.X * i + Box.Max.X * (NumAreaColumn - i)) / NumAreaColumn;
-        const auto Py1 = Box.Min.Y;
-        const auto Qy1 = Box.Max.Y;
-        constexpr auto Z = 0.0;
-        const FVector P1(X1, Py1, Z);
-        const FVector Q1(X1, Qy1, Z);
-        PDI->DrawLine(P1, Q1, Color, SDPG_World, 1, 0, true);
+    for (int i = 1; i <= NumAreaColumn - 1; ++i) {
+        const auto X1 = (MinX * i + MaxX * (NumAreaColumn - i)) / NumAreaColumn;
+        OutLines.Emplace(FVector(X1, MinY, Z), FVector(X1, MaxY, Z), LineColor, 0.0f, 0.0f, SDPG_World);
     }
 
     for (int i = 1; i <= NumAreaRow - 1; ++i) {
-        const auto Y2 = (Box.Min.Y * i + Box.Max.Y * (NumAreaRow - i)) / NumAreaRow;
-        const auto Px2 = Box.Min.X;
-        const auto Qx2 = Box.Max.X;
-        constexpr auto Z = 0.0;
-        const FVector P2(Px2, Y2, Z);
-        const FVector Q2(Qx2, Y2, Z);
-        PDI->DrawLine(P2, Q2, Color, SDPG_World, 1, 0, true);
+        const auto Y2 = (MinY * i + MaxY * (NumAreaRow - i)) / NumAreaRow;
+        OutLines.Emplace(FVector(MinX, Y2, Z), FVector(MaxX, Y2, Z), LineColor, 0.0f, 0.0f, SDPG_World);
     }
+}
+
+void FPLATEAUMeshCodeGizmo::AddSelectedAreaMesh(TArray<FVector>& OutVertices, TArray<int32>& OutIndices) const {
+    const int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
+    const int NumAreaRow = GetNumAreaRowByMeshCode(MeshCode);
 
     // エリア塗りつぶし
-    const auto CellWidth = (Box.Max.X - Box.Min.X) / NumAreaRow;
-    const auto CellHalfWidth = (Box.Max.X - Box.Min.X) / (NumAreaRow * 2);
-    const auto CellHeight = (Box.Max.Y - Box.Min.Y) / NumAreaColumn;
-    const auto CellHalfHeight = (Box.Max.Y - Box.Min.Y) / (NumAreaColumn * 2);
+    const auto CellWidth = (MaxX - MinX) / NumAreaRow;
+    const auto CellHalfWidth = (MaxX - MinX) / (NumAreaRow * 2);
+    const auto CellHeight = (MaxY - MinY) / NumAreaColumn;
+    const auto CellHalfHeight = (MaxY - MinY) / (NumAreaColumn * 2);
 
     for (int Col = 0; Col < NumAreaColumn; Col++) {
         for (int Row = 0; Row < NumAreaRow; Row++) {
-            if (bSelectedArray[Row + Col * NumAreaColumn]) {
-                FMatrix ObjectToWorld = FMatrix::Identity;
-                ObjectToWorld.SetAxis(0, FVector(CellHalfWidth, 0, 0));
-                ObjectToWorld.SetAxis(1, FVector(0, CellHalfHeight, 0));
-
-                //Level4は1Gridずらす
-                int AdjustedRow = IsLevel4OrAbove(MeshCode) ? Row + 1 : Row;
-                int AdjustedCol = IsLevel4OrAbove(MeshCode) ? Col + 1 : Col;
-                ObjectToWorld.SetOrigin(FVector((Box.Min.X + Box.Max.X) / 2 - CellHalfWidth - CellWidth + CellWidth * AdjustedRow,
-                                                (Box.Min.Y + Box.Max.Y) / 2 + CellHalfHeight + CellHeight - CellHeight * AdjustedCol, 0));
-                DrawPlane10x10(PDI, ObjectToWorld, 1.0f, FVector2D::Zero(), FVector2D::One(), AreaSelectedMaterial->GetRenderProxy(), SDPG_Foreground);
-            }
+            if (!bSelectedArray[Row + Col * NumAreaColumn])
+                continue;
+
+            //Level4は1Gridずらす
+            int AdjustedRow = IsLevel4OrAbove(MeshCode) ? Row + 1 : Row;
+            int AdjustedCol = IsLevel4OrAbove(MeshCode) ? Col + 1 : Col;
+            const FVector Center((MinX + MaxX) / 2 - CellHalfWidth - CellWidth + CellWidth * AdjustedRow,
+                                 (MinY + MaxY) / 2 + CellHalfHeight + CellHeight - CellHeight * AdjustedCol, 0);
+
+            const int32 First = OutVertices.Num();
+            OutVertices.Add(Center + FVector(-CellHalfWidth, -CellHalfHeight, 0));
+            OutVertices.Add(Center + FVector(CellHalfWidth, -CellHalfHeight, 0));
+            OutVertices.Add(Center + FVector(CellHalfWidth, CellHalfHeight, 0));
+            OutVertices.Add(Center + FVector(-CellHalfWidth, CellHalfHeight, 0));
+            // 裏面カリングされないよう両面分の三角形を追加する
+            OutIndices.Append({ First, First + 1, First + 2, First, First + 2, First + 3 });
+            OutIndices.Append({ First, First + 2, First + 1, First, First + 3, First + 2 });
         }
     }
 }
@@ -211,7 +216,6 @@ void FPLATEAUMeshCodeGizmo::Init(const plateau::dataset::MeshCode& InMeshCode, c
     MinY = FGenericPlatformMath::Min(RawMin.y, RawMax.y);
     MaxX = FGenericPlatformMath::Max(RawMin.x, RawMax.x);
     MaxY = FGenericPlatformMath::Max(RawMin.y, RawMax.y);
-    LineThickness = 2.0f;
 
     const int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
     const int NumAreaRow = GetNumAreaRowByMeshCode(MeshCode);
@@ -221,13 +225,13 @@ void FPLATEAUMeshCodeGizmo::Init(const plateau::dataset::MeshCode& InMeshCode, c
     }
 }
 
-void FPLATEAUMeshCodeGizmo::ToggleSelectArea(const double X, const double Y) {
+bool FPLATEAUMeshCodeGizmo::ToggleSelectArea(const double X, const double Y) {
 
     if (!IsSelectable()) 
-        return;
+        return false;
 
     if ((MinX <= X && X <= MaxX && MinY <= Y && Y <= MaxY) == false) {
-        return;
+        return false;
     }
 
     int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
@@ -235,17 +239,19 @@ void FPLATEAUMeshCodeGizmo::ToggleSelectArea(const double X, const double Y) {
     const auto RowIndex = GetRowIndex(MinX, MaxX, NumAreaRow, X);
     const auto ColumnIndex = GetColumnIndex(MinY, MaxY, NumAreaColumn, Y);
     bSelectedArray[RowIndex + ColumnIndex * NumAreaColumn] = !bSelectedArray[RowIndex + ColumnIndex * NumAreaColumn];
+    return true;
 }
 
-void FPLATEAUMeshCodeGizmo::SetSelectArea(const FVector2d InMin, const FVector2d InMax, const bool bSelect) {
+bool FPLATEAUMeshCodeGizmo::SetSelectArea(const FVector2d InMin, const FVector2d InMax, const bool bSelect) {
 
     if (!IsSelectable()) 
-        return;
+        return false;
 
     const int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
     const int NumAreaRow = GetNumAreaRowByMeshCode(MeshCode);   
     const auto CellWidth = (MaxX - MinX) / NumAreaRow;
     const auto CellHeight = (MaxY - MinY) / NumAreaColumn;
+    bool bChanged = false;
     for (int Col = 0; Col < NumAreaColumn; Col++) {
         for (int Row = 0; Row < NumAreaRow; Row++) {
             const auto RectMinX = MinX + CellWidth * Row;
@@ -255,25 +261,29 @@ void FPLATEAUMeshCodeGizmo::SetSelectArea(const FVector2d InMin, const FVector2d
             if (RectMaxX < InMin.X || RectMinX > InMax.X || RectMaxY < InMin.Y || RectMinY > InMax.Y) {
                 continue;
             }
+            bChanged |= bSelectedArray[Row + Col * NumAreaColumn] != bSelect;
             bSelectedArray[Row + Col * NumAreaColumn] = bSelect;
         }
     }
+    return bChanged;
 }
 
-void FPLATEAUMeshCodeGizmo::SetSelectArea(const double X, const double Y, const bool bSelect) {
+bool FPLATEAUMeshCodeGizmo::SetSelectArea(const double X, const double Y, const bool bSelect) {
 
     if (!IsSelectable()) 
-        return;
+        return false;
     
     if ((MinX <= X && X <= MaxX && MinY <= Y && Y <= MaxY) == false) {
-        return;
+        return false;
     }
 
     const int NumAreaColumn = GetNumAreaColumnByMeshCode(MeshCode);
     const int NumAreaRow = GetNumAreaRowByMeshCode(MeshCode);
     const auto RowIndex = GetRowIndex(MinX, MaxX, NumAreaRow, X);
     const auto ColumnIndex = GetColumnIndex(MinY, MaxY, NumAreaColumn, Y);
+    const bool bChanged = bSelectedArray[RowIndex + ColumnIndex * NumAreaColumn] != bSelect;
     bSelectedArray[RowIndex + ColumnIndex * NumAreaColumn] = bSelect;
+    return bChanged;
 }
 
 TArray<FString> FPLATEAUMeshCodeGizmo::GetSelectedMeshIds() {
@@ -300,7 +310,3 @@ TArray<FString> FPLATEAUMeshCodeGizmo::GetSelectedMeshIds() {
     }
     return MeshIdArray;
 }
-
-void FPLATEAUMeshCodeGizmo::SetShowLevel5Mesh(const bool bValue) {
-    bShowLevel5Mesh = bValue;
-}
@@ -14,6 +14,8 @@ namespace plateau {
     }
 }
 
+struct FBatchedLine;
+
 /**
  * @brief 各地域メッシュのメッシュコードのギズモを表します。
  */
@@ -22,7 +24,27 @@ public:
     FPLATEAUMeshCodeGizmo();
 
     void ResetSelectedArea();
-    void DrawExtent(const FSceneView* View, FPrimitiveDrawInterface* PDI) const;
+
+    /**
+     * @brief 範囲の枠線をOutLinesに追加します。
+     */
+    void AddBorderLines(TArray<FBatchedLine>& OutLines) const;
+
+    /**
+     * @brief 範囲内の格子状のラインをOutLinesに追加します。
+     */
+    void AddGridLines(TArray<FBatchedLine>& OutLines) const;
+
+    /**
+     * @brief 選択されているエリアの矩形をOutVertices, OutIndicesに追加します。
+     */
+    void AddSelectedAreaMesh(TArray<FVector>& OutVertices, TArray<int32>& OutIndices) const;
+
+    /**
+     * @brief 選択されているエリアの塗りつぶし色
+     */
+    static FColor GetSelectedAreaColor();
+
     void DrawRegionMeshID(const FViewport& InViewport, const FSceneView& View, FCanvas& Canvas, const FString& RegionMeshID, double CameraDistance, int IconCount) const;
 
     /**
@@ -74,39 +96,34 @@ public:
      * @brief マウス座標がエリア内であれば選択状態をトグル
      * @param X マウス座標X
      * @param Y マウス座標Y
+     * @return 選択状態が変わった場合true
      */
-    void ToggleSelectArea(const double X, const double Y);
+    bool ToggleSelectArea(const double X, const double Y);
 
     /**
      * @brief ドラッグ矩形がギズモ範囲と交差していた時に選択されたとみなす
      * @param InMin ドラッグ矩形の最小座標
      * @param InMax ドラッグ矩形の最大座標
      * @param bSelect エリアを指定の選択状態に設定
+     * @return 選択状態が変わった場合true
      */
-    void SetSelectArea(const FVector2d InMin, const FVector2d InMax, const bool bSelect);
+    bool SetSelectArea(const FVector2d InMin, const FVector2d InMax, const bool bSelect);
 
     /**
      * @brief マウス座標がエリア内であれば指定の選択状態に設定
      * @param X マウス座標X
      * @param Y マウス座標Y
      * @param bSelect エリアを指定の選択状態に設定
+     * @return 選択状態が変わった場合true
      */
-    void SetSelectArea(const double X, const double Y, const bool bSelect);
+    bool SetSelectArea(const double X, const double Y, const bool bSelect);
 
     /**
      * @brief 選択されているメッシュID配列を取得
      */
     TArray<FString> GetSelectedMeshIds();
-    
-    /**
-     * @brief エリア内の描画有効化状態を設定
-     * @param bValue 有効化するか？
-     */
-    static void SetShowLevel5Mesh(const bool bValue);
 
 private:
-    inline static bool bShowLevel5Mesh = false;
-
     plateau::dataset::MeshCode MeshCode;
     FString MeshCodeString;
     double Width;
@@ -115,9 +132,6 @@ private:
     double MinY;
     double MaxX;
     double MaxY;
-    float LineThickness;
     TArray<bool> bSelectedArray;
-    TObjectPtr<UMaterialInstanceDynamic> AreaSelectedMaterial;
-    TObjectPtr<UMaterialInstanceDynamic> AreaUnSelectedMaterial;
     bool IsSelectable() const;
 };
@@ -0,0 +1,75 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "ExtentEditor/PLATEAUMeshCodeGizmoIndex.h"
+
+namespace {
+    /**
+     * @brief 1辺あたりの最大セル数
+     */
+    constexpr int32 MaxCellsPerAxis = 1024;
+}
+
+void FPLATEAUMeshCodeGizmoIndex::Build(const TArray<FBox2D>& InBounds) {
+    Bounds = InBounds;
+    Cells.Reset();
+    NumCellX = 0;
+    NumCellY = 0;
+    if (Bounds.IsEmpty())
+        return;
+
+    FBox2D TotalBounds(ForceInit);
+    FVector2D SumSize = FVector2D::ZeroVector;
+    for (const auto& Box : Bounds) {
+        TotalBounds += Box;
+        SumSize += Box.GetSize();
+    }
+
+    // セルの大きさはギズモの平均的な大きさとする
+    const auto TotalSize = TotalBounds.GetSize();
+    const auto AverageSize = SumSize / Bounds.Num();
+    CellSize.X = FMath::Max3(AverageSize.X, TotalSize.X / MaxCellsPerAxis, UE_KINDA_SMALL_NUMBER);
+    CellSize.Y = FMath::Max3(AverageSize.Y, TotalSize.Y / MaxCellsPerAxis, UE_KINDA_SMALL_NUMBER);
+    Origin = TotalBounds.Min;
+    NumCellX = FMath::Clamp(FMath::FloorToInt32(TotalSize.X / CellSize.X) + 1, 1, MaxCellsPerAxis);
+    NumCellY = FMath::Clamp(FMath::FloorToInt32(TotalSize.Y / CellSize.Y) + 1, 1, MaxCellsPerAxis);
+    Cells.SetNum(NumCellX * NumCellY);
+
+    for (int32 i = 0; i < Bounds.Num(); ++i) {
+        const auto MinCell = GetCell(Bounds[i].Min);
+        const auto MaxCell = GetCell(Bounds[i].Max);
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+            for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+                Cells[X + Y * NumCellX].Add(i);
+            }
+        }
+    }
+}
+
+void FPLATEAUMeshCodeGizmoIndex::Query(const FBox2D& Box, TArray<int32>& OutIndices) const {
+    OutIndices.Reset();
+    if (Cells.IsEmpty() || !Box.bIsValid)
+        return;
+
+    const auto MinCell = GetCell(Box.Min);
+    const auto MaxCell = GetCell(Box.Max);
+    TBitArray<> Visited(false, Bounds.Num());
+    for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+        for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+            for (const auto Index : Cells[X + Y * NumCellX]) {
+                if (Visited[Index])
+                    continue;
+                Visited[Index] = true;
+                if (Bounds[Index].Intersect(Box))
+                    OutIndices.Add(Index);
+            }
+        }
+    }
+    OutIndices.Sort();
+}
+
+FIntPoint FPLATEAUMeshCodeGizmoIndex::GetCell(const FVector2D& Position) const {
+    const auto Local = (Position - Origin) / CellSize;
+    return FIntPoint(
+        FMath::Clamp(FMath::FloorToInt32(Local.X), 0, NumCellX - 1),
+        FMath::Clamp(FMath::FloorToInt32(Local.Y), 0, NumCellY - 1));
+}
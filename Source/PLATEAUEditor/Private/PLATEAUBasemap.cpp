@@ -21,15 +21,36 @@ namespace {
 
 FPLATEAUBasemap::FPLATEAUBasemap(
     const FPLATEAUGeoReference& InGeoReference,
-    const TSharedPtr<FPLATEAUExtentEditorViewportClient> InViewportClient)
+    const TSharedPtr<FPLATEAUExtentEditorViewportClient> InViewportClient,
+    const FPLATEAUBasemapSettings& InSettings)
     : DeltaTime(0)
     , GeoReference(InGeoReference)
     , ViewportClient(InViewportClient)
-    , VectorTilePipe{ TEXT("VectorTilePipe") } {}
+    , Settings(InSettings)
+    , NextPipeIndex(0)
+    , UpdateCount(0) {
+    if (Settings.TileDirectory.IsEmpty())
+        Settings.TileDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir() + TEXT("\\PLATEAU\\Basemap"));
+    Settings.MaxConcurrentLoads = FMath::Max(1, Settings.MaxConcurrentLoads);
+    Settings.MaxCachedTiles = FMath::Max(1, Settings.MaxCachedTiles);
+
+    // タイルごとに読み込まず、全タイルで共有する
+    TileAssets.Material.Reset(Cast<UMaterial>(StaticLoadObject(UMaterial::StaticClass(), nullptr, TEXT("/PLATEAU-SDK-for-Unreal/FeatureInfoPanel_PanelIcon"))));
+    TileAssets.PlaneMesh.Reset(Cast<UStaticMesh>(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, TEXT("/Engine/BasicShapes/Plane"))));
+
+    for (int32 i = 0; i < Settings.MaxConcurrentLoads; ++i) {
+        VectorTilePipes.Add(MakeUnique<UE::Tasks::FPipe>(TEXT("VectorTilePipe")));
+    }
+}
 
 FPLATEAUBasemap::~FPLATEAUBasemap() {
-    if (VectorTilePipe.HasWork())
-        VectorTilePipe.WaitUntilEmpty();
+    for (const auto& VectorTilePipe : VectorTilePipes) {
+        if (VectorTilePipe->HasWork())
+            VectorTilePipe->WaitUntilEmpty();
+    }
+    for (const auto& Entry : AsyncLoadedTiles) {
+        Entry.Value->Release();
+    }
 }
 
 void FPLATEAUBasemap::UpdateAsync(const FPLATEAUExtent& InExtent, float DeltaSeconds) {
@@ -44,6 +65,17 @@ void FPLATEAUBasemap::UpdateAsync(const FPLATEAUExtent& InExtent, float DeltaSec
         --ZoomLevel;
     }
 
+    TArray<FPLATEAUTileCoordinate> VisibleTiles;
+    VisibleTiles.Reserve(TileCoordinates->size());
+    for (const auto& RawTileCoordinate : *TileCoordinates) {
+        VisibleTiles.Add(FPLATEAUTileCoordinate::FromNativeData(RawTileCoordinate));
+    }
+    UpdateTiles(VisibleTiles, DeltaSeconds);
+}
+
+void FPLATEAUBasemap::UpdateTiles(const TArray<FPLATEAUTileCoordinate>& VisibleTiles, float DeltaSeconds) {
+    ++UpdateCount;
+
     for (auto& Entry : AsyncLoadedTiles) {
         const auto TileComponent = Entry.Value->GetComponent();
         if (TileComponent == nullptr)
@@ -52,7 +84,7 @@ void FPLATEAUBasemap::UpdateAsync(const FPLATEAUExtent& InExtent, float DeltaSec
             continue;
 
         // ここで一旦読み込み済みのタイルを非表示にする
-        // 後述のSetVisibilityにより表示するべきタイル（TileCoordinates）を表示する
+        // 後述のSetVisibilityにより表示するべきタイル（VisibleTiles）を表示する
         Entry.Value->SetVisibility(false);
 
         if (TilesInScene.Contains(TileComponent))
@@ -84,19 +116,59 @@ void FPLATEAUBasemap::UpdateAsync(const FPLATEAUExtent& InExtent, float DeltaSec
         TilesInScene.Add(TileComponent);
     }
 
-    for (const auto& RawTileCoordinate : *TileCoordinates) {
-        auto TileCoordinate = FPLATEAUTileCoordinate::FromNativeData(RawTileCoordinate);
+    for (const auto& TileCoordinate : VisibleTiles) {
         if (!AsyncLoadedTiles.Find(TileCoordinate)) {
             const auto& AsyncLoadedTile = AsyncLoadedTiles.Add(TileCoordinate, MakeShared<FPLATEAUAsyncLoadedVectorTile>());
-            AsyncLoadedTile->StartLoading(TileCoordinate, VectorTilePipe);
+            AsyncLoadedTile->SetLastVisibleUpdate(UpdateCount);
+            AsyncLoadedTile->StartLoading(TileCoordinate, Settings, TileAssets, *VectorTilePipes[NextPipeIndex]);
+            NextPipeIndex = (NextPipeIndex + 1) % VectorTilePipes.Num();
             continue;
         }
 
         const auto& AsyncLoadedTile = AsyncLoadedTiles[TileCoordinate];
+        AsyncLoadedTile->SetLastVisibleUpdate(UpdateCount);
         if (AsyncLoadedTile->GetLoadPhase() == EVectorTileLoadingPhase::FullyLoaded) {
             AsyncLoadedTile->SetVisibility(true);
         }
     }
+
+    EvictTiles();
+}
+
+EVectorTileLoadingPhase FPLATEAUBasemap::GetTileLoadPhase(const FPLATEAUTileCoordinate& TileCoordinate) const {
+    const auto AsyncLoadedTile = AsyncLoadedTiles.Find(TileCoordinate);
+    return AsyncLoadedTile != nullptr ? (*AsyncLoadedTile)->GetLoadPhase() : EVectorTileLoadingPhase::Idle;
+}
+
+void FPLATEAUBasemap::EvictTiles() {
+    if (AsyncLoadedTiles.Num() <= Settings.MaxCachedTiles)
+        return;
+
+    // 画面外かつ読込中でないタイルを、最後に表示されたのが古い順に破棄
+    TArray<FPLATEAUTileCoordinate> Candidates;
+    for (const auto& Entry : AsyncLoadedTiles) {
+        if (Entry.Value->GetLastVisibleUpdate() == UpdateCount)
+            continue;
+        if (Entry.Value->GetLoadPhase() == EVectorTileLoadingPhase::Loading)
+            continue;
+        Candidates.Add(Entry.Key);
+    }
+    Candidates.Sort([this](const FPLATEAUTileCoordinate& A, const FPLATEAUTileCoordinate& B) {
+        return AsyncLoadedTiles[A]->GetLastVisibleUpdate() < AsyncLoadedTiles[B]->GetLastVisibleUpdate();
+    });
+
+    const auto PreviewScene = ViewportClient.IsValid() ? ViewportClient.Pin()->GetPreviewScene() : nullptr;
+    for (const auto& TileCoordinate : Candidates) {
+        if (AsyncLoadedTiles.Num() <= Settings.MaxCachedTiles)
+            break;
+
+        const auto AsyncLoadedTile = AsyncLoadedTiles.FindAndRemoveChecked(TileCoordinate);
+        if (const auto TileComponent = AsyncLoadedTile->GetComponent(); TileComponent != nullptr && TilesInScene.Remove(TileComponent) > 0) {
+            if (PreviewScene != nullptr)
+                PreviewScene->RemoveComponent(TileComponent);
+        }
+        AsyncLoadedTile->Release();
+    }
 }
 
 FPLATEAUTileCoordinate FPLATEAUTileCoordinate::FromNativeData(const TileCoordinate& Data) {
@@ -129,12 +201,12 @@ uint32 GetTypeHash(const FPLATEAUTileCoordinate& Value) {
     return Value.ZoomLevel * 100000000 + Value.Row * 10000 + Value.Column;
 }
 
-void FPLATEAUAsyncLoadedVectorTile::StartLoading(const FPLATEAUTileCoordinate& InTileCoordinate, FPipe& VectorTilePipe) {
+void FPLATEAUAsyncLoadedVectorTile::StartLoading(const FPLATEAUTileCoordinate& InTileCoordinate, const FPLATEAUBasemapSettings& Settings,
+                                                 const FPLATEAUBasemapTileAssets& Assets, UE::Tasks::FPipe& VectorTilePipe) {
     LoadPhase = EVectorTileLoadingPhase::Loading;
     Task = VectorTilePipe.Launch(TEXT("VectorTileTask"),
-        [this, InTileCoordinate]() {
+        [this, InTileCoordinate, Destination = Settings.TileDirectory, bAllowDownload = Settings.bAllowDownload, &Assets]() {
 
-            const auto Destination = FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir() + TEXT("\\PLATEAU\\Basemap"));
             const FString TexturePath = UTF8_TO_TCHAR(VectorTileDownloader::calcDestinationPath(InTileCoordinate.ToNativeData(), TCHAR_TO_UTF8(*Destination), ".png").u8string().c_str());
             IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 
@@ -148,6 +220,10 @@ void FPLATEAUAsyncLoadedVectorTile::StartLoading(const FPLATEAUTileCoordinate& I
                     return;
                 }
             }
+            else if (!bAllowDownload) {
+                LoadPhase = EVectorTileLoadingPhase::Failed;
+                return;
+            }
             else {
                 //画像ダウンロード
                 const auto Tile = VectorTileDownloader::download(
@@ -171,35 +247,26 @@ void FPLATEAUAsyncLoadedVectorTile::StartLoading(const FPLATEAUTileCoordinate& I
                 return;
             }
 
-            const auto& TempComponent = CreateTileComponentInGameThread(Texture);
-            {
-                FScopeLock Lock(&CriticalSection);
-                TileComponent = TempComponent;
-                LoadPhase = EVectorTileLoadingPhase::FullyLoaded;
-            }
-
-            check(LoadPhase != EVectorTileLoadingPhase::Loading);
+            CreateTileComponentInGameThread(Texture, Assets);
+            LoadPhase = EVectorTileLoadingPhase::FullyLoaded;
         });
 }
 
-UStaticMeshComponent* FPLATEAUAsyncLoadedVectorTile::CreateTileComponentInGameThread(UTexture* Texture) {
-    UStaticMeshComponent* NewTileComponent;
+void FPLATEAUAsyncLoadedVectorTile::CreateTileComponentInGameThread(UTexture* Texture, const FPLATEAUBasemapTileAssets& Assets) {
     FFunctionGraphTask::CreateAndDispatchWhenReady([&] {
         //mesh component作成，テクスチャを適用
         const FName MeshName = MakeUniqueObjectName(GetTransientPackage(), UStaticMeshComponent::StaticClass(), TEXT("Tile"));
-        NewTileComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), MeshName, RF_Transient);
-        const auto Mat = Cast<UMaterial>(StaticLoadObject(UMaterial::StaticClass(), nullptr, TEXT("/PLATEAU-SDK-for-Unreal/FeatureInfoPanel_PanelIcon")));
-        const auto DynMat = UMaterialInstanceDynamic::Create(Mat, GetTransientPackage());
+        const auto NewTileComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), MeshName, RF_Transient);
+        const auto DynMat = UMaterialInstanceDynamic::Create(Assets.Material.Get(), GetTransientPackage());
         DynMat->SetTextureParameterValue(TEXT("Texture"), Texture);
-        TileMaterialInstanceDynamicsMap.Emplace(NewTileComponent, DynMat);
+        NewTileComponent->SetStaticMesh(Assets.PlaneMesh.Get());
         NewTileComponent->SetMaterial(0, DynMat);
-        const auto StaticMeshName = TEXT("/Engine/BasicShapes/Plane");
-        const auto Mesh = Cast<UStaticMesh>(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, StaticMeshName));
-        Mesh->AddMaterial(DynMat);
-        NewTileComponent->SetStaticMesh(Mesh);
-    }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
 
-    return NewTileComponent;
+        FScopeLock Lock(&CriticalSection);
+        TileComponent.Reset(NewTileComponent);
+        TileMaterialInstanceDynamic.Reset(DynMat);
+        TileTexture.Reset(Texture);
+    }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
 }
 
 void FPLATEAUAsyncLoadedVectorTile::SetVisibility(const bool InbVisibility) {
@@ -210,12 +277,21 @@ void FPLATEAUAsyncLoadedVectorTile::SetVisibility(const bool InbVisibility) {
     ApplyVisibility();
 }
 
+void FPLATEAUAsyncLoadedVectorTile::Release() {
+    check(IsInGameThread());
+    check(LoadPhase != EVectorTileLoadingPhase::Loading);
+
+    FScopeLock Lock(&CriticalSection);
+    if (TileComponent.IsValid())
+        TileComponent->MarkAsGarbage();
+    TileComponent.Reset();
+    TileMaterialInstanceDynamic.Reset();
+    // テクスチャのGPUリソースは次回のGCで解放される
+    TileTexture.Reset();
+}
+
 void FPLATEAUAsyncLoadedVectorTile::ApplyVisibility() const {
-    if (!TileMaterialInstanceDynamicsMap.Contains(TileComponent))
-        return;
-    
-    const auto& MaterialInstanceDynamic = TileMaterialInstanceDynamicsMap[TileComponent];
-    if (MaterialInstanceDynamic == nullptr)
+    if (!TileMaterialInstanceDynamic.IsValid())
         return;
-    MaterialInstanceDynamic->SetScalarParameterValue(FName("Opacity"), bVisibility ? 1.0 : 0);
+    TileMaterialInstanceDynamic->SetScalarParameterValue(FName("Opacity"), bVisibility ? 1.0 : 0);
 }
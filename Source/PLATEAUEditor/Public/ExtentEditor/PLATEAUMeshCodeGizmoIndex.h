@@ -0,0 +1,36 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief メッシュコードギズモの範囲を格子状に分割して保持し、矩形と交差するギズモを検索します。
+ * 範囲選択画面の表示範囲によるカリングと、画面中心から近いギズモの検索に使用します。
+ */
+class PLATEAUEDITOR_API FPLATEAUMeshCodeGizmoIndex {
+public:
+    /**
+     * @brief インデックスを作成します。Boundsの要素番号が検索結果として返されます。
+     */
+    void Build(const TArray<FBox2D>& InBounds);
+
+    /**
+     * @brief Boxと交差する範囲を持つ要素番号を昇順で取得します。
+     */
+    void Query(const FBox2D& Box, TArray<int32>& OutIndices) const;
+
+    int32 Num() const {
+        return Bounds.Num();
+    }
+
+private:
+    TArray<FBox2D> Bounds;
+    TArray<TArray<int32>> Cells;
+    FVector2D Origin = FVector2D::ZeroVector;
+    FVector2D CellSize = FVector2D::UnitVector;
+    int32 NumCellX = 0;
+    int32 NumCellY = 0;
+
+    FIntPoint GetCell(const FVector2D& Position) const;
+};
@@ -0,0 +1,160 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "PLATEAUGeometry.h"
+#include "Tasks/Pipe.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/StrongObjectPtr.h"
+
+UENUM(BlueprintType)
+enum class EVectorTileLoadingPhase : uint8 {
+    Idle = 0,
+    Loading = 1,
+    FullyLoaded = 2,
+    Failed = 3
+};
+
+struct FPLATEAUExtent;
+
+// TODO: 名前空間
+struct TileCoordinate;
+
+struct FPLATEAUTileCoordinate {
+    int Column;
+    int Row;
+    int ZoomLevel;
+
+    static FPLATEAUTileCoordinate FromNativeData(const TileCoordinate& Data);
+    TileCoordinate ToNativeData() const;
+
+    bool operator==(const FPLATEAUTileCoordinate& Other) const;
+    bool operator!=(const FPLATEAUTileCoordinate& Other) const;
+};
+
+/**
+ * @brief タイルの読込設定です
+ */
+struct FPLATEAUBasemapSettings {
+    //タイル画像の保存先。空の場合は Content/PLATEAU/Basemap
+    FString TileDirectory;
+    //同時に読み込むタイルの数
+    int32 MaxConcurrentLoads = 4;
+    //保持するタイルの上限。超えた場合は画面外のタイルを最後に表示された順に破棄します
+    int32 MaxCachedTiles = 64;
+    //タイル画像が存在しない場合にダウンロードするか
+    bool bAllowDownload = true;
+};
+
+/**
+ * @brief 全タイルで共有するマテリアルとメッシュです
+ */
+struct FPLATEAUBasemapTileAssets {
+    TStrongObjectPtr<UMaterial> Material;
+    TStrongObjectPtr<UStaticMesh> PlaneMesh;
+};
+
+struct FPLATEAUAsyncLoadedVectorTile {
+public:
+    FPLATEAUAsyncLoadedVectorTile()
+        : bVisibility(false)
+        , LoadPhase(EVectorTileLoadingPhase::Idle)
+        , TileComponent(nullptr)
+        , LastVisibleUpdate(0) {
+    }
+
+    ~FPLATEAUAsyncLoadedVectorTile() {
+        if (LoadPhase == EVectorTileLoadingPhase::Loading)
+            Task.Wait();
+    }
+
+    EVectorTileLoadingPhase GetLoadPhase() {
+        return LoadPhase;
+    }
+
+    UStaticMeshComponent* GetComponent() {
+        FScopeLock Lock(&CriticalSection);
+        return TileComponent.Get();
+    }
+
+    /**
+     * @brief タイルの読込を開始します。SettingsとAssetsは読込完了まで破棄しないでください
+     */
+    void StartLoading(const FPLATEAUTileCoordinate& InTileCoordinate, const FPLATEAUBasemapSettings& Settings,
+                      const FPLATEAUBasemapTileAssets& Assets, UE::Tasks::FPipe& VectorTilePipe);
+    void SetVisibility(const bool InbVisibility);
+
+    /**
+     * @brief コンポーネントとテクスチャへの参照を解放します。ゲームスレッドで呼び出してください
+     */
+    void Release();
+
+    uint64 GetLastVisibleUpdate() const {
+        return LastVisibleUpdate;
+    }
+
+    void SetLastVisibleUpdate(const uint64 InLastVisibleUpdate) {
+        LastVisibleUpdate = InLastVisibleUpdate;
+    }
+
+private:
+    void CreateTileComponentInGameThread(UTexture* Texture, const FPLATEAUBasemapTileAssets& Assets);
+    void ApplyVisibility() const;
+    
+    bool bVisibility;
+    FCriticalSection CriticalSection;
+    TAtomic<EVectorTileLoadingPhase> LoadPhase;
+    TStrongObjectPtr<UStaticMeshComponent> TileComponent;
+    TStrongObjectPtr<UMaterialInstanceDynamic> TileMaterialInstanceDynamic;
+    TStrongObjectPtr<UTexture> TileTexture;
+    uint64 LastVisibleUpdate;
+    UE::Tasks::FTask Task;
+};
+
+uint32 GetTypeHash(const FPLATEAUTileCoordinate& Value);
+
+/**
+ * @brief 範囲選択画面の背景地図です。
+ * タイルは複数のパイプで並列に読み込み、画面外のタイルは上限を超えた分から破棄します。
+ */
+class PLATEAUEDITOR_API FPLATEAUBasemap {
+public:
+    FPLATEAUBasemap(const FPLATEAUGeoReference& InGeoReference, const TSharedPtr<class FPLATEAUExtentEditorViewportClient> InViewportClient,
+                    const FPLATEAUBasemapSettings& InSettings = FPLATEAUBasemapSettings());
+    ~FPLATEAUBasemap();
+
+    void UpdateAsync(const FPLATEAUExtent& InExtent, float DeltaSeconds);
+
+    /**
+     * @brief 表示するタイルを指定して更新します
+     */
+    void UpdateTiles(const TArray<FPLATEAUTileCoordinate>& VisibleTiles, float DeltaSeconds);
+
+    int32 GetNumCachedTiles() const {
+        return AsyncLoadedTiles.Num();
+    }
+
+    /**
+     * @brief 指定されたタイルの読込状態を取得します。保持していない場合はIdleを返します
+     */
+    EVectorTileLoadingPhase GetTileLoadPhase(const FPLATEAUTileCoordinate& TileCoordinate) const;
+
+private:
+    void EvictTiles();
+
+    float DeltaTime;
+    FPLATEAUGeoReference GeoReference;
+    TWeakPtr<FPLATEAUExtentEditorViewportClient> ViewportClient;
+    FPLATEAUBasemapSettings Settings;
+    FPLATEAUBasemapTileAssets TileAssets;
+    TArray<TUniquePtr<UE::Tasks::FPipe>> VectorTilePipes;
+    int32 NextPipeIndex;
+    uint64 UpdateCount;
+    TMap<FPLATEAUTileCoordinate, TSharedPtr<FPLATEAUAsyncLoadedVectorTile>> AsyncLoadedTiles;
+    TSet<UStaticMeshComponent*> TilesInScene;
+};
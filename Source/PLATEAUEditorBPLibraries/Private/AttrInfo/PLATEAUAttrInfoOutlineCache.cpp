@@ -0,0 +1,305 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "AttrInfo/PLATEAUAttrInfoOutlineCache.h"
+#include "MeshDescription.h"
+#include "Async/ParallelFor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "PhysicsEngine/BodySetup.h"
+
+
+namespace {
+    /**
+     * @brief 向きを問わないエッジのキー。頂点座標の辞書順で小さい方をFirstにします
+     */
+    TPair<FVector, FVector> MakeUndirectedEdgeKey(const FEdgeData& EdgeData) {
+        const auto& A = EdgeData.VertexPos0;
+        const auto& B = EdgeData.VertexPos1;
+        const bool bSwap = B.X < A.X || (B.X == A.X && (B.Y < A.Y || (B.Y == A.Y && B.Z < A.Z)));
+        return bSwap ? TPair<FVector, FVector>(B, A) : TPair<FVector, FVector>(A, B);
+    }
+
+    /**
+     * @brief 三角形のエッジから、奇数回出現するエッジ(外周)のみを残します。
+     * 出現順は元のエッジ配列と同じで、同じエッジが2回出現するごとに取り除かれます。
+     */
+    TArray<FEdgeData> GetDistinctEdges(const TArray<FEdgeData>& EdgeDataArray) {
+        TArray<FEdgeData> Edges;
+        TArray<bool> Alive;
+        TMap<TPair<FVector, FVector>, int32> AliveIndices;
+        Edges.Reserve(EdgeDataArray.Num());
+        Alive.Reserve(EdgeDataArray.Num());
+        AliveIndices.Reserve(EdgeDataArray.Num());
+        for (const auto& EdgeData : EdgeDataArray) {
+            const auto Key = MakeUndirectedEdgeKey(EdgeData);
+            if (int32 ExistingIndex; AliveIndices.RemoveAndCopyValue(Key, ExistingIndex)) {
+                Alive[ExistingIndex] = false;
+            } else {
+                AliveIndices.Add(Key, Edges.Num());
+                Edges.Add(EdgeData);
+                Alive.Add(true);
+            }
+        }
+
+        TArray<FEdgeData> DistinctEdges;
+        DistinctEdges.Reserve(AliveIndices.Num());
+        for (int32 i = 0; i < Edges.Num(); ++i) {
+            if (Alive[i])
+                DistinctEdges.Add(Edges[i]);
+        }
+        return DistinctEdges;
+    }
+
+    /**
+     * @brief エッジ同士を結ぶ順番に並べます。結び先がないエッジからは未使用の先頭エッジから再開します
+     */
+    TArray<FEdgeData> ChainEdges(const TArray<FEdgeData>& Edges) {
+        TMultiMap<FVector, int32> EdgesByStart;
+        for (int32 i = 0; i < Edges.Num(); ++i) {
+            EdgesByStart.Add(Edges[i].VertexPos0, i);
+        }
+
+        TArray<FEdgeData> Chained;
+        Chained.Reserve(Edges.Num());
+        TBitArray<> Used(false, Edges.Num());
+        for (int32 Start = 0; Start < Edges.Num(); ++Start) {
+            int32 Current = Start;
+            while (Current != INDEX_NONE && !Used[Current]) {
+                Used[Current] = true;
+                Chained.Add(Edges[Current]);
+
+                int32 Next = INDEX_NONE;
+                for (auto It = EdgesByStart.CreateConstKeyIterator(Edges[Current].VertexPos1); It; ++It) {
+                    if (!Used[It.Value()]) {
+                        Next = It.Value();
+                        break;
+                    }
+                }
+                Current = Next;
+            }
+        }
+        return Chained;
+    }
+
+    FPLATEAUAttrInfoBounds ComputeBoundsFromPositions(const TArray<FVector>& Positions) {
+        FPLATEAUAttrInfoBounds Bounds;
+        if (Positions.Num() <= 0)
+            return Bounds;
+
+        TArray<FVector> FlattenPositions;
+        FlattenPositions.Reserve(Positions.Num());
+        double MinZ = Positions[0].Z;
+        double MaxZ = Positions[0].Z;
+        for (const auto& Position : Positions) {
+            FlattenPositions.Emplace(Position.X, Position.Y, 0);
+            MinZ = FMath::Min(MinZ, Position.Z);
+            MaxZ = FMath::Max(MaxZ, Position.Z);
+        }
+        // WorldContextObjectはデバッグ描画にのみ使用されるため、ワーカースレッドからnullptrで呼び出せます
+        UKismetMathLibrary::MinAreaRectangle(nullptr, FlattenPositions, FVector(0, 0, 1), Bounds.RectCenter, Bounds.RectRotation, Bounds.RectLengthX, Bounds.RectLengthY);
+        Bounds.MinZ = MinZ;
+        Bounds.MaxZ = MaxZ;
+        return Bounds;
+    }
+}
+
+FPLATEAUAttrInfoMeshData FPLATEAUAttrInfoMeshData::Gather(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex, const int32 UVChannel) {
+    check(IsInGameThread());
+
+    FPLATEAUAttrInfoMeshData MeshData;
+    if (StaticMeshComponent == nullptr || StaticMeshComponent->GetStaticMesh() == nullptr)
+        return MeshData;
+
+    const auto& StaticMesh = StaticMeshComponent->GetStaticMesh();
+    MeshData.PolygonVertices = FPLATEAUAttrInfoComponentCache::CollectPolygonVertices(StaticMesh->GetMeshDescription(LodIndex));
+
+    const auto& BodySetup = StaticMeshComponent->GetBodySetup();
+    if (BodySetup == nullptr)
+        return MeshData;
+
+    const auto& [IndexBuffer, VertPositions, VertUVs] = BodySetup->UVInfo;
+    if (!VertUVs.IsValidIndex(UVChannel))
+        return MeshData;
+
+    MeshData.IndexBuffer = IndexBuffer;
+    MeshData.VertPositions = VertPositions;
+    MeshData.VertUVs = VertUVs[UVChannel];
+    // コリジョンのUV情報はLOD0から作成されます
+    MeshData.NumTriangles = FMath::Min(StaticMesh->GetNumTriangles(0), IndexBuffer.Num() / 3);
+    return MeshData;
+}
+
+TSharedRef<FPLATEAUAttrInfoComponentCache> FPLATEAUAttrInfoComponentCache::Build(const FPLATEAUAttrInfoMeshData& MeshData) {
+    const auto Cache = MakeShared<FPLATEAUAttrInfoComponentCache>();
+    Cache->MeshBounds = ComputeBounds(MeshData.PolygonVertices);
+
+    // 同じ頂点ID、同じ座標は追加しない
+    TSet<FVertexID> VertexIDs;
+    TSet<FVector> VertexPositions;
+    for (const auto& VertexData : MeshData.PolygonVertices) {
+        if (VertexIDs.Contains(VertexData.VertexID) || VertexPositions.Contains(VertexData.VertexPos))
+            continue;
+        VertexIDs.Add(VertexData.VertexID);
+        VertexPositions.Add(VertexData.VertexPos);
+        Cache->PerimeterVertices.Add(VertexData);
+    }
+    Cache->PerimeterVertices.Sort([](const FVertexData& A, const FVertexData& B) { return A.VertexID < B.VertexID; });
+
+    // UVごとに三角形のエッジを振り分け
+    TMap<FIntPoint, int32> GroupIndices;
+    TArray<TArray<FEdgeData>> EdgeGroups;
+    TArray<TArray<FVector>> PositionGroups;
+    const auto& IndexBuffer = MeshData.IndexBuffer;
+    const auto& VertPositions = MeshData.VertPositions;
+    const auto& VertUVs = MeshData.VertUVs;
+    for (int32 FaceIndex = 0; FaceIndex < MeshData.NumTriangles; ++FaceIndex) {
+        const int32 Index0 = IndexBuffer[FaceIndex * 3 + 0];
+        const int32 Index1 = IndexBuffer[FaceIndex * 3 + 1];
+        const int32 Index2 = IndexBuffer[FaceIndex * 3 + 2];
+        if (!VertPositions.IsValidIndex(Index0) || !VertPositions.IsValidIndex(Index1) || !VertPositions.IsValidIndex(Index2) ||
+            !VertUVs.IsValidIndex(Index0) || !VertUVs.IsValidIndex(Index1) || !VertUVs.IsValidIndex(Index2))
+            continue;
+
+        const FVector& Pos0 = VertPositions[Index0];
+        const FVector& Pos1 = VertPositions[Index1];
+        const FVector& Pos2 = VertPositions[Index2];
+
+        // 第一引数に自身の頂点を与えることで必ず同じBaryCoordsが得られるようにしている（FaceIndexによってのみUVが変化する）
+        const FVector BaryCoords = FMath::ComputeBaryCentric2D(Pos0, Pos0, Pos1, Pos2);
+        const auto& TargetUV = BaryCoords.X * VertUVs[Index0] + BaryCoords.Y * VertUVs[Index1] + BaryCoords.Z * VertUVs[Index2];
+        const FIntPoint Key(static_cast<int32>(TargetUV.X), static_cast<int32>(TargetUV.Y));
+
+        int32 GroupIndex;
+        if (const auto Found = GroupIndices.Find(Key)) {
+            GroupIndex = *Found;
+        } else {
+            GroupIndex = EdgeGroups.AddDefaulted();
+            PositionGroups.AddDefaulted();
+            GroupIndices.Add(Key, GroupIndex);
+        }
+        EdgeGroups[GroupIndex].Emplace(Pos0, Pos1);
+        EdgeGroups[GroupIndex].Emplace(Pos1, Pos2);
+        EdgeGroups[GroupIndex].Emplace(Pos2, Pos0);
+        PositionGroups[GroupIndex].Append({ Pos0, Pos1, Pos2 });
+    }
+
+    TArray<FPLATEAUAttrInfoOutline> Outlines;
+    Outlines.SetNum(EdgeGroups.Num());
+    ParallelFor(EdgeGroups.Num(), [&](const int32 GroupIndex) {
+        Outlines[GroupIndex].PerimeterEdges = ChainEdges(GetDistinctEdges(EdgeGroups[GroupIndex]));
+        Outlines[GroupIndex].Bounds = ComputeBoundsFromPositions(PositionGroups[GroupIndex]);
+    }, EParallelForFlags::Unbalanced);
+
+    Cache->Outlines.Reserve(GroupIndices.Num());
+    for (const auto& [Key, GroupIndex] : GroupIndices) {
+        Cache->Outlines.Add(Key, MoveTemp(Outlines[GroupIndex]));
+    }
+    return Cache;
+}
+
+TArray<FVertexData> FPLATEAUAttrInfoComponentCache::CollectPolygonVertices(const FMeshDescription* MeshDescription) {
+    TArray<FVertexData> VectorMapArray;
+    if (MeshDescription == nullptr)
+        return VectorMapArray;
+
+    const auto PolygonCount = MeshDescription->Polygons().Num();
+    for (int32 i = 0; i < PolygonCount; i++) {
+        const auto& EdgeIdArray = MeshDescription->GetPolygonPerimeterEdges(i);
+        for (const auto& EdgeId : EdgeIdArray) {
+            // エッジの頂点は必ず２つある
+            for (int32 j = 0; j < 2; j++) {
+                const auto& VertexId = MeshDescription->GetEdgeVertex(EdgeId, j);
+                VectorMapArray.Emplace(FVertexData(VertexId, FVector(MeshDescription->GetVertexPosition(VertexId))));
+            }
+        }
+    }
+    return VectorMapArray;
+}
+
+FPLATEAUAttrInfoBounds FPLATEAUAttrInfoComponentCache::ComputeBounds(const TArray<FVertexData>& Vertices) {
+    TArray<FVector> Positions;
+    Positions.Reserve(Vertices.Num());
+    for (const auto& Vertex : Vertices) {
+        Positions.Add(Vertex.VertexPos);
+    }
+    return ComputeBoundsFromPositions(Positions);
+}
+
+FPLATEAUAttrInfoOutlineCache& FPLATEAUAttrInfoOutlineCache::Get() {
+    static FPLATEAUAttrInfoOutlineCache Instance;
+    return Instance;
+}
+
+void FPLATEAUAttrInfoOutlineCache::Prefetch(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex) {
+    FindOrAddEntry(StaticMeshComponent, LodIndex);
+}
+
+TSharedPtr<const FPLATEAUAttrInfoComponentCache> FPLATEAUAttrInfoOutlineCache::FindOrBuild(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex) {
+    const auto Entry = FindOrAddEntry(StaticMeshComponent, LodIndex);
+    if (Entry == nullptr)
+        return nullptr;
+
+    Entry->Task.Wait();
+    return Entry->Task.GetResult();
+}
+
+void FPLATEAUAttrInfoOutlineCache::Clear() {
+    check(IsInGameThread());
+    for (auto& [Key, Entry] : Entries) {
+        Entry.Task.Wait();
+    }
+    Entries.Empty();
+}
+
+FPLATEAUAttrInfoOutlineCache::FEntry* FPLATEAUAttrInfoOutlineCache::FindOrAddEntry(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex) {
+    check(IsInGameThread());
+    if (StaticMeshComponent == nullptr || StaticMeshComponent->GetStaticMesh() == nullptr)
+        return nullptr;
+
+    const TPair<TObjectKey<UStaticMeshComponent>, int32> Key(StaticMeshComponent, LodIndex);
+    if (const auto Entry = Entries.Find(Key)) {
+        // メッシュが差し替えや再ビルドされていなければそのまま使用
+        if (IsUpToDate(*Entry, StaticMeshComponent->GetStaticMesh()))
+            return Entry;
+        Entry->Task.Wait();
+        Entries.Remove(Key);
+    }
+
+    // 破棄されたコンポーネントのキャッシュを削除
+    for (auto It = Entries.CreateIterator(); It; ++It) {
+        if (It->Key.Key.ResolveObjectPtr() == nullptr && It->Value.Task.IsCompleted())
+            It.RemoveCurrent();
+    }
+
+    const auto StaticMesh = StaticMeshComponent->GetStaticMesh();
+    FEntry NewEntry;
+    NewEntry.StaticMesh = StaticMesh;
+    NewEntry.RenderData = StaticMesh->GetRenderData();
+#if WITH_EDITORONLY_DATA
+    if (NewEntry.RenderData != nullptr)
+        NewEntry.DerivedDataKey = NewEntry.RenderData->DerivedDataKey;
+#endif
+    NewEntry.Task = UE::Tasks::Launch(TEXT("PLATEAUAttrInfoOutlineCache"),
+        [MeshData = FPLATEAUAttrInfoMeshData::Gather(StaticMeshComponent, LodIndex)] {
+            return FPLATEAUAttrInfoComponentCache::Build(MeshData);
+        });
+    return &Entries.Add(Key, MoveTemp(NewEntry));
+}
+
+bool FPLATEAUAttrInfoOutlineCache::IsUpToDate(const FEntry& Entry, const UStaticMesh* StaticMesh) {
+    if (Entry.StaticMesh.Get() != StaticMesh)
+        return false;
+
+    // 高さ合わせやアトラス化ではStaticMeshを差し替えずに再ビルドするため、描画データも比較する
+    const auto RenderData = StaticMesh->GetRenderData();
+    if (Entry.RenderData != RenderData)
+        return false;
+#if WITH_EDITORONLY_DATA
+    // 解放された描画データと同じアドレスが再利用される場合があるため、派生データのキーも比較する
+    if (RenderData != nullptr && Entry.DerivedDataKey != RenderData->DerivedDataKey)
+        return false;
+#endif
+    return true;
+}
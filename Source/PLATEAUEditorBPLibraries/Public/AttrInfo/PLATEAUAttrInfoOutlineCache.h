@@ -0,0 +1,116 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectKey.h"
+#include "AttrInfo/PLATEAUAttrInfoDrawGizmo.h"
+
+class UStaticMesh;
+class UStaticMeshComponent;
+class FStaticMeshRenderData;
+struct FMeshDescription;
+
+/**
+ * @brief 平面上の最小面積矩形とZ範囲です
+ */
+struct FPLATEAUAttrInfoBounds {
+    FVector RectCenter = FVector::ZeroVector;
+    FRotator RectRotation = FRotator::ZeroRotator;
+    float RectLengthX = 0;
+    float RectLengthY = 0;
+    int32 MinZ = 0;
+    int32 MaxZ = 0;
+};
+
+/**
+ * @brief 地物1つ分(UV4の値が同じ三角形群)の外形線とバウンディング情報です
+ */
+struct FPLATEAUAttrInfoOutline {
+    //外形線。エッジ同士が結ばれる順に並んでいます
+    TArray<FEdgeData> PerimeterEdges;
+    FPLATEAUAttrInfoBounds Bounds;
+};
+
+/**
+ * @brief キャッシュ作成に必要なメッシュ情報です。ゲームスレッドで収集し、キャッシュの作成はワーカースレッドで行います
+ */
+struct PLATEAUEDITORBPLIBRARIES_API FPLATEAUAttrInfoMeshData {
+    //MeshDescriptionのポリゴンのエッジ順に並べた頂点
+    TArray<FVertexData> PolygonVertices;
+
+    //コリジョンのUV情報 (BodySetup->UVInfo)
+    TArray<int32> IndexBuffer;
+    TArray<FVector> VertPositions;
+    TArray<FVector2D> VertUVs;
+    int32 NumTriangles = 0;
+
+    static FPLATEAUAttrInfoMeshData Gather(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex, const int32 UVChannel = 3);
+};
+
+/**
+ * @brief コンポーネント1つ分の属性情報表示用データです
+ */
+struct PLATEAUEDITORBPLIBRARIES_API FPLATEAUAttrInfoComponentCache {
+    //メッシュ全体のバウンディング情報
+    FPLATEAUAttrInfoBounds MeshBounds;
+    //メッシュの重複のない頂点 (頂点IDでソート済み)
+    TArray<FVertexData> PerimeterVertices;
+    //UV4の値(整数部)ごとの地物の外形線
+    TMap<FIntPoint, FPLATEAUAttrInfoOutline> Outlines;
+
+    const FPLATEAUAttrInfoOutline* FindOutline(const FVector2D& UV) const {
+        return Outlines.Find(FIntPoint(static_cast<int32>(UV.X), static_cast<int32>(UV.Y)));
+    }
+
+    static TSharedRef<FPLATEAUAttrInfoComponentCache> Build(const FPLATEAUAttrInfoMeshData& MeshData);
+
+    /**
+     * @brief MeshDescriptionのポリゴンのエッジ順に頂点を取得します(重複あり)
+     */
+    static TArray<FVertexData> CollectPolygonVertices(const FMeshDescription* MeshDescription);
+
+    /**
+     * @brief 頂点を平面に投影した最小面積矩形と、Z範囲を求めます
+     */
+    static FPLATEAUAttrInfoBounds ComputeBounds(const TArray<FVertexData>& Vertices);
+};
+
+/**
+ * @brief UPLATEAUAttrInfoDrawGizmo用に、コンポーネントごとの外形線を保持するキャッシュです。
+ * 初回アクセス時にワーカースレッドで作成し、以降のクリックでは検索のみで描画できるようにします。
+ * ゲームスレッドからのみ使用してください。
+ */
+class PLATEAUEDITORBPLIBRARIES_API FPLATEAUAttrInfoOutlineCache {
+public:
+    static FPLATEAUAttrInfoOutlineCache& Get();
+
+    /**
+     * @brief キャッシュがなければバックグラウンドで作成を開始します。完了は待ちません
+     */
+    void Prefetch(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex);
+
+    /**
+     * @brief キャッシュを取得します。作成中の場合は完了まで待機します
+     */
+    TSharedPtr<const FPLATEAUAttrInfoComponentCache> FindOrBuild(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex);
+
+    void Clear();
+
+private:
+    struct FEntry {
+        TWeakObjectPtr<UStaticMesh> StaticMesh;
+        //作成時の描画データ。同じStaticMeshのまま再ビルドされた場合の判定に使用
+        const FStaticMeshRenderData* RenderData = nullptr;
+#if WITH_EDITORONLY_DATA
+        FString DerivedDataKey;
+#endif
+        UE::Tasks::TTask<TSharedRef<FPLATEAUAttrInfoComponentCache>> Task;
+    };
+
+    FEntry* FindOrAddEntry(const UStaticMeshComponent* StaticMeshComponent, const int32 LodIndex);
+    static bool IsUpToDate(const FEntry& Entry, const UStaticMesh* StaticMesh);
+
+    TMap<TPair<TObjectKey<UStaticMeshComponent>, int32>, FEntry> Entries;
+};
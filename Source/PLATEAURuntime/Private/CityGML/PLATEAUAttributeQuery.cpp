@@ -0,0 +1,115 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "CityGML/PLATEAUAttributeQuery.h"
+#include "CityGML/PLATEAUCityObject.h"
+#include <limits>
+
+namespace {
+    //数値型でない場合はNaNを返します
+    double GetNumericValue(const FPLATEAUAttributeValue& Value) {
+        switch (Value.Type) {
+        case EPLATEAUAttributeType::Double:
+        case EPLATEAUAttributeType::Measure:
+            return Value.DoubleValue;
+        case EPLATEAUAttributeType::Integer:
+        case EPLATEAUAttributeType::Boolean:
+            return Value.IntValue;
+        default:
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+}
+
+FPLATEAUAttributeQuery::FPLATEAUAttributeQuery(const FString& Key) {
+    // GetAttributesByKeyと同じく空の要素も残して分割する
+    TArray<FString> Keys;
+    Key.ParseIntoArray(Keys, TEXT("/"), false);
+    Segments.Reserve(Keys.Num());
+    for (auto& SegmentKey : Keys) {
+        const uint32 Hash = GetTypeHash(SegmentKey);
+        Segments.Add({ MoveTemp(SegmentKey), Hash });
+    }
+    EmptySegment = { FString(), GetTypeHash(FString()) };
+}
+
+const FPLATEAUAttributeValue* FPLATEAUAttributeQuery::Find(const FPLATEAUAttributeMap& AttributeMap) const {
+    const FPLATEAUAttributeMap* CurrentMap = &AttributeMap;
+    for (int32 Depth = 0; ; ++Depth) {
+        const FSegment& Segment = Depth < Segments.Num() ? Segments[Depth] : EmptySegment;
+        const FPLATEAUAttributeValue* Value = CurrentMap->AttributeMap.FindByHash(Segment.Hash, Segment.Key);
+        if (Value == nullptr)
+            return nullptr;
+        if (Value->Type != EPLATEAUAttributeType::AttributeSets)
+            return Value;
+        if (!Value->Attributes.IsValid())
+            return nullptr;
+        CurrentMap = Value->Attributes.Get();
+    }
+}
+
+void FPLATEAUAttributeQuery::FindInRootAndChildren(TArrayView<const FPLATEAUCityObject> CityObjects, TArray<const FPLATEAUAttributeValue*>& OutValues) const {
+    int32 Count = CityObjects.Num();
+    for (const auto& CityObject : CityObjects)
+        Count += CityObject.Children.Num();
+    OutValues.Reserve(OutValues.Num() + Count);
+
+    for (const auto& CityObject : CityObjects) {
+        OutValues.Add(Find(CityObject.Attributes));
+        for (const auto& Child : CityObject.Children)
+            OutValues.Add(Find(Child.Attributes));
+    }
+}
+
+FPLATEAUAttributePredicate FPLATEAUAttributePredicate::Equal(const FString& Value) {
+    FPLATEAUAttributePredicate Predicate;
+    Predicate.Operator = EOperator::Equal;
+    Predicate.StringValue = Value;
+    return Predicate;
+}
+
+FPLATEAUAttributePredicate FPLATEAUAttributePredicate::InRange(const double Min, const double Max) {
+    FPLATEAUAttributePredicate Predicate;
+    Predicate.Operator = EOperator::InRange;
+    Predicate.Min = Min;
+    Predicate.Max = Max;
+    return Predicate;
+}
+
+bool FPLATEAUAttributePredicate::Evaluate(const FPLATEAUAttributeValue* Value) const {
+    if (Value == nullptr)
+        return false;
+    if (Operator == EOperator::Equal)
+        return Value->StringValue.Equals(StringValue, ESearchCase::CaseSensitive);
+    const double Numeric = GetNumericValue(*Value);
+    return Min <= Numeric && Numeric <= Max;
+}
+
+void FPLATEAUAttributePredicate::EvaluateBatch(TArrayView<const FPLATEAUAttributeValue* const> Values, TBitArray<>& OutResults) const {
+    OutResults.Init(false, Values.Num());
+    if (Operator == EOperator::Equal) {
+        for (int32 i = 0; i < Values.Num(); ++i) {
+            const auto Value = Values[i];
+            if (Value != nullptr && Value->StringValue.Equals(StringValue, ESearchCase::CaseSensitive))
+                OutResults[i] = true;
+        }
+        return;
+    }
+
+    // 数値を連続した配列に取り出してから比較し、比較ループを分岐なしにする
+    TArray<double> Numerics;
+    Numerics.SetNumUninitialized(Values.Num());
+    for (int32 i = 0; i < Values.Num(); ++i)
+        Numerics[i] = Values[i] != nullptr ? GetNumericValue(*Values[i]) : std::numeric_limits<double>::quiet_NaN();
+
+    TArray<uint8> Matches;
+    Matches.SetNumUninitialized(Values.Num());
+    const double* NumericData = Numerics.GetData();
+    uint8* MatchData = Matches.GetData();
+    for (int32 i = 0; i < Values.Num(); ++i)
+        MatchData[i] = static_cast<uint8>((Min <= NumericData[i]) & (NumericData[i] <= Max));
+
+    for (int32 i = 0; i < Values.Num(); ++i) {
+        if (MatchData[i])
+            OutResults[i] = true;
+    }
+}
@@ -1,6 +1,7 @@
 // Copyright © 2023 Ministry of Land, Infrastructure and Transport
 #include "CityGML/PLATEAUAttributeValue.h"
 #include "Component/PLATEAUCityObjectGroup.h"
+#include "CityGML/PLATEAUAttributeQuery.h"
 
 namespace {
     constexpr TCHAR EPLATEAUAttributeTypePath[] = TEXT("/Script/PLATEAURuntime.EPLATEAUAttributeType");
@@ -125,22 +126,9 @@ FPLATEAUAttributeMap UPLATEAUAttributeValueBlueprintLibrary::GetAttributes(const
 }
 
 TArray<FPLATEAUAttributeValue> UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey(UPARAM(ref) const FString& Key, UPARAM(ref) const FPLATEAUAttributeMap& AttributeMap) {
-    TArray<FString> Keys;
-    int32 Length = Key.ParseIntoArray(Keys, TEXT("/"), false);
-    FString FirstKey = Length > 0 ? Keys[0] : "";
     TArray<FPLATEAUAttributeValue> Values;
-    if (AttributeMap.AttributeMap.Contains(FirstKey)) {
-        const auto& attr = AttributeMap.AttributeMap[FirstKey];
-        if (attr.Type != EPLATEAUAttributeType::AttributeSets) {
-            Values.Add(attr);
-        }
-        else {
-            Keys.RemoveSingle(FirstKey);
-            FString NewKey = FString::Join<TArray<FString>>(Keys, TEXT("/"));
-            const auto& ChildAttr = attr.Attributes.Get();
-            return GetAttributesByKey(NewKey, *ChildAttr);
-        }
-    }
+    if (const auto Value = FPLATEAUAttributeQuery(Key).Find(AttributeMap))
+        Values.Add(*Value);
     return Values;
 }
 
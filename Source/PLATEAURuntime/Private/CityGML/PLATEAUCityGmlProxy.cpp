@@ -5,10 +5,119 @@
 
 #include <citygml/citygml.h>
 #include <Misc/Paths.h>
+#include "HAL/FileManager.h"
+#include <atomic>
 
 #include "Async/Async.h"
 
-TMap<FString, FPLATEAUCityModel> UPLATEAUCityGmlProxy::CityModelCache;
+namespace {
+    // 既定のインデックスキャッシュ上限
+    constexpr int64 DefaultCacheBudgetBytes = 256 * 1024 * 1024;
+
+    struct FCityGmlCacheEntry {
+        FDateTime ModificationTime;
+        int64 FileSize = 0;
+        TSharedPtr<const FPLATEAUCityModelIndex> Index;
+        // CityModelは呼び出し側が保持している間のみ再利用する
+        std::weak_ptr<const citygml::CityModel> CityModel;
+        uint64 LastAccess = 0;
+    };
+
+    /**
+     * @brief GMLのパスをキーとし、更新日時とファイルサイズで無効化されるLRUキャッシュ
+     */
+    class FCityGmlCache {
+    public:
+        FCityGmlCacheEntry* Find(const FString& Path, const FFileStatData& StatData) {
+            const auto Entry = Entries.Find(Path);
+            if (Entry == nullptr)
+                return nullptr;
+
+            if (Entry->ModificationTime != StatData.ModificationTime || Entry->FileSize != StatData.FileSize) {
+                Remove(Path);
+                return nullptr;
+            }
+
+            Entry->LastAccess = ++AccessCounter;
+            return Entry;
+        }
+
+        FCityGmlCacheEntry& Add(const FString& Path, const FFileStatData& StatData, const TSharedPtr<const FPLATEAUCityModelIndex>& Index) {
+            Remove(Path);
+            auto& Entry = Entries.Add(Path);
+            Entry.ModificationTime = StatData.ModificationTime;
+            Entry.FileSize = StatData.FileSize;
+            Entry.Index = Index;
+            Entry.LastAccess = ++AccessCounter;
+            AllocatedSize += Index->GetAllocatedSize();
+            Evict(Path);
+            return Entries[Path];
+        }
+
+        void SetBudget(const int64 InBudgetBytes) {
+            BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+            Evict(FString());
+        }
+
+        void Reset() {
+            Entries.Reset();
+            AllocatedSize = 0;
+        }
+
+        int64 GetAllocatedSize() const {
+            return AllocatedSize;
+        }
+
+    private:
+        void Remove(const FString& Path) {
+            if (const auto Entry = Entries.Find(Path)) {
+                AllocatedSize -= Entry->Index->GetAllocatedSize();
+                Entries.Remove(Path);
+            }
+        }
+
+        // 上限を超えている間、最も古くアクセスされたエントリを破棄する。直前に追加したエントリは残す
+        void Evict(const FString& KeepPath) {
+            while (BudgetBytes < AllocatedSize && 1 < Entries.Num()) {
+                const FString* OldestPath = nullptr;
+                uint64 OldestAccess = TNumericLimits<uint64>::Max();
+                for (const auto& [Path, Entry] : Entries) {
+                    if (Path != KeepPath && Entry.LastAccess < OldestAccess) {
+                        OldestAccess = Entry.LastAccess;
+                        OldestPath = &Path;
+                    }
+                }
+                if (OldestPath == nullptr)
+                    break;
+                Remove(FString(*OldestPath));
+            }
+        }
+
+        TMap<FString, FCityGmlCacheEntry> Entries;
+        int64 AllocatedSize = 0;
+        int64 BudgetBytes = DefaultCacheBudgetBytes;
+        uint64 AccessCounter = 0;
+    };
+
+    FCityGmlCache CityGmlCache;
+    FCriticalSection CityGmlCacheSection;
+    std::atomic<int32> ParseCount = 0;
+
+    // 属性情報のみを読み込む。パースはロック外で行う
+    std::shared_ptr<const citygml::CityModel> ParseCityModel(const FString& FullGmlPath) {
+        citygml::ParserParams params;
+        params.tesselate = false;
+        params.ignoreGeometries = true;
+
+        ++ParseCount;
+        try {
+            return citygml::load(TCHAR_TO_UTF8(*FullGmlPath), params);
+        }
+        catch (...) {
+            return nullptr;
+        }
+    }
+}
 
 void UPLATEAUCityGmlProxy::Activate() {
     static FCriticalSection CriticalSection;
@@ -36,13 +145,67 @@ UPLATEAUCityGmlProxy* UPLATEAUCityGmlProxy::LoadAsync(UObject* WorldContextObjec
 }
 
 std::shared_ptr<const citygml::CityModel> UPLATEAUCityGmlProxy::Load(const FPLATEAUCityObjectInfo& GmlInfo) {
-    if (CityModelCache.Find(GmlInfo.GmlName))
-        return CityModelCache[GmlInfo.GmlName].GetData();
+    const auto FullGmlPath = GetFullGmlPath(GmlInfo);
+    const auto StatData = IFileManager::Get().GetStatData(*FullGmlPath);
+    if (!StatData.bIsValid)
+        return nullptr;
+
+    {
+        FScopeLock Lock(&CityGmlCacheSection);
+        if (const auto Entry = CityGmlCache.Find(FullGmlPath, StatData)) {
+            if (auto CityModel = Entry->CityModel.lock())
+                return CityModel;
+        }
+    }
 
-    citygml::ParserParams params;
-    params.tesselate = false;
-    params.ignoreGeometries = true;
+    const auto CityModelData = ParseCityModel(FullGmlPath);
+    if (CityModelData == nullptr)
+        return nullptr;
 
+    AddToCache(FullGmlPath, StatData, CityModelData);
+    return CityModelData;
+}
+
+TSharedPtr<const FPLATEAUCityModelIndex> UPLATEAUCityGmlProxy::LoadIndex(const FPLATEAUCityObjectInfo& GmlInfo) {
+    const auto FullGmlPath = GetFullGmlPath(GmlInfo);
+    const auto StatData = IFileManager::Get().GetStatData(*FullGmlPath);
+    if (!StatData.bIsValid)
+        return nullptr;
+
+    // GMLが変更されていなければインデックスのみで足りるためパースしない
+    {
+        FScopeLock Lock(&CityGmlCacheSection);
+        if (const auto Entry = CityGmlCache.Find(FullGmlPath, StatData))
+            return Entry->Index;
+    }
+
+    const auto CityModelData = ParseCityModel(FullGmlPath);
+    if (CityModelData == nullptr)
+        return nullptr;
+
+    return AddToCache(FullGmlPath, StatData, CityModelData);
+}
+
+void UPLATEAUCityGmlProxy::SetCacheBudget(const int64 BudgetBytes) {
+    FScopeLock Lock(&CityGmlCacheSection);
+    CityGmlCache.SetBudget(BudgetBytes);
+}
+
+void UPLATEAUCityGmlProxy::ClearCache() {
+    FScopeLock Lock(&CityGmlCacheSection);
+    CityGmlCache.Reset();
+}
+
+int64 UPLATEAUCityGmlProxy::GetCacheAllocatedSize() {
+    FScopeLock Lock(&CityGmlCacheSection);
+    return CityGmlCache.GetAllocatedSize();
+}
+
+int32 UPLATEAUCityGmlProxy::GetParseCount() {
+    return ParseCount;
+}
+
+FString UPLATEAUCityGmlProxy::GetFullGmlPath(const FPLATEAUCityObjectInfo& GmlInfo) {
     FString SubFolderName;
     int Index = 0;
     if (GmlInfo.GmlName.FindChar('_', Index))
@@ -50,24 +213,31 @@ std::shared_ptr<const citygml::CityModel> UPLATEAUCityGmlProxy::Load(const FPLAT
     if (SubFolderName.FindChar('_', Index))
         SubFolderName = SubFolderName.LeftChop(SubFolderName.Len() - Index);
 
-    const auto FullGmlPath =
-        FPaths::ProjectContentDir() +
+    return FPaths::ProjectContentDir() +
         "PLATEAU/Datasets/" +
         GmlInfo.DatasetName +
         "/udx/" +
         SubFolderName + "/" +
         GmlInfo.GmlName;
-    std::shared_ptr<const citygml::CityModel> CityModelData;
-    try {
-        CityModelData = citygml::load(TCHAR_TO_UTF8(*FullGmlPath), params);
-    }
-    catch (...) {
-    }
+}
 
-    if (CityModelData == nullptr) {
-        return nullptr;
+TSharedPtr<const FPLATEAUCityModelIndex> UPLATEAUCityGmlProxy::AddToCache(const FString& FullGmlPath, const FFileStatData& StatData, const std::shared_ptr<const citygml::CityModel>& CityModelData) {
+    {
+        // 別スレッドで先に登録されている場合はそのインデックスを使う
+        FScopeLock Lock(&CityGmlCacheSection);
+        if (const auto Entry = CityGmlCache.Find(FullGmlPath, StatData)) {
+            Entry->CityModel = CityModelData;
+            return Entry->Index;
+        }
     }
 
-    CityModelCache.Add(GmlInfo.GmlName, FPLATEAUCityModel(CityModelData));
-    return CityModelCache[GmlInfo.GmlName].GetData();
+    // インデックスの作成はロック外で行う
+    const auto Index = MakeShared<const FPLATEAUCityModelIndex>(*CityModelData);
+
+    FScopeLock Lock(&CityGmlCacheSection);
+    auto Entry = CityGmlCache.Find(FullGmlPath, StatData);
+    if (Entry == nullptr)
+        Entry = &CityGmlCache.Add(FullGmlPath, StatData, Index);
+    Entry->CityModel = CityModelData;
+    return Entry->Index;
 }
@@ -0,0 +1,42 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "CityGML/PLATEAUCityModelIndex.h"
+#include <citygml/citymodel.h>
+
+namespace {
+    SIZE_T GetAttributeMapAllocatedSize(const FPLATEAUAttributeMap& AttributeMap) {
+        SIZE_T Size = AttributeMap.AttributeMap.GetAllocatedSize();
+        for (const auto& [Key, Value] : AttributeMap.AttributeMap) {
+            Size += Key.GetAllocatedSize() + Value.StringValue.GetAllocatedSize();
+            if (Value.Attributes.IsValid()) {
+                Size += sizeof(FPLATEAUAttributeMap) + GetAttributeMapAllocatedSize(*Value.Attributes);
+            }
+        }
+        return Size;
+    }
+}
+
+FPLATEAUCityModelIndex::FPLATEAUCityModelIndex(const citygml::CityModel& CityModel) {
+    for (const auto& RootCityObject : CityModel.getRootCityObjects()) {
+        AddRecursive(*RootCityObject);
+    }
+    AllocatedSize += Entries.GetAllocatedSize();
+}
+
+void FPLATEAUCityModelIndex::AddRecursive(const citygml::CityObject& CityObject) {
+    const FString GmlID = UTF8_TO_TCHAR(CityObject.getId().c_str());
+    if (!Entries.Contains(GmlID)) {
+        auto& Entry = Entries.Add(GmlID);
+        Entry.Type = CityObject.getType();
+        for (const auto& [Key, Value] : CityObject.getAttributes()) {
+            FPLATEAUAttributeValue AttributeValue;
+            AttributeValue.SetAttributeValue(Value);
+            Entry.Attributes.AttributeMap.Add(UTF8_TO_TCHAR(Key.c_str()), AttributeValue);
+        }
+        AllocatedSize += GmlID.GetAllocatedSize() + GetAttributeMapAllocatedSize(Entry.Attributes);
+    }
+
+    for (unsigned int i = 0; i < CityObject.getChildCityObjectsCount(); ++i) {
+        AddRecursive(CityObject.getChildCityObject(i));
+    }
+}
@@ -0,0 +1,537 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "Component/PLATEAUCityModelStreamingComponent.h"
+
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "Component/PLATEAUSceneComponent.h"
+#include "PLATEAUCityModelLoader.h"
+#include "PLATEAUExtractedModelCache.h"
+#include "PLATEAUImportSettings.h"
+#include "PLATEAUMeshLoader.h"
+#include "PLATEAUTextureLoader.h"
+#include "StaticMeshResources.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include <plateau/dataset/dataset_source.h>
+#include <plateau/dataset/mesh_code.h>
+
+
+/**
+ * @brief 読み込んだテクスチャ・メッシュをアセットとして保存せず、テクスチャをタイル間で共有するMeshLoaderです。
+ */
+class FPLATEAUMeshLoaderForStreaming : public FPLATEAUMeshLoader {
+public:
+    FPLATEAUMeshLoaderForStreaming(const TWeakObjectPtr<UPLATEAUCityModelStreamingComponent>& InStreamingComponent,
+        const TWeakObjectPtr<AActor>& InOwner,
+        const TSharedRef<UPLATEAUCityModelStreamingComponent::FLoadResult>& InResult)
+        : FPLATEAUMeshLoader(false)
+        , StreamingComponent(InStreamingComponent)
+        , Owner(InOwner)
+        , Result(InResult) {
+    }
+
+protected:
+    UTexture2D* LoadTexture(const FString& TexturePath) override {
+        if (!StreamingComponent.IsValid())
+            return nullptr;
+        return StreamingComponent->LoadTexture(TexturePath, *Result);
+    }
+
+    bool IsLoadAborted() const override {
+        // 読込中にEndPlayやアクタの破棄が行われた場合は以降のコンポーネント作成を行わない
+        return FPLATEAUMeshLoader::IsLoadAborted() || !StreamingComponent.IsValid() || !Owner.IsValid();
+    }
+
+    bool UseRuntimeMeshBuild() const override {
+        // タイルは一時的なものであるため、エディタでもアセット用のビルドを行わない
+        return true;
+    }
+
+private:
+    TWeakObjectPtr<UPLATEAUCityModelStreamingComponent> StreamingComponent;
+    TWeakObjectPtr<AActor> Owner;
+    TSharedRef<UPLATEAUCityModelStreamingComponent::FLoadResult> Result;
+};
+
+namespace {
+    /**
+     * @brief メッシュコードを指定した次数まで分割します。2次メッシュは3次メッシュに、3次以上のメッシュは4分割します。
+     */
+    void SubdivideMeshCode(const FString& MeshCode, const int32 Level, TArray<FString>& OutMeshCodes) {
+        const int32 CurrentLevel = plateau::dataset::MeshCode(TCHAR_TO_UTF8(*MeshCode)).getLevel();
+        if (Level <= CurrentLevel) {
+            OutMeshCodes.Add(MeshCode);
+            return;
+        }
+
+        if (CurrentLevel == 2) {
+            for (int32 Row = 0; Row < 10; ++Row) {
+                for (int32 Col = 0; Col < 10; ++Col) {
+                    SubdivideMeshCode(FString::Printf(TEXT("%s%d%d"), *MeshCode, Row, Col), Level, OutMeshCodes);
+                }
+            }
+            return;
+        }
+
+        for (int32 i = 1; i <= 4; ++i) {
+            SubdivideMeshCode(FString::Printf(TEXT("%s%d"), *MeshCode, i), Level, OutMeshCodes);
+        }
+    }
+
+    double GetHorizontalDistance(const FBox& Box, const FVector& Point) {
+        const double DX = FMath::Max3(Box.Min.X - Point.X, 0.0, Point.X - Box.Max.X);
+        const double DY = FMath::Max3(Box.Min.Y - Point.Y, 0.0, Point.Y - Box.Max.Y);
+        return FMath::Sqrt(DX * DX + DY * DY);
+    }
+
+    int64 GetStaticMeshBytes(const UStaticMesh* StaticMesh) {
+        const auto RenderData = StaticMesh != nullptr ? StaticMesh->GetRenderData() : nullptr;
+        if (RenderData == nullptr)
+            return 0;
+
+        // RHIによってはCPU側のデータが破棄されるため、頂点数とストライドから計算する
+        int64 Bytes = 0;
+        for (const auto& LODResource : RenderData->LODResources) {
+            const auto& VertexBuffers = LODResource.VertexBuffers;
+            Bytes += static_cast<int64>(VertexBuffers.PositionVertexBuffer.GetNumVertices()) * VertexBuffers.PositionVertexBuffer.GetStride();
+            Bytes += VertexBuffers.StaticMeshVertexBuffer.GetResourceSize();
+            Bytes += static_cast<int64>(LODResource.IndexBuffer.GetNumIndices()) * (LODResource.IndexBuffer.Is32Bit() ? 4 : 2);
+        }
+        return Bytes;
+    }
+
+    /**
+     * @brief Root以下のメッシュと属性情報のサイズを計算します。共有されたメッシュは1度だけ数えます。
+     */
+    int64 GetComponentBytes(const USceneComponent& Root) {
+        TArray<USceneComponent*> Children;
+        Root.GetChildrenComponents(true, Children);
+        TSet<const UStaticMesh*> StaticMeshes;
+        int64 Bytes = 0;
+        for (const auto& Child : Children) {
+            if (const auto StaticMeshComponent = Cast<UStaticMeshComponent>(Child)) {
+                const auto StaticMesh = StaticMeshComponent->GetStaticMesh();
+                if (StaticMesh != nullptr && !StaticMeshes.Contains(StaticMesh)) {
+                    StaticMeshes.Add(StaticMesh);
+                    Bytes += GetStaticMeshBytes(StaticMesh);
+                }
+            }
+            if (const auto CityObjectGroup = Cast<UPLATEAUCityObjectGroup>(Child)) {
+                Bytes += CityObjectGroup->SerializedCityObjects.GetAllocatedSize();
+            }
+        }
+        return Bytes;
+    }
+}
+
+UPLATEAUCityModelStreamingComponent::UPLATEAUCityModelStreamingComponent() {
+    PrimaryComponentTick.bCanEverTick = true;
+    ImportSettings = nullptr;
+    LodSettings.Emplace(50000.0f, 4);
+    LodSettings.Emplace(150000.0f, 1);
+}
+
+void UPLATEAUCityModelStreamingComponent::BeginPlay() {
+    Super::BeginPlay();
+}
+
+void UPLATEAUCityModelStreamingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+    UnloadAll();
+    Super::EndPlay(EndPlayReason);
+}
+
+void UPLATEAUCityModelStreamingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) {
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    TArray<FVector> Viewpoints;
+    if (bUsePlayerCameras && GetWorld() != nullptr) {
+        for (auto Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator) {
+            if (const auto PlayerController = Iterator->Get()) {
+                FVector Location;
+                FRotator Rotation;
+                PlayerController->GetPlayerViewPoint(Location, Rotation);
+                Viewpoints.Add(Location);
+            }
+        }
+    }
+    for (const auto& ViewpointActor : ViewpointActors) {
+        if (IsValid(ViewpointActor))
+            Viewpoints.Add(ViewpointActor->GetActorLocation());
+    }
+    UpdateStreaming(Viewpoints);
+}
+
+void UPLATEAUCityModelStreamingComponent::UpdateStreaming(const TArray<FVector>& Viewpoints) {
+    if (!InitializeTiles())
+        return;
+
+    if (PendingLoad.IsValid() && PendingLoad->Future.IsReady())
+        FinishLoad();
+
+    // 視点が一時的に無い場合は現在の状態を維持する
+    if (Viewpoints.IsEmpty())
+        return;
+
+    for (auto& Tile : Tiles) {
+        Tile.Distance = TNumericLimits<double>::Max();
+        for (const auto& Viewpoint : Viewpoints) {
+            Tile.Distance = FMath::Min(Tile.Distance, GetHorizontalDistance(Tile.Bounds, Viewpoint));
+        }
+    }
+
+    // 範囲外のタイルを破棄
+    for (auto& Tile : Tiles) {
+        if (Tile.LoadedLodIndex != INDEX_NONE && GetDesiredLodIndex(Tile) == INDEX_NONE)
+            UnloadTile(Tile);
+    }
+
+    // 読込は1タイルずつ行う
+    if (PendingLoad.IsValid()) {
+        if (GetDesiredLodIndex(Tiles[PendingLoad->TileIndex]) != PendingLoad->LodIndex)
+            PendingLoad->bCanceled->Store(true);
+        return;
+    }
+
+    // 最も近い、読込またはLODの切り替えが必要なタイル
+    int32 TileIndex = INDEX_NONE;
+    int32 LodIndex = INDEX_NONE;
+    for (int32 i = 0; i < Tiles.Num(); ++i) {
+        const int32 DesiredLodIndex = GetDesiredLodIndex(Tiles[i]);
+        if (DesiredLodIndex == INDEX_NONE || DesiredLodIndex == Tiles[i].LoadedLodIndex)
+            continue;
+        if (TileIndex == INDEX_NONE || Tiles[i].Distance < Tiles[TileIndex].Distance) {
+            TileIndex = i;
+            LodIndex = DesiredLodIndex;
+        }
+    }
+    if (TileIndex == INDEX_NONE)
+        return;
+
+    auto& Tile = Tiles[TileIndex];
+    const int64 BudgetBytes = GetMemoryBudgetBytes();
+    if (0 < BudgetBytes) {
+        // LODを切り替える場合は現在のタイルを破棄してから読み込む
+        const int64 RequiredBytes = EstimateTileBytes(Tile, LodIndex) - Tile.Bytes;
+        while (BudgetBytes < GetUsedMemoryBytes() + RequiredBytes && EvictFarthestTile(Tile.Distance, TileIndex)) {}
+
+        // 他のタイルが読み込まれていない場合は予算を超えても1タイルは読み込む
+        const bool bHasOtherTile = 1 < GetLoadedTileCount() || (GetLoadedTileCount() == 1 && Tile.LoadedLodIndex == INDEX_NONE);
+        if (BudgetBytes < GetUsedMemoryBytes() + RequiredBytes && bHasOtherTile)
+            return;
+    }
+
+    UnloadTile(Tile);
+    StartLoad(TileIndex, LodIndex);
+}
+
+void UPLATEAUCityModelStreamingComponent::UnloadAll() {
+    if (PendingLoad.IsValid()) {
+        // 読込スレッドの以降のゲームスレッドでの処理は何も行わなくなる。完了済みであれば作成途中のコンポーネントをここで破棄する
+        PendingLoad->bCanceled->Store(true);
+        if (PendingLoad->Future.IsReady())
+            FinishLoad();
+    }
+    for (auto& Tile : Tiles) {
+        UnloadTile(Tile);
+    }
+}
+
+int64 UPLATEAUCityModelStreamingComponent::GetUsedMemoryBytes() const {
+    int64 Bytes = 0;
+    for (const auto& Tile : Tiles) {
+        Bytes += Tile.Bytes;
+    }
+    for (const auto& [TexturePath, StreamedTexture] : StreamedTextures) {
+        if (0 < StreamedTexture.RefCount)
+            Bytes += StreamedTexture.Bytes;
+    }
+    return Bytes;
+}
+
+int64 UPLATEAUCityModelStreamingComponent::GetMemoryBudgetBytes() const {
+    return static_cast<int64>(static_cast<double>(MemoryBudgetMB) * 1024.0 * 1024.0);
+}
+
+int32 UPLATEAUCityModelStreamingComponent::GetLoadedTileCount() const {
+    int32 Count = 0;
+    for (const auto& Tile : Tiles) {
+        if (Tile.LoadedLodIndex != INDEX_NONE)
+            ++Count;
+    }
+    return Count;
+}
+
+TArray<FString> UPLATEAUCityModelStreamingComponent::GetLoadedTileMeshCodes() const {
+    TArray<FString> MeshCodes;
+    for (const auto& Tile : Tiles) {
+        if (Tile.LoadedLodIndex != INDEX_NONE)
+            MeshCodes.Add(Tile.MeshCode);
+    }
+    return MeshCodes;
+}
+
+bool UPLATEAUCityModelStreamingComponent::IsLoading() const {
+    return PendingLoad.IsValid();
+}
+
+TArray<FString> UPLATEAUCityModelStreamingComponent::GetTileMeshCodes() const {
+    TArray<FString> MeshCodes;
+    for (const auto& Tile : Tiles) {
+        MeshCodes.Add(Tile.MeshCode);
+    }
+    return MeshCodes;
+}
+
+bool UPLATEAUCityModelStreamingComponent::InitializeTiles() {
+    if (bTilesInitialized)
+        return !Tiles.IsEmpty();
+    bTilesInitialized = true;
+
+    if (ImportSettings == nullptr || Source.IsEmpty()) {
+        UE_LOG(LogTemp, Warning, TEXT("PLATEAUCityModelStreaming: Source or ImportSettings is not set."));
+        return false;
+    }
+
+    try {
+        DatasetSource = std::make_shared<plateau::dataset::DatasetSource>(
+            plateau::dataset::DatasetSource::createLocal(TCHAR_TO_UTF8(*Source)));
+    }
+    catch (std::exception& e) {
+        UE_LOG(LogTemp, Error, TEXT("PLATEAUCityModelStreaming: Failed to open dataset. Path=%s, What=%s"), *Source, UTF8_TO_TCHAR(e.what()));
+        return false;
+    }
+
+    // データセットのメッシュコードを3次メッシュ単位にまとめてから分割する
+    TSet<FString> BaseMeshCodes;
+    for (const auto& MeshCode : DatasetSource->getAccessor()->getMeshCodes()) {
+        const FString MeshCodeString = UTF8_TO_TCHAR(MeshCode.get().c_str());
+        BaseMeshCodes.Add(MeshCode.getLevel() <= 2 ? MeshCodeString : MeshCodeString.Left(8));
+    }
+
+    const int32 Level = FMath::Clamp(TileMeshCodeLevel, 3, 5);
+    TArray<FString> TileMeshCodes;
+    for (const auto& MeshCode : BaseMeshCodes) {
+        SubdivideMeshCode(MeshCode, Level, TileMeshCodes);
+    }
+    TileMeshCodes.Sort();
+
+    for (const auto& MeshCode : TileMeshCodes) {
+        auto& Tile = Tiles.AddDefaulted_GetRef();
+        Tile.MeshCode = MeshCode;
+        const auto Extent = FPLATEAUExtent(plateau::dataset::MeshCode(TCHAR_TO_UTF8(*MeshCode)).getExtent());
+        Tile.Bounds = UPLATEAUGeoReferenceBlueprintLibrary::ProjectExtent(GeoReference, Extent);
+    }
+
+    // LodIndexは近い順とする
+    LodSettings.StableSort([](const FPLATEAUStreamingLodSetting& A, const FPLATEAUStreamingLodSetting& B) {
+        return A.Distance < B.Distance;
+    });
+    return !Tiles.IsEmpty();
+}
+
+int32 UPLATEAUCityModelStreamingComponent::GetDesiredLodIndex(const FTile& Tile) const {
+    int32 DesiredLodIndex = INDEX_NONE;
+    for (int32 i = 0; i < LodSettings.Num(); ++i) {
+        if (Tile.Distance <= LodSettings[i].Distance) {
+            DesiredLodIndex = i;
+            break;
+        }
+    }
+
+    // より粗いLODへの切り替え・破棄はHysteresisDistanceだけ遅らせる
+    const int32 CurrentLodIndex = Tile.LoadedLodIndex;
+    if (CurrentLodIndex != INDEX_NONE && LodSettings.IsValidIndex(CurrentLodIndex)
+        && (DesiredLodIndex == INDEX_NONE || CurrentLodIndex < DesiredLodIndex)
+        && Tile.Distance <= LodSettings[CurrentLodIndex].Distance + HysteresisDistance)
+        return CurrentLodIndex;
+
+    return DesiredLodIndex;
+}
+
+int64 UPLATEAUCityModelStreamingComponent::EstimateTileBytes(const FTile& Tile, const int32 LodIndex) const {
+    if (const auto KnownBytes = Tile.KnownBytes.Find(LodIndex))
+        return *KnownBytes;
+
+    // 未読込のタイルは同じLODで読み込んだタイルの平均とする
+    int64 TotalBytes = 0;
+    int32 Count = 0;
+    for (const auto& OtherTile : Tiles) {
+        if (const auto KnownBytes = OtherTile.KnownBytes.Find(LodIndex)) {
+            TotalBytes += *KnownBytes;
+            ++Count;
+        }
+    }
+    return Count == 0 ? 0 : TotalBytes / Count;
+}
+
+void UPLATEAUCityModelStreamingComponent::StartLoad(const int32 TileIndex, const int32 LodIndex) {
+    AActor* Owner = GetOwner();
+    if (Owner->GetRootComponent() == nullptr) {
+        const auto RootComponent = NewObject<UPLATEAUSceneComponent>(Owner, USceneComponent::GetDefaultSceneRootVariableName());
+        RootComponent->Mobility = EComponentMobility::Static;
+        Owner->SetRootComponent(RootComponent);
+        Owner->AddInstanceComponent(RootComponent);
+        RootComponent->RegisterComponent();
+    }
+
+    const auto& Tile = Tiles[TileIndex];
+    PendingLoad = MakeUnique<FPendingLoad>();
+    PendingLoad->TileIndex = TileIndex;
+    PendingLoad->LodIndex = LodIndex;
+    PendingLoad->Root = CreateTileComponent(*Owner->GetRootComponent(), Tile.MeshCode);
+    PendingLoad->bCanceled = MakeShared<TAtomic<bool>>(false);
+    PendingLoad->Result = MakeShared<FLoadResult>();
+
+    PendingLoad->Future = Async(EAsyncExecution::Thread,
+        [
+            StreamingComponent = TWeakObjectPtr<UPLATEAUCityModelStreamingComponent>(this),
+            Owner = TWeakObjectPtr<AActor>(Owner),
+            TileRoot = PendingLoad->Root,
+            DatasetSource = DatasetSource,
+            ImportSettings = ImportSettings,
+            GeoReference = GeoReference,
+            MeshCode = Tile.MeshCode,
+            MaxLod = LodSettings[LodIndex].MaxLod,
+            bCanceled = PendingLoad->bCanceled.ToSharedRef(),
+            Result = PendingLoad->Result.ToSharedRef()
+        ]() mutable {
+            auto LoadInputDataArray = APLATEAUCityModelLoader::PrepareLoadInputData(ImportSettings, *DatasetSource, { MeshCode }, GeoReference);
+            for (auto& LoadInputData : LoadInputDataArray) {
+                if (bCanceled->Load(EMemoryOrder::Relaxed))
+                    return;
+
+                auto& ExtractOptions = LoadInputData.ExtractOptions;
+                ExtractOptions.max_lod = FMath::Clamp(static_cast<unsigned>(FMath::Max(MaxLod, 0)), ExtractOptions.min_lod, ExtractOptions.max_lod);
+
+                FPLATEAUExtractedModel ExtractedModel;
+                if (!APLATEAUCityModelLoader::ExtractModel(LoadInputData.GmlPath, LoadInputData, ExtractedModel))
+                    continue;
+
+                // 以降のゲームスレッドでの処理はキャンセルフラグとオーナーの有効性を確認してから行う
+                USceneComponent* GmlRootComponent = nullptr;
+                AActor* OwnerActor = nullptr;
+                FFunctionGraphTask::CreateAndDispatchWhenReady(
+                    [&StreamingComponent, &Owner, &TileRoot, &LoadInputData, &GmlRootComponent, &OwnerActor, &bCanceled] {
+                        if (bCanceled->Load(EMemoryOrder::Relaxed) || !StreamingComponent.IsValid() || !Owner.IsValid() || !TileRoot.IsValid())
+                            return;
+                        OwnerActor = Owner.Get();
+                        GmlRootComponent = StreamingComponent->CreateTileComponent(*TileRoot, FPaths::GetBaseFilename(LoadInputData.GmlPath));
+                    }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+                if (GmlRootComponent == nullptr || bCanceled->Load(EMemoryOrder::Relaxed))
+                    return;
+
+                FPLATEAUMeshLoaderForStreaming(StreamingComponent, Owner, Result).LoadModel(OwnerActor, GmlRootComponent, ExtractedModel, LoadInputData, &bCanceled.Get());
+            }
+        });
+}
+
+void UPLATEAUCityModelStreamingComponent::FinishLoad() {
+    const auto Load = MoveTemp(PendingLoad);
+    auto& Tile = Tiles[Load->TileIndex];
+
+    if (Load->bCanceled->Load() || !Load->Root.IsValid()) {
+        if (Load->Root.IsValid()) {
+            TArray<USceneComponent*> Children;
+            Load->Root->GetChildrenComponents(true, Children);
+            for (const auto& Child : Children) {
+                Child->DestroyComponent();
+            }
+            Load->Root->DestroyComponent();
+        }
+        RemoveUnreferencedTextures();
+        return;
+    }
+
+    Tile.Root = Load->Root;
+    Tile.LoadedLodIndex = Load->LodIndex;
+    Tile.TexturePaths = MoveTemp(Load->Result->TexturePaths);
+    Tile.Bytes = GetComponentBytes(*Tile.Root);
+    int64 TextureBytes = 0;
+    for (const auto& TexturePath : Tile.TexturePaths) {
+        if (auto StreamedTexture = StreamedTextures.Find(TexturePath)) {
+            ++StreamedTexture->RefCount;
+            TextureBytes += StreamedTexture->Bytes;
+        }
+    }
+    // テクスチャが他のタイルと共有されない場合を想定して見積もる
+    Tile.KnownBytes.Add(Load->LodIndex, Tile.Bytes + TextureBytes);
+
+    const int64 BudgetBytes = GetMemoryBudgetBytes();
+    while (0 < BudgetBytes && BudgetBytes < GetUsedMemoryBytes() && 1 < GetLoadedTileCount() && EvictFarthestTile(-1.0, INDEX_NONE)) {}
+}
+
+void UPLATEAUCityModelStreamingComponent::UnloadTile(FTile& Tile) {
+    if (Tile.Root.IsValid()) {
+        TArray<USceneComponent*> Children;
+        Tile.Root->GetChildrenComponents(true, Children);
+        for (const auto& Child : Children) {
+            Child->DestroyComponent();
+        }
+        Tile.Root->DestroyComponent();
+    }
+    Tile.Root.Reset();
+    Tile.LoadedLodIndex = INDEX_NONE;
+    Tile.Bytes = 0;
+
+    for (const auto& TexturePath : Tile.TexturePaths) {
+        if (auto StreamedTexture = StreamedTextures.Find(TexturePath))
+            --StreamedTexture->RefCount;
+    }
+    Tile.TexturePaths.Reset();
+    RemoveUnreferencedTextures();
+}
+
+void UPLATEAUCityModelStreamingComponent::RemoveUnreferencedTextures() {
+    // 読込中のタイルが参照しているテクスチャは残す
+    const TSet<FString>* PendingTexturePaths = PendingLoad.IsValid() ? &PendingLoad->Result->TexturePaths : nullptr;
+    for (auto Iterator = StreamedTextures.CreateIterator(); Iterator; ++Iterator) {
+        if (0 < Iterator->Value.RefCount)
+            continue;
+        if (PendingTexturePaths != nullptr && PendingTexturePaths->Contains(Iterator->Key))
+            continue;
+        Iterator.RemoveCurrent();
+    }
+}
+
+bool UPLATEAUCityModelStreamingComponent::EvictFarthestTile(const double MinDistance, const int32 ExcludeTileIndex) {
+    int32 FarthestTileIndex = INDEX_NONE;
+    for (int32 i = 0; i < Tiles.Num(); ++i) {
+        if (i == ExcludeTileIndex || Tiles[i].LoadedLodIndex == INDEX_NONE || Tiles[i].Distance <= MinDistance)
+            continue;
+        if (FarthestTileIndex == INDEX_NONE || Tiles[FarthestTileIndex].Distance < Tiles[i].Distance)
+            FarthestTileIndex = i;
+    }
+    if (FarthestTileIndex == INDEX_NONE)
+        return false;
+
+    UnloadTile(Tiles[FarthestTileIndex]);
+    return true;
+}
+
+USceneComponent* UPLATEAUCityModelStreamingComponent::CreateTileComponent(USceneComponent& Parent, const FString& Name) const {
+    AActor* Owner = GetOwner();
+    const auto Component = NewObject<UPLATEAUSceneComponent>(Owner,
+        MakeUniqueObjectName(Owner, UPLATEAUSceneComponent::StaticClass(), FName(Name)));
+    Component->Mobility = EComponentMobility::Static;
+    Owner->AddInstanceComponent(Component);
+    Component->RegisterComponent();
+    Component->AttachToComponent(&Parent, FAttachmentTransformRules::KeepWorldTransform);
+    return Component;
+}
+
+UTexture2D* UPLATEAUCityModelStreamingComponent::LoadTexture(const FString& TexturePath, FLoadResult& Result) {
+    auto StreamedTexture = StreamedTextures.Find(TexturePath);
+    if (StreamedTexture == nullptr) {
+        int64 Bytes = 0;
+        const auto Texture = FPLATEAUTextureLoader::LoadTransient(TexturePath, &Bytes);
+        if (Texture == nullptr)
+            return nullptr;
+
+        StreamedTexture = &StreamedTextures.Add(TexturePath);
+        StreamedTexture->Texture = Texture;
+        StreamedTexture->Bytes = Bytes;
+    }
+    Result.TexturePaths.Add(TexturePath);
+    return StreamedTexture->Texture;
+}
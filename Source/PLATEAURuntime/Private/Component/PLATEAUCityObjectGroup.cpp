@@ -95,6 +95,11 @@ void UPLATEAUCityObjectGroup::SerializeCityObject(const plateau::polygonMesh::No
     SerializedCityObjects = CityModelSerializer.SerializeCityObject(InNode, InCityObject, Granularity);
 }
 
+void UPLATEAUCityObjectGroup::SetSerializedCityObjects(const FString& InSerializedCityObjects, const plateau::polygonMesh::MeshGranularity& Granularity) {
+    SetMeshGranularity(Granularity);
+    SerializedCityObjects = InSerializedCityObjects;
+}
+
 FPLATEAUCityObject UPLATEAUCityObjectGroup::GetPrimaryCityObjectByRaycast(const FHitResult& HitResult) {
     if (RootCityObjects.Num() <= 0) {
         GetAllRootCityObjects();
@@ -131,20 +136,8 @@ FPLATEAUCityObject UPLATEAUCityObjectGroup::GetCityObjectByUV(const FVector2d& U
 }
 
 FPLATEAUCityObject UPLATEAUCityObjectGroup::GetCityObjectByIndex(const FPLATEAUCityObjectIndex Index) {
-    if (RootCityObjects.Num() <= 0) {
-        GetAllRootCityObjects();
-    }
-
-    for (const auto& RootCityObject : RootCityObjects) {
-        if (RootCityObject.CityObjectIndex == Index) {
-            return RootCityObject;
-        }
-
-        for (const auto& ChildCityObject : RootCityObject.Children) {
-            if (ChildCityObject.CityObjectIndex == Index) {
-                return ChildCityObject;
-            }
-        }
+    if (const auto CityObject = FindCityObjectByIndex(Index)) {
+        return *CityObject;
     }
 
     UE_LOG(LogTemp, Error, TEXT("There is no index (%d, %d)."), Index.PrimaryIndex, Index.AtomicIndex);
@@ -171,9 +164,119 @@ TArray<FPLATEAUCityObject> UPLATEAUCityObjectGroup::GetAllRootCityObjects() {
     }
 
     Deserializer.DeserializeCityObjects(SerializedCityObjects, GetAttachChildren(), RootCityObjects, OutsideParent);
+
+    CityObjectIndexMap.Reset();
+    for (int32 RootIndex = 0; RootIndex < RootCityObjects.Num(); ++RootIndex) {
+        CityObjectIndexMap.FindOrAdd(RootCityObjects[RootIndex].CityObjectIndex, TPair<int32, int32>(RootIndex, INDEX_NONE));
+        for (int32 ChildIndex = 0; ChildIndex < RootCityObjects[RootIndex].Children.Num(); ++ChildIndex) {
+            CityObjectIndexMap.FindOrAdd(RootCityObjects[RootIndex].Children[ChildIndex].CityObjectIndex, TPair<int32, int32>(RootIndex, ChildIndex));
+        }
+    }
     return RootCityObjects;
 }
 
+bool UPLATEAUCityObjectGroup::BuildSpatialIndex() {
+    SpatialIndexMesh = GetStaticMesh();
+    if (!SpatialIndex.Build(GetStaticMesh())) {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to build spatial index: %s"), *GetName());
+        return false;
+    }
+    return true;
+}
+
+void UPLATEAUCityObjectGroup::InvalidateSpatialIndex() {
+    SpatialIndexMesh.Reset();
+}
+
+bool UPLATEAUCityObjectGroup::QueryCityObjectByRay(const FVector& Origin, const FVector& Direction, const double MaxDistance, const bool bPrimary, FPLATEAUCityObject& OutCityObject, FVector& OutHitLocation) {
+    if (!EnsureSpatialIndex())
+        return false;
+
+    // スケールを考慮してローカル空間のレイに変換
+    const auto& ComponentTransform = GetComponentTransform();
+    const FVector LocalOrigin = ComponentTransform.InverseTransformPosition(Origin);
+    const FVector LocalEnd = ComponentTransform.InverseTransformPosition(Origin + Direction.GetSafeNormal() * MaxDistance);
+    const FVector LocalDirection = (LocalEnd - LocalOrigin).GetSafeNormal();
+
+    int32 TriangleIndex;
+    double Distance;
+    if (!SpatialIndex.Raycast(LocalOrigin, LocalDirection, FVector::Distance(LocalOrigin, LocalEnd), TriangleIndex, Distance))
+        return false;
+
+    const auto CityObject = FindCityObjectByTriangle(TriangleIndex, bPrimary);
+    if (CityObject == nullptr)
+        return false;
+
+    OutCityObject = *CityObject;
+    OutHitLocation = ComponentTransform.TransformPosition(LocalOrigin + LocalDirection * Distance);
+    return true;
+}
+
+bool UPLATEAUCityObjectGroup::QueryCityObjectByPoint(const FVector& Point, const double Tolerance, const bool bPrimary, FPLATEAUCityObject& OutCityObject) {
+    if (!EnsureSpatialIndex())
+        return false;
+
+    const auto& ComponentTransform = GetComponentTransform();
+    const double LocalTolerance = Tolerance / FMath::Max(ComponentTransform.GetMinimumAxisScale(), UE_SMALL_NUMBER);
+
+    int32 TriangleIndex;
+    double Distance;
+    if (!SpatialIndex.FindNearestTriangle(ComponentTransform.InverseTransformPosition(Point), LocalTolerance, TriangleIndex, Distance))
+        return false;
+
+    const auto CityObject = FindCityObjectByTriangle(TriangleIndex, bPrimary);
+    if (CityObject == nullptr)
+        return false;
+
+    OutCityObject = *CityObject;
+    return true;
+}
+
+TArray<FPLATEAUCityObject> UPLATEAUCityObjectGroup::QueryCityObjectsInBox(const FBox& Box, const bool bPrimary) {
+    TArray<FPLATEAUCityObject> CityObjects;
+    if (!EnsureSpatialIndex())
+        return CityObjects;
+
+    TSet<FPLATEAUCityObjectIndex> Added;
+    const FBox LocalBox = Box.InverseTransformBy(GetComponentTransform());
+    for (const auto& Index : SpatialIndex.FindCityObjectIndicesInBox(LocalBox)) {
+        const auto TargetIndex = bPrimary ? FPLATEAUCityObjectIndex(Index.PrimaryIndex, -1) : Index;
+        if (Added.Contains(TargetIndex))
+            continue;
+
+        Added.Add(TargetIndex);
+        if (const auto CityObject = FindCityObjectByIndex(TargetIndex)) {
+            CityObjects.Add(*CityObject);
+        }
+    }
+    return CityObjects;
+}
+
+bool UPLATEAUCityObjectGroup::EnsureSpatialIndex() {
+    if (SpatialIndex.IsValid() && SpatialIndexMesh.Get() == GetStaticMesh())
+        return true;
+
+    return BuildSpatialIndex();
+}
+
+const FPLATEAUCityObject* UPLATEAUCityObjectGroup::FindCityObjectByIndex(const FPLATEAUCityObjectIndex& Index) {
+    if (RootCityObjects.Num() <= 0) {
+        GetAllRootCityObjects();
+    }
+
+    const auto Found = CityObjectIndexMap.Find(Index);
+    if (Found == nullptr)
+        return nullptr;
+
+    const auto& RootCityObject = RootCityObjects[Found->Key];
+    return Found->Value == INDEX_NONE ? &RootCityObject : &RootCityObject.Children[Found->Value];
+}
+
+const FPLATEAUCityObject* UPLATEAUCityObjectGroup::FindCityObjectByTriangle(const int32 TriangleIndex, const bool bPrimary) {
+    const auto& Index = SpatialIndex.GetCityObjectIndex(TriangleIndex);
+    return FindCityObjectByIndex(bPrimary ? FPLATEAUCityObjectIndex(Index.PrimaryIndex, -1) : Index);
+}
+
 const plateau::granularityConvert::ConvertGranularity UPLATEAUCityObjectGroup::GetConvertGranularity() {
     return static_cast<plateau::granularityConvert::ConvertGranularity>(MeshGranularityIntValue);
 }
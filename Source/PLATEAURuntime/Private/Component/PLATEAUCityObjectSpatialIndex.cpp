@@ -0,0 +1,285 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "Component/PLATEAUCityObjectSpatialIndex.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include <algorithm>
+
+namespace {
+    // 葉ノードが持つ最大三角形数
+    constexpr int32 MaxTrianglesPerLeaf = 4;
+
+    bool RayIntersectsBox(const FBox3f& Box, const FVector3f& Origin, const FVector3f& InvDirection, const float MaxT) {
+        float TMin = 0.0f;
+        float TMax = MaxT;
+        for (int Axis = 0; Axis < 3; ++Axis) {
+            float T0 = (Box.Min[Axis] - Origin[Axis]) * InvDirection[Axis];
+            float T1 = (Box.Max[Axis] - Origin[Axis]) * InvDirection[Axis];
+            if (T1 < T0)
+                Swap(T0, T1);
+            TMin = FMath::Max(TMin, T0);
+            TMax = FMath::Min(TMax, T1);
+            if (TMax < TMin)
+                return false;
+        }
+        return true;
+    }
+}
+
+bool FPLATEAUCityObjectSpatialIndex::Build(const UStaticMesh* StaticMesh, const int32 UVChannel) {
+    Reset();
+    if (StaticMesh == nullptr || StaticMesh->GetRenderData() == nullptr || StaticMesh->GetRenderData()->LODResources.Num() <= 0)
+        return false;
+
+    if (FPlatformProperties::RequiresCookedData() && !StaticMesh->bAllowCPUAccess) {
+        UE_LOG(LogTemp, Warning, TEXT("FPLATEAUCityObjectSpatialIndex: %s does not allow CPU access."), *StaticMesh->GetName());
+        return false;
+    }
+
+    const auto& RenderMesh = StaticMesh->GetRenderData()->LODResources[0];
+    const auto& PositionBuffer = RenderMesh.VertexBuffers.PositionVertexBuffer;
+    const auto& VertexBuffer = RenderMesh.VertexBuffers.StaticMeshVertexBuffer;
+    if (VertexBuffer.GetNumTexCoords() <= static_cast<uint32>(UVChannel))
+        return false;
+
+    TArray<FVector3f> Positions;
+    Positions.SetNumUninitialized(PositionBuffer.GetNumVertices());
+    for (uint32 i = 0; i < PositionBuffer.GetNumVertices(); ++i) {
+        Positions[i] = PositionBuffer.VertexPosition(i);
+    }
+
+    const int32 NumIndices = RenderMesh.IndexBuffer.GetNumIndices();
+    TArray<uint32> Indices;
+    Indices.SetNumUninitialized(NumIndices);
+    TArray<FPLATEAUCityObjectIndex> CityObjectIndices;
+    CityObjectIndices.SetNumUninitialized(NumIndices / 3);
+    for (int32 i = 0; i < NumIndices; ++i) {
+        Indices[i] = RenderMesh.IndexBuffer.GetIndex(i);
+    }
+    for (int32 TriangleIndex = 0; TriangleIndex < NumIndices / 3; ++TriangleIndex) {
+        // FindCollisionUVと同様に三角形の1頂点目のUVをCityObjectIndexとみなす
+        const FVector2f UV = VertexBuffer.GetVertexUV(Indices[TriangleIndex * 3], UVChannel);
+        CityObjectIndices[TriangleIndex] = FPLATEAUCityObjectIndex(static_cast<int32>(UV.X), static_cast<int32>(UV.Y));
+    }
+
+    return Build(Positions, Indices, CityObjectIndices);
+}
+
+bool FPLATEAUCityObjectSpatialIndex::Build(const TArray<FVector3f>& Positions, const TArray<uint32>& Indices, const TArray<FPLATEAUCityObjectIndex>& InTriangleCityObjectIndices) {
+    Reset();
+    const int32 NumTriangles = Indices.Num() / 3;
+    if (NumTriangles <= 0 || InTriangleCityObjectIndices.Num() != NumTriangles)
+        return false;
+
+    TArray<FBox3f> TriangleBounds;
+    TArray<FVector3f> Centroids;
+    TriangleBounds.SetNumUninitialized(NumTriangles);
+    Centroids.SetNumUninitialized(NumTriangles);
+    for (int32 i = 0; i < NumTriangles; ++i) {
+        const FVector3f& P0 = Positions[Indices[i * 3]];
+        const FVector3f& P1 = Positions[Indices[i * 3 + 1]];
+        const FVector3f& P2 = Positions[Indices[i * 3 + 2]];
+        FBox3f Bounds(P0, P0);
+        Bounds += P1;
+        Bounds += P2;
+        TriangleBounds[i] = Bounds;
+        Centroids[i] = (P0 + P1 + P2) / 3.0f;
+    }
+
+    // BVH順に並べ替えた元の三角形番号
+    TArray<int32> Order;
+    Order.SetNumUninitialized(NumTriangles);
+    for (int32 i = 0; i < NumTriangles; ++i) {
+        Order[i] = i;
+    }
+
+    Nodes.Reserve(2 * NumTriangles / MaxTrianglesPerLeaf + 1);
+    BuildRecursive(0, NumTriangles, Order, TriangleBounds, Centroids);
+
+    TriangleVertices.SetNumUninitialized(NumTriangles * 3);
+    TriangleCityObjectIndices.SetNumUninitialized(NumTriangles);
+    for (int32 i = 0; i < NumTriangles; ++i) {
+        const int32 Source = Order[i];
+        TriangleVertices[i * 3] = Positions[Indices[Source * 3]];
+        TriangleVertices[i * 3 + 1] = Positions[Indices[Source * 3 + 1]];
+        TriangleVertices[i * 3 + 2] = Positions[Indices[Source * 3 + 2]];
+        TriangleCityObjectIndices[i] = InTriangleCityObjectIndices[Source];
+    }
+    return true;
+}
+
+void FPLATEAUCityObjectSpatialIndex::Reset() {
+    Nodes.Reset();
+    TriangleVertices.Reset();
+    TriangleCityObjectIndices.Reset();
+}
+
+int32 FPLATEAUCityObjectSpatialIndex::BuildRecursive(const int32 Begin, const int32 End, TArray<int32>& Order, const TArray<FBox3f>& TriangleBounds, const TArray<FVector3f>& Centroids) {
+    const int32 NodeIndex = Nodes.AddDefaulted();
+
+    FBox3f Bounds(ForceInit);
+    FBox3f CentroidBounds(ForceInit);
+    for (int32 i = Begin; i < End; ++i) {
+        Bounds += TriangleBounds[Order[i]];
+        CentroidBounds += Centroids[Order[i]];
+    }
+    Nodes[NodeIndex].Bounds = Bounds;
+
+    const FVector3f Extent = CentroidBounds.GetSize();
+    if (End - Begin <= MaxTrianglesPerLeaf || Extent.GetMax() <= 0.0f) {
+        Nodes[NodeIndex].Offset = Begin;
+        Nodes[NodeIndex].Count = End - Begin;
+        return NodeIndex;
+    }
+
+    // 重心の広がりが最大の軸の中央値で分割
+    const int32 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+    const int32 Mid = Begin + (End - Begin) / 2;
+    std::nth_element(Order.GetData() + Begin, Order.GetData() + Mid, Order.GetData() + End, [&Centroids, Axis](const int32 A, const int32 B) {
+        return Centroids[A][Axis] < Centroids[B][Axis];
+    });
+
+    BuildRecursive(Begin, Mid, Order, TriangleBounds, Centroids);
+    const int32 RightIndex = BuildRecursive(Mid, End, Order, TriangleBounds, Centroids);
+    Nodes[NodeIndex].Offset = RightIndex;
+    Nodes[NodeIndex].Count = 0;
+    return NodeIndex;
+}
+
+bool FPLATEAUCityObjectSpatialIndex::RaycastTriangle(const int32 TriangleIndex, const FVector3f& Origin, const FVector3f& Direction, float& OutT) const {
+    // Möller–Trumbore (両面)
+    const FVector3f& P0 = TriangleVertices[TriangleIndex * 3];
+    const FVector3f Edge1 = TriangleVertices[TriangleIndex * 3 + 1] - P0;
+    const FVector3f Edge2 = TriangleVertices[TriangleIndex * 3 + 2] - P0;
+    const FVector3f PVec = FVector3f::CrossProduct(Direction, Edge2);
+    const float Det = FVector3f::DotProduct(Edge1, PVec);
+    if (FMath::Abs(Det) < UE_SMALL_NUMBER)
+        return false;
+
+    const float InvDet = 1.0f / Det;
+    const FVector3f TVec = Origin - P0;
+    const float U = FVector3f::DotProduct(TVec, PVec) * InvDet;
+    if (U < 0.0f || 1.0f < U)
+        return false;
+
+    const FVector3f QVec = FVector3f::CrossProduct(TVec, Edge1);
+    const float V = FVector3f::DotProduct(Direction, QVec) * InvDet;
+    if (V < 0.0f || 1.0f < U + V)
+        return false;
+
+    OutT = FVector3f::DotProduct(Edge2, QVec) * InvDet;
+    return 0.0f <= OutT;
+}
+
+bool FPLATEAUCityObjectSpatialIndex::Raycast(const FVector& Origin, const FVector& Direction, const double MaxDistance, int32& OutTriangleIndex, double& OutDistance) const {
+    if (!IsValid())
+        return false;
+
+    const FVector3f RayOrigin(Origin);
+    const FVector3f RayDirection(Direction);
+    const FVector3f InvDirection(
+        RayDirection.X != 0.0f ? 1.0f / RayDirection.X : UE_BIG_NUMBER,
+        RayDirection.Y != 0.0f ? 1.0f / RayDirection.Y : UE_BIG_NUMBER,
+        RayDirection.Z != 0.0f ? 1.0f / RayDirection.Z : UE_BIG_NUMBER);
+
+    float ClosestT = static_cast<float>(MaxDistance);
+    OutTriangleIndex = INDEX_NONE;
+
+    TArray<int32, TInlineAllocator<64>> Stack;
+    Stack.Add(0);
+    while (0 < Stack.Num()) {
+        const FNode& Node = Nodes[Stack.Pop(false)];
+        if (!RayIntersectsBox(Node.Bounds, RayOrigin, InvDirection, ClosestT))
+            continue;
+
+        if (Node.IsLeaf()) {
+            for (int32 i = Node.Offset; i < Node.Offset + Node.Count; ++i) {
+                float T;
+                if (RaycastTriangle(i, RayOrigin, RayDirection, T) && T < ClosestT) {
+                    ClosestT = T;
+                    OutTriangleIndex = i;
+                }
+            }
+            continue;
+        }
+
+        // 左の子は常に自ノードの直後
+        const int32 NodeIndex = &Node - Nodes.GetData();
+        Stack.Add(Node.Offset);
+        Stack.Add(NodeIndex + 1);
+    }
+
+    OutDistance = ClosestT;
+    return OutTriangleIndex != INDEX_NONE;
+}
+
+bool FPLATEAUCityObjectSpatialIndex::FindNearestTriangle(const FVector& Point, const double Tolerance, int32& OutTriangleIndex, double& OutDistance) const {
+    if (!IsValid())
+        return false;
+
+    const FVector3f Target(Point);
+    float ClosestDistSquared = FMath::Square(static_cast<float>(Tolerance));
+    OutTriangleIndex = INDEX_NONE;
+
+    TArray<int32, TInlineAllocator<64>> Stack;
+    Stack.Add(0);
+    while (0 < Stack.Num()) {
+        const int32 NodeIndex = Stack.Pop(false);
+        const FNode& Node = Nodes[NodeIndex];
+        if (ClosestDistSquared < Node.Bounds.ComputeSquaredDistanceToPoint(Target))
+            continue;
+
+        if (Node.IsLeaf()) {
+            for (int32 i = Node.Offset; i < Node.Offset + Node.Count; ++i) {
+                const FVector3f Closest = FMath::ClosestPointOnTriangleToPoint(Target, TriangleVertices[i * 3], TriangleVertices[i * 3 + 1], TriangleVertices[i * 3 + 2]);
+                const float DistSquared = FVector3f::DistSquared(Closest, Target);
+                if (DistSquared <= ClosestDistSquared) {
+                    ClosestDistSquared = DistSquared;
+                    OutTriangleIndex = i;
+                }
+            }
+            continue;
+        }
+
+        Stack.Add(Node.Offset);
+        Stack.Add(NodeIndex + 1);
+    }
+
+    OutDistance = FMath::Sqrt(ClosestDistSquared);
+    return OutTriangleIndex != INDEX_NONE;
+}
+
+TArray<FPLATEAUCityObjectIndex> FPLATEAUCityObjectSpatialIndex::FindCityObjectIndicesInBox(const FBox& Box) const {
+    TArray<FPLATEAUCityObjectIndex> Result;
+    if (!IsValid())
+        return Result;
+
+    const FBox3f QueryBox(Box);
+    TSet<FPLATEAUCityObjectIndex> Found;
+
+    TArray<int32, TInlineAllocator<64>> Stack;
+    Stack.Add(0);
+    while (0 < Stack.Num()) {
+        const int32 NodeIndex = Stack.Pop(false);
+        const FNode& Node = Nodes[NodeIndex];
+        if (!Node.Bounds.Intersect(QueryBox))
+            continue;
+
+        if (Node.IsLeaf()) {
+            for (int32 i = Node.Offset; i < Node.Offset + Node.Count; ++i) {
+                FBox3f TriangleBounds(TriangleVertices[i * 3], TriangleVertices[i * 3]);
+                TriangleBounds += TriangleVertices[i * 3 + 1];
+                TriangleBounds += TriangleVertices[i * 3 + 2];
+                if (TriangleBounds.Intersect(QueryBox) && !Found.Contains(TriangleCityObjectIndices[i])) {
+                    Found.Add(TriangleCityObjectIndices[i]);
+                    Result.Add(TriangleCityObjectIndices[i]);
+                }
+            }
+            continue;
+        }
+
+        Stack.Add(Node.Offset);
+        Stack.Add(NodeIndex + 1);
+    }
+    return Result;
+}
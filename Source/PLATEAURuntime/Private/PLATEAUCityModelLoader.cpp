@@ -10,10 +10,15 @@
 #include "plateau/polygon_mesh/mesh_extractor.h"
 #include "plateau/polygon_mesh/mesh_extract_options.h"
 #include "PLATEAUMeshLoader.h"
+#include "PLATEAUExtractedModelCache.h"
+#include "PLATEAUImportMemoryBudget.h"
+#include "PLATEAUDatasetIndex.h"
 #include "citygml/citygml.h"
 #include "Kismet/GameplayStatics.h"
 #include "Reconstruct/PLATEAUMeshLoaderForHeightmap.h"
 #include "Component/PLATEAUSceneComponent.h"
+#include "Misc/ScopeExit.h"
+#include "HAL/FileManager.h"
 
 
 #define LOCTEXT_NAMESPACE "PLATEAUCityModelLoader"
@@ -26,37 +31,68 @@ public:
     static TArray<FLoadInputData> PrepareInputData(
         const UPLATEAUImportSettings* ImportSettings, const FString& Source,
         const TArray<FString>& MeshCodes, FPLATEAUGeoReference& GeoReference, const bool bImportFromServer, const plateau::network::Client ClientRef) {
+        // ローカルのデータセットはファイルの索引から検索する
+        if (!bImportFromServer) {
+            if (const auto DatasetIndex = FPLATEAUDatasetIndex::FindOrBuild(Source)) {
+                return PrepareInputData(ImportSettings, MeshCodes, GeoReference,
+                    [&DatasetIndex, &MeshCodes](const plateau::dataset::PredefinedCityModelPackage Package) {
+                        return DatasetIndex->FindGmlFiles(MeshCodes, Package);
+                    });
+            }
+        }
+
         // ファイル検索
         const auto DatasetSource = LoadDataset(bImportFromServer, Source, ClientRef);
+        return PrepareInputData(ImportSettings, DatasetSource, MeshCodes, GeoReference);
+    }
+
+    static TArray<FLoadInputData> PrepareInputData(
+        const UPLATEAUImportSettings* ImportSettings, const plateau::dataset::DatasetSource& DatasetSource,
+        const TArray<FString>& MeshCodes, FPLATEAUGeoReference& GeoReference) {
+        std::vector<plateau::dataset::MeshCode> RawMeshCodes;
+        for (const auto& MeshCode : MeshCodes) {
+            RawMeshCodes.emplace_back(TCHAR_TO_UTF8(*MeshCode));
+        }
+        const auto FilteredDatasetAccessor = DatasetSource.getAccessor()->filterByMeshCodes(RawMeshCodes);
+
+        return PrepareInputData(ImportSettings, MeshCodes, GeoReference,
+            [&FilteredDatasetAccessor](const plateau::dataset::PredefinedCityModelPackage Package) {
+                TArray<FString> GmlPaths;
+                for (const auto& GmlFile : *FilteredDatasetAccessor->getGmlFiles(Package)) {
+                    GmlPaths.Add(UTF8_TO_TCHAR(GmlFile.getPath().c_str()));
+                }
+                return GmlPaths;
+            });
+    }
+
+    /**
+     * @brief FindGmlFilesで得たパッケージ毎のGMLについて、インポート設定から読込用データを作成します。
+     */
+    static TArray<FLoadInputData> PrepareInputData(
+        const UPLATEAUImportSettings* ImportSettings, const TArray<FString>& MeshCodes, FPLATEAUGeoReference& GeoReference,
+        TFunctionRef<TArray<FString>(plateau::dataset::PredefinedCityModelPackage)> FindGmlFiles) {
         TArray<FLoadInputData> LoadInputDataArray;
 
+        // メッシュコードからインポート範囲に変換
+        std::vector<plateau::geometry::Extent> Extents;
+        for (const auto& MeshCode : MeshCodes) {
+            Extents.push_back(plateau::dataset::MeshCode(TCHAR_TO_UTF8(*MeshCode)).getExtent());
+        }
+
         for (const auto& Package : UPLATEAUImportSettings::GetAllPackages()) {
             const auto Settings = ImportSettings->GetFeatureSettings(Package);
             if (!Settings.bImport)
                 continue;
 
-            std::vector<plateau::dataset::MeshCode> RawMeshCodes;
-            for (const auto& MeshCode : MeshCodes) {
-                RawMeshCodes.emplace_back(TCHAR_TO_UTF8(*MeshCode));
-            }
-
-            const auto GmlFiles =
-                DatasetSource.getAccessor()
-                ->filterByMeshCodes(RawMeshCodes)
-                ->getGmlFiles(Package);
-
-            for (const auto& GmlFile : *GmlFiles) {
+            for (const auto& GmlPath : FindGmlFiles(Package)) {
                 auto& LoadInputData = LoadInputDataArray.AddDefaulted_GetRef();
-                LoadInputData.GmlPath = UTF8_TO_TCHAR(GmlFile.getPath().c_str());
-
-                // メッシュコードからインポート範囲に変換
-                for (const auto& MeshCode : MeshCodes) {
-                    const auto RawExtent = plateau::dataset::MeshCode(TCHAR_TO_UTF8(*MeshCode)).getExtent();
-                    LoadInputData.Extents.push_back(RawExtent);
-                }
+                LoadInputData.GmlPath = GmlPath;
+                LoadInputData.Package = Package;
+                LoadInputData.Extents = Extents;
 
                 LoadInputData.bIncludeAttrInfo = Settings.bIncludeAttrInfo;
                 LoadInputData.FallbackMaterial = Settings.FallbackMaterial;
+                LoadInputData.bEnableMeshInstancing = Settings.bEnableMeshInstancing;
                 auto& ExtractOptions = LoadInputData.ExtractOptions;
                 ExtractOptions.reference_point = GeoReference.GetData().getReferencePoint();
                 ExtractOptions.mesh_axes = plateau::geometry::CoordinateSystem::ESU;
@@ -148,6 +184,24 @@ public:
         return CityModel;
     }
 
+    static bool ExtractModel(const FString& GmlPath, const FLoadInputData& InputData, FPLATEAUExtractedModel& OutExtractedModel) {
+        const auto CacheKey = FPLATEAUExtractedModelCache::IsEnabled()
+            ? FPLATEAUExtractedModelCache::MakeKey(GmlPath, InputData)
+            : FString();
+        if (FPLATEAUExtractedModelCache::Load(CacheKey, OutExtractedModel))
+            return true;
+
+        const auto CityModel = ParseCityGml(GmlPath);
+        if (CityModel == nullptr)
+            return false;
+
+        OutExtractedModel = FPLATEAUExtractedModel();
+        OutExtractedModel.Model = plateau::polygonMesh::MeshExtractor::extractInExtents(*CityModel, InputData.ExtractOptions, InputData.Extents);
+        FPLATEAUExtractedModelCache::SerializeCityObjects(*OutExtractedModel.Model, CityModel, InputData, OutExtractedModel.SerializedCityObjects);
+        FPLATEAUExtractedModelCache::Save(CacheKey, OutExtractedModel);
+        return true;
+    }
+
     static USceneComponent* CreateComponentInGameThread(
         AActor* Actor, const FString& Name) {
         USceneComponent* Component;
@@ -200,6 +254,14 @@ namespace {
     }
 
 
+    void UpdateMemoryStats(FPLATEAUCityModelLoadStatus& Status, const FPLATEAUImportMemoryBudget& MemoryBudget) {
+        const auto Stats = MemoryBudget.GetStats();
+        Status.PeakReservedMemoryBytes = Stats.PeakReservedBytes;
+        Status.PeakUsedPhysicalMemoryBytes = Stats.PeakUsedPhysicalBytes;
+        Status.PeakConcurrentGmlCount = Stats.PeakConcurrentGmlCount;
+        Status.DeferredGmlCount = Stats.DeferredCount;
+    }
+
     void CreateRootComponent(AActor& Actor) {
 #if WITH_EDITOR
         USceneComponent* ActorRootComponent = NewObject<UPLATEAUSceneComponent>(&Actor,
@@ -253,7 +315,9 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                 ImportGmlProgressDelegate = ImportGmlProgressDelegate,
                 ImportFailedGmlFileDelegate = ImportFailedGmlFileDelegate,
                 ImportFinishedDelegate = ImportFinishedDelegate,
-                LoadMeshSection = &LoadMeshSection
+                LoadMeshSection = &LoadMeshSection,
+                MemoryBudgetBytes = static_cast<int64>(MemoryBudgetMB * 1024.0 * 1024.0),
+                MaxConcurrentGmlCount = MaxConcurrentGmlCount
         ]() mutable {
 
                 auto LoadInputDataArray = FCityModelLoaderImpl::PrepareInputData(
@@ -278,6 +342,9 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                 TArray<TFuture<bool>> Futures;
                 TArray<FString> GmlNames;
 
+                // GML毎のメモリ使用量の見積もりが予算に収まる間だけ処理を開始する
+                const auto MemoryBudget = MakeShared<FPLATEAUImportMemoryBudget, ESPMode::ThreadSafe>(MemoryBudgetBytes, MaxConcurrentGmlCount);
+
                 bool bHasDatasetNameSet = false;
                 FCriticalSection SetDatasetNameSection;
 
@@ -290,8 +357,11 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                         continue;
                     }
 
+                    const auto Estimate = FPLATEAUImportMemoryBudget::Estimate(
+                        IFileManager::Get().FileSize(*LoadInputDataArray[Index].GmlPath), LoadInputDataArray[Index]);
+                    bool bAdmitted = false;
                     FGenericPlatformProcess::ConditionalSleep(
-                        [&Futures, &GmlNames, OwnerLoader, &bCanceledRef] {
+                        [&Futures, &GmlNames, OwnerLoader, &bCanceledRef, &MemoryBudget, &Estimate, &bAdmitted] {
                             TArray<FString> CurrentLoadingGmls;
                             int LoadCompletedCount = 0;
                             for (int i = 0; i < Futures.Num(); ++i) {
@@ -305,15 +375,19 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                                     ++LoadCompletedCount;
 
                                 ExecuteInGameThread(OwnerLoader,
-                                    [&CurrentLoadingGmls, &LoadCompletedCount](TWeakObjectPtr<APLATEAUCityModelLoader> Loader) {
+                                    [&CurrentLoadingGmls, &LoadCompletedCount, &MemoryBudget](TWeakObjectPtr<APLATEAUCityModelLoader> Loader) {
                                         Loader->Status.LoadedGmlCount = LoadCompletedCount;
                                         Loader->Status.LoadingGmls = CurrentLoadingGmls;
+                                        UpdateMemoryStats(Loader->Status, *MemoryBudget);
                                     });
                             }
-                            return CurrentLoadingGmls.Num() < 4;
+                            bAdmitted = MemoryBudget->TryAcquire(Estimate);
+                            return bAdmitted;
                         }, 3);
 
                     if (bCanceledRef->Load(EMemoryOrder::Relaxed)) {
+                        if (bAdmitted)
+                            MemoryBudget->Release(Estimate, false);
                         FFunctionGraphTask::CreateAndDispatchWhenReady(
                             [Index, ImportGmlProgressDelegate] {
                                 ImportGmlProgressDelegate.Broadcast(Index, 0, LOCTEXT("Cancel", "キャンセルされました"));
@@ -360,6 +434,7 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                     }
 
                     if (bCanceledRef->Load(EMemoryOrder::Relaxed)) {
+                        MemoryBudget->Release(Estimate, false);
                         FFunctionGraphTask::CreateAndDispatchWhenReady(
                             [Index, ImportGmlProgressDelegate] {
                                 ImportGmlProgressDelegate.Broadcast(Index, 0.25, LOCTEXT("Cancel", "キャンセルされました"));
@@ -376,38 +451,59 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                     GmlNames.Add(GmlName);
                     Futures.Add(Async(EAsyncExecution::Thread,
                         [InputData, &LoadInputDataArray, Source, ModelActor, GmlName, OwnerLoader,
-                        CopiedGmlPath, &LoadMeshSection, bAutomationTest, &bCanceledRef, Index, ImportGmlProgressDelegate, ImportFailedGmlFileDelegate] {
+                        CopiedGmlPath, &LoadMeshSection, bAutomationTest, &bCanceledRef, Index, ImportGmlProgressDelegate, ImportFailedGmlFileDelegate,
+                        MemoryBudget, Estimate] {
+
+                            // 抽出結果等が解放された後に予約を解放するため、ローカル変数より先に宣言する
+                            bool bParseReleased = false;
+                            ON_SCOPE_EXIT {
+                                MemoryBudget->Release(Estimate, bParseReleased);
+                            };
 
                             if (bCanceledRef->Load(EMemoryOrder::Relaxed))
                                 return false;
 
-                            const auto CityModel = FCityModelLoaderImpl::ParseCityGml(CopiedGmlPath);
-                            if (CityModel == nullptr) {
-                                ExecuteInGameThread(OwnerLoader,
-                                    [GmlName, Index, ImportFailedGmlFileDelegate](auto Loader) {
-                                        ++Loader->Status.LoadedGmlCount;
-                                        Loader->Status.LoadingGmls.Remove(GmlName);
-                                        Loader->Status.FailedGmls.Add(GmlName);
-                                        ImportFailedGmlFileDelegate.Broadcast(Index);
-                                    });
-                                return false;
-                            }
+                            // 同じGML・抽出設定で抽出済みのメッシュがキャッシュにあればパースと抽出を省略する
+                            const auto CacheKey = FPLATEAUExtractedModelCache::IsEnabled()
+                                ? FPLATEAUExtractedModelCache::MakeKey(CopiedGmlPath, InputData)
+                                : FString();
+                            FPLATEAUExtractedModel ExtractedModel;
+                            if (!FPLATEAUExtractedModelCache::Load(CacheKey, ExtractedModel)) {
+                                auto CityModel = FCityModelLoaderImpl::ParseCityGml(CopiedGmlPath);
+                                if (CityModel == nullptr) {
+                                    ExecuteInGameThread(OwnerLoader,
+                                        [GmlName, Index, ImportFailedGmlFileDelegate](auto Loader) {
+                                            ++Loader->Status.LoadedGmlCount;
+                                            Loader->Status.LoadingGmls.Remove(GmlName);
+                                            Loader->Status.FailedGmls.Add(GmlName);
+                                            ImportFailedGmlFileDelegate.Broadcast(Index);
+                                        });
+                                    return false;
+                                }
+
+                                if (bCanceledRef->Load(EMemoryOrder::Relaxed)) {
+                                    FFunctionGraphTask::CreateAndDispatchWhenReady(
+                                        [Index, ImportGmlProgressDelegate] {
+                                            ImportGmlProgressDelegate.Broadcast(Index, 0.5, LOCTEXT("Cancel", "キャンセルされました"));
+                                        }, TStatId(), nullptr, ENamedThreads::GameThread);
+                                    return false;
+                                }
 
-                            if (bCanceledRef->Load(EMemoryOrder::Relaxed)) {
                                 FFunctionGraphTask::CreateAndDispatchWhenReady(
                                     [Index, ImportGmlProgressDelegate] {
-                                        ImportGmlProgressDelegate.Broadcast(Index, 0.5, LOCTEXT("Cancel", "キャンセルされました"));
+                                        ImportGmlProgressDelegate.Broadcast(Index, 0.5, LOCTEXT("MeshExtractorExtract", "ポリゴンメッシュ変換中..."));
                                     }, TStatId(), nullptr, ENamedThreads::GameThread);
-                                return false;
-                            }
 
-                            FFunctionGraphTask::CreateAndDispatchWhenReady(
-                                [Index, ImportGmlProgressDelegate] {
-                                    ImportGmlProgressDelegate.Broadcast(Index, 0.5, LOCTEXT("MeshExtractorExtract", "ポリゴンメッシュ変換中..."));
-                                }, TStatId(), nullptr, ENamedThreads::GameThread);
+                                // 注: 名前空間plateau::polygonMeshをusingで省略しないこと。Packageビルドで問題となる。
+                                ExtractedModel.Model = plateau::polygonMesh::MeshExtractor::extractInExtents(*CityModel, InputData.ExtractOptions, InputData.Extents);
+                                FPLATEAUExtractedModelCache::SerializeCityObjects(*ExtractedModel.Model, CityModel, InputData, ExtractedModel.SerializedCityObjects);
 
-                            // 注: 名前空間plateau::polygonMeshをusingで省略しないこと。Packageビルドで問題となる。
-                            const auto Model = plateau::polygonMesh::MeshExtractor::extractInExtents(*CityModel, InputData.ExtractOptions, InputData.Extents);
+                                // パース結果は抽出後は不要なため、ワールドへの読込を待たずに解放する
+                                CityModel.reset();
+                                FPLATEAUExtractedModelCache::Save(CacheKey, ExtractedModel);
+                            }
+                            MemoryBudget->ReleaseParse(Estimate);
+                            bParseReleased = true;
 
                             // 各GMLについて親Componentを作成
                             // コンポーネントは拡張子無しgml名に設定
@@ -429,7 +525,7 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
 
                             {
                                 FScopeLock Lock(LoadMeshSection);
-                                FPLATEAUMeshLoader(bAutomationTest).LoadModel(ModelActor, GmlRootComponent, Model, InputData, CityModel, bCanceledRef);
+                                FPLATEAUMeshLoader(bAutomationTest).LoadModel(ModelActor, GmlRootComponent, ExtractedModel, InputData, bCanceledRef);
                             }
 
                             FFunctionGraphTask::CreateAndDispatchWhenReady(
@@ -468,9 +564,21 @@ void APLATEAUCityModelLoader::LoadAsync(const bool bAutomationTest) {
                         return CurrentLoadingGmls.Num() == 0;
                     }, 3);
 
+                const auto MemoryStats = MemoryBudget->GetStats();
+                UE_LOG(LogTemp, Log, TEXT("Import memory: peak reserved %lld MB, peak physical %lld MB, peak concurrent gml %d, deferred %d"),
+                    MemoryStats.PeakReservedBytes / (1024 * 1024), MemoryStats.PeakUsedPhysicalBytes / (1024 * 1024),
+                    MemoryStats.PeakConcurrentGmlCount, MemoryStats.DeferredCount);
+                ExecuteInGameThread(OwnerLoader,
+                    [&MemoryBudget](auto Loader) {
+                        UpdateMemoryStats(Loader->Status, *MemoryBudget);
+                    });
+
                 *Phase = ECityModelLoadingPhase::Finished;
                 FFunctionGraphTask::CreateAndDispatchWhenReady(
-                    [ImportFinishedDelegate] {
+                    [ImportFinishedDelegate, ModelActor] {
+                        // フィルタリング用のインデックスをインポート時に構築しておく
+                        if (IsValid(ModelActor))
+                            ModelActor->BuildFilteringIndex();
                         ImportFinishedDelegate.Broadcast();
                     }, TStatId(), nullptr, ENamedThreads::GameThread);
             });
@@ -530,7 +638,9 @@ void APLATEAUCityModelLoader::LoadGmlAsync(const FString& GmlPath) {
             *Phase = ECityModelLoadingPhase::Finished;
 
             FFunctionGraphTask::CreateAndDispatchWhenReady(
-                [ImportFinishedDelegate] {
+                [ImportFinishedDelegate, ModelActor] {
+                    if (IsValid(ModelActor))
+                        ModelActor->BuildFilteringIndex();
                     ImportFinishedDelegate.Broadcast();
                 }, TStatId(), nullptr, ENamedThreads::GameThread);
 
@@ -539,6 +649,16 @@ void APLATEAUCityModelLoader::LoadGmlAsync(const FString& GmlPath) {
 #endif
 }
 
+TArray<FLoadInputData> APLATEAUCityModelLoader::PrepareLoadInputData(
+    const UPLATEAUImportSettings* ImportSettings, const plateau::dataset::DatasetSource& DatasetSource,
+    const TArray<FString>& MeshCodes, FPLATEAUGeoReference& GeoReference) {
+    return FCityModelLoaderImpl::PrepareInputData(ImportSettings, DatasetSource, MeshCodes, GeoReference);
+}
+
+bool APLATEAUCityModelLoader::ExtractModel(const FString& GmlPath, const FLoadInputData& LoadInputData, FPLATEAUExtractedModel& OutExtractedModel) {
+    return FCityModelLoaderImpl::ExtractModel(GmlPath, LoadInputData, OutExtractedModel);
+}
+
 void APLATEAUCityModelLoader::Cancel() {
     if (Phase == ECityModelLoadingPhase::Start) {
         bCanceled.Store(true);
@@ -0,0 +1,262 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUDatasetIndex.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <plateau/dataset/gml_file.h>
+#include <plateau/dataset/i_dataset_accessor.h>
+
+namespace {
+    using plateau::dataset::PredefinedCityModelPackage;
+
+    // "PLDI"
+    constexpr uint32 IndexMagic = 0x49444C50;
+    // 保存形式を変更した場合は更新すること
+    constexpr uint32 IndexVersion = 1;
+
+    /**
+     * @brief udx以下の1ディレクトリ分の走査結果です。更新日時が変わらない間は再走査せずに使用します。
+     */
+    struct FDirectoryRecord {
+        FDateTime ModificationTime;
+        TArray<FString> SubDirectories;
+        TArray<FPLATEAUDatasetIndex::FEntry> Files;
+    };
+
+    using FDirectoryRecords = TMap<FString, FDirectoryRecord>;
+
+    struct FCachedIndex {
+        FDirectoryRecords Directories;
+        TSharedPtr<const FPLATEAUDatasetIndex, ESPMode::ThreadSafe> Index;
+    };
+
+    FCriticalSection CacheSection;
+    TMap<FString, FCachedIndex> MemoryCache;
+
+    FString GetCacheFilePath(const FString& SourcePath) {
+        FSHAHash Hash;
+        FSHA1::HashBuffer(*SourcePath, SourcePath.Len() * sizeof(TCHAR), Hash.Hash);
+        return FPLATEAUDatasetIndex::GetCacheDirectory() / Hash.ToString() + TEXT(".bin");
+    }
+
+    void SerializeEntry(FArchive& Ar, FPLATEAUDatasetIndex::FEntry& Entry) {
+        uint32 Package = static_cast<uint32>(Entry.Package);
+        Ar << Entry.GmlPath << Package << Entry.MeshCode << Entry.FileSize << Entry.ModificationTime;
+        Entry.Package = static_cast<PredefinedCityModelPackage>(Package);
+    }
+
+    void SaveRecords(const FString& SourcePath, FDirectoryRecords& Records) {
+        TArray<uint8> FileBytes;
+        FMemoryWriter Ar(FileBytes);
+        uint32 Magic = IndexMagic, Version = IndexVersion;
+        auto Source = SourcePath;
+        int32 RecordCount = Records.Num();
+        Ar << Magic << Version << Source << RecordCount;
+        for (auto& Pair : Records) {
+            auto Directory = Pair.Key;
+            auto& Record = Pair.Value;
+            int32 FileCount = Record.Files.Num();
+            Ar << Directory << Record.ModificationTime << Record.SubDirectories << FileCount;
+            for (auto& Entry : Record.Files) {
+                SerializeEntry(Ar, Entry);
+            }
+        }
+
+        // 書き込み途中のファイルを読まないよう一時ファイルに書いてから移動する
+        const auto Path = GetCacheFilePath(SourcePath);
+        const auto TempPath = Path + FString::Printf(TEXT(".%u.tmp"), FPlatformTLS::GetCurrentThreadId());
+        if (!FFileHelper::SaveArrayToFile(FileBytes, *TempPath))
+            return;
+        if (!IFileManager::Get().Move(*Path, *TempPath, true, true, false, true))
+            IFileManager::Get().Delete(*TempPath, false, true, true);
+    }
+
+    bool LoadRecords(const FString& SourcePath, FDirectoryRecords& OutRecords) {
+        TArray<uint8> FileBytes;
+        if (!FFileHelper::LoadFileToArray(FileBytes, *GetCacheFilePath(SourcePath), FILEREAD_Silent))
+            return false;
+
+        FMemoryReader Ar(FileBytes);
+        uint32 Magic = 0, Version = 0;
+        FString Source;
+        int32 RecordCount = 0;
+        Ar << Magic << Version;
+        if (Ar.IsError() || Magic != IndexMagic || Version != IndexVersion)
+            return false;
+        Ar << Source << RecordCount;
+        if (Ar.IsError() || Source != SourcePath || RecordCount < 0)
+            return false;
+
+        FDirectoryRecords Records;
+        Records.Reserve(RecordCount);
+        for (int32 i = 0; i < RecordCount; ++i) {
+            FString Directory;
+            FDirectoryRecord Record;
+            int32 FileCount = 0;
+            Ar << Directory << Record.ModificationTime << Record.SubDirectories << FileCount;
+            if (Ar.IsError() || FileCount < 0)
+                return false;
+            Record.Files.SetNum(FileCount);
+            for (auto& Entry : Record.Files) {
+                SerializeEntry(Ar, Entry);
+            }
+            if (Ar.IsError())
+                return false;
+            Records.Add(Directory, MoveTemp(Record));
+        }
+        OutRecords = MoveTemp(Records);
+        return true;
+    }
+
+    bool TryCreateEntry(const TCHAR* Path, const FFileStatData& StatData, const PredefinedCityModelPackage Package, FPLATEAUDatasetIndex::FEntry& OutEntry) {
+        try {
+            const plateau::dataset::GmlFile GmlFile(TCHAR_TO_UTF8(Path));
+            if (!GmlFile.isValid())
+                return false;
+            OutEntry.GmlPath = Path;
+            OutEntry.Package = Package;
+            OutEntry.MeshCode = UTF8_TO_TCHAR(GmlFile.getMeshCode().get().c_str());
+            OutEntry.FileSize = StatData.FileSize;
+            OutEntry.ModificationTime = StatData.ModificationTime;
+            return true;
+        }
+        catch (std::exception& e) {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to index %s: %s"), Path, UTF8_TO_TCHAR(e.what()));
+            return false;
+        }
+    }
+
+    /**
+     * @brief ディレクトリを再帰的に走査します。更新日時が前回と同じディレクトリは前回の結果を使用します。
+     * @param Package udx直下のフォルダ名から決まるパッケージ。udxフォルダ自身はNoneとし、直下のGMLは対象外とする
+     */
+    void ScanDirectory(const FString& Directory, const PredefinedCityModelPackage Package,
+        const FDirectoryRecords& OldRecords, FDirectoryRecords& OutRecords, int32& RescannedCount) {
+        const auto StatData = IFileManager::Get().GetStatData(*Directory);
+        if (!StatData.bIsValid || !StatData.bIsDirectory)
+            return;
+
+        const auto OldRecord = OldRecords.Find(Directory);
+        FDirectoryRecord Record;
+        if (OldRecord != nullptr && OldRecord->ModificationTime == StatData.ModificationTime) {
+            Record = *OldRecord;
+        }
+        else {
+            ++RescannedCount;
+            Record.ModificationTime = StatData.ModificationTime;
+            IFileManager::Get().IterateDirectoryStat(*Directory,
+                [&Record, Package](const TCHAR* Path, const FFileStatData& ChildStatData) {
+                    if (ChildStatData.bIsDirectory) {
+                        Record.SubDirectories.Add(FPaths::GetCleanFilename(Path));
+                        return true;
+                    }
+                    if (Package == PredefinedCityModelPackage::None || !FPaths::GetExtension(Path).Equals(TEXT("gml"), ESearchCase::IgnoreCase))
+                        return true;
+                    FPLATEAUDatasetIndex::FEntry Entry;
+                    if (TryCreateEntry(Path, ChildStatData, Package, Entry))
+                        Record.Files.Add(MoveTemp(Entry));
+                    return true;
+                });
+            Record.SubDirectories.Sort();
+        }
+
+        for (const auto& SubDirectory : Record.SubDirectories) {
+            const auto SubPackage = Package == PredefinedCityModelPackage::None
+                ? plateau::dataset::UdxSubFolder::getPackage(TCHAR_TO_UTF8(*SubDirectory))
+                : Package;
+            ScanDirectory(Directory / SubDirectory, SubPackage, OldRecords, OutRecords, RescannedCount);
+        }
+        OutRecords.Add(Directory, MoveTemp(Record));
+    }
+}
+
+TSharedPtr<const FPLATEAUDatasetIndex, ESPMode::ThreadSafe> FPLATEAUDatasetIndex::FindOrBuild(const FString& SourcePath, int32* OutRescannedDirectoryCount) {
+    if (OutRescannedDirectoryCount != nullptr)
+        *OutRescannedDirectoryCount = 0;
+
+    auto FullSourcePath = FPaths::ConvertRelativePathToFull(SourcePath);
+    FPaths::NormalizeDirectoryName(FullSourcePath);
+    const auto UdxPath = FullSourcePath / TEXT("udx");
+    if (!IFileManager::Get().DirectoryExists(*UdxPath))
+        return nullptr;
+
+    FScopeLock Lock(&CacheSection);
+    auto& Cached = MemoryCache.FindOrAdd(FullSourcePath);
+    if (!Cached.Index)
+        LoadRecords(FullSourcePath, Cached.Directories);
+
+    FDirectoryRecords Records;
+    int32 RescannedCount = 0;
+    ScanDirectory(UdxPath, PredefinedCityModelPackage::None, Cached.Directories, Records, RescannedCount);
+    if (OutRescannedDirectoryCount != nullptr)
+        *OutRescannedDirectoryCount = RescannedCount;
+
+    // ディレクトリの削除は親ディレクトリの再走査で検出される
+    const bool bChanged = 0 < RescannedCount || Records.Num() != Cached.Directories.Num();
+    if (Cached.Index && !bChanged)
+        return Cached.Index;
+
+    const auto Index = MakeShared<FPLATEAUDatasetIndex, ESPMode::ThreadSafe>();
+    for (const auto& Pair : Records) {
+        Index->Entries.Append(Pair.Value.Files);
+    }
+    Index->Entries.Sort([](const FEntry& A, const FEntry& B) {
+        return A.MeshCode != B.MeshCode ? A.MeshCode < B.MeshCode : A.GmlPath < B.GmlPath;
+    });
+
+    if (bChanged)
+        SaveRecords(FullSourcePath, Records);
+    Cached.Directories = MoveTemp(Records);
+    Cached.Index = Index;
+    return Index;
+}
+
+TArray<FString> FPLATEAUDatasetIndex::FindGmlFiles(const TArray<FString>& MeshCodes, const PredefinedCityModelPackage Packages) const {
+    TSet<int32> FoundIndices;
+    const auto AddMatches = [this, &FoundIndices](const FString& MeshCode, const bool bIncludeDescendants) {
+        int32 Index = Algo::LowerBoundBy(Entries, MeshCode, [](const FEntry& Entry) -> const FString& { return Entry.MeshCode; });
+        for (; Index < Entries.Num(); ++Index) {
+            const auto& EntryMeshCode = Entries[Index].MeshCode;
+            if (bIncludeDescendants ? !EntryMeshCode.StartsWith(MeshCode) : EntryMeshCode != MeshCode)
+                break;
+            FoundIndices.Add(Index);
+        }
+    };
+
+    for (const auto& MeshCode : MeshCodes) {
+        // 選択範囲を内包する上位の地域メッシュ(1次, 2次, 3次, 2分の1地域メッシュ)のGML
+        for (const int32 Length : { 4, 6, 8, 9 }) {
+            if (Length < MeshCode.Len())
+                AddMatches(MeshCode.Left(Length), false);
+        }
+        // 選択範囲と同じ、または内包される下位の地域メッシュのGML
+        AddMatches(MeshCode, true);
+    }
+
+    TArray<FString> GmlFiles;
+    for (const auto Index : FoundIndices) {
+        if ((Entries[Index].Package & Packages) != PredefinedCityModelPackage::None)
+            GmlFiles.Add(Entries[Index].GmlPath);
+    }
+    GmlFiles.Sort();
+    return GmlFiles;
+}
+
+const TArray<FPLATEAUDatasetIndex::FEntry>& FPLATEAUDatasetIndex::GetEntries() const {
+    return Entries;
+}
+
+void FPLATEAUDatasetIndex::ClearCache() {
+    FScopeLock Lock(&CacheSection);
+    MemoryCache.Reset();
+    IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+}
+
+FString FPLATEAUDatasetIndex::GetCacheDirectory() {
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()) / TEXT("PLATEAU/DatasetIndex");
+}
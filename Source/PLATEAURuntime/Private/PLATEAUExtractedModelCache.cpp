@@ -0,0 +1,528 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUExtractedModelCache.h"
+#include "PLATEAUCityModelLoader.h"
+#include "CityGML/Serialization/PLATEAUNativeCityObjectSerialization.h"
+#include "Util/PLATEAUGmlUtil.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Serialization/ArchiveSaveCompressedProxy.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include <atomic>
+#include <string_view>
+#include <citygml/citymodel.h>
+#include <citygml/cityobject.h>
+#include <citygml/material.h>
+#include <plateau/polygon_mesh/model.h>
+#include <plateau/polygon_mesh/mesh.h>
+#include <plateau/polygon_mesh/node.h>
+
+namespace {
+    // "PLMC"
+    constexpr uint32 CacheMagic = 0x434D4C50;
+    // 保存形式やキーの内容を変更した場合は更新すること
+    constexpr uint32 CacheVersion = 1;
+    // 1つの配列として読み込む要素数の上限。破損したファイルによる巨大な確保を防ぐ
+    constexpr int64 MaxArrayNum = 1LL << 31;
+
+    std::atomic<bool> bCacheEnabled = true;
+    std::atomic<int64> CacheBudget = 4LL * 1024 * 1024 * 1024;
+    FCriticalSection CacheDirectorySection;
+    // キャッシュ全体のサイズ(バイト)。未走査の場合は負の値。CacheDirectorySectionで保護する
+    int64 CachedTotalSize = -1;
+
+    // citygml::Materialのコンストラクタはprotectedのため、キャッシュからの復元用に派生クラスを用意する
+    class FCachedCityGmlMaterial : public citygml::Material {
+    public:
+        explicit FCachedCityGmlMaterial(const std::string& Id)
+            : citygml::Material(Id) {
+        }
+    };
+
+    FString GetCacheFilePath(const FString& Key) {
+        return FPLATEAUExtractedModelCache::GetCacheDirectory() / Key.Left(2) / Key + TEXT(".bin");
+    }
+
+    void WriteString(FArchive& Ar, const std::string& Value) {
+        int32 Length = Value.size();
+        Ar << Length;
+        Ar.Serialize(const_cast<char*>(Value.data()), Length);
+    }
+
+    bool ReadString(FArchive& Ar, std::string& OutValue) {
+        int32 Length = 0;
+        Ar << Length;
+        if (Ar.IsError() || Length < 0)
+            return false;
+        OutValue.resize(Length);
+        Ar.Serialize(OutValue.data(), Length);
+        return !Ar.IsError();
+    }
+
+    template <typename T>
+    void WriteVector(FArchive& Ar, const std::vector<T>& Values) {
+        int64 Num = Values.size();
+        Ar << Num;
+        Ar.Serialize(const_cast<T*>(Values.data()), Num * sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadVector(FArchive& Ar, std::vector<T>& OutValues) {
+        int64 Num = 0;
+        Ar << Num;
+        if (Ar.IsError() || Num < 0 || MaxArrayNum < Num)
+            return false;
+        OutValues.resize(Num);
+        Ar.Serialize(OutValues.data(), Num * sizeof(T));
+        return !Ar.IsError();
+    }
+
+    template <typename T>
+    void SerializeVec3(FArchive& Ar, T& Value) {
+        Ar << Value.x << Value.y << Value.z;
+    }
+
+    void WriteMesh(FArchive& Ar, const plateau::polygonMesh::Mesh& Mesh) {
+        WriteVector(Ar, Mesh.getVertices());
+        WriteVector(Ar, Mesh.getIndices());
+        WriteVector(Ar, Mesh.getUV1());
+        WriteVector(Ar, Mesh.getUV4());
+        WriteVector(Ar, Mesh.getVertexColors());
+
+        const auto& SubMeshes = Mesh.getSubMeshes();
+        int32 SubMeshCount = SubMeshes.size();
+        Ar << SubMeshCount;
+        for (const auto& SubMesh : SubMeshes) {
+            int64 StartIndex = SubMesh.getStartIndex();
+            int64 EndIndex = SubMesh.getEndIndex();
+            int32 GameMaterialID = SubMesh.getGameMaterialID();
+            Ar << StartIndex << EndIndex << GameMaterialID;
+            WriteString(Ar, SubMesh.getTexturePath());
+
+            const auto Material = SubMesh.getMaterial();
+            bool bHasMaterial = Material != nullptr;
+            Ar << bHasMaterial;
+            if (!bHasMaterial)
+                continue;
+
+            WriteString(Ar, Material->getId());
+            auto Diffuse = Material->getDiffuse();
+            auto Emissive = Material->getEmissive();
+            auto Specular = Material->getSpecular();
+            float AmbientIntensity = Material->getAmbientIntensity();
+            float Shininess = Material->getShininess();
+            float Transparency = Material->getTransparency();
+            bool bIsSmooth = Material->isSmooth();
+            SerializeVec3(Ar, Diffuse);
+            SerializeVec3(Ar, Emissive);
+            SerializeVec3(Ar, Specular);
+            Ar << AmbientIntensity << Shininess << Transparency << bIsSmooth;
+        }
+
+        const auto& CityObjectList = Mesh.getCityObjectList();
+        std::vector<plateau::polygonMesh::CityObjectIndex> Keys;
+        CityObjectList.getAllKeys(Keys);
+        int32 KeyCount = Keys.size();
+        Ar << KeyCount;
+        for (const auto& Key : Keys) {
+            int32 PrimaryIndex = Key.primary_index;
+            int32 AtomicIndex = Key.atomic_index;
+            Ar << PrimaryIndex << AtomicIndex;
+            std::string GmlID;
+            if (AtomicIndex == plateau::polygonMesh::CityObjectIndex::invalidIndex())
+                CityObjectList.tryGetPrimaryGmlID(PrimaryIndex, GmlID);
+            else
+                CityObjectList.tryGetAtomicGmlID(Key, GmlID);
+            WriteString(Ar, GmlID);
+        }
+    }
+
+    std::unique_ptr<plateau::polygonMesh::Mesh> ReadMesh(FArchive& Ar) {
+        std::vector<TVec3d> Vertices;
+        std::vector<unsigned> Indices;
+        plateau::polygonMesh::UV UV1;
+        plateau::polygonMesh::UV UV4;
+        std::vector<TVec3d> VertexColors;
+        if (!ReadVector(Ar, Vertices) || !ReadVector(Ar, Indices) || !ReadVector(Ar, UV1) || !ReadVector(Ar, UV4) || !ReadVector(Ar, VertexColors))
+            return nullptr;
+
+        int32 SubMeshCount = 0;
+        Ar << SubMeshCount;
+        if (Ar.IsError() || SubMeshCount < 0)
+            return nullptr;
+        std::vector<plateau::polygonMesh::SubMesh> SubMeshes;
+        SubMeshes.reserve(SubMeshCount);
+        for (int32 i = 0; i < SubMeshCount; ++i) {
+            int64 StartIndex, EndIndex;
+            int32 GameMaterialID;
+            std::string TexturePath;
+            Ar << StartIndex << EndIndex << GameMaterialID;
+            if (!ReadString(Ar, TexturePath))
+                return nullptr;
+
+            bool bHasMaterial = false;
+            Ar << bHasMaterial;
+            std::shared_ptr<const citygml::Material> Material;
+            if (bHasMaterial) {
+                std::string MaterialID;
+                if (!ReadString(Ar, MaterialID))
+                    return nullptr;
+                TVec3f Diffuse, Emissive, Specular;
+                float AmbientIntensity, Shininess, Transparency;
+                bool bIsSmooth;
+                SerializeVec3(Ar, Diffuse);
+                SerializeVec3(Ar, Emissive);
+                SerializeVec3(Ar, Specular);
+                Ar << AmbientIntensity << Shininess << Transparency << bIsSmooth;
+
+                const auto CachedMaterial = std::make_shared<FCachedCityGmlMaterial>(MaterialID);
+                CachedMaterial->setDiffuse(Diffuse);
+                CachedMaterial->setEmissive(Emissive);
+                CachedMaterial->setSpecular(Specular);
+                CachedMaterial->setAmbientIntensity(AmbientIntensity);
+                CachedMaterial->setShininess(Shininess);
+                CachedMaterial->setTransparency(Transparency);
+                CachedMaterial->setIsSmooth(bIsSmooth);
+                Material = CachedMaterial;
+            }
+            SubMeshes.emplace_back(StartIndex, EndIndex, TexturePath, Material, GameMaterialID);
+        }
+
+        int32 KeyCount = 0;
+        Ar << KeyCount;
+        if (Ar.IsError() || KeyCount < 0)
+            return nullptr;
+        plateau::polygonMesh::CityObjectList CityObjectList;
+        for (int32 i = 0; i < KeyCount; ++i) {
+            int32 PrimaryIndex, AtomicIndex;
+            std::string GmlID;
+            Ar << PrimaryIndex << AtomicIndex;
+            if (!ReadString(Ar, GmlID))
+                return nullptr;
+            CityObjectList.add(plateau::polygonMesh::CityObjectIndex(PrimaryIndex, AtomicIndex), GmlID);
+        }
+
+        auto Mesh = std::make_unique<plateau::polygonMesh::Mesh>(std::move(Vertices), std::move(Indices), std::move(UV1), std::move(UV4),
+            std::move(SubMeshes), std::move(CityObjectList));
+        if (!VertexColors.empty())
+            Mesh->setVertexColors(VertexColors);
+        return Mesh;
+    }
+
+    void WriteNode(FArchive& Ar, const plateau::polygonMesh::Node& Node) {
+        WriteString(Ar, Node.getName());
+        auto Position = Node.getLocalPosition();
+        auto Scale = Node.getLocalScale();
+        const auto Rotation = Node.getLocalRotation();
+        double RotationX = Rotation.getX(), RotationY = Rotation.getY(), RotationZ = Rotation.getZ(), RotationW = Rotation.getW();
+        SerializeVec3(Ar, Position);
+        SerializeVec3(Ar, Scale);
+        Ar << RotationX << RotationY << RotationZ << RotationW;
+
+        bool bHasMesh = Node.getMesh() != nullptr;
+        Ar << bHasMesh;
+        if (bHasMesh)
+            WriteMesh(Ar, *Node.getMesh());
+
+        int32 ChildCount = Node.getChildCount();
+        Ar << ChildCount;
+        for (int32 i = 0; i < ChildCount; ++i) {
+            WriteNode(Ar, Node.getChildAt(i));
+        }
+    }
+
+    bool ReadNode(FArchive& Ar, plateau::polygonMesh::Node& OutNode) {
+        std::string Name;
+        if (!ReadString(Ar, Name))
+            return false;
+        TVec3d Position, Scale;
+        double RotationX, RotationY, RotationZ, RotationW;
+        SerializeVec3(Ar, Position);
+        SerializeVec3(Ar, Scale);
+        Ar << RotationX << RotationY << RotationZ << RotationW;
+
+        bool bHasMesh = false;
+        Ar << bHasMesh;
+        std::unique_ptr<plateau::polygonMesh::Mesh> Mesh;
+        if (bHasMesh) {
+            Mesh = ReadMesh(Ar);
+            if (Mesh == nullptr)
+                return false;
+        }
+
+        OutNode = plateau::polygonMesh::Node(Name, std::move(Mesh));
+        OutNode.setLocalPosition(Position);
+        OutNode.setLocalScale(Scale);
+        OutNode.setLocalRotation(plateau::polygonMesh::Quaternion(RotationX, RotationY, RotationZ, RotationW));
+
+        int32 ChildCount = 0;
+        Ar << ChildCount;
+        if (Ar.IsError() || ChildCount < 0)
+            return false;
+        OutNode.reserveChild(ChildCount);
+        for (int32 i = 0; i < ChildCount; ++i) {
+            plateau::polygonMesh::Node Child("");
+            if (!ReadNode(Ar, Child))
+                return false;
+            OutNode.addChildNode(std::move(Child));
+        }
+        return true;
+    }
+
+    bool HasAllTextures(const plateau::polygonMesh::Node& Node) {
+        if (const auto Mesh = Node.getMesh()) {
+            for (const auto& SubMesh : Mesh->getSubMeshes()) {
+                const auto& TexturePath = SubMesh.getTexturePath();
+                if (!TexturePath.empty() && !FPaths::FileExists(UTF8_TO_TCHAR(TexturePath.c_str())))
+                    return false;
+            }
+        }
+        for (size_t i = 0; i < Node.getChildCount(); ++i) {
+            if (!HasAllTextures(Node.getChildAt(i)))
+                return false;
+        }
+        return true;
+    }
+
+    void SerializeCityObjectsRecursive(const plateau::polygonMesh::Node& Node, const std::shared_ptr<const citygml::CityModel> CityModel,
+        const FLoadInputData& LoadInputData, FPLATEAUNativeCityObjectSerialization& Serializer, TMap<FString, FString>& OutSerializedCityObjects) {
+        const auto Granularity = LoadInputData.ExtractOptions.mesh_granularity;
+        if (const auto Mesh = Node.getMesh()) {
+            // FPLATEAUMeshLoader::GetStaticMeshComponentForCondition と同じ条件
+            if (LoadInputData.bIncludeAttrInfo && Mesh->getVertices().size() != 0)
+                OutSerializedCityObjects.Add(FPLATEAUGmlUtil::GetNodePathString(Node), Serializer.SerializeCityObject(Node.getName(), *Mesh, Granularity, CityModel));
+        } else if (LoadInputData.bIncludeAttrInfo) {
+            // FPLATEAUMeshLoader::LoadNode と同じ条件。CityObjectが無いノードはエントリを作成しない
+            if (const auto CityObject = CityModel->getCityObjectById(Node.getName()))
+                OutSerializedCityObjects.Add(FPLATEAUGmlUtil::GetNodePathString(Node), Serializer.SerializeCityObject(Node, CityObject, Granularity));
+        }
+
+        for (size_t i = 0; i < Node.getChildCount(); ++i) {
+            SerializeCityObjectsRecursive(Node.getChildAt(i), CityModel, LoadInputData, Serializer, OutSerializedCityObjects);
+        }
+    }
+
+    /**
+     * @brief キャッシュディレクトリを走査し、最終アクセスが古いキャッシュファイルから削除して合計サイズを上限以下にします
+     */
+    void TrimCache() {
+        struct FCacheFile {
+            FString Path;
+            int64 Size;
+            FDateTime AccessTime;
+        };
+        TArray<FCacheFile> Files;
+        int64 TotalSize = 0;
+        IFileManager::Get().IterateDirectoryStatRecursively(*FPLATEAUExtractedModelCache::GetCacheDirectory(),
+            [&Files, &TotalSize](const TCHAR* Path, const FFileStatData& StatData) {
+                if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("bin")) {
+                    Files.Add({ Path, StatData.FileSize, StatData.ModificationTime });
+                    TotalSize += StatData.FileSize;
+                }
+                return true;
+            });
+
+        if (TotalSize <= CacheBudget) {
+            CachedTotalSize = TotalSize;
+            return;
+        }
+
+        Files.Sort([](const FCacheFile& A, const FCacheFile& B) {
+            return A.AccessTime < B.AccessTime;
+        });
+        for (const auto& File : Files) {
+            if (TotalSize <= CacheBudget)
+                break;
+            if (IFileManager::Get().Delete(*File.Path, false, true, true))
+                TotalSize -= File.Size;
+        }
+        CachedTotalSize = TotalSize;
+    }
+}
+
+FString FPLATEAUExtractedModelCache::MakeKey(const FString& GmlPath, const FLoadInputData& LoadInputData) {
+    TArray<uint8> GmlBytes;
+    if (!FFileHelper::LoadFileToArray(GmlBytes, *GmlPath, FILEREAD_Silent))
+        return FString();
+
+    FSHA1 Hash;
+    Hash.Update(reinterpret_cast<const uint8*>(&CacheVersion), sizeof(CacheVersion));
+    Hash.Update(GmlBytes.GetData(), GmlBytes.Num());
+
+    // codeSpace属性で参照されているコードリストの内容もキーに含める
+    const std::string_view GmlText(reinterpret_cast<const char*>(GmlBytes.GetData()), GmlBytes.Num());
+    constexpr std::string_view CodeSpaceAttribute = "codeSpace=\"";
+    TSet<FString> CodeListPaths;
+    for (size_t Position = GmlText.find(CodeSpaceAttribute); Position != std::string_view::npos; Position = GmlText.find(CodeSpaceAttribute, Position)) {
+        Position += CodeSpaceAttribute.size();
+        const auto End = GmlText.find('"', Position);
+        if (End == std::string_view::npos)
+            break;
+        const std::string RelativePath(GmlText.substr(Position, End - Position));
+        CodeListPaths.Add(FPaths::ConvertRelativePathToFull(FPaths::GetPath(GmlPath), UTF8_TO_TCHAR(RelativePath.c_str())));
+        Position = End;
+    }
+    TArray<FString> SortedCodeListPaths = CodeListPaths.Array();
+    SortedCodeListPaths.Sort();
+    for (const auto& CodeListPath : SortedCodeListPaths) {
+        const auto CodeListHash = FMD5Hash::HashFile(*CodeListPath);
+        const auto CodeListHashString = FPaths::GetCleanFilename(CodeListPath) + LexToString(CodeListHash);
+        Hash.UpdateWithString(*CodeListHashString, CodeListHashString.Len());
+    }
+
+    // メッシュの形状と属性に影響する抽出設定
+    const auto& Options = LoadInputData.ExtractOptions;
+    FString OptionString = FString::Printf(TEXT("%.17g,%.17g,%.17g|%d|%d|%u|%u|%d|%d|%.9g|%d|%d|%d|%d|%u|%d|%d|%s|%d"),
+        Options.reference_point.x, Options.reference_point.y, Options.reference_point.z,
+        static_cast<int32>(Options.mesh_axes), static_cast<int32>(Options.mesh_granularity),
+        Options.max_lod, Options.min_lod, Options.export_appearance, Options.grid_count_of_side, Options.unit_scale,
+        Options.coordinate_zone_id, Options.exclude_city_object_outside_extent, Options.exclude_polygons_outside_extent,
+        Options.enable_texture_packing, Options.texture_packing_resolution, Options.attach_map_tile, Options.map_tile_zoom_level,
+        UTF8_TO_TCHAR(Options.map_tile_url), LoadInputData.bIncludeAttrInfo);
+    for (const auto& Extent : LoadInputData.Extents) {
+        OptionString += FString::Printf(TEXT("|%.17g,%.17g,%.17g,%.17g"), Extent.min.latitude, Extent.min.longitude, Extent.max.latitude, Extent.max.longitude);
+    }
+    Hash.UpdateWithString(*OptionString, OptionString.Len());
+
+    Hash.Final();
+    FSHAHash Result;
+    Hash.GetHash(Result.Hash);
+    return Result.ToString();
+}
+
+bool FPLATEAUExtractedModelCache::Load(const FString& Key, FPLATEAUExtractedModel& OutExtractedModel) {
+    if (!IsEnabled() || Key.IsEmpty())
+        return false;
+
+    const auto Path = GetCacheFilePath(Key);
+    TArray<uint8> FileBytes;
+    if (!FFileHelper::LoadFileToArray(FileBytes, *Path, FILEREAD_Silent))
+        return false;
+
+    FMemoryReader HeaderReader(FileBytes);
+    uint32 Magic = 0, Version = 0;
+    HeaderReader << Magic << Version;
+    if (HeaderReader.IsError() || Magic != CacheMagic || Version != CacheVersion)
+        return false;
+
+    const TArray<uint8> CompressedBytes(FileBytes.GetData() + HeaderReader.Tell(), FileBytes.Num() - HeaderReader.Tell());
+    FArchiveLoadCompressedProxy Ar(CompressedBytes, NAME_Zlib);
+
+    auto Model = plateau::polygonMesh::Model::createModel();
+    int32 RootNodeCount = 0;
+    Ar << RootNodeCount;
+    if (Ar.IsError() || RootNodeCount < 0)
+        return false;
+    Model->reserveRootNodes(RootNodeCount);
+    for (int32 i = 0; i < RootNodeCount; ++i) {
+        plateau::polygonMesh::Node Node("");
+        if (!ReadNode(Ar, Node)) {
+            UE_LOG(LogTemp, Warning, TEXT("Extracted model cache is corrupted: %s"), *Path);
+            return false;
+        }
+        Model->addNode(std::move(Node));
+    }
+    Model->assignNodeHierarchy();
+
+    TMap<FString, FString> SerializedCityObjects;
+    Ar << SerializedCityObjects;
+    if (Ar.IsError())
+        return false;
+
+    // テクスチャパッキングや地図タイルで生成された画像は削除されている可能性がある
+    for (size_t i = 0; i < Model->getRootNodeCount(); ++i) {
+        if (!HasAllTextures(Model->getRootNodeAt(i)))
+            return false;
+    }
+
+    // 最終アクセス日時として更新日時を使用する
+    IFileManager::Get().SetTimeStamp(*Path, FDateTime::UtcNow());
+
+    OutExtractedModel.Model = Model;
+    OutExtractedModel.SerializedCityObjects = MoveTemp(SerializedCityObjects);
+    return true;
+}
+
+void FPLATEAUExtractedModelCache::SerializeCityObjects(const plateau::polygonMesh::Model& Model, const std::shared_ptr<const citygml::CityModel> CityModel,
+    const FLoadInputData& LoadInputData, TMap<FString, FString>& OutSerializedCityObjects) {
+    FPLATEAUNativeCityObjectSerialization Serializer;
+    for (size_t i = 0; i < Model.getRootNodeCount(); ++i) {
+        SerializeCityObjectsRecursive(Model.getRootNodeAt(i), CityModel, LoadInputData, Serializer, OutSerializedCityObjects);
+    }
+}
+
+bool FPLATEAUExtractedModelCache::Save(const FString& Key, const FPLATEAUExtractedModel& ExtractedModel) {
+    if (!IsEnabled() || Key.IsEmpty() || ExtractedModel.Model == nullptr)
+        return false;
+
+    TArray<uint8> CompressedBytes;
+    {
+        FArchiveSaveCompressedProxy Ar(CompressedBytes, NAME_Zlib);
+        const auto& Model = *ExtractedModel.Model;
+        int32 RootNodeCount = Model.getRootNodeCount();
+        Ar << RootNodeCount;
+        for (int32 i = 0; i < RootNodeCount; ++i) {
+            WriteNode(Ar, Model.getRootNodeAt(i));
+        }
+        auto SerializedCityObjects = ExtractedModel.SerializedCityObjects;
+        Ar << SerializedCityObjects;
+        Ar.Flush();
+    }
+
+    TArray<uint8> FileBytes;
+    FMemoryWriter Writer(FileBytes);
+    uint32 Magic = CacheMagic, Version = CacheVersion;
+    Writer << Magic << Version;
+    FileBytes.Append(CompressedBytes);
+
+    // 書き込み途中のファイルを読まないよう一時ファイルに書いてから移動する
+    const auto Path = GetCacheFilePath(Key);
+    const auto TempPath = Path + FString::Printf(TEXT(".%u.tmp"), FPlatformTLS::GetCurrentThreadId());
+    if (!FFileHelper::SaveArrayToFile(FileBytes, *TempPath))
+        return false;
+
+    FScopeLock Lock(&CacheDirectorySection);
+    const int64 ReplacedSize = FMath::Max<int64>(IFileManager::Get().FileSize(*Path), 0);
+    if (!IFileManager::Get().Move(*Path, *TempPath, true, true, false, true)) {
+        IFileManager::Get().Delete(*TempPath, false, true, true);
+        return false;
+    }
+
+    // ディレクトリの走査は初回と上限を超えた場合のみ行う
+    if (CachedTotalSize < 0) {
+        TrimCache();
+        return true;
+    }
+    CachedTotalSize += FileBytes.Num() - ReplacedSize;
+    if (CacheBudget < CachedTotalSize)
+        TrimCache();
+    return true;
+}
+
+bool FPLATEAUExtractedModelCache::IsEnabled() {
+    return bCacheEnabled;
+}
+
+void FPLATEAUExtractedModelCache::SetEnabled(const bool bInEnabled) {
+    bCacheEnabled = bInEnabled;
+}
+
+void FPLATEAUExtractedModelCache::SetCacheBudget(const int64 BudgetBytes) {
+    CacheBudget = FMath::Max<int64>(BudgetBytes, 0);
+    FScopeLock Lock(&CacheDirectorySection);
+    TrimCache();
+}
+
+void FPLATEAUExtractedModelCache::ClearCache() {
+    FScopeLock Lock(&CacheDirectorySection);
+    IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+    CachedTotalSize = 0;
+}
+
+FString FPLATEAUExtractedModelCache::GetCacheDirectory() {
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()) / TEXT("PLATEAU/ExtractedModelCache");
+}
@@ -0,0 +1,118 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUImportMemoryBudget.h"
+#include "PLATEAUCityModelLoader.h"
+#include "HAL/PlatformMemory.h"
+
+namespace {
+    // サイズ不明のGMLに用いるファイルサイズ
+    constexpr int64 UnknownFileSize = 64ll * 1024 * 1024;
+
+    // テッセレーション込みのパース結果はGMLのファイルサイズの数倍となる
+    constexpr double ParseBytesPerFileByte = 6.0;
+
+    /**
+     * @brief GMLの1バイトあたりの抽出結果とFMeshDescriptionのバイト数です。
+     * 座標以外の記述が多いパッケージは小さく、メッシュが細かくなる起伏は大きくなります。
+     */
+    double GetMeshBytesPerFileByte(const plateau::dataset::PredefinedCityModelPackage Package) {
+        using plateau::dataset::PredefinedCityModelPackage;
+        switch (Package) {
+        case PredefinedCityModelPackage::Relief:
+            return 4.0;
+        case PredefinedCityModelPackage::Building:
+        case PredefinedCityModelPackage::Bridge:
+            return 2.0;
+        case PredefinedCityModelPackage::UrbanPlanningDecision:
+        case PredefinedCityModelPackage::LandUse:
+        case PredefinedCityModelPackage::DisasterRisk:
+            return 1.0;
+        default:
+            return 1.5;
+        }
+    }
+}
+
+FPLATEAUImportMemoryBudget::FPLATEAUImportMemoryBudget(const int64 InBudgetBytes, const int32 InMaxConcurrentCount)
+    : BudgetBytes(InBudgetBytes)
+    , MaxConcurrentCount(InMaxConcurrentCount) {
+}
+
+FPLATEAUImportMemoryBudget::FEstimate FPLATEAUImportMemoryBudget::Estimate(const int64 FileSize, const FLoadInputData& LoadInputData) {
+    const double Size = static_cast<double>(FileSize < 0 ? UnknownFileSize : FileSize);
+    const auto& ExtractOptions = LoadInputData.ExtractOptions;
+
+    double MeshBytesPerFileByte = GetMeshBytesPerFileByte(LoadInputData.Package);
+    // LOD3以上は部材単位の細かい形状を含む
+    if (ExtractOptions.max_lod >= 3)
+        MeshBytesPerFileByte *= 2.0;
+    // テクスチャのデコード結果
+    if (ExtractOptions.export_appearance)
+        MeshBytesPerFileByte += 1.0;
+    if (ExtractOptions.attach_map_tile)
+        MeshBytesPerFileByte += 1.0;
+
+    FEstimate Estimate;
+    Estimate.ParseBytes = static_cast<int64>(Size * ParseBytesPerFileByte);
+    Estimate.MeshBytes = static_cast<int64>(Size * MeshBytesPerFileByte);
+    return Estimate;
+}
+
+bool FPLATEAUImportMemoryBudget::TryAcquire(const FEstimate& Estimate) {
+    FScopeLock Lock(&Section);
+    const bool bCountExceeded = 0 < MaxConcurrentCount && MaxConcurrentCount <= ActiveCount;
+    const bool bBytesExceeded = 0 < BudgetBytes && 0 < ActiveCount && BudgetBytes < ReservedBytes + Estimate.GetTotalBytes();
+    if (bCountExceeded || bBytesExceeded) {
+        // 同じGMLの待機中に繰り返し呼ばれるため、待機の開始時のみ数える
+        if (!bLastAcquireFailed)
+            ++Stats.DeferredCount;
+        bLastAcquireFailed = true;
+        return false;
+    }
+
+    bLastAcquireFailed = false;
+    ReservedBytes += Estimate.GetTotalBytes();
+    ++ActiveCount;
+    Stats.PeakReservedBytes = FMath::Max(Stats.PeakReservedBytes, ReservedBytes);
+    Stats.PeakConcurrentGmlCount = FMath::Max(Stats.PeakConcurrentGmlCount, ActiveCount);
+    UpdatePhysicalPeak();
+    return true;
+}
+
+void FPLATEAUImportMemoryBudget::ReleaseParse(const FEstimate& Estimate) {
+    FScopeLock Lock(&Section);
+    UpdatePhysicalPeak();
+    ReservedBytes -= Estimate.ParseBytes;
+}
+
+void FPLATEAUImportMemoryBudget::Release(const FEstimate& Estimate, const bool bParseReleased) {
+    FScopeLock Lock(&Section);
+    UpdatePhysicalPeak();
+    ReservedBytes -= bParseReleased ? Estimate.MeshBytes : Estimate.GetTotalBytes();
+    --ActiveCount;
+    check(0 <= ReservedBytes && 0 <= ActiveCount);
+}
+
+int64 FPLATEAUImportMemoryBudget::GetReservedBytes() const {
+    FScopeLock Lock(&Section);
+    return ReservedBytes;
+}
+
+int32 FPLATEAUImportMemoryBudget::GetActiveCount() const {
+    FScopeLock Lock(&Section);
+    return ActiveCount;
+}
+
+int64 FPLATEAUImportMemoryBudget::GetBudgetBytes() const {
+    return BudgetBytes;
+}
+
+FPLATEAUImportMemoryStats FPLATEAUImportMemoryBudget::GetStats() const {
+    FScopeLock Lock(&Section);
+    return Stats;
+}
+
+void FPLATEAUImportMemoryBudget::UpdatePhysicalPeak() {
+    const int64 UsedPhysical = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical);
+    Stats.PeakUsedPhysicalBytes = FMath::Max(Stats.PeakUsedPhysicalBytes, UsedPhysical);
+}
@@ -17,6 +17,7 @@
 #include <Reconstruct/PLATEAUModelLandscape.h>
 #include <Reconstruct/PLATEAUMeshLoaderForLandscapeMesh.h>
 #include <Reconstruct/PLATEAUModelAlignLand.h>
+#include <Reconstruct/PLATEAUModelTextureAtlas.h>
 #include <PLATEAUModelFiltering.h>
 #include <Util/PLATEAUReconstructUtil.h>
 #include <Util/PLATEAUComponentUtil.h>
@@ -90,7 +91,7 @@ plateau::dataset::PredefinedCityModelPackage APLATEAUInstancedCityModel::GetCity
 APLATEAUInstancedCityModel* APLATEAUInstancedCityModel::FilterByLods(const plateau::dataset::PredefinedCityModelPackage InPackage, const TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod>& PackageToLodRangeMap, const bool bOnlyMaxLod) {
     bIsFiltering = true;
     FPLATEAUModelFiltering Filter;
-    Filter.FilterByLods(GetGmlComponents(), InPackage, PackageToLodRangeMap, bOnlyMaxLod);
+    Filter.FilterByIndex(GetFilteringIndex(), InPackage, PackageToLodRangeMap, bOnlyMaxLod, citygml::CityObject::CityObjectsType::COT_All);
     bIsFiltering = false;
     return this;
 }
@@ -100,11 +101,38 @@ APLATEAUInstancedCityModel* APLATEAUInstancedCityModel::FilterByFeatureTypes(con
         return FilterByFeatureTypesLegacy(InCityObjectType);
     bIsFiltering = true;
     FPLATEAUModelFiltering Filter;
-    Filter.FilterByFeatureTypes(GetGmlComponents(), InCityObjectType);
+    Filter.FilterByFeatureTypesByIndex(GetFilteringIndex(), InCityObjectType);
     bIsFiltering = false;
     return this;
 }
 
+APLATEAUInstancedCityModel* APLATEAUInstancedCityModel::FilterByLodsAndFeatureTypes(const plateau::dataset::PredefinedCityModelPackage InPackage, const TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod>& PackageToLodRangeMap, const bool bOnlyMaxLod, const citygml::CityObject::CityObjectsType InCityObjectType) {
+    if (!HasAttributeInfo())
+        return FilterByLods(InPackage, PackageToLodRangeMap, bOnlyMaxLod)->FilterByFeatureTypesLegacy(InCityObjectType);
+
+    bIsFiltering = true;
+    FPLATEAUModelFiltering Filter;
+    Filter.FilterByIndex(GetFilteringIndex(), InPackage, PackageToLodRangeMap, bOnlyMaxLod, InCityObjectType);
+    bIsFiltering = false;
+    return this;
+}
+
+void APLATEAUInstancedCityModel::BuildFilteringIndex() {
+    if (!FilteringIndex.IsValid())
+        FilteringIndex = MakeShared<FPLATEAUModelFilteringIndex>();
+    FilteringIndex->Build(GetGmlComponents());
+}
+
+void APLATEAUInstancedCityModel::InvalidateFilteringIndex() {
+    FilteringIndex.Reset();
+}
+
+const FPLATEAUModelFilteringIndex& APLATEAUInstancedCityModel::GetFilteringIndex() {
+    if (!FilteringIndex.IsValid() || !FilteringIndex->IsUpToDate(GetGmlComponents()))
+        BuildFilteringIndex();
+    return *FilteringIndex;
+}
+
 APLATEAUInstancedCityModel* APLATEAUInstancedCityModel::FilterByFeatureTypesLegacy(const citygml::CityObject::CityObjectsType InCityObjectType) {
     bIsFiltering = true;
     FPLATEAUModelFiltering Filter;
@@ -230,10 +258,7 @@ UE::Tasks::TTask<TArray<USceneComponent*>> APLATEAUInstancedCityModel::ClassifyT
                 const auto& Targets = ModelClassification.FilterComponentsByConvertGranularity(TargetCityObjects, Granularity);
                 if (Targets.Num() > 0) {
                     ModelClassification.SetConvertGranularity(Granularity);
-                    auto GranularityTask = ReconstructTask(ModelClassification, Targets, bDestroyOriginal);
-                    AddNested(GranularityTask);
-                    GranularityTask.Wait();
-                    JoinedResults.Append(GranularityTask.GetResult());
+                    JoinedResults.Append(ClassifyWithGranularity(ModelClassification, Targets, bDestroyOriginal));
                 }
             }
             return JoinedResults;
@@ -241,14 +266,31 @@ UE::Tasks::TTask<TArray<USceneComponent*>> APLATEAUInstancedCityModel::ClassifyT
         else {
             const auto& ConvertGranularity = FPLATEAUReconstructUtil::GetConvertGranularityFromReconstructType(ReconstructType);
             ModelClassification.SetConvertGranularity(ConvertGranularity);
-            auto Task = ReconstructTask(ModelClassification, TargetCityObjects, bDestroyOriginal);
-            return Task.GetResult();
+            return ClassifyWithGranularity(ModelClassification, TargetCityObjects, bDestroyOriginal);
         }
 
         });
     return ClassifyTask;
 }
 
+TArray<USceneComponent*> APLATEAUInstancedCityModel::ClassifyWithGranularity(FPLATEAUModelClassification& ModelClassification, const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, bool bDestroyOriginal) {
+    // 元のコンポーネントを残す場合はマテリアルを直接書き換えられないので、全て再生成する
+    TArray<UPLATEAUCityObjectGroup*> RemainingTargets;
+    TArray<USceneComponent*> Results;
+    if (bDestroyOriginal)
+        Results = ModelClassification.ClassifyInPlace(TargetCityObjects, RemainingTargets);
+    else
+        RemainingTargets = TargetCityObjects;
+
+    if (RemainingTargets.Num() > 0) {
+        auto Task = ReconstructTask(ModelClassification, RemainingTargets, bDestroyOriginal);
+        AddNested(Task);
+        Task.Wait();
+        Results.Append(Task.GetResult());
+    }
+    return Results;
+}
+
 
 UE::Tasks::TTask<TArray<USceneComponent*>> APLATEAUInstancedCityModel::ReconstructTask(FPLATEAUModelReconstruct& ModelReconstruct, const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, bool bDestroyOriginal) {
 
@@ -261,12 +303,22 @@ UE::Tasks::TTask<TArray<USceneComponent*>> APLATEAUInstancedCityModel::Reconstru
             ->Wait();
 
         const auto ResultComponents = ModelReconstruct.ReconstructFromConvertedModel(converted);
+        FFunctionGraphTask::CreateAndDispatchWhenReady([&]() {
+            InvalidateFilteringIndex();
+            }, TStatId(), NULL, ENamedThreads::GameThread)
+            ->Wait();
         return ResultComponents;
     });
     return ConvertTask;
 }
 
 //Landscape
+FPLATEAUTextureAtlasResult APLATEAUInstancedCityModel::AtlasTextures(const int32 AtlasSize) {
+    FPLATEAUModelTextureAtlas TextureAtlas(this);
+    TextureAtlas.AtlasSize = AtlasSize;
+    return TextureAtlas.Execute();
+}
+
 UE::Tasks::FTask APLATEAUInstancedCityModel::CreateLandscape(const TArray<USceneComponent*>& TargetComponents, FPLATEAULandscapeParam Param, bool bDestroyOriginal) {
 
     UE_LOG(LogTemp, Log, TEXT("CreateLandscape: %d %s"), TargetComponents.Num(), bDestroyOriginal ? TEXT("True") : TEXT("False"));
@@ -294,7 +346,7 @@ UE::Tasks::FTask APLATEAUInstancedCityModel::CreateLandscape(const TArray<UScene
                 }, TStatId(), NULL, ENamedThreads::GameThread)->Wait();
         }
 
-        for (const auto Result : Results) {
+        for (const auto& Result : Results) {
             //　平滑化Mesh / Landscape生成
             if (Param.ConvertTerrain) {
                 if (!Param.ConvertToLandscape) {
@@ -304,10 +356,10 @@ UE::Tasks::FTask APLATEAUInstancedCityModel::CreateLandscape(const TArray<UScene
                 }
                 else {
                     //Landscape生成
-                    TArray<uint16> HeightData(Result.Data->data(), Result.Data->size());
-                    //LandScape  
+                    // 高さデータは大きいため、ワーカースレッドでは複製せずResultのバッファをそのままゲームスレッドへ渡す
                     FFunctionGraphTask::CreateAndDispatchWhenReady(
-                        [&, HeightData, Result, Param ] {
+                        [&]() {
+                            const TConstArrayView<uint16> HeightData(Result.Data->data(), static_cast<int32>(Result.Data->size()));
                             auto LandActor = Landscape.CreateLandScape(GetWorld(), Param.NumSubsections, Param.SubsectionSizeQuads,
                             Param.ComponentCountX, Param.ComponentCountY,
                             Param.TextureWidth, Param.TextureHeight,
@@ -318,11 +370,15 @@ UE::Tasks::FTask APLATEAUInstancedCityModel::CreateLandscape(const TArray<UScene
             }
         }
 
+        // ハイトマップ画像の書き出し完了を待ってから終了を通知する
+        FPLATEAUReconstructUtil::FlushHeightmapImages();
+
         FFunctionGraphTask::CreateAndDispatchWhenReady([&, TargetCityObjects, bDestroyOriginal, Results]() {
 
             // Landscape コンポーネント削除
             if (Param.ConvertTerrain)
                 FPLATEAUComponentUtil::DestroyOrHideComponents(TargetCityObjects, bDestroyOriginal);
+            InvalidateFilteringIndex();
 
             //終了イベント通知
             EPLATEAULandscapeCreationResult Res = Results.Num() > 0 ? EPLATEAULandscapeCreationResult::Success : EPLATEAULandscapeCreationResult::Fail;
@@ -341,7 +397,11 @@ TArray<UPLATEAUCityObjectGroup*> APLATEAUInstancedCityModel::AlignLand(TArray<He
     //Lod3Roadの場合はLandscape生成前にResultのHeightmap情報書き換え&TargetCityObjectsからLod3Road除外
     if (Param.InvertRoadLod3) 
         Results = ModelAlign.UpdateHeightMapForLod3Road(TargetCityObjects);
-    if (Param.AlignLand) 
-        ModelAlign.Align(TargetCityObjects);
+    if (Param.AlignLand) {
+        // 元の形状を残す場合はその場で書き換えられないので、全てモデル経由で作り直す
+        ModelAlign.Align(TargetCityObjects, bDestroyOriginal);
+        // その場で高さ合わせしたコンポーネントは作り直していないので削除対象に含めない
+        return ModelAlign.GetReloadedCityObjects();
+    }
     return TargetCityObjects;
 }
\ No newline at end of file
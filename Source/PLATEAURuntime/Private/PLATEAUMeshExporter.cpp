@@ -222,8 +222,10 @@ void FPLATEAUMeshExporter::CreateMesh(plateau::polygonMesh::Mesh& OutMesh, UScen
     }
 
     auto GeoRef = TargetActor->GeoReference.GetData();
+    // 共有メッシュはローカル座標のため、モデルの座標に戻す
+    const FVector SharedMeshOffset = FPLATEAUComponentUtil::GetSharedMeshOffset(StaticMeshComponent);
     for (uint32 i = 0; i < RenderMesh.VertexBuffers.PositionVertexBuffer.GetNumVertices(); i++) {
-        const auto VertexPosition = RenderMesh.VertexBuffers.PositionVertexBuffer.VertexPosition(i);
+        const auto VertexPosition = FVector(RenderMesh.VertexBuffers.PositionVertexBuffer.VertexPosition(i)) + SharedMeshOffset;
         TVec3d Vertex;
         if (Option.TransformType == EMeshTransformType::PlaneRect)
             Vertex = TVec3d(VertexPosition.X + ReferencePoint.X, VertexPosition.Y + ReferencePoint.Y, VertexPosition.Z + ReferencePoint.Z);
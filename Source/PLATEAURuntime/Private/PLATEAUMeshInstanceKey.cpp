@@ -0,0 +1,81 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUMeshInstanceKey.h"
+#include <plateau/polygon_mesh/mesh.h>
+#include <citygml/material.h>
+
+namespace {
+    /**
+     * @brief 頂点座標の量子化単位(cm)
+     */
+    constexpr double PositionQuantum = 0.01;
+
+    /**
+     * @brief UV, マテリアルパラメータの量子化単位
+     */
+    constexpr double ValueQuantum = 1e-6;
+
+    int64 Quantize(const double Value, const double Quantum) {
+        return FMath::RoundToInt64(Value / Quantum);
+    }
+}
+
+FPLATEAUMeshInstanceKey::FPLATEAUMeshInstanceKey(const plateau::polygonMesh::Mesh& InMesh) {
+    const auto& Vertices = InMesh.getVertices();
+    const auto& Indices = InMesh.getIndices();
+    const auto& UV1 = InMesh.getUV1();
+    const auto& UV4 = InMesh.getUV4();
+    const auto& SubMeshes = InMesh.getSubMeshes();
+    if (Vertices.empty() || Indices.empty())
+        return;
+
+    FBox Bounds(ForceInit);
+    for (const auto& Vertex : Vertices)
+        Bounds += FVector(Vertex.x, Vertex.y, Vertex.z);
+    Origin = Bounds.Min;
+
+    Signature.Reserve(4 + Vertices.size() * 3 + Indices.size() + (UV1.size() + UV4.size()) * 2 + SubMeshes.size() * 16);
+    Signature.Add(Vertices.size());
+    Signature.Add(Indices.size());
+    Signature.Add(UV1.size());
+    Signature.Add(UV4.size());
+    for (const auto& Vertex : Vertices) {
+        Signature.Add(Quantize(Vertex.x - Origin.X, PositionQuantum));
+        Signature.Add(Quantize(Vertex.y - Origin.Y, PositionQuantum));
+        Signature.Add(Quantize(Vertex.z - Origin.Z, PositionQuantum));
+    }
+    for (const auto Index : Indices)
+        Signature.Add(Index);
+    for (const auto& UV : UV1) {
+        Signature.Add(Quantize(UV.x, ValueQuantum));
+        Signature.Add(Quantize(UV.y, ValueQuantum));
+    }
+    // UV4は地物のインデックスのため、同じ並びであれば地物構成も同じとみなせる
+    for (const auto& UV : UV4) {
+        Signature.Add(Quantize(UV.x, ValueQuantum));
+        Signature.Add(Quantize(UV.y, ValueQuantum));
+    }
+
+    // FSubMeshMaterialSetで比較される内容と同じ情報を含める
+    for (const auto& SubMesh : SubMeshes) {
+        Signature.Add(SubMesh.getStartIndex());
+        Signature.Add(SubMesh.getEndIndex());
+        Signature.Add(SubMesh.getGameMaterialID());
+        Signature.Add(FCrc::StrCrc32(UTF8_TO_TCHAR(SubMesh.getTexturePath().c_str())));
+        const auto Material = SubMesh.getMaterial();
+        Signature.Add(Material != nullptr);
+        if (Material == nullptr)
+            continue;
+        for (const auto& Color : { Material->getDiffuse(), Material->getSpecular(), Material->getEmissive() }) {
+            Signature.Add(Quantize(Color.x, ValueQuantum));
+            Signature.Add(Quantize(Color.y, ValueQuantum));
+            Signature.Add(Quantize(Color.z, ValueQuantum));
+        }
+        Signature.Add(Quantize(Material->getShininess(), ValueQuantum));
+        Signature.Add(Quantize(Material->getTransparency(), ValueQuantum));
+        Signature.Add(Quantize(Material->getAmbientIntensity(), ValueQuantum));
+        Signature.Add(Material->isSmooth());
+    }
+
+    Hash = FCrc::MemCrc32(Signature.GetData(), Signature.Num() * Signature.GetTypeSize());
+}
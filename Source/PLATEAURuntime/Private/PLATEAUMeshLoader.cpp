@@ -20,6 +20,7 @@
 #include "Util/PLATEAUComponentUtil.h"
 #include "Util/PLATEAUGmlUtil.h"
 #include "PLATEAUModelFiltering.h"
+#include "PLATEAUExtractedModelCache.h"
 #include "Math/UnrealMathUtility.h"
 
 #if WITH_EDITOR
@@ -31,6 +32,43 @@ DECLARE_STATS_GROUP(TEXT("PLATEAUMeshLoader"), STATGROUP_PLATEAUMeshLoader, STAT
 
 DECLARE_CYCLE_STAT(TEXT("Mesh.Build"), STAT_Mesh_Build, STATGROUP_PLATEAUMeshLoader);
 
+namespace {
+    /**
+     * @brief ビルド済みのStaticMeshをComponentに設定し、コリジョンを設定します。
+     */
+    void SetBuiltStaticMesh(UStaticMeshComponent* Component, UStaticMesh* Mesh) {
+        if (Component == nullptr)
+            return;
+        // Runtime用にSetStaticMeshを行う際にMobilityを適切な値に変更
+        Component->SetMobility(EComponentMobility::Type::Stationary);
+        Component->SetStaticMesh(Mesh);
+        Component->SetMobility(EComponentMobility::Type::Static);
+
+        // Collision情報設定
+        Mesh->CreateBodySetup();
+        Mesh->GetBodySetup()->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+    }
+
+    /**
+     * @brief ランタイムではSourceModelを持てないため、MeshDescriptionから直接ビルドします。
+     */
+    void BuildStaticMeshFromMeshDescription(UStaticMesh* StaticMesh, const FMeshDescription& MeshDescription) {
+        UStaticMesh::FBuildMeshDescriptionsParams Params;
+        Params.bFastBuild = true;
+        Params.bBuildSimpleCollision = false;
+        // CTF_UseComplexAsSimpleのコリジョン作成にCPU側の頂点データが必要
+        Params.bAllowCpuAccess = true;
+        StaticMesh->BuildFromMeshDescriptions({ &MeshDescription }, Params);
+    }
+
+    void TranslateMeshDescription(FMeshDescription& MeshDescription, const FVector3f& Offset) {
+        const auto VertexPositions = FStaticMeshAttributes(MeshDescription).GetVertexPositions();
+        for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs()) {
+            VertexPositions[VertexID] += Offset;
+        }
+    }
+}
+
 FSubMeshMaterialSet::FSubMeshMaterialSet() {
 }
 
@@ -311,28 +349,45 @@ void FPLATEAUMeshLoader::LoadModel(AActor* ModelActor, USceneComponent* ParentCo
     UE_LOG(LogTemp, Log, TEXT("Model->getRootNodeCount(): %d"), Model->getRootNodeCount());
     LastCreatedComponents.Empty();
     this->PathToTexture = FPathToTexture();
+    SharedStaticMeshes.Reset();
+    CancelFlag = bCanceled;
     for (int i = 0; i < Model->getRootNodeCount(); i++) {
         if (bCanceled->Load(EMemoryOrder::Relaxed))
             break;
 
         LoadNodeRecursive(ParentComponent, Model->getRootNodeAt(i), LoadInputData, CityModel, *ModelActor);
 
+#if WITH_EDITOR
         // メッシュをワールド内にビルド
         const auto CopiedStaticMeshes = StaticMeshes;
         FFunctionGraphTask::CreateAndDispatchWhenReady(
-            [CopiedStaticMeshes, &bCanceled]() {
+            [this, CopiedStaticMeshes, &bCanceled]() {
+                if (IsLoadAborted())
+                    return;
                 UStaticMesh::BatchBuild(CopiedStaticMeshes, true, [&bCanceled](UStaticMesh* mesh) {
                     return bCanceled->Load(EMemoryOrder::Relaxed);
                     });
             }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+#endif
         StaticMeshes.Reset();
     }
 
     // 最大LOD以外の形状を非表示化
     FFunctionGraphTask::CreateAndDispatchWhenReady(
-        [ParentComponent]() {
+        [this, ParentComponent]() {
+            if (IsLoadAborted())
+                return;
             FPLATEAUModelFiltering().FilterLowLods(ParentComponent);
         }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+    CancelFlag = nullptr;
+}
+
+void FPLATEAUMeshLoader::LoadModel(AActor* ModelActor, USceneComponent* ParentComponent,
+    const FPLATEAUExtractedModel& ExtractedModel,
+    const FLoadInputData& LoadInputData, TAtomic<bool>* bCanceled) {
+    SerializedCityObjects = &ExtractedModel.SerializedCityObjects;
+    LoadModel(ModelActor, ParentComponent, ExtractedModel.Model, LoadInputData, nullptr, bCanceled);
+    SerializedCityObjects = nullptr;
 }
 
 void FPLATEAUMeshLoader::LoadNodeRecursive(
@@ -341,6 +396,10 @@ void FPLATEAUMeshLoader::LoadNodeRecursive(
     const FLoadInputData& InLoadInputData,
     const std::shared_ptr<const citygml::CityModel> InCityModel,
     AActor& InActor) {
+    // キャンセルされた場合は以降のノードを作成しない
+    if (CancelFlag != nullptr && CancelFlag->Load(EMemoryOrder::Relaxed))
+        return;
+
     const auto Component = LoadNode(InParentComponent, InNode, InLoadInputData, InCityModel, InActor);
     const size_t ChildNodeCount = InNode.getChildCount();
     for (int i = 0; i < ChildNodeCount; i++) {
@@ -355,17 +414,38 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
     const FLoadInputData& LoadInputData,
     const std::shared_ptr<const citygml::CityModel>
     CityModel, FNodeHierarchy NodeHier) {
+    // 平行移動を除いて同一形状のメッシュが作成済みであれば共有する
+    FPLATEAUMeshInstanceKey InstanceKey;
+    if (LoadInputData.bEnableMeshInstancing) {
+        InstanceKey = FPLATEAUMeshInstanceKey(InMesh);
+        if (UStaticMesh** SharedStaticMesh = SharedStaticMeshes.Find(InstanceKey))
+            return CreateSharedStaticMeshComponent(Actor, ParentComponent, InMesh, LoadInputData, CityModel, NodeHier,
+                *SharedStaticMesh, InstanceKey.Origin);
+    }
+
     // コンポーネント作成
     const FString NodeName = NodeHier.NodeName;
-    UStaticMesh* StaticMesh;
+    UStaticMesh* StaticMesh = nullptr;
     UStaticMeshComponent* Component = nullptr;
     UStaticMeshComponent* ComponentRef = nullptr;
     TArray<FSubMeshMaterialSet> SubMeshMaterialSets;
-    FMeshDescription* MeshDescription;
+#if WITH_EDITOR
+    const bool bRuntimeBuild = UseRuntimeMeshBuild();
+#else
+    constexpr bool bRuntimeBuild = true;
+#endif
+    FMeshDescription* MeshDescription = nullptr;
+    FMeshDescription RuntimeMeshDescription;
+    if (bRuntimeBuild) {
+        FStaticMeshAttributes(RuntimeMeshDescription).Register();
+        MeshDescription = &RuntimeMeshDescription;
+    }
     {
         FFunctionGraphTask::CreateAndDispatchWhenReady(
             [this, &LoadInputData, &NodeHier, &InMesh, &CityModel, &Component, &Actor, &StaticMesh, &MeshDescription,
-            &NodeName]() {
+            &NodeName, bRuntimeBuild]() {
+                if (IsLoadAborted())
+                    return;
 
                 Component = GetStaticMeshComponentForCondition(Actor, NAME_None, NodeHier, InMesh, LoadInputData, CityModel);
                 if (bAutomationTest) {
@@ -378,37 +458,37 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                 StaticMesh = CreateStaticMesh(InMesh, Component, FName(NodeName));
 #if WITH_EDITOR
                 Component->bVisualizeComponent = true;
-                MeshDescription = StaticMesh->CreateMeshDescription(0);
+                if (!bRuntimeBuild)
+                    MeshDescription = StaticMesh->CreateMeshDescription(0);
 #endif
             }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
     }
+    if (Component == nullptr)
+        return nullptr;
 
     ConvertMesh(InMesh, *MeshDescription, SubMeshMaterialSets, InvertMeshNormal(), MergeTriangles());
     ModifyMeshDescription(*MeshDescription);
+    // 共有可能なメッシュはOriginを原点とするローカル座標にする
+    if (InstanceKey.IsValid())
+        TranslateMeshDescription(*MeshDescription, FVector3f(-InstanceKey.Origin));
 
 #if WITH_EDITOR
-    FFunctionGraphTask::CreateAndDispatchWhenReady(
-        [&StaticMesh]() {
-            StaticMesh->CommitMeshDescription(0);
-        }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
-#endif
+    if (!bRuntimeBuild) {
+        FFunctionGraphTask::CreateAndDispatchWhenReady(
+            [this, &StaticMesh]() {
+                if (IsLoadAborted())
+                    return;
+                StaticMesh->CommitMeshDescription(0);
+            }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
         StaticMeshes.Add(StaticMesh);
-#if WITH_EDITOR
         StaticMesh->OnPostMeshBuild().AddLambda(
             [Component](UStaticMesh* Mesh) {
-                if (Component == nullptr)
-                    return;
-                // Runtime用にSetStaticMeshを行う際にMobilityを適切な値に変更
-                Component->SetMobility(EComponentMobility::Type::Stationary);
-                Component->SetStaticMesh(Mesh);
-                Component->SetMobility(EComponentMobility::Type::Static);
-
-                // Collision情報設定
-                Mesh->CreateBodySetup();
-                Mesh->GetBodySetup()->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+                SetBuiltStaticMesh(Component, Mesh);
             });
 
-        const FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([&StaticMesh] {
+        const FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([this, &StaticMesh] {
+            if (IsLoadAborted())
+                return;
             // ビルド前にImportVersionを設定する必要がある。
             StaticMesh->ImportVersion = EImportStaticMeshVersion::LastVersion;
 
@@ -417,6 +497,7 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
             //StaticMesh->SetFlags();
             }, TStatId(), nullptr, ENamedThreads::GameThread);
         Task->Wait();
+    }
 #endif
         //PolygonGroup数の整合性チェック
         if (SubMeshMaterialSets.Num() != MeshDescription->PolygonGroups().Num())
@@ -424,8 +505,11 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
 
         const auto ComponentSetupTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
             [&SubMeshMaterialSets, this, &Component, &StaticMesh, &MeshDescription, &Actor, &ParentComponent, &
-                ComponentRef, &LoadInputData, &NodeHier]
+                ComponentRef, &LoadInputData, &NodeHier, &InstanceKey]
             {
+                if (IsLoadAborted())
+                    return;
+
                 for (const auto& SubMeshValue : SubMeshMaterialSets)
                 {
                     UMaterialInterface** SharedMatPtr = CachedMaterials.Find(SubMeshValue);
@@ -459,7 +543,7 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                                 }
                                 else // テクスチャ未ロードの場合、ロードします。
                                 {
-                                    Texture = FPLATEAUTextureLoader::Load(TexturePath, OverwriteTexture());
+                                    Texture = LoadTexture(TexturePath);
                                     // なければnullptrを返します。
                                     PathToTexture.Add(TexturePath, Texture);
                                 }
@@ -506,6 +590,10 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                     StaticMesh->GetName());
 
                 Component->Rename(*NewUniqueName, nullptr, REN_DontCreateRedirectors);
+                if (InstanceKey.IsValid()) {
+                    Component->ComponentTags.Add(FPLATEAUComponentUtil::SharedMeshComponentTag);
+                    Component->SetRelativeLocation(InstanceKey.Origin);
+                }
                 Actor.AddInstanceComponent(Component);
                 Component->RegisterComponent();
                 Component->AttachToComponent(&ParentComponent, FAttachmentTransformRules::KeepWorldTransform);
@@ -515,17 +603,94 @@ UStaticMeshComponent* FPLATEAUMeshLoader::CreateStaticMeshComponent(AActor& Acto
                 ComponentRef = Component;
             }, TStatId(), nullptr, ENamedThreads::GameThread);
         ComponentSetupTask->Wait();
+        if (ComponentRef == nullptr)
+            return nullptr;
+
+        if (bRuntimeBuild) {
+            FFunctionGraphTask::CreateAndDispatchWhenReady(
+                [this, &StaticMesh, &MeshDescription, &Component]() {
+                    if (IsLoadAborted())
+                        return;
+                    BuildStaticMeshFromMeshDescription(StaticMesh, *MeshDescription);
+                    SetBuiltStaticMesh(Component, StaticMesh);
+                }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+        }
+
+        if (InstanceKey.IsValid())
+            SharedStaticMeshes.Add(InstanceKey, StaticMesh);
 
         LastCreatedComponents.Add(ComponentRef);
         return ComponentRef;
 }
 
+UStaticMeshComponent* FPLATEAUMeshLoader::CreateSharedStaticMeshComponent(AActor& Actor, USceneComponent& ParentComponent,
+    const plateau::polygonMesh::Mesh& InMesh,
+    const FLoadInputData& LoadInputData,
+    const std::shared_ptr<const citygml::CityModel> CityModel,
+    FNodeHierarchy NodeHier,
+    UStaticMesh* SharedStaticMesh,
+    const FVector& Origin) {
+    UStaticMeshComponent* Component = nullptr;
+    // 同じルートノード内で作成されたメッシュはまだビルドされていない
+    const bool bPendingBuild = StaticMeshes.Contains(SharedStaticMesh);
+    FFunctionGraphTask::CreateAndDispatchWhenReady(
+        [this, &Actor, &ParentComponent, &InMesh, &LoadInputData, &CityModel, &NodeHier, SharedStaticMesh, &Origin, bPendingBuild, &Component]() {
+            if (IsLoadAborted())
+                return;
+
+            Component = GetStaticMeshComponentForCondition(Actor, NAME_None, NodeHier, InMesh, LoadInputData, CityModel);
+            if (bAutomationTest) {
+                Component->Mobility = EComponentMobility::Movable;
+            }
+            else {
+                Component->Mobility = EComponentMobility::Static;
+            }
+            Component->DepthPriorityGroup = SDPG_World;
+            Component->ComponentTags.Add(FPLATEAUComponentUtil::SharedMeshComponentTag);
+            Component->SetRelativeLocation(Origin);
+
+            const FString NewUniqueName =
+                FPLATEAUComponentUtil::MakeUniqueGmlObjectName(&Actor, UPLATEAUCityObjectGroup::StaticClass(),
+                NodeHier.NodeName);
+            Component->Rename(*NewUniqueName, nullptr, REN_DontCreateRedirectors);
+            Actor.AddInstanceComponent(Component);
+            Component->RegisterComponent();
+            Component->AttachToComponent(&ParentComponent, FAttachmentTransformRules::KeepWorldTransform);
+#if WITH_EDITOR
+            Component->bVisualizeComponent = true;
+            if (bPendingBuild) {
+                const auto CreatedComponent = Component;
+                SharedStaticMesh->OnPostMeshBuild().AddLambda(
+                    [CreatedComponent](UStaticMesh* Mesh) {
+                        SetBuiltStaticMesh(CreatedComponent, Mesh);
+                    });
+            }
+            else {
+                SetBuiltStaticMesh(Component, SharedStaticMesh);
+            }
+            Component->PostEditChange();
+#else
+            // ランタイムでは作成時にビルド済み
+            SetBuiltStaticMesh(Component, SharedStaticMesh);
+#endif
+        }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+    if (Component == nullptr)
+        return nullptr;
+
+    LastCreatedComponents.Add(Component);
+    return Component;
+}
+
 UStaticMeshComponent* FPLATEAUMeshLoader::GetStaticMeshComponentForCondition(AActor& Actor, EName Name, FNodeHierarchy NodeHier,
     const plateau::polygonMesh::Mesh& InMesh, 
     const FLoadInputData& LoadInputData, const std::shared_ptr <const citygml::CityModel> CityModel) {
     if (LoadInputData.bIncludeAttrInfo) {
         const auto& PLATEAUCityObjectGroup = NewObject<UPLATEAUCityObjectGroup>(&Actor, NAME_None);
-        PLATEAUCityObjectGroup->SerializeCityObject(NodeHier.GetNameAsStandardString(), InMesh, LoadInputData, CityModel);
+        const FString* SerializedCityObject = SerializedCityObjects != nullptr ? SerializedCityObjects->Find(NodeHier.NodePath) : nullptr;
+        if (SerializedCityObject != nullptr)
+            PLATEAUCityObjectGroup->SetSerializedCityObjects(*SerializedCityObject, LoadInputData.ExtractOptions.mesh_granularity);
+        else
+            PLATEAUCityObjectGroup->SerializeCityObject(NodeHier.GetNameAsStandardString(), InMesh, LoadInputData, CityModel);
         return PLATEAUCityObjectGroup;
     }
     //属性情報を追加しない場合は、UPLATEAUStaticMeshComponentとする
@@ -607,13 +772,28 @@ USceneComponent* FPLATEAUMeshLoader::LoadNode(USceneComponent* ParentComponent,
     const std::shared_ptr<const citygml::CityModel> CityModel,
     AActor& Actor) {
     if (Node.getMesh() == nullptr) {
-        const auto& CityObject = CityModel->getCityObjectById(Node.getName());
+        // シリアライズ済みの地物情報がある場合はCityModelを参照しない
+        const FString* SerializedCityObject = SerializedCityObjects != nullptr
+            ? SerializedCityObjects->Find(FPLATEAUGmlUtil::GetNodePathString(Node))
+            : nullptr;
+        const citygml::CityObject* CityObject = SerializedCityObject == nullptr && CityModel != nullptr
+            ? CityModel->getCityObjectById(Node.getName())
+            : nullptr;
         USceneComponent* Comp = nullptr;
         UClass* StaticClass;
         const FString DesiredName = FString(UTF8_TO_TCHAR(Node.getName().c_str()));
         const FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([&, DesiredName] {
+            if (IsLoadAborted())
+                return;
+
             // CityObjectがある場合はUPLATEAUCityObjectGroupとする
-            if (CityObject != nullptr && LoadInputData.bIncludeAttrInfo) { 
+            if (SerializedCityObject != nullptr && LoadInputData.bIncludeAttrInfo) {
+                StaticClass = UPLATEAUCityObjectGroup::StaticClass();
+                const auto& PLATEAUCityObjectGroup = NewObject<UPLATEAUCityObjectGroup>(&Actor, NAME_None);
+                PLATEAUCityObjectGroup->SetSerializedCityObjects(*SerializedCityObject, LoadInputData.ExtractOptions.mesh_granularity);
+                Comp = PLATEAUCityObjectGroup;
+            }
+            else if (CityObject != nullptr && LoadInputData.bIncludeAttrInfo) { 
                 StaticClass = UPLATEAUCityObjectGroup::StaticClass();
                 const auto& PLATEAUCityObjectGroup = NewObject<UPLATEAUCityObjectGroup>(&Actor, NAME_None);
                 PLATEAUCityObjectGroup->SerializeCityObject(Node, CityObject, LoadInputData.ExtractOptions.mesh_granularity);
@@ -674,6 +854,22 @@ bool FPLATEAUMeshLoader::MergeTriangles() {
     return false;
 }
 
+UTexture2D* FPLATEAUMeshLoader::LoadTexture(const FString& TexturePath) {
+    return FPLATEAUTextureLoader::Load(TexturePath, OverwriteTexture());
+}
+
 bool FPLATEAUMeshLoader::OverwriteTexture() {
     return true;
 }
+
+bool FPLATEAUMeshLoader::IsLoadAborted() const {
+    return CancelFlag != nullptr && CancelFlag->Load(EMemoryOrder::Relaxed);
+}
+
+bool FPLATEAUMeshLoader::UseRuntimeMeshBuild() const {
+#if WITH_EDITOR
+    return false;
+#else
+    return true;
+#endif
+}
@@ -198,7 +198,7 @@ void FPLATEAUModelFiltering::FilterByFeatureTypesLegacyCacheCityGml(const TArray
         FPLATEAUCityObjectInfo GmlInfo;
         GmlInfo.DatasetName = DatasetName;
         GmlInfo.GmlName = FPLATEAUGmlUtil::GetGmlFileName(GmlComponent);
-        const auto CityModel = UPLATEAUCityGmlProxy::Load(GmlInfo);
+        UPLATEAUCityGmlProxy::LoadIndex(GmlInfo);
     }
 }
 
@@ -235,20 +235,20 @@ void FPLATEAUModelFiltering::FilterByFeatureTypesLegacyMain(const TArray<TObject
                 FPLATEAUCityObjectInfo GmlInfo;
                 GmlInfo.DatasetName = DatasetName;
                 GmlInfo.GmlName = FPLATEAUGmlUtil::GetGmlFileName(GmlComponent);
-                const auto CityModel = UPLATEAUCityGmlProxy::Load(GmlInfo);
+                const auto CityModelIndex = UPLATEAUCityGmlProxy::LoadIndex(GmlInfo);
 
-                if (CityModel == nullptr) {
+                if (CityModelIndex == nullptr) {
                     UE_LOG(LogTemp, Error, TEXT("Invalid Dataset or Gml : %s, %s"), *GmlInfo.DatasetName, *GmlInfo.GmlName);
                     continue;
                 }
 
-                const auto CityObject = CityModel->getCityObjectById(TCHAR_TO_UTF8(*FeatureID));
+                const auto CityObject = CityModelIndex->Find(FeatureID);
                 if (CityObject == nullptr) {
                     UE_LOG(LogTemp, Error, TEXT("Invalid ID : %s"), *FeatureID);
                     continue;
                 }
 
-                const auto CityObjectType = CityObject->getType();
+                const auto CityObjectType = CityObject->Type;
                 if (static_cast<uint64_t>(InCityObjectType & CityObjectType))
                     continue;
 
@@ -257,4 +257,170 @@ void FPLATEAUModelFiltering::FilterByFeatureTypesLegacyMain(const TArray<TObject
             }
         }
     }
-}
\ No newline at end of file
+}
+namespace {
+    /**
+     * @brief 変化がある場合のみ表示状態とコリジョン設定を変更します
+     * @return 変更した場合true
+     */
+    bool ApplyVisibilityIfChanged(USceneComponent* Component, const bool bVisible, const bool bUpdateCollision) {
+        bool bChanged = false;
+        if (Component->GetVisibleFlag() != bVisible) {
+            Component->SetVisibility(bVisible, false);
+            bChanged = true;
+        }
+
+        if (!bUpdateCollision)
+            return bChanged;
+
+        if (const auto& StaticMeshComponent = Cast<UStaticMeshComponent>(Component); StaticMeshComponent != nullptr) {
+            const auto Response = bVisible ? ECR_Block : ECR_Ignore;
+            if (StaticMeshComponent->GetCollisionResponseToChannel(ECC_Visibility) != Response) {
+                StaticMeshComponent->SetCollisionResponseToChannel(ECC_Visibility, Response);
+                bChanged = true;
+            }
+        }
+        return bChanged;
+    }
+
+    uint32 LodRangeMask(const int MinLod, const int MaxLod) {
+        uint32 Mask = 0;
+        for (int Lod = FMath::Max(MinLod, 0); Lod <= FMath::Min(MaxLod, 31); ++Lod) {
+            Mask |= 1u << Lod;
+        }
+        return Mask;
+    }
+}
+
+void FPLATEAUModelFilteringIndex::Build(const TArray<TObjectPtr<USceneComponent>>& GmlComponents) {
+    Gmls.Reset();
+    Features.Reset();
+    Entries.Reset();
+
+    for (const auto& GmlComponent : GmlComponents) {
+        // BillboardComponentを無視
+        if (GmlComponent == nullptr || GmlComponent.GetName().Contains("BillboardComponent"))
+            continue;
+
+        const int32 GmlIndex = Gmls.Add({ FPLATEAUGmlUtil::GetCityModelPackage(GmlComponent), GmlComponent.Get() });
+        // 起伏は重いため地物タイプでのフィルタリングから意図的に除外
+        const bool bFilterByType = Gmls[GmlIndex].Package != plateau::dataset::PredefinedCityModelPackage::Relief;
+
+        // 地物名ごとに存在するLODを集計
+        TMap<FString, uint32> NameToLodMask;
+        const int32 FirstFeature = Features.Num();
+        TArray<FString> FeatureNames;
+        for (const auto& LodComponent : GmlComponent->GetAttachChildren()) {
+            const auto Lod = FPLATEAUComponentUtil::ParseLodComponent(LodComponent);
+            for (const auto& FeatureComponent : LodComponent->GetAttachChildren()) {
+                const auto& Name = FeatureNames.Add_GetRef(FPLATEAUComponentUtil::GetOriginalComponentName(FeatureComponent));
+                if (0 <= Lod && Lod < 32)
+                    NameToLodMask.FindOrAdd(Name) |= 1u << Lod;
+
+                const int32 FeatureIndex = Features.Add({ GmlIndex, Lod, 0 });
+
+                TArray<USceneComponent*> Components;
+                Components.Add(FeatureComponent);
+                FeatureComponent->GetChildrenComponents(true, Components);
+                for (const auto& Component : Components) {
+                    if (Component->GetName().Contains("BillboardComponent"))
+                        continue;
+
+                    uint64 CityObjectType = 0;
+                    if (const auto& CityObjectGroup = Cast<UPLATEAUCityObjectGroup>(Component); bFilterByType && CityObjectGroup != nullptr) {
+                        const auto ObjList = CityObjectGroup->GetAllRootCityObjects();
+                        if (ObjList.Num() == 1)
+                            CityObjectType = UPLATEAUCityObjectBlueprintLibrary::GetTypeAsInt64(ObjList[0].Type);
+                    }
+                    Entries.Add({ Component, FeatureIndex, CityObjectType });
+                }
+            }
+        }
+
+        for (int32 i = 0; i < FeatureNames.Num(); ++i) {
+            Features[FirstFeature + i].SameNameLodMask = NameToLodMask.FindRef(FeatureNames[i]);
+        }
+    }
+}
+
+bool FPLATEAUModelFilteringIndex::IsUpToDate(const TArray<TObjectPtr<USceneComponent>>& GmlComponents) const {
+    int32 GmlCount = 0;
+    for (const auto& GmlComponent : GmlComponents) {
+        if (GmlComponent != nullptr && !GmlComponent.GetName().Contains("BillboardComponent"))
+            ++GmlCount;
+    }
+    if (GmlCount != Gmls.Num())
+        return false;
+
+    for (const auto& Gml : Gmls) {
+        if (!Gml.Component.IsValid())
+            return false;
+    }
+    for (const auto& Entry : Entries) {
+        if (!Entry.Component.IsValid())
+            return false;
+    }
+    return true;
+}
+
+int32 FPLATEAUModelFiltering::FilterByIndex(const FPLATEAUModelFilteringIndex& Index, const plateau::dataset::PredefinedCityModelPackage InPackage,
+    const TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod>& PackageToLodRangeMap, const bool bOnlyMaxLod, const citygml::CityObject::CityObjectsType InCityObjectType) {
+
+    // GMLごとの表示対象LODのビットマスク
+    TArray<uint32> GmlLodMasks;
+    GmlLodMasks.SetNumZeroed(Index.Gmls.Num());
+    for (int32 i = 0; i < Index.Gmls.Num(); ++i) {
+        const auto Package = Index.Gmls[i].Package;
+        if ((Package & InPackage) == plateau::dataset::PredefinedCityModelPackage::None)
+            continue;
+
+        if (const auto LodRange = PackageToLodRangeMap.Find(Package))
+            GmlLodMasks[i] = LodRangeMask(LodRange->MinLod, LodRange->MaxLod);
+    }
+
+    TBitArray<> FeatureVisible(false, Index.Features.Num());
+    for (int32 i = 0; i < Index.Features.Num(); ++i) {
+        const auto& Feature = Index.Features[i];
+        const uint32 LodMask = GmlLodMasks[Feature.GmlIndex];
+        if (Feature.Lod < 0 || 32 <= Feature.Lod || (LodMask & (1u << Feature.Lod)) == 0)
+            continue;
+
+        // 範囲内でより大きいLODに同名の地物が存在する場合は非表示
+        const uint32 HigherLodMask = LodMask & ~((2u << Feature.Lod) - 1);
+        FeatureVisible[i] = !bOnlyMaxLod || (Feature.SameNameLodMask & HigherLodMask) == 0;
+    }
+
+    const uint64 TypeMask = static_cast<uint64>(InCityObjectType);
+    int32 ChangedCount = 0;
+    for (const auto& Entry : Index.Entries) {
+        const auto Component = Entry.Component.Get();
+        if (Component == nullptr)
+            continue;
+
+        bool bVisible = FeatureVisible[Entry.FeatureIndex];
+        if (bVisible && Entry.CityObjectType != 0 && (TypeMask & Entry.CityObjectType) == 0)
+            bVisible = false;
+
+        if (ApplyVisibilityIfChanged(Component, bVisible, true))
+            ++ChangedCount;
+    }
+    return ChangedCount;
+}
+
+int32 FPLATEAUModelFiltering::FilterByFeatureTypesByIndex(const FPLATEAUModelFilteringIndex& Index, const citygml::CityObject::CityObjectsType InCityObjectType) {
+    const uint64 TypeMask = static_cast<uint64>(InCityObjectType);
+    int32 ChangedCount = 0;
+    for (const auto& Entry : Index.Entries) {
+        const auto Component = Entry.Component.Get();
+        //この時点で不可視状態ならLodフィルタリングで不可視化されたことになるので無視
+        if (Component == nullptr || Entry.CityObjectType == 0 || !Component->IsVisible())
+            continue;
+
+        if (TypeMask & Entry.CityObjectType)
+            continue;
+
+        if (ApplyVisibilityIfChanged(Component, false, true))
+            ++ChangedCount;
+    }
+    return ChangedCount;
+}
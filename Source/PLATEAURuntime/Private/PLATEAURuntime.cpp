@@ -3,6 +3,7 @@
 #include "PLATEAURuntime.h"
 
 #include "Interfaces/IPluginManager.h"
+#include "Util/PLATEAUReconstructUtil.h"
 
 #define LOCTEXT_NAMESPACE "FPLATEAURuntimeModule"
 
@@ -11,7 +12,10 @@ void FPLATEAURuntimeModule::StartupModule() {
     // IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 }
 
-void FPLATEAURuntimeModule::ShutdownModule() {}
+void FPLATEAURuntimeModule::ShutdownModule() {
+    // 書き出し途中のハイトマップ画像を残さない
+    FPLATEAUReconstructUtil::FlushHeightmapImages();
+}
 
 FString FPLATEAURuntimeModule::GetContentDir() {
     return IPluginManager::Get()
@@ -7,6 +7,7 @@
 #include "RHICommandList.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "UObject/SavePackage.h"
+#include "Misc/PackageName.h"
 #include "Engine/Texture2D.h"
 #include "Misc/FileHelper.h"
 #include "TextureResource.h"
@@ -264,7 +265,7 @@ UTexture2D* FPLATEAUTextureLoader::Load(const FString& TexturePath_SlashOrBackSl
     return NewTexture;
 }
 
-UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
+UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath, int64* OutMip0Bytes) {
     int32 Width, Height;
     EPixelFormat PixelFormat;
     TArray64<uint8> UncompressedData;
@@ -273,6 +274,8 @@ UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
 
     // Mip0Data
     const int32 Mip0Size = Width * Height * GPixelFormats[PixelFormat].BlockBytes;
+    if (OutMip0Bytes != nullptr)
+        *OutMip0Bytes = Mip0Size;
 
     // テクスチャ作成
     UTexture2D* NewTexture = nullptr;
@@ -306,3 +309,54 @@ UTexture2D* FPLATEAUTextureLoader::LoadTransient(const FString& TexturePath) {
 
     return NewTexture;
 }
+
+#if WITH_EDITOR
+UTexture2D* FPLATEAUTextureLoader::CreateTextureAsset(const FString& TextureName, const int32 Width, const int32 Height, const TArray64<uint8>& BGRA8Data, const FString& SourceDirectory) {
+    check(BGRA8Data.Num() == static_cast<int64>(Width) * Height * 4);
+
+    // 既存のアセット・画像ファイルを上書きしないよう、使用されていない名前になるまで末尾に番号を付ける
+    const auto GetTexturePath = [&SourceDirectory](const FString& Name) {
+        return FPaths::ConvertRelativePathToFull(SourceDirectory / Name + TEXT(".png"));
+    };
+    FString UniqueTextureName = TextureName;
+    FString PackageName = TEXT("/Game/PLATEAU/Textures/") + UniqueTextureName;
+    for (int32 Suffix = 1; FindPackage(nullptr, *PackageName) != nullptr || FPackageName::DoesPackageExist(PackageName) || IFileManager::Get().FileExists(*GetTexturePath(UniqueTextureName)); ++Suffix) {
+        UniqueTextureName = FString::Printf(TEXT("%s_%d"), *TextureName, Suffix);
+        PackageName = TEXT("/Game/PLATEAU/Textures/") + UniqueTextureName;
+    }
+
+    // 3Dファイルエクスポートでテクスチャを参照できるよう画像ファイルとして書き出す
+    const auto TexturePath = GetTexturePath(UniqueTextureName);
+    IImageWrapperModule& ImageWrapperModule = FModuleManager::Get().LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+    const auto ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+    if (!ImageWrapper->SetRaw(BGRA8Data.GetData(), BGRA8Data.Num(), Width, Height, ERGBFormat::BGRA, 8) ||
+        !FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *TexturePath)) {
+        UE_LOG(LogTemp, Error, TEXT("Failed to save texture file : %s"), *TexturePath);
+    }
+
+    UPackage* Package = CreatePackage(*PackageName);
+    UTexture2D* NewTexture = NewObject<UTexture2D>(Package, *UniqueTextureName, RF_Public | RF_Standalone);
+    NewTexture->NeverStream = true;
+
+    NewTexture->PreEditChange(nullptr);
+    // ソースパス設定 (Loadと同じくPLATEAUフォルダからの相対パス)
+    const auto PLATEAURootDir = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(
+        *(FPaths::ProjectContentDir() + FString("PLATEAU/")));
+    NewTexture->AssetImportData->SetSourceFiles({ TexturePath.Replace(*PLATEAURootDir, *FString("../")) });
+    NewTexture->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, BGRA8Data.GetData());
+    NewTexture->PostEditChange();
+
+    Package->MarkPackageDirty();
+    Package->SetLoadedPath(FPackagePath::FromLocalPath(TexturePath));
+    FAssetRegistryModule::AssetCreated(NewTexture);
+    const FString PackageFileName = FPackageName::LongPackageNameToFilename(
+        PackageName, FPackageName::GetAssetPackageExtension());
+    FSavePackageArgs Args;
+    Args.SaveFlags = SAVE_NoError;
+    Args.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
+    Args.Error = GError;
+    UPackage::SavePackage(Package, NewTexture, *PackageFileName, Args);
+
+    return NewTexture;
+}
+#endif
@@ -14,6 +14,7 @@
 #include "Landscape.h"
 #include "Util/PLATEAUReconstructUtil.h"
 #include "Util/PLATEAUComponentUtil.h"
+#include "Async/ParallelFor.h"
 
 
 FPLATEAUMeshLoaderForHeightmap::FPLATEAUMeshLoaderForHeightmap() : FPLATEAUMeshLoader(FPLATEAUCachedMaterialArray())
@@ -26,34 +27,36 @@ FPLATEAUMeshLoaderForHeightmap::FPLATEAUMeshLoaderForHeightmap(const bool InbAut
 TArray<HeightmapCreationResult> FPLATEAUMeshLoaderForHeightmap::CreateHeightMap(
     AActor* ModelActor,
     const std::shared_ptr<plateau::polygonMesh::Model> Model, FPLATEAULandscapeParam Param) {
-    TArray<HeightmapCreationResult> CreationResults;
+    TArray<const plateau::polygonMesh::Node*> TargetNodes;
     for (int i = 0; i < Model->getRootNodeCount(); i++) {
-        LoadNodeRecursiveForHeightMap(Model->getRootNodeAt(i), *ModelActor, Param, CreationResults);
+        LoadNodeRecursiveForHeightMap(Model->getRootNodeAt(i), TargetNodes);
     }
+
+    // ハイトマップ生成はノード間で独立しているため並列に実行します。結果の順序はノードの走査順のままです。
+    TArray<HeightmapCreationResult> CreationResults;
+    CreationResults.SetNum(TargetNodes.Num());
+    ParallelFor(TargetNodes.Num(), [&](int32 Index) {
+        const auto& Node = *TargetNodes[Index];
+        CreationResults[Index] = CreateHeightMapFromMesh(*Node.getMesh(), FString(UTF8_TO_TCHAR(Node.getName().c_str())), *ModelActor, Param);
+    }, EParallelForFlags::Unbalanced);
     return CreationResults;
 }
 
 void FPLATEAUMeshLoaderForHeightmap::LoadNodeRecursiveForHeightMap(
-    const plateau::polygonMesh::Node& InNode,
-    AActor& InActor, FPLATEAULandscapeParam Param, TArray<HeightmapCreationResult> &Results) {
-    LoadNodeForHeightMap(InNode, InActor, Param, Results);
+    const plateau::polygonMesh::Node& InNode, TArray<const plateau::polygonMesh::Node*>& OutTargetNodes) {
+    LoadNodeForHeightMap(InNode, OutTargetNodes);
     const size_t ChildNodeCount = InNode.getChildCount();
     for (int i = 0; i < ChildNodeCount; i++) {
         const auto& TargetNode = InNode.getChildAt(i);
-        LoadNodeRecursiveForHeightMap( TargetNode, InActor, Param, Results);
+        LoadNodeRecursiveForHeightMap(TargetNode, OutTargetNodes);
     }
 }
 
 void FPLATEAUMeshLoaderForHeightmap::LoadNodeForHeightMap(
-    const plateau::polygonMesh::Node& InNode,
-    AActor& InActor, FPLATEAULandscapeParam Param, TArray<HeightmapCreationResult> &Results) {
-    if (InNode.getMesh() == nullptr || InNode.getMesh()->getVertices().size() == 0) {
-        const FString DesiredName = FString(UTF8_TO_TCHAR(InNode.getName().c_str()));      
-    }
-    else {
-        auto Result = CreateHeightMapFromMesh(*InNode.getMesh(), FString(UTF8_TO_TCHAR(InNode.getName().c_str())), InActor, Param);
-        Results.Add(Result);
-    }
+    const plateau::polygonMesh::Node& InNode, TArray<const plateau::polygonMesh::Node*>& OutTargetNodes) {
+    if (InNode.getMesh() == nullptr || InNode.getMesh()->getVertices().size() == 0)
+        return;
+    OutTargetNodes.Add(&InNode);
 }
 
 HeightmapCreationResult FPLATEAUMeshLoaderForHeightmap::CreateHeightMapFromMesh(
@@ -65,9 +68,10 @@ HeightmapCreationResult FPLATEAUMeshLoaderForHeightmap::CreateHeightMapFromMesh(
     TVec2d Offset(Param.Offset.X, Param.Offset.Y);
     std::vector<uint16_t> heightMapData = generator.generateFromMesh(InMesh, Param.TextureWidth, Param.TextureHeight, Offset, 
         plateau::geometry::CoordinateSystem::ESU, Param.FillEdges, Param.ApplyBlurFilter, ExtMin, ExtMax, UVMin, UVMax);
-    
+    TSharedPtr<std::vector<uint16_t>> sharedData = MakeShared<std::vector<uint16_t>>(MoveTemp(heightMapData));
+
     // Heightmap Image Output 
-    FPLATEAUReconstructUtil::SaveHeightmapImage(Param.HeightmapImageOutput, "HM_" + NodeName , Param.TextureWidth, Param.TextureHeight, heightMapData.data());
+    FPLATEAUReconstructUtil::SaveHeightmapImageAsync(Param.HeightmapImageOutput, "HM_" + NodeName , Param.TextureWidth, Param.TextureHeight, sharedData);
 
     //Texture
     FString TexturePath;
@@ -77,7 +81,6 @@ HeightmapCreationResult FPLATEAUMeshLoaderForHeightmap::CreateHeightMapFromMesh(
         TexturePath = FString(subMesh.getTexturePath().c_str());
     }
 
-    TSharedPtr<std::vector<uint16_t>> sharedData = MakeShared<std::vector<uint16_t>>(heightMapData);
     HeightmapCreationResult Result{ NodeName, sharedData ,ExtMin, ExtMax , UVMin, UVMax, TexturePath };
     return Result;
 }
@@ -7,6 +7,12 @@
 #include <plateau/height_map_generator/heightmap_generator.h>
 #include "Util/PLATEAUReconstructUtil.h"
 #include "Util/PLATEAUComponentUtil.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshOperations.h"
+#include "MathUtil.h"
+#include "Async/ParallelFor.h"
 
 FPLATEAUModelAlignLand::FPLATEAUModelAlignLand():heightmapAligner(HeightOffset, plateau::geometry::CoordinateSystem::ESU) {}
 FPLATEAUModelAlignLand::FPLATEAUModelAlignLand(APLATEAUInstancedCityModel* Actor) :heightmapAligner(HeightOffset, plateau::geometry::CoordinateSystem::ESU) {
@@ -54,15 +60,138 @@ void FPLATEAUModelAlignLand::SetResults(const TArray<HeightmapCreationResult> Re
     }
 }
 
-TArray<USceneComponent*> FPLATEAUModelAlignLand::Align(const TArray<UPLATEAUCityObjectGroup*> TargetCityObjects) {
+TArray<UPLATEAUCityObjectGroup*> FPLATEAUModelAlignLand::AlignInPlace(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects) {
+#if WITH_EDITOR
+    struct FInPlaceTarget {
+        UStaticMesh* StaticMesh = nullptr;
+        FMeshDescription* MeshDescription = nullptr;
+        TArray<UPLATEAUCityObjectGroup*> Components;
+        bool bNeedsSubdivision = false;
+        bool bMoved = false;
+    };
+    TArray<FInPlaceTarget> Targets;
+    TArray<UPLATEAUCityObjectGroup*> Remaining;
+
+    FFunctionGraphTask::CreateAndDispatchWhenReady([&] {
+        TMap<UStaticMesh*, int32> MeshToTarget;
+        for (const auto Component : TargetCityObjects) {
+            UStaticMesh* StaticMesh = Component != nullptr ? Component->GetStaticMesh() : nullptr;
+            // 非表示のものはエクスポートされないので従来通りモデル経由で扱う
+            // 共有メッシュは他のコンポーネントにも影響するため、同様にモデル経由で個別のメッシュとして作り直す
+            if (StaticMesh == nullptr || !Component->IsVisible() || Component->ComponentHasTag(FPLATEAUComponentUtil::SharedMeshComponentTag)) {
+                Remaining.Add(Component);
+                continue;
+            }
+            if (const auto Index = MeshToTarget.Find(StaticMesh)) {
+                Targets[*Index].Components.Add(Component);
+                continue;
+            }
+            FMeshDescription* MeshDescription = StaticMesh->GetMeshDescription(0);
+            if (MeshDescription == nullptr) {
+                Remaining.Add(Component);
+                continue;
+            }
+            auto& Target = Targets.AddDefaulted_GetRef();
+            Target.StaticMesh = StaticMesh;
+            Target.MeshDescription = MeshDescription;
+            Target.Components.Add(Component);
+            MeshToTarget.Add(StaticMesh, Targets.Num() - 1);
+        }
+    }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+
+    TArray<const plateau::heightMapAligner::HeightMapFrame*> Frames;
+    for (int i = 0; i < heightmapAligner.heightmapCount(); ++i)
+        Frames.Add(&heightmapAligner.getHeightMapFrameAt(i));
+
+    // エクスポート時と同じく、ローカル座標をESUとして扱いハイトマップから高さを求めます。
+    ParallelFor(Targets.Num(), [&](int32 Index) {
+        auto& Target = Targets[Index];
+        auto& MeshDescription = *Target.MeshDescription;
+        FStaticMeshAttributes Attributes(MeshDescription);
+        auto Positions = Attributes.GetVertexPositions();
+
+        const float MaxEdgeLengthSquared = MaxEdgeLength * MaxEdgeLength;
+        for (const FTriangleID TriangleID : MeshDescription.Triangles().GetElementIDs()) {
+            const auto Vertices = MeshDescription.GetTriangleVertices(TriangleID);
+            for (int32 i = 0; i < 3; ++i) {
+                if (FVector3f::DistSquared(Positions[Vertices[i]], Positions[Vertices[(i + 1) % 3]]) > MaxEdgeLengthSquared) {
+                    Target.bNeedsSubdivision = true;
+                    return;
+                }
+            }
+        }
+
+        for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs()) {
+            const FVector3f Position = Positions[VertexID];
+            auto Enu = plateau::geometry::GeoReference::convertAxisToENU(plateau::geometry::CoordinateSystem::ESU, TVec3d(Position.X, Position.Y, Position.Z));
+            for (const auto Frame : Frames) {
+                if (Enu.x < Frame->min_x || Frame->max_x < Enu.x || Enu.y < Frame->min_y || Frame->max_y < Enu.y)
+                    continue;
+                Enu.z = Frame->posToHeight(TVec2d(Enu.x, Enu.y), HeightOffset);
+                break;
+            }
+            const auto Esu = plateau::geometry::GeoReference::convertAxisFromENUTo(plateau::geometry::CoordinateSystem::ESU, Enu);
+            const FVector3f NewPosition(Esu.x, Esu.y, Esu.z);
+            if (!NewPosition.Equals(Position, KINDA_SMALL_NUMBER)) {
+                Positions[VertexID] = NewPosition;
+                Target.bMoved = true;
+            }
+        }
+
+        // メッシュは法線を再計算せずにビルドされるため、変形後の形状に合わせてここで計算し直す
+        if (Target.bMoved) {
+            FStaticMeshOperations::ComputeTriangleTangentsAndNormals(MeshDescription, FMathf::Epsilon);
+            FStaticMeshOperations::ComputeTangentsAndNormals(MeshDescription, EComputeNTBsFlags::WeightedNTBs | EComputeNTBsFlags::Normals | EComputeNTBsFlags::Tangents);
+        }
+    }, EParallelForFlags::Unbalanced);
+
+    FFunctionGraphTask::CreateAndDispatchWhenReady([&] {
+        TArray<UStaticMesh*> MovedMeshes;
+        for (const auto& Target : Targets) {
+            if (Target.bNeedsSubdivision) {
+                Remaining.Append(Target.Components);
+                continue;
+            }
+            if (!Target.bMoved)
+                continue;
+            Target.StaticMesh->CommitMeshDescription(0);
+            MovedMeshes.Add(Target.StaticMesh);
+        }
+        if (MovedMeshes.Num() > 0)
+            UStaticMesh::BatchBuild(MovedMeshes, true);
+        for (const auto& Target : Targets) {
+            if (!Target.bMoved)
+                continue;
+            for (const auto Component : Target.Components) {
+                Component->UpdateBounds();
+                Component->MarkRenderStateDirty();
+                // StaticMeshが同じままなので、変形前の形状で構築されたBVHを明示的に破棄する
+                Component->InvalidateSpatialIndex();
+            }
+        }
+        UE_LOG(LogTemp, Log, TEXT("AlignInPlace: %d meshes aligned in place (%d rebuilt), %d components need reload"), Targets.Num(), MovedMeshes.Num(), Remaining.Num());
+    }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+
+    return Remaining;
+#else
+    return TargetCityObjects;
+#endif
+}
+
+TArray<USceneComponent*> FPLATEAUModelAlignLand::Align(const TArray<UPLATEAUCityObjectGroup*> TargetCityObjects, bool bAllowInPlace) {
+
+    // 細分化が不要なものはその場で高さ合わせし、残りのみモデル経由で作り直します。
+    ReloadedCityObjects = bAllowInPlace ? AlignInPlace(TargetCityObjects) : TargetCityObjects;
+    if (ReloadedCityObjects.Num() == 0)
+        return TArray<USceneComponent*>();
 
-    std::shared_ptr<plateau::polygonMesh::Model> Model = CreateModelFromTargets(TargetCityObjects);
+    std::shared_ptr<plateau::polygonMesh::Model> Model = CreateModelFromTargets(ReloadedCityObjects);
 
     // 高さ合わせをします。
     heightmapAligner.align(*Model, MaxEdgeLength);
 
     // 元コンポーネントを覚えておきます。
-    const auto& ComponentsMap = FPLATEAUComponentUtil::CreateComponentsMapWithNodePath(TargetCityObjects);
+    const auto& ComponentsMap = FPLATEAUComponentUtil::CreateComponentsMapWithNodePath(ReloadedCityObjects);
 
     FPLATEAUMeshLoaderCloneComponent MeshLoader(false, FPLATEAUCachedMaterialArray());
 
@@ -102,9 +231,9 @@ TArray<HeightmapCreationResult> FPLATEAUModelAlignLand::UpdateHeightMapForLod3Ro
         NewResults.Add(NewResult);
 
         // Heightmap Image Output 
-        FPLATEAUReconstructUtil::SaveHeightmapImage(LandscapeParam.HeightmapImageOutput,
+        FPLATEAUReconstructUtil::SaveHeightmapImageAsync(LandscapeParam.HeightmapImageOutput,
             "HM_ALN_" + NewResult.NodeName , 
-            LandscapeParam.TextureWidth, LandscapeParam.TextureHeight, NewResult.Data->data());
+            LandscapeParam.TextureWidth, LandscapeParam.TextureHeight, NewResult.Data);
     }
     HeightmapCreationResults = NewResults;
     return HeightmapCreationResults;
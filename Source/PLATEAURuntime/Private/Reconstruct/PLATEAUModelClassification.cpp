@@ -0,0 +1,142 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "Reconstruct/PLATEAUModelClassification.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+
+namespace {
+    //コンポーネント内の地物の分類結果を集計します
+    struct FInPlaceClassification {
+        UMaterialInterface* Material = nullptr;
+        bool bHasResult = false;
+        bool bMixed = false;
+
+        void Add(UMaterialInterface* InMaterial) {
+            if (!bHasResult) {
+                Material = InMaterial;
+                bHasResult = true;
+            }
+            else if (Material != InMaterial) {
+                bMixed = true;
+            }
+        }
+    };
+
+    void CollectCityObjects(const FPLATEAUCityObject& CityObject, TSet<FString>& VisitedGmlIds, TArray<const FPLATEAUCityObject*>& OutCityObjects) {
+        bool bAlreadyVisited = false;
+        VisitedGmlIds.Add(CityObject.GmlID, &bAlreadyVisited);
+        if (!bAlreadyVisited)
+            OutCityObjects.Add(&CityObject);
+        for (const auto& Child : CityObject.Children)
+            CollectCityObjects(Child, VisitedGmlIds, OutCityObjects);
+    }
+}
+
+void FPLATEAUModelClassification::FindClassificationMaterials(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<UMaterialInterface*>& OutMaterials, TBitArray<>& OutAmbiguous) const {
+    OutMaterials.SetNumZeroed(CityObjects.Num());
+    OutAmbiguous.Init(false, CityObjects.Num());
+    for (int32 i = 0; i < CityObjects.Num(); ++i) {
+        bool bAmbiguous = false;
+        OutMaterials[i] = FindClassificationMaterial(*CityObjects[i], bAmbiguous);
+        OutAmbiguous[i] = bAmbiguous;
+    }
+}
+
+TArray<USceneComponent*> FPLATEAUModelClassification::ClassifyInPlace(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, TArray<UPLATEAUCityObjectGroup*>& OutRemainingTargets) {
+    // 地物ごとの分類結果はGmlIDで使い回す (最小地物単位では親の地物が複数のコンポーネントに含まれるため)
+    TMap<FString, TTuple<UMaterialInterface*, bool>> MaterialCache;
+    const auto FindMaterialCached = [&](const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) {
+        if (const auto Cached = MaterialCache.Find(CityObject.GmlID)) {
+            bOutAmbiguous = Cached->Get<1>();
+            return Cached->Get<0>();
+        }
+        bool bAmbiguous = false;
+        const auto Material = FindClassificationMaterial(CityObject, bAmbiguous);
+        MaterialCache.Add(CityObject.GmlID, MakeTuple(Material, bAmbiguous));
+        bOutAmbiguous = bAmbiguous;
+        return Material;
+    };
+
+    // 対象となる地物の分類結果をまとめて求めておく
+    {
+        // GetAllRootCityObjectsはコピーを返すため、評価が終わるまで保持する
+        TArray<TArray<FPLATEAUCityObject>> RootCityObjectsPerTarget;
+        RootCityObjectsPerTarget.Reserve(TargetCityObjects.Num());
+        TSet<FString> VisitedGmlIds;
+        TArray<const FPLATEAUCityObject*> CityObjects;
+        for (const auto& Target : TargetCityObjects) {
+            if (!IsValid(Target) || Target->GetConvertGranularity() != ConvGranularity)
+                continue;
+            for (const auto& CityObject : RootCityObjectsPerTarget.Add_GetRef(Target->GetAllRootCityObjects()))
+                CollectCityObjects(CityObject, VisitedGmlIds, CityObjects);
+        }
+
+        TArray<UMaterialInterface*> Materials;
+        TBitArray<> Ambiguous;
+        FindClassificationMaterials(CityObjects, Materials, Ambiguous);
+        MaterialCache.Reserve(CityObjects.Num());
+        for (int32 i = 0; i < CityObjects.Num(); ++i)
+            MaterialCache.Add(CityObjects[i]->GmlID, MakeTuple(Materials[i], static_cast<bool>(Ambiguous[i])));
+    }
+
+    // マテリアル分けでは、分類された地物の子孫にも同じマテリアルが登録されるため、祖先の分類結果を引き継いで判定する
+    const TFunction<bool(const FPLATEAUCityObject&, UMaterialInterface*, FInPlaceClassification&)> Classify =
+        [&](const FPLATEAUCityObject& CityObject, UMaterialInterface* InheritedMaterial, FInPlaceClassification& Result) {
+        bool bAmbiguous = false;
+        UMaterialInterface* Material = FindMaterialCached(CityObject, bAmbiguous);
+        if (bAmbiguous || (Material != nullptr && InheritedMaterial != nullptr && Material != InheritedMaterial))
+            return false;
+        if (Material == nullptr)
+            Material = InheritedMaterial;
+
+        Result.Add(Material);
+        if (Result.bMixed)
+            return false;
+
+        for (const auto& Child : CityObject.Children) {
+            if (!Classify(Child, Material, Result))
+                return false;
+        }
+        return true;
+    };
+
+    TArray<TTuple<UPLATEAUCityObjectGroup*, UMaterialInterface*>> InPlaceTargets;
+    for (const auto& Target : TargetCityObjects) {
+        if (!IsValid(Target) || Target->GetConvertGranularity() != ConvGranularity) {
+            OutRemainingTargets.Add(Target);
+            continue;
+        }
+
+        FInPlaceClassification Result;
+        bool bSucceeded = true;
+        for (const auto& CityObject : Target->GetAllRootCityObjects()) {
+            if (!Classify(CityObject, nullptr, Result)) {
+                bSucceeded = false;
+                break;
+            }
+        }
+
+        if (bSucceeded)
+            InPlaceTargets.Add(MakeTuple(Target, Result.Material));
+        else
+            OutRemainingTargets.Add(Target);
+    }
+
+    TArray<USceneComponent*> ResultComponents;
+    if (InPlaceTargets.Num() == 0)
+        return ResultComponents;
+
+    FFunctionGraphTask::CreateAndDispatchWhenReady([&] {
+        for (const auto& [Component, ClassifiedMaterial] : InPlaceTargets) {
+            // 分類対象外の地物は、Defaultマテリアルがあればそれを、なければ元のマテリアルを維持する
+            UMaterialInterface* Material = ClassifiedMaterial != nullptr ? ClassifiedMaterial : DefaultMaterial;
+            if (Material != nullptr) {
+                for (int32 MaterialIndex = 0; MaterialIndex < Component->GetNumMaterials(); ++MaterialIndex)
+                    Component->SetMaterial(MaterialIndex, Material);
+            }
+            ResultComponents.Add(Component);
+        }
+        }, TStatId(), nullptr, ENamedThreads::GameThread)->Wait();
+
+    UE_LOG(LogTemp, Log, TEXT("ClassifyInPlace: %d / %d"), ResultComponents.Num(), TargetCityObjects.Num());
+    return ResultComponents;
+}
@@ -13,23 +13,16 @@
 
 using namespace plateau::granularityConvert;
 
-namespace {
-
-    TSet<FString> ConvertAttributeValuesToUniqueStringValues(TArray<FPLATEAUAttributeValue> AttributeValues) {
-        TSet<FString> StringValues;
-        for (const auto& AttributeValue : AttributeValues) {
-            StringValues.Add(AttributeValue.StringValue);
-        }
-        return StringValues;
-    }
-}
-
-
 FPLATEAUModelClassificationByAttribute::FPLATEAUModelClassificationByAttribute(APLATEAUInstancedCityModel* Actor, const FString& AttributeKey, const TMap<FString, UMaterialInterface*>& Materials, UMaterialInterface* Material)
+    : ClassificationAttributeQuery(AttributeKey)
 {
     CityModelActor = Actor;
     ClassificationAttributeKey = AttributeKey;
     ClassificationMaterials = Materials;
+    for (const auto& [Value, Material] : Materials) {
+        if (Material != nullptr)
+            ClassificationPatterns.Add({ Value, FPLATEAUAttributePredicate::Equal(Value), Material });
+    }
     bDivideGrid = false;
     DefaultMaterial = Material;
 }
@@ -74,42 +67,40 @@ std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelClassificationByAttrib
     ComposeCachedMaterialFromTarget(TargetCityObjects);
     
     // ChachedMaterialに入っている元々のマテリアルに追加で、マテリアル分け用のマテリアルを追加
-    TMap<int, UMaterialInterface*> ClassifyMatIDs;
-    for (const auto& [Attr, Mat] : ClassificationMaterials)
-    {
-        if (Mat == nullptr) continue;
-        int id = CachedMaterials.Add(Mat);
-        Adjuster.registerMaterialPattern(TCHAR_TO_UTF8(*Attr), id);
+    for (const auto& Pattern : ClassificationPatterns) {
+        int id = CachedMaterials.Add(Pattern.Material);
+        Adjuster.registerMaterialPattern(TCHAR_TO_UTF8(*Pattern.Value), id);
     }
 
-    // 変更が必要な属性値とマテリアルIDをC++側に登録
+    // 分類対象の地物を集めて属性値をまとめて評価する
+    TArray<std::string> GmlIds;
+    TArray<const FPLATEAUCityObject*> CityObjects;
     auto meshes = converted.get()->getAllMeshes();
     for (auto& mesh : meshes) {
         auto cityObjList = mesh->getCityObjectList();
         for (auto& cityobj : cityObjList) {
-
-            const auto GmlId = cityobj.second;
-            const auto AttrInfoPtr = CityObjMap.Find(UTF8_TO_TCHAR(GmlId.c_str()));
-
-            if (AttrInfoPtr) {
-                TArray<FPLATEAUAttributeValue> AttributeValues = UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey(ClassificationAttributeKey, AttrInfoPtr->Attributes);
-                TSet<FString> AttributeStringValues = ConvertAttributeValuesToUniqueStringValues(AttributeValues);
-                
-                for (const auto& Value : AttributeStringValues) {
-                    if (ClassificationMaterials.Contains(Value) && ClassificationMaterials[Value] != nullptr) {
-
-                        Adjuster.registerAttribute(GmlId, TCHAR_TO_UTF8(*Value));
-
-                        const auto AttrInfo = *AttrInfoPtr;
-                        TSet<FString> Children = FPLATEAUGmlUtil::GetChildrenGmlIds(AttrInfo);
-                        for (auto ChildId : Children) {
-                            Adjuster.registerAttribute(TCHAR_TO_UTF8(*ChildId), TCHAR_TO_UTF8(*Value));
-                        }
-                    }
-                }
+            const auto& GmlId = cityobj.second;
+            if (const auto AttrInfoPtr = CityObjMap.Find(UTF8_TO_TCHAR(GmlId.c_str()))) {
+                GmlIds.Add(GmlId);
+                CityObjects.Add(AttrInfoPtr);
             }
         }
     }
+    TArray<int32> PatternIndices;
+    FindClassificationPatterns(CityObjects, PatternIndices);
+
+    // 変更が必要な属性値とマテリアルIDをC++側に登録
+    for (int32 i = 0; i < CityObjects.Num(); ++i) {
+        if (PatternIndices[i] == INDEX_NONE)
+            continue;
+        const auto& Value = ClassificationPatterns[PatternIndices[i]].Value;
+        Adjuster.registerAttribute(GmlIds[i], TCHAR_TO_UTF8(*Value));
+
+        TSet<FString> Children = FPLATEAUGmlUtil::GetChildrenGmlIds(*CityObjects[i]);
+        for (const auto& ChildId : Children) {
+            Adjuster.registerAttribute(TCHAR_TO_UTF8(*ChildId), TCHAR_TO_UTF8(*Value));
+        }
+    }
     Adjuster.exec(*converted);
     
     //地物単位に応じたModelを再生成
@@ -124,6 +115,39 @@ std::shared_ptr<plateau::polygonMesh::Model> FPLATEAUModelClassificationByAttrib
     return converted;
 }
 
+UMaterialInterface* FPLATEAUModelClassificationByAttribute::FindClassificationMaterial(const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) const {
+    const FPLATEAUCityObject* CityObjectPtr = &CityObject;
+    TArray<int32> PatternIndices;
+    FindClassificationPatterns(MakeArrayView(&CityObjectPtr, 1), PatternIndices);
+    return PatternIndices[0] != INDEX_NONE ? ClassificationPatterns[PatternIndices[0]].Material : nullptr;
+}
+
+void FPLATEAUModelClassificationByAttribute::FindClassificationMaterials(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<UMaterialInterface*>& OutMaterials, TBitArray<>& OutAmbiguous) const {
+    TArray<int32> PatternIndices;
+    FindClassificationPatterns(CityObjects, PatternIndices);
+    OutMaterials.SetNumZeroed(CityObjects.Num());
+    OutAmbiguous.Init(false, CityObjects.Num());
+    for (int32 i = 0; i < CityObjects.Num(); ++i) {
+        if (PatternIndices[i] != INDEX_NONE)
+            OutMaterials[i] = ClassificationPatterns[PatternIndices[i]].Material;
+    }
+}
+
+void FPLATEAUModelClassificationByAttribute::FindClassificationPatterns(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<int32>& OutPatternIndices) const {
+    TArray<const FPLATEAUAttributeValue*> Values;
+    Values.Reserve(CityObjects.Num());
+    for (const auto CityObject : CityObjects)
+        Values.Add(ClassificationAttributeQuery.Find(CityObject->Attributes));
+
+    OutPatternIndices.Init(INDEX_NONE, CityObjects.Num());
+    TBitArray<> Matches;
+    for (int32 PatternIndex = 0; PatternIndex < ClassificationPatterns.Num(); ++PatternIndex) {
+        ClassificationPatterns[PatternIndex].Predicate.EvaluateBatch(Values, Matches);
+        for (TConstSetBitIterator<> It(Matches); It; ++It)
+            OutPatternIndices[It.GetIndex()] = PatternIndex;
+    }
+}
+
 TArray<USceneComponent*> FPLATEAUModelClassificationByAttribute::ReconstructFromConvertedModel(std::shared_ptr<plateau::polygonMesh::Model> Model) {
 
     FPLATEAUMeshLoaderForClassification MeshLoader(CachedMaterials, false);
@@ -107,6 +107,11 @@ void FPLATEAUModelClassificationByType::ComposeCachedMaterialFromTarget(const TA
     }
 }
 
+UMaterialInterface* FPLATEAUModelClassificationByType::FindClassificationMaterial(const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) const {
+    const auto MaterialPtr = ClassificationMaterials.Find(CityObject.Type);
+    return MaterialPtr != nullptr ? *MaterialPtr : nullptr;
+}
+
 TArray<USceneComponent*> FPLATEAUModelClassificationByType::ReconstructFromConvertedModel(std::shared_ptr<plateau::polygonMesh::Model> Model) {
 
     // TMap<int, UMaterialInterface*> NewClassificationMaterials;
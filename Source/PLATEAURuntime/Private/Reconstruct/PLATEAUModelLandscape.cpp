@@ -57,7 +57,7 @@ TArray<UPLATEAUCityObjectGroup*> FPLATEAUModelLandscape::GetUPLATEAUCityObjectGr
 
 
 ALandscape* FPLATEAUModelLandscape::CreateLandScape(UWorld* World, const int32 NumSubsections, const int32 SubsectionSizeQuads, const  int32 ComponentCountX, const int32 ComponentCountY, const  int32 SizeX, const int32 SizeY,
-    const TVec3d Min, const TVec3d Max, const TVec2f MinUV, const TVec2f MaxUV, const FString TexturePath, TArray<uint16> HeightData, const FString ActorName) {
+    const TVec3d Min, const TVec3d Max, const TVec2f MinUV, const TVec2f MaxUV, const FString TexturePath, TConstArrayView<uint16> HeightData, const FString ActorName) {
 
     // Weightmap is sized the same as the component
     const int32 WeightmapSize = (SubsectionSizeQuads + 1) * NumSubsections;
@@ -84,8 +84,9 @@ ALandscape* FPLATEAUModelLandscape::CreateLandScape(UWorld* World, const int32 N
 
     UE_LOG(LogTemp, Log, TEXT("Create Landscape SizeX:%d SizeY:%d SubsectionSizeQuads:%d  NumSubsections:%d ComponentCount(%d,%d)"), SizeX, SizeY, SubsectionSizeQuads, NumSubsections, ComponentCountX, ComponentCountY);
 
+    // ALandscape::ImportはTArrayを要求するため、高さデータはインポート用バッファへの1回のみコピーする
     TMap<FGuid, TArray<uint16>> HeightDataPerLayers;
-    HeightDataPerLayers.Add(FGuid(), MoveTemp(HeightData));
+    HeightDataPerLayers.Add(FGuid(), TArray<uint16>(HeightData.GetData(), HeightData.Num()));
 
     TMap<FGuid, TArray<FLandscapeImportLayerInfo>> MaterialLayerDataPerLayers;
     TArray<FLandscapeImportLayerInfo> MaterialImportLayers;
@@ -0,0 +1,505 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#include "Reconstruct/PLATEAUModelTextureAtlas.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "PLATEAUTextureLoader.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#include "StaticMeshCompiler.h"
+#endif
+
+const FString FPLATEAUModelTextureAtlas::AtlasTexturePrefix = TEXT("PLATEAUAtlas_");
+
+namespace {
+    const FName TextureParameterName(TEXT("Texture"));
+
+    UTexture* GetTextureParameter(const UMaterialInterface* Material) {
+        UTexture* Texture = nullptr;
+        if (Material != nullptr)
+            Material->GetTextureParameterValue(FHashedMaterialParameterInfo(TextureParameterName), Texture, true);
+        return Texture;
+    }
+
+    UStaticMesh* GetStaticMesh(const UStaticMeshComponent* Component) {
+        return Component != nullptr ? Component->GetStaticMesh().Get() : nullptr;
+    }
+
+    void CountUsage(const TArray<UStaticMeshComponent*>& Components, int32& OutMaterialCount, int32& OutTextureCount, int32& OutSectionCount) {
+        TSet<UMaterialInterface*> Materials;
+        TSet<UTexture*> Textures;
+        OutSectionCount = 0;
+        for (const auto Component : Components) {
+            const auto StaticMesh = GetStaticMesh(Component);
+            if (StaticMesh == nullptr)
+                continue;
+            for (int32 i = 0; i < Component->GetNumMaterials(); ++i) {
+                const auto Material = Component->GetMaterial(i);
+                if (Material == nullptr)
+                    continue;
+                Materials.Add(Material);
+                if (const auto Texture = GetTextureParameter(Material))
+                    Textures.Add(Texture);
+            }
+            OutSectionCount += StaticMesh->GetNumSections(0);
+        }
+        OutMaterialCount = Materials.Num();
+        OutTextureCount = Textures.Num();
+    }
+
+#if WITH_EDITOR
+    /**
+     * @brief ビルド時と同様に、PolygonGroupに対応するマテリアルのインデックスを求めます。
+     */
+    int32 GetPolygonGroupMaterialIndex(const UStaticMesh& StaticMesh, const FMeshDescription& MeshDescription, const FPolygonGroupID PolygonGroupID) {
+        const auto SlotNames = FStaticMeshConstAttributes(MeshDescription).GetPolygonGroupMaterialSlotNames();
+        const int32 Index = StaticMesh.GetMaterialIndexFromImportedMaterialSlotName(SlotNames[PolygonGroupID]);
+        return Index != INDEX_NONE ? Index : PolygonGroupID.GetValue();
+    }
+
+    struct FMeshTarget {
+        UStaticMesh* StaticMesh = nullptr;
+        FMeshDescription* MeshDescription = nullptr;
+        TArray<UStaticMeshComponent*> Components;
+        // マテリアルスロット毎のマテリアル
+        TArray<UMaterialInterface*> Materials;
+        // Key: PolygonGroup, Value: マテリアル
+        TMap<FPolygonGroupID, UMaterialInterface*> GroupMaterials;
+        // UVが0~1の範囲外となるテクスチャ
+        TSet<UTexture2D*> TiledTextures;
+        // 結合後のPolygonGroupの順のマテリアルスロット
+        TArray<FStaticMaterial> StaticMaterials;
+        bool bValid = true;
+        bool bModified = false;
+    };
+
+    struct FAtlasPlacement {
+        int32 AtlasIndex = INDEX_NONE;
+        // パディングを除いたテクスチャの配置
+        int32 X = 0;
+        int32 Y = 0;
+        int32 Width = 0;
+        int32 Height = 0;
+    };
+
+    struct FAtlasPage {
+        int32 Width = 0;
+        int32 Height = 0;
+        TArray64<uint8> Pixels;
+        UTexture2D* Texture = nullptr;
+    };
+
+    bool CanPackTexture(UTexture2D* Texture, const int32 AtlasSize, const int32 Padding) {
+        const auto& Source = Texture->Source;
+        return Source.IsValid()
+            && Source.GetFormat() == ETextureSourceFormat::TSF_BGRA8
+            && Source.GetNumSlices() == 1
+            && Source.GetNumBlocks() == 1
+            && Source.GetSizeX() + Padding * 2 <= AtlasSize
+            && Source.GetSizeY() + Padding * 2 <= AtlasSize;
+    }
+
+    /**
+     * @brief 高さ順に並べたテクスチャを棚詰めで配置します。
+     */
+    void PackTextures(const TArray<UTexture2D*>& Textures, const int32 AtlasSize, const int32 Padding,
+        TMap<UTexture2D*, FAtlasPlacement>& OutPlacements, TArray<FAtlasPage>& OutPages) {
+        TArray<UTexture2D*> Sorted = Textures;
+        Sorted.Sort([](const UTexture2D& A, const UTexture2D& B) {
+            if (A.Source.GetSizeY() != B.Source.GetSizeY())
+                return A.Source.GetSizeY() > B.Source.GetSizeY();
+            return A.Source.GetSizeX() > B.Source.GetSizeX();
+            });
+
+        int32 CursorX = 0;
+        int32 ShelfY = 0;
+        int32 ShelfHeight = 0;
+        for (const auto Texture : Sorted) {
+            const int32 CellWidth = Texture->Source.GetSizeX() + Padding * 2;
+            const int32 CellHeight = Texture->Source.GetSizeY() + Padding * 2;
+            if (OutPages.Num() > 0 && AtlasSize < CursorX + CellWidth) {
+                CursorX = 0;
+                ShelfY += ShelfHeight;
+                ShelfHeight = 0;
+            }
+            if (OutPages.Num() == 0 || AtlasSize < ShelfY + CellHeight) {
+                auto& Page = OutPages.AddDefaulted_GetRef();
+                Page.Width = AtlasSize;
+                CursorX = 0;
+                ShelfY = 0;
+                ShelfHeight = 0;
+            }
+
+            FAtlasPlacement Placement;
+            Placement.AtlasIndex = OutPages.Num() - 1;
+            Placement.X = CursorX + Padding;
+            Placement.Y = ShelfY + Padding;
+            Placement.Width = Texture->Source.GetSizeX();
+            Placement.Height = Texture->Source.GetSizeY();
+            OutPlacements.Add(Texture, Placement);
+
+            CursorX += CellWidth;
+            ShelfHeight = FMath::Max(ShelfHeight, CellHeight);
+            auto& Page = OutPages.Last();
+            Page.Height = FMath::Max(Page.Height, ShelfY + ShelfHeight);
+        }
+
+        // 使用している高さまで縮める
+        for (auto& Page : OutPages) {
+            Page.Height = FMath::Min(static_cast<int32>(FMath::RoundUpToPowerOfTwo(Page.Height)), AtlasSize);
+            Page.Pixels.SetNumZeroed(static_cast<int64>(Page.Width) * Page.Height * 4);
+        }
+    }
+
+    /**
+     * @brief テクスチャをアトラスに書き込みます。パディング部分は端のピクセルで埋めます。
+     */
+    void BlitTexture(const TArray64<uint8>& Source, const FAtlasPlacement& Placement, const int32 Padding, FAtlasPage& Page) {
+        for (int32 Y = -Padding; Y < Placement.Height + Padding; ++Y) {
+            const int32 SourceY = FMath::Clamp(Y, 0, Placement.Height - 1);
+            for (int32 X = -Padding; X < Placement.Width + Padding; ++X) {
+                const int32 SourceX = FMath::Clamp(X, 0, Placement.Width - 1);
+                const int64 SourceOffset = (static_cast<int64>(SourceY) * Placement.Width + SourceX) * 4;
+                const int64 DestOffset = (static_cast<int64>(Placement.Y + Y) * Page.Width + Placement.X + X) * 4;
+                FMemory::Memcpy(&Page.Pixels[DestOffset], &Source[SourceOffset], 4);
+            }
+        }
+    }
+
+    /**
+     * @brief アトラス化後のマテリアルの同一性を判定するキーを作成します。MaterialInstanceDynamic以外はそのものを区別します。
+     */
+    FString MakeMaterialKey(UMaterialInterface* Material, UTexture* Texture) {
+        const auto Instance = Cast<UMaterialInstanceDynamic>(Material);
+        if (Instance == nullptr)
+            return Material->GetPathName();
+
+        TArray<FString> Entries;
+        for (const auto& Value : Instance->ScalarParameterValues)
+            Entries.Add(FString::Printf(TEXT("S:%s=%.6g"), *Value.ParameterInfo.Name.ToString(), Value.ParameterValue));
+        for (const auto& Value : Instance->VectorParameterValues)
+            Entries.Add(FString::Printf(TEXT("V:%s=%s"), *Value.ParameterInfo.Name.ToString(), *Value.ParameterValue.ToString()));
+        for (const auto& Value : Instance->TextureParameterValues) {
+            const UTexture* ParameterTexture = Value.ParameterInfo.Name == TextureParameterName ? Texture : Value.ParameterValue.Get();
+            Entries.Add(FString::Printf(TEXT("T:%s=%s"), *Value.ParameterInfo.Name.ToString(), *GetPathNameSafe(ParameterTexture)));
+        }
+        Entries.Sort();
+        return FString::Printf(TEXT("%s|%d|%s"), *GetPathNameSafe(Instance->Parent), Instance->TwoSided ? 1 : 0, *FString::Join(Entries, TEXT(";")));
+    }
+
+    /**
+     * @brief アトラスのUV範囲に変換します。UVはテクスチャの範囲内であることを確認済みです。
+     */
+    void RemapUVs(FMeshDescription& MeshDescription, const FPolygonGroupID PolygonGroupID, const FAtlasPlacement& Placement, const FAtlasPage& Page,
+        TSet<FVertexInstanceID>& RemappedVertexInstances) {
+        const auto UVs = FStaticMeshAttributes(MeshDescription).GetVertexInstanceUVs();
+        const FVector2f Scale(static_cast<float>(Placement.Width) / Page.Width, static_cast<float>(Placement.Height) / Page.Height);
+        const FVector2f Offset(static_cast<float>(Placement.X) / Page.Width, static_cast<float>(Placement.Y) / Page.Height);
+        for (const FTriangleID TriangleID : MeshDescription.GetPolygonGroupTriangles(PolygonGroupID)) {
+            for (const FVertexInstanceID VertexInstanceID : MeshDescription.GetTriangleVertexInstances(TriangleID)) {
+                bool bAlreadyRemapped = false;
+                RemappedVertexInstances.Add(VertexInstanceID, &bAlreadyRemapped);
+                if (bAlreadyRemapped)
+                    continue;
+                const FVector2f UV = UVs.Get(VertexInstanceID, 0);
+                const FVector2f Clamped(FMath::Clamp(UV.X, 0.0f, 1.0f), FMath::Clamp(UV.Y, 0.0f, 1.0f));
+                UVs.Set(VertexInstanceID, 0, Offset + Clamped * Scale);
+            }
+        }
+    }
+
+    bool HasUVOutsideUnitRange(const FMeshDescription& MeshDescription, const FPolygonGroupID PolygonGroupID) {
+        constexpr float Tolerance = 1e-3f;
+        const auto UVs = FStaticMeshConstAttributes(MeshDescription).GetVertexInstanceUVs();
+        for (const FTriangleID TriangleID : MeshDescription.GetPolygonGroupTriangles(PolygonGroupID)) {
+            for (const FVertexInstanceID VertexInstanceID : MeshDescription.GetTriangleVertexInstances(TriangleID)) {
+                const FVector2f UV = UVs.Get(VertexInstanceID, 0);
+                if (UV.X < -Tolerance || 1.0f + Tolerance < UV.X || UV.Y < -Tolerance || 1.0f + Tolerance < UV.Y)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 同じマテリアルのPolygonGroupを結合し、PolygonGroupの順にマテリアルスロットを作り直します。
+     * UStaticMeshへの反映はゲームスレッドで行うため、Target.StaticMaterialsに格納します。
+     */
+    void MergePolygonGroups(FMeshTarget& Target, const TMap<UMaterialInterface*, UMaterialInterface*>& MaterialMap) {
+        auto& MeshDescription = *Target.MeshDescription;
+        TMap<UMaterialInterface*, FPolygonGroupID> MaterialToGroup;
+        TArray<FPolygonGroupID> GroupsToDelete;
+        for (const auto& [PolygonGroupID, SourceMaterial] : Target.GroupMaterials) {
+            UMaterialInterface* Material = MaterialMap.FindRef(SourceMaterial);
+            if (Material == nullptr)
+                Material = SourceMaterial;
+            if (MeshDescription.GetNumPolygonGroupPolygons(PolygonGroupID) == 0) {
+                GroupsToDelete.Add(PolygonGroupID);
+                continue;
+            }
+            if (const auto ExistingGroup = MaterialToGroup.Find(Material)) {
+                const TArray<FPolygonID> PolygonIDs(MeshDescription.GetPolygonGroupPolygonIDs(PolygonGroupID));
+                for (const auto PolygonID : PolygonIDs)
+                    MeshDescription.SetPolygonPolygonGroup(PolygonID, *ExistingGroup);
+                GroupsToDelete.Add(PolygonGroupID);
+                continue;
+            }
+            MaterialToGroup.Add(Material, PolygonGroupID);
+        }
+        for (const auto PolygonGroupID : GroupsToDelete)
+            MeshDescription.DeletePolygonGroup(PolygonGroupID);
+
+        FElementIDRemappings Remappings;
+        MeshDescription.Compact(Remappings);
+
+        auto& StaticMaterials = Target.StaticMaterials;
+        StaticMaterials.SetNum(MeshDescription.PolygonGroups().Num());
+        const auto SlotNames = FStaticMeshAttributes(MeshDescription).GetPolygonGroupMaterialSlotNames();
+        for (const auto& [Material, OldPolygonGroupID] : MaterialToGroup) {
+            const FPolygonGroupID PolygonGroupID = Remappings.GetRemappedPolygonGroupID(OldPolygonGroupID);
+            const FName SlotName(*FString::Printf(TEXT("Material_%d"), PolygonGroupID.GetValue()));
+            SlotNames[PolygonGroupID] = SlotName;
+            StaticMaterials[PolygonGroupID.GetValue()] = FStaticMaterial(Material, SlotName, SlotName);
+        }
+    }
+#endif
+}
+
+FString FPLATEAUTextureAtlasResult::ToString() const {
+    return FString::Printf(TEXT("materials %d -> %d, textures %d -> %d, sections %d -> %d, %d textures packed into %d atlases"),
+        MaterialCountBefore, MaterialCountAfter, TextureCountBefore, TextureCountAfter,
+        SectionCountBefore, SectionCountAfter, AtlasedTextureCount, AtlasCount);
+}
+
+FPLATEAUModelTextureAtlas::FPLATEAUModelTextureAtlas(APLATEAUInstancedCityModel* Actor)
+    : CityModelActor(Actor) {
+}
+
+FPLATEAUTextureAtlasResult FPLATEAUModelTextureAtlas::Execute() {
+    check(IsInGameThread());
+    FPLATEAUTextureAtlasResult Result;
+    if (CityModelActor == nullptr)
+        return Result;
+
+    TArray<UStaticMeshComponent*> Components;
+    CityModelActor->GetComponents<UStaticMeshComponent>(Components);
+
+#if WITH_EDITOR
+    TArray<UStaticMesh*> AllMeshes;
+    for (const auto Component : Components) {
+        if (const auto StaticMesh = GetStaticMesh(Component))
+            AllMeshes.AddUnique(StaticMesh);
+    }
+    FStaticMeshCompilingManager::Get().FinishCompilation(AllMeshes);
+    CountUsage(Components, Result.MaterialCountBefore, Result.TextureCountBefore, Result.SectionCountBefore);
+
+    // メッシュ毎に対象を集める。共有メッシュは全てのコンポーネントでマテリアルが一致する場合のみ対象とする
+    TArray<FMeshTarget> Targets;
+    TMap<UStaticMesh*, int32> MeshToTarget;
+    for (const auto Component : Components) {
+        const auto StaticMesh = GetStaticMesh(Component);
+        if (StaticMesh == nullptr)
+            continue;
+
+        TArray<UMaterialInterface*> Materials;
+        for (int32 i = 0; i < StaticMesh->GetStaticMaterials().Num(); ++i)
+            Materials.Add(Component->GetMaterial(i));
+
+        if (const auto Index = MeshToTarget.Find(StaticMesh)) {
+            auto& Target = Targets[*Index];
+            Target.Components.Add(Component);
+            Target.bValid &= Target.Materials == Materials;
+            continue;
+        }
+
+        auto& Target = Targets.AddDefaulted_GetRef();
+        MeshToTarget.Add(StaticMesh, Targets.Num() - 1);
+        Target.StaticMesh = StaticMesh;
+        Target.Components.Add(Component);
+        Target.Materials = Materials;
+        Target.MeshDescription = StaticMesh->GetMeshDescription(0);
+        Target.bValid = Target.MeshDescription != nullptr;
+        if (!Target.bValid)
+            continue;
+
+        for (const FPolygonGroupID PolygonGroupID : Target.MeshDescription->PolygonGroups().GetElementIDs()) {
+            const int32 MaterialIndex = GetPolygonGroupMaterialIndex(*StaticMesh, *Target.MeshDescription, PolygonGroupID);
+            Target.GroupMaterials.Add(PolygonGroupID, Materials.IsValidIndex(MaterialIndex) ? Materials[MaterialIndex] : nullptr);
+        }
+    }
+
+    // アトラスに含めるテクスチャを選ぶ。UVを書き換えられないメッシュや、差し替えられないマテリアルで使われるテクスチャは除く
+    TSet<UTexture2D*> CandidateTextures;
+    TSet<UTexture2D*> ExcludedTextures;
+    for (const auto& Target : Targets) {
+        for (const auto Material : Target.Materials) {
+            const auto Texture = Cast<UTexture2D>(GetTextureParameter(Material));
+            if (Texture == nullptr)
+                continue;
+            if (Target.bValid && Material->IsA<UMaterialInstanceDynamic>() && CanPackTexture(Texture, AtlasSize, Padding))
+                CandidateTextures.Add(Texture);
+            else
+                ExcludedTextures.Add(Texture);
+        }
+    }
+
+    ParallelFor(Targets.Num(), [&](const int32 Index) {
+        auto& Target = Targets[Index];
+        if (!Target.bValid)
+            return;
+        for (const auto& [PolygonGroupID, Material] : Target.GroupMaterials) {
+            const auto Texture = Cast<UTexture2D>(GetTextureParameter(Material));
+            if (Texture != nullptr && CandidateTextures.Contains(Texture) && HasUVOutsideUnitRange(*Target.MeshDescription, PolygonGroupID))
+                Target.TiledTextures.Add(Texture);
+        }
+    }, EParallelForFlags::Unbalanced);
+    for (const auto& Target : Targets)
+        ExcludedTextures.Append(Target.TiledTextures);
+
+    TArray<UTexture2D*> PackedTextures;
+    for (const auto Texture : CandidateTextures) {
+        if (!ExcludedTextures.Contains(Texture))
+            PackedTextures.Add(Texture);
+    }
+    // 1枚だけではアトラス化の効果が無い
+    if (PackedTextures.Num() < 2)
+        PackedTextures.Reset();
+
+    TMap<UTexture2D*, FAtlasPlacement> Placements;
+    TArray<FAtlasPage> Pages;
+    PackTextures(PackedTextures, AtlasSize, Padding, Placements, Pages);
+
+    TArray<TArray64<uint8>> SourcePixels;
+    SourcePixels.SetNum(PackedTextures.Num());
+    for (int32 i = 0; i < PackedTextures.Num(); ++i)
+        PackedTextures[i]->Source.GetMipData(SourcePixels[i], 0);
+    ParallelFor(PackedTextures.Num(), [&](const int32 Index) {
+        const auto& Placement = Placements[PackedTextures[Index]];
+        if (SourcePixels[Index].Num() == static_cast<int64>(Placement.Width) * Placement.Height * 4)
+            BlitTexture(SourcePixels[Index], Placement, Padding, Pages[Placement.AtlasIndex]);
+        else
+            UE_LOG(LogTemp, Warning, TEXT("Failed to read texture source for atlas: %s"), *PackedTextures[Index]->GetName());
+    });
+    SourcePixels.Empty();
+
+    // データセットのテクスチャと同じくContent/PLATEAU/Datasets以下に画像ファイルを置く
+    const FString AtlasDirectory = FPaths::ProjectContentDir() / TEXT("PLATEAU/Datasets") / CityModelActor->DatasetName / TEXT("PLATEAUAtlas");
+    for (int32 i = 0; i < Pages.Num(); ++i) {
+        const FString TextureName = FString::Printf(TEXT("%s%s_%d"), *AtlasTexturePrefix, *CityModelActor->GetName(), i);
+        Pages[i].Texture = FPLATEAUTextureLoader::CreateTextureAsset(TextureName, Pages[i].Width, Pages[i].Height, Pages[i].Pixels, AtlasDirectory);
+        Pages[i].Pixels.Empty();
+    }
+
+    // アトラス化後に同一となるマテリアルをまとめる
+    TMap<FString, TArray<UMaterialInterface*>> KeyToMaterials;
+    TMap<UMaterialInterface*, FString> MaterialToKey;
+    for (const auto& Target : Targets) {
+        if (!Target.bValid)
+            continue;
+        for (const auto Material : Target.Materials) {
+            if (Material == nullptr || MaterialToKey.Contains(Material))
+                continue;
+            UTexture* Texture = GetTextureParameter(Material);
+            if (const auto Placement = Placements.Find(Cast<UTexture2D>(Texture)))
+                Texture = Pages[Placement->AtlasIndex].Texture;
+            const FString Key = MakeMaterialKey(Material, Texture);
+            MaterialToKey.Add(Material, Key);
+            KeyToMaterials.FindOrAdd(Key).Add(Material);
+        }
+    }
+
+    TMap<UMaterialInterface*, UMaterialInterface*> MaterialMap;
+    for (const auto& [Key, Materials] : KeyToMaterials) {
+        const auto Source = Materials[0];
+        const auto Placement = Placements.Find(Cast<UTexture2D>(GetTextureParameter(Source)));
+        if (Materials.Num() == 1 && Placement == nullptr)
+            continue;
+
+        // 統合したマテリアルはコンポーネントの破棄に影響されないようアクターに持たせる
+        UMaterialInterface* Merged = Source;
+        if (const auto SourceInstance = Cast<UMaterialInstanceDynamic>(Source)) {
+            const auto Instance = UMaterialInstanceDynamic::Create(SourceInstance->Parent, CityModelActor);
+            Instance->CopyParameterOverrides(SourceInstance);
+            Instance->TwoSided = SourceInstance->TwoSided;
+            if (Placement != nullptr)
+                Instance->SetTextureParameterValue(TextureParameterName, Pages[Placement->AtlasIndex].Texture);
+            Merged = Instance;
+        }
+        for (const auto Material : Materials)
+            MaterialMap.Add(Material, Merged);
+    }
+
+    // UVの書き換えとセクションの結合
+    ParallelFor(Targets.Num(), [&](const int32 Index) {
+        auto& Target = Targets[Index];
+        if (!Target.bValid)
+            return;
+        bool bNeedsMerge = false;
+        TSet<UMaterialInterface*> MergedMaterials;
+        TSet<FVertexInstanceID> RemappedVertexInstances;
+        for (const auto& [PolygonGroupID, Material] : Target.GroupMaterials) {
+            const auto Placement = Placements.Find(Cast<UTexture2D>(GetTextureParameter(Material)));
+            if (Placement != nullptr) {
+                RemapUVs(*Target.MeshDescription, PolygonGroupID, *Placement, Pages[Placement->AtlasIndex], RemappedVertexInstances);
+                Target.bModified = true;
+            }
+            UMaterialInterface* MergedMaterial = MaterialMap.FindRef(Material);
+            if (MergedMaterial != nullptr)
+                Target.bModified = true;
+            else
+                MergedMaterial = Material;
+            bool bAlreadyExists = false;
+            MergedMaterials.Add(MergedMaterial, &bAlreadyExists);
+            bNeedsMerge |= bAlreadyExists;
+        }
+        if (Target.bModified || bNeedsMerge) {
+            Target.bModified = true;
+            MergePolygonGroups(Target, MaterialMap);
+        }
+    }, EParallelForFlags::Unbalanced);
+
+    TArray<UStaticMesh*> ModifiedMeshes;
+    for (auto& Target : Targets) {
+        if (!Target.bModified)
+            continue;
+        Target.StaticMesh->SetStaticMaterials(Target.StaticMaterials);
+        Target.StaticMesh->GetSectionInfoMap().Clear();
+        Target.StaticMesh->GetOriginalSectionInfoMap().Clear();
+        Target.StaticMesh->CommitMeshDescription(0);
+        ModifiedMeshes.Add(Target.StaticMesh);
+    }
+    if (ModifiedMeshes.Num() > 0) {
+        UStaticMesh::BatchBuild(ModifiedMeshes, true);
+        FStaticMeshCompilingManager::Get().FinishCompilation(ModifiedMeshes);
+    }
+    for (const auto& Target : Targets) {
+        if (!Target.bModified)
+            continue;
+        for (const auto Component : Target.Components) {
+            Component->EmptyOverrideMaterials();
+            Component->MarkRenderStateDirty();
+        }
+    }
+    if (ModifiedMeshes.Num() > 0)
+        CityModelActor->MarkPackageDirty();
+
+    Result.AtlasCount = Pages.Num();
+    Result.AtlasedTextureCount = PackedTextures.Num();
+    CountUsage(Components, Result.MaterialCountAfter, Result.TextureCountAfter, Result.SectionCountAfter);
+    UE_LOG(LogTemp, Log, TEXT("TextureAtlas: %s"), *Result.ToString());
+#else
+    UE_LOG(LogTemp, Warning, TEXT("TextureAtlas is only available in editor."));
+    CountUsage(Components, Result.MaterialCountBefore, Result.TextureCountBefore, Result.SectionCountBefore);
+    Result.MaterialCountAfter = Result.MaterialCountBefore;
+    Result.TextureCountAfter = Result.TextureCountBefore;
+    Result.SectionCountAfter = Result.SectionCountBefore;
+#endif
+    return Result;
+}
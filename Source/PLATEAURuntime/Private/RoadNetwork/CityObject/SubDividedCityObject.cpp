@@ -1,6 +1,9 @@
 #include "RoadNetwork/CityObject/SubDividedCityObject.h"
 #include "Component/PLATEAUCityObjectGroup.h"
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
+#include "RoadNetwork/GeoGraph/GeoGraph2d.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
 
 TArray<FSubDividedCityObjectSubMesh> FSubDividedCityObjectSubMesh::Separate() const{
     TArray<FSubDividedCityObjectSubMesh> Result;
@@ -8,16 +11,44 @@ TArray<FSubDividedCityObjectSubMesh> FSubDividedCityObjectSubMesh::Separate() co
         return Result;
     }
 
-    TArray<bool> Used;
-    Used.SetNum(Triangles.Num() / 3);
+    const int32 TriangleNum = Triangles.Num() / 3;
 
-    for (int32 i = 0; i < Used.Num(); ++i) {
+    // 頂点 => 三角形の隣接表(CSR形式)
+    // 三角形番号の昇順に詰めるので各頂点のリストは昇順になる
+    int32 MaxVertexIndex = 0;
+    for (int32 i = 0; i < TriangleNum * 3; ++i) {
+        MaxVertexIndex = FMath::Max(MaxVertexIndex, Triangles[i]);
+    }
+    TArray<int32> VertexOffsets;
+    VertexOffsets.SetNumZeroed(MaxVertexIndex + 2);
+    for (int32 i = 0; i < TriangleNum * 3; ++i) {
+        VertexOffsets[Triangles[i] + 1]++;
+    }
+    for (int32 v = 0; v <= MaxVertexIndex; ++v) {
+        VertexOffsets[v + 1] += VertexOffsets[v];
+    }
+    TArray<int32> VertexTriangles;
+    VertexTriangles.SetNumUninitialized(TriangleNum * 3);
+    {
+        TArray<int32> Cursor(VertexOffsets.GetData(), MaxVertexIndex + 1);
+        for (int32 t = 0; t < TriangleNum; ++t) {
+            for (int32 k = 0; k < 3; ++k) {
+                VertexTriangles[Cursor[Triangles[t * 3 + k]]++] = t;
+            }
+        }
+    }
+
+    TBitArray<> Used(false, TriangleNum);
+    TArray<int32> Stack;
+    TArray<int32> Neighbors;
+    for (int32 i = 0; i < TriangleNum; ++i) {
         if (Used[i]) continue;
 
         FSubDividedCityObjectSubMesh NewMesh;
-        TArray<int32> Stack = { i };
+        Stack.Reset();
+        Stack.Add(i);
         while (Stack.Num() > 0) {
-            int32 Current = Stack.Pop();
+            int32 Current = Stack.Pop(false);
             if (Used[Current]) continue;
 
             Used[Current] = true;
@@ -26,27 +57,25 @@ TArray<FSubDividedCityObjectSubMesh> FSubDividedCityObjectSubMesh::Separate() co
                 NewMesh.Triangles.Add(Triangles[Current * 3 + j]);
             }
 
-            for (int32 j = 0; j < Used.Num(); ++j) {
-                if (Used[j]) continue;
-
-                bool IsConnected = false;
-                for (int32 k = 0; k < 3; ++k) {
-                    int32 CurrentIndex = Triangles[Current * 3 + k];
-                    for (int32 l = 0; l < 3; ++l) {
-                        if (CurrentIndex == Triangles[j * 3 + l]) {
-                            IsConnected = true;
-                            break;
-                        }
-                    }
-                    if (IsConnected) break;
-                }
-
-                if (IsConnected) {
-                    Stack.Add(j);
+            // 頂点を共有する未使用の三角形を番号の昇順に積む
+            // (全三角形を走査していた時と同じ出力順になる)
+            Neighbors.Reset();
+            for (int32 k = 0; k < 3; ++k) {
+                const int32 V = Triangles[Current * 3 + k];
+                for (int32 n = VertexOffsets[V]; n < VertexOffsets[V + 1]; ++n) {
+                    const int32 T = VertexTriangles[n];
+                    if (Used[T] == false)
+                        Neighbors.Add(T);
                 }
             }
+            Neighbors.Sort();
+            for (int32 n = 0; n < Neighbors.Num(); ++n) {
+                if (n > 0 && Neighbors[n] == Neighbors[n - 1])
+                    continue;
+                Stack.Add(Neighbors[n]);
+            }
         }
-        Result.Add(NewMesh);
+        Result.Add(MoveTemp(NewMesh));
     }
 
     return Result;
@@ -72,6 +101,7 @@ TArray<TArray<int32>> FSubDividedCityObjectSubMesh::CreateOutlineIndices() const
     // Key   : 辺
     // Value : 0以上の場合は三角形のインデックス、-1の場合は複数の三角形に接続している
     TMap<TTuple<int32, int32>, int32> Edge2Triangle;
+    Edge2Triangle.Reserve(Triangles.Num());
     for (int32 i = 0; i < Triangles.Num(); i += 3) 
     {
         auto T = i / 3;
@@ -99,22 +129,20 @@ TArray<TArray<int32>> FSubDividedCityObjectSubMesh::CreateOutlineIndices() const
     }
 
     // Convert to continuous outlines
-    while (OutlineEdges.Num() > 0) 
+    // 各頂点に接続する辺のうち, 配列上で最初の未使用の辺を辿る
+    FGeoGraph2D::FEdgeChainTable Table(OutlineEdges);
+    for (auto EdgeIndex = Table.PopFirst(); EdgeIndex >= 0; EdgeIndex = Table.PopFirst())
     {
-        TArray<int32> Outline;
-        auto Edge = OutlineEdges[0];
-        OutlineEdges.RemoveAt(0);
-
+        auto Edge = OutlineEdges[EdgeIndex];
         auto Indices = TArray<int32>{ Edge.Key, Edge.Value };
-        while(OutlineEdges.Num() > 0)
+        while(true)
         {
             auto V0 = Indices[0];
             auto LastV = Indices[Indices.Num() - 1];
-            auto Index = OutlineEdges.IndexOfByPredicate([LastV](const TTuple<int32, int32>& E) { return E.Key == LastV || E.Value == LastV; });
+            auto Index = Table.PopFirst(LastV);
             if (Index < 0)
                 break;
             auto E = OutlineEdges[Index];
-            OutlineEdges.RemoveAt(Index);
             // 1周した
             if (E.Key == V0 || E.Value == V0)
                 break;
@@ -137,58 +165,123 @@ void FSubDividedCityObjectMesh::VertexReduction() {
         return;
     }
 
-    // Create vertex mapping
-    TMap<FVector, int32> VertexMap;
-    TArray<int32> OldToNewIndices;
-    OldToNewIndices.SetNum(Vertices.Num());
-    for (int32 i = 0; i < Vertices.Num(); ++i) {
-        const FVector& Vertex = Vertices[i];
-        if (VertexMap.Contains(Vertex))
-            continue;
-        VertexMap.Add(Vertex, VertexMap.Num());
+    const int32 VertexNum = Vertices.Num();
+    auto ToBits = [](const double V) {
+        uint64 Bits;
+        FMemory::Memcpy(&Bits, &V, sizeof(Bits));
+        return Bits;
+    };
+    auto IsSameVertex = [&](const int32 A, const int32 B) {
+        return ToBits(Vertices[A].X) == ToBits(Vertices[B].X)
+            && ToBits(Vertices[A].Y) == ToBits(Vertices[B].Y)
+            && ToBits(Vertices[A].Z) == ToBits(Vertices[B].Z);
+    };
+
+    // 座標(のビット列)でソートして同じ頂点を連続させる. 同じ座標内は元の番号順
+    TArray<int32> Order;
+    Order.SetNumUninitialized(VertexNum);
+    for (int32 i = 0; i < VertexNum; ++i) {
+        Order[i] = i;
+    }
+    Algo::Sort(Order, [&](const int32 A, const int32 B) {
+        const auto& VA = Vertices[A];
+        const auto& VB = Vertices[B];
+        if (ToBits(VA.X) != ToBits(VB.X))
+            return ToBits(VA.X) < ToBits(VB.X);
+        if (ToBits(VA.Y) != ToBits(VB.Y))
+            return ToBits(VA.Y) < ToBits(VB.Y);
+        if (ToBits(VA.Z) != ToBits(VB.Z))
+            return ToBits(VA.Z) < ToBits(VB.Z);
+        return A < B;
+    });
+
+    // OldToNew[i] には一旦同じ座標の最初の頂点番号を入れ、
+    // 前から順に新しい番号へ置き換える(最初に出現した順に番号を振る)
+    TArray<int32> OldToNew;
+    OldToNew.SetNumUninitialized(VertexNum);
+    for (int32 k = 0; k < VertexNum; ++k) {
+        const bool bHead = k == 0 || IsSameVertex(Order[k - 1], Order[k]) == false;
+        OldToNew[Order[k]] = bHead ? Order[k] : OldToNew[Order[k - 1]];
+    }
+    TArray<FVector> NewVertices;
+    for (int32 i = 0; i < VertexNum; ++i) {
+        if (OldToNew[i] == i) {
+            OldToNew[i] = NewVertices.Num();
+            NewVertices.Add(Vertices[i]);
+        }
+        else {
+            OldToNew[i] = OldToNew[OldToNew[i]];
+        }
     }
+
+    // 三角形の重複除去用のオープンアドレス法のハッシュ表. 値は出力済みの三角形番号
+    TArray<int32> Slots;
     for (auto& SubMesh : SubMeshes) 
     {
-        TSet<TTuple<int32, int32, int32>> NewTriangles;
-        for (int32 i = 0; i < SubMesh.Triangles.Num(); i+=3) 
+        auto& Triangles = SubMesh.Triangles;
+        const int32 TriangleNum = Triangles.Num() / 3;
+        const int32 SlotNum = FMath::RoundUpToPowerOfTwo(FMath::Max(TriangleNum * 2, 16));
+        Slots.SetNumUninitialized(SlotNum, false);
+        FMemory::Memset(Slots.GetData(), 0xFF, SlotNum * sizeof(int32));
+        const int32 SlotBits = FMath::FloorLog2(SlotNum);
+
+        // 出力は入力より前にしか書かないので、その場で詰める
+        int32 OutNum = 0;
+        for (int32 i = 0; i < TriangleNum * 3; i+=3) 
         {
-            auto I0 = VertexMap[Vertices[SubMesh.Triangles[i]]];
-            auto I1 = VertexMap[Vertices[SubMesh.Triangles[i + 1]]];
-            auto I2 = VertexMap[Vertices[SubMesh.Triangles[i + 2]]];
+            int32 I0 = OldToNew[Triangles[i]];
+            int32 I1 = OldToNew[Triangles[i + 1]];
+            int32 I2 = OldToNew[Triangles[i + 2]];
             // 三角形にならない場合は削除
             if (I0 == I1 || I1 == I2 || I2 == I0) {
                 continue;
             }
-            // 同じ三関係を削除するためにソート
-            TArray<int32> Ind = { I0, I1, I2 };
-            Ind.Sort();
-            NewTriangles.Add(MakeTuple(Ind[0], Ind[1], Ind[2]));
-        }
-        SubMesh.Triangles.Empty();
-        for (auto&& T : NewTriangles) {
-            SubMesh.Triangles.Add(T.Get<0>());
-            SubMesh.Triangles.Add(T.Get<1>());
-            SubMesh.Triangles.Add(T.Get<2>());
+            // 同じ三角形を削除するためにソート
+            if (I0 > I1) Swap(I0, I1);
+            if (I1 > I2) Swap(I1, I2);
+            if (I0 > I1) Swap(I0, I1);
+
+            const uint64 Key = (static_cast<uint64>(I0) << 42) ^ (static_cast<uint64>(I1) << 21) ^ static_cast<uint64>(I2);
+            uint32 Slot = static_cast<uint32>((Key * 0x9E3779B97F4A7C15ull) >> (64 - SlotBits));
+            bool bFound = false;
+            while (Slots[Slot] >= 0) {
+                const int32 T = Slots[Slot] * 3;
+                if (Triangles[T] == I0 && Triangles[T + 1] == I1 && Triangles[T + 2] == I2) {
+                    bFound = true;
+                    break;
+                }
+                Slot = (Slot + 1) & (SlotNum - 1);
+            }
+            if (bFound)
+                continue;
+
+            Slots[Slot] = OutNum;
+            Triangles[OutNum * 3] = I0;
+            Triangles[OutNum * 3 + 1] = I1;
+            Triangles[OutNum * 3 + 2] = I2;
+            OutNum++;
         }
+        Triangles.SetNum(OutNum * 3, false);
     }
 
-    TArray<FVector> NewVertices;
-    NewVertices.SetNumUninitialized(VertexMap.Num());
-    for (auto&& P : VertexMap) {
-        NewVertices[P.Value] = P.Key;
-    }
-   
     // Update vertices
-    Vertices = NewVertices;
+    Vertices = MoveTemp(NewVertices);
 }
 
 void FSubDividedCityObjectMesh::Separate() {
+    // サブメッシュ毎に独立しているので並列に分離し、元の順番で結合する
+    TArray<TArray<FSubDividedCityObjectSubMesh>> Separated;
+    Separated.SetNum(SubMeshes.Num());
+    ParallelFor(SubMeshes.Num(), [&](int32 i) {
+        Separated[i] = SubMeshes[i].Separate();
+    }, SubMeshes.Num() <= 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced);
+
     TArray<FSubDividedCityObjectSubMesh> NewSubMeshes;
-    for (const auto& SubMesh : SubMeshes) {
-        NewSubMeshes.Append(SubMesh.Separate());
+    for (auto& S : Separated) {
+        NewSubMeshes.Append(MoveTemp(S));
     }
 
-    SubMeshes = NewSubMeshes;
+    SubMeshes = MoveTemp(NewSubMeshes);
 }
 
 FSubDividedCityObjectMesh FSubDividedCityObjectMesh::DeepCopy() const {
@@ -224,7 +317,8 @@ FSubDividedCityObject::FSubDividedCityObject(UPLATEAUCityObjectGroup* Co, const
 FSubDividedCityObject::FSubDividedCityObject(UPLATEAUCityObjectGroup* Co,
     const plateau::polygonMesh::Node& PlateauNode,
     TMap<FString, FPLATEAUCityObject>& CityObj,
-    ERRoadTypeMask ParentTypeMask)
+    ERRoadTypeMask ParentTypeMask,
+    bool bVertexReduction)
     : Name(PlateauNode.getName().c_str())
     , SelfRoadType(ERRoadTypeMask::Empty)
     , ParentRoadType(ParentTypeMask) {
@@ -253,8 +347,9 @@ FSubDividedCityObject::FSubDividedCityObject(UPLATEAUCityObjectGroup* Co,
             }
             Mesh.SubMeshes.Add(SubMesh);
         }
-        Mesh.VertexReduction();
-        Meshes.Add(Mesh);
+        if (bVertexReduction)
+            Mesh.VertexReduction();
+        Meshes.Add(MoveTemp(Mesh));
     }
 
     const FString DesiredName = FString(UTF8_TO_TCHAR(PlateauNode.getName().c_str()));
@@ -265,7 +360,7 @@ FSubDividedCityObject::FSubDividedCityObject(UPLATEAUCityObjectGroup* Co,
     // Process child nodes
     for (int32 i = 0; i < PlateauNode.getChildCount(); ++i) {
         auto& ChildNode = PlateauNode.getChildAt(i);
-        FSubDividedCityObject Child(Co, ChildNode, CityObj, SelfRoadType);
+        FSubDividedCityObject Child(Co, ChildNode, CityObj, SelfRoadType, bVertexReduction);
         Children.Add(Child);
     }
 }
@@ -288,6 +383,27 @@ void FSubDividedCityObject::SetCityObjectGroup(UPLATEAUCityObjectGroup* Group) {
     }
 }
 
+void FSubDividedCityObject::CollectAllMeshes(FSubDividedCityObject& Obj, TArray<FSubDividedCityObjectMesh*>& OutMeshes) {
+    for (auto& Mesh : Obj.Meshes) {
+        OutMeshes.Add(&Mesh);
+    }
+    for (auto& Child : Obj.Children) {
+        CollectAllMeshes(Child, OutMeshes);
+    }
+}
+
+void FSubDividedCityObject::VertexReductionMeshes(const TArray<TSharedPtr<FSubDividedCityObject>>& Objects) {
+    TArray<FSubDividedCityObjectMesh*> TargetMeshes;
+    for (auto& Obj : Objects) {
+        if (Obj.IsValid())
+            CollectAllMeshes(*Obj, TargetMeshes);
+    }
+
+    ParallelFor(TargetMeshes.Num(), [&TargetMeshes](int32 i) {
+        TargetMeshes[i]->VertexReduction();
+    }, EParallelForFlags::Unbalanced);
+}
+
 TSharedPtr<FSubDividedCityObject> FSubDividedCityObject::DeepCopy()
 {
     auto Result = MakeShared<FSubDividedCityObject>();
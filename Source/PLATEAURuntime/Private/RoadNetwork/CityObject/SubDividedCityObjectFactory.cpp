@@ -47,12 +47,14 @@ FSubDividedCityObjectFactory::ConvertCityObjectsAsync(
 
         for (auto i = 0; i < model->getRootNodeCount(); ++i) {
             auto& Node = model->getRootNodeAt(i);
-            auto SO = MakeShared<FSubDividedCityObject>(CityObjectGroup, Node, Loader.GetCityObjMap(), ERRoadTypeMask::Empty);
+            auto SO = MakeShared<FSubDividedCityObject>(CityObjectGroup, Node, Loader.GetCityObjMap(), ERRoadTypeMask::Empty, false);
             Result->ConvertedCityObjects.Add(SO);
         }
     }
 
-   
+    // 頂点の結合はメッシュ毎に独立しているのでまとめて並列に行う
+    FSubDividedCityObject::VertexReductionMeshes(Result->ConvertedCityObjects);
+
 
     return Result;
 }
@@ -17,6 +17,7 @@
 #include "RoadNetwork/Structure/RnSideWalk.h"
 #include "RoadNetwork/Structure/RnLineString.h"
 #include "RoadNetwork/Structure/RnRoadGroup.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Structure/RnWay.h"
 #include "RoadNetwork/Util/PLATEAURnLinq.h"
 
@@ -1085,12 +1086,12 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
                 {
                     LeftLaneNum = FMath::Max(1, LeftLaneNum);
                     RightLaneNum = FMath::Max(1, RightLaneNum);
-                    RoadGroup->SetLaneCountWithMedian(LeftLaneNum, RightLaneNum, MedianWidth / BorderWidth);
+                    RoadGroup->SetLaneCountWithMedian(LeftLaneNum, RightLaneNum, MedianWidth / BorderWidth, false);
                 }
                 // レーン数が2以上になる場合だけ分割する
                 else if((LeftLaneNum + RightLaneNum) > 1)
                 {
-                    RoadGroup->SetLaneCount(LeftLaneNum, RightLaneNum);
+                    RoadGroup->SetLaneCount(LeftLaneNum, RightLaneNum, false);
                 }
             }
         }
@@ -1120,8 +1121,9 @@ TRnRef_T<URnModel> FRoadNetworkFactoryEx::CreateRnModel(
 
         if(Self.bBuildTracks)
         {
-            for (auto Inter : Model->GetIntersections())
-                Inter->BuildTracks();
+            // 隣接しない交差点同士は並列に計算する
+            FRnTracksBuilder TracksBuilder;
+            TracksBuilder.BuildTracks(Model->GetIntersections(), FBuildTrackOption::Default());
         }
 
     }
@@ -4,6 +4,59 @@
 #include "Math/UnrealMathUtility.h"
 #include "MathUtil.h"
 
+namespace {
+    /**
+     * @brief CellSize四方のセルに点を登録し, 近傍セル(隣接セルを含む)の点だけを列挙するための空間ハッシュです。
+     * CellSize未満の距離にある点は必ず列挙されます。
+     */
+    class FNearPointGrid {
+    public:
+        FNearPointGrid(double InCellSize, int32 Capacity, bool bInUseZ)
+            : CellSize(InCellSize)
+            , bUseZ(bInUseZ)
+        {
+            Heads.Reserve(Capacity);
+            Next.Init(INDEX_NONE, Capacity);
+        }
+
+        void Add(int32 Index, const FVector& Position) {
+            auto& Head = Heads.FindOrAdd(ToCell(Position), INDEX_NONE);
+            Next[Index] = Head;
+            Head = Index;
+        }
+
+        template<class TFunc>
+        void ForEachNear(const FVector& Position, TFunc&& Func) const {
+            const auto Cell = ToCell(Position);
+            const int32 ZRange = bUseZ ? 1 : 0;
+            for (int32 X = -1; X <= 1; ++X) {
+                for (int32 Y = -1; Y <= 1; ++Y) {
+                    for (int32 Z = -ZRange; Z <= ZRange; ++Z) {
+                        const auto Head = Heads.Find(Cell + FInt64Vector(X, Y, Z));
+                        if (Head == nullptr)
+                            continue;
+                        for (int32 i = *Head; i != INDEX_NONE; i = Next[i])
+                            Func(i);
+                    }
+                }
+            }
+        }
+
+    private:
+        FInt64Vector ToCell(const FVector& Position) const {
+            return FInt64Vector(
+                static_cast<int64>(FMath::FloorToDouble(Position.X / CellSize)),
+                static_cast<int64>(FMath::FloorToDouble(Position.Y / CellSize)),
+                bUseZ ? static_cast<int64>(FMath::FloorToDouble(Position.Z / CellSize)) : 0);
+        }
+
+        double CellSize;
+        bool bUseZ;
+        TMap<FInt64Vector, int32> Heads;
+        TArray<int32> Next;
+    };
+}
+
 
 bool FGeoGraph2D::FVector2DEquitable::Equals(const FVector2D& X, const FVector2D& Y) const {
     return (X - Y).SizeSquared() < Tolerance;
@@ -279,34 +332,55 @@ TArray<FVector> FGeoGraph2D::ComputeConvexVolume(
     TFunction<FVector2D(const FVector&)> ToVec2)
 {
     TArray<FVector2D > Points2D;
+    Points2D.Reserve(Vertices.Num());
     for(auto& v : Vertices)
         Points2D.Add(ToVec2(v));
 
-    auto ConvexHull2D = ComputeConvexVolume(Points2D);
+    // 2D座標が同じ頂点が複数ある場合は, 先頭に近い方を返す
+    FNearPointGrid Grid(Eps, Points2D.Num(), false);
+    for (int32 i = 0; i < Points2D.Num(); ++i)
+        Grid.Add(i, FVector(Points2D[i], 0.f));
 
     TArray<FVector> Result;
-    for (const auto& Point2D : ConvexHull2D) {
-        for (const auto& Vertex : Vertices) {
-            if (FVector2D::Distance(ToVec2(Vertex), Point2D) < Eps) {
-                Result.Add(Vertex);
-                break;
-            }
-        }
+    for (const auto HullIndex : ComputeConvexVolumeIndices(Points2D)) {
+        int32 Found = INDEX_NONE;
+        Grid.ForEachNear(FVector(Points2D[HullIndex], 0.f), [&](int32 i) {
+            if ((Found == INDEX_NONE || i < Found) && FVector2D::Distance(Points2D[i], Points2D[HullIndex]) < Eps)
+                Found = i;
+        });
+        if (Found != INDEX_NONE)
+            Result.Add(Vertices[Found]);
     }
     return Result;
 }
+
 TArray<FVector2D> FGeoGraph2D::ComputeConvexVolume(const TArray<FVector2D>& Vertices) {
     if (Vertices.Num() <= 3) {
         return Vertices;
     }
 
+    TArray<FVector2D> Points;
+    for (const auto Index : ComputeConvexVolumeIndices(Vertices)) {
+        Points.Add(Vertices[Index]);
+    }
+    return Points;
+}
+
+TArray<int32> FGeoGraph2D::ComputeConvexVolumeIndices(const TArray<FVector2D>& Vertices) {
+    if (Vertices.Num() <= 3) {
+        TArray<int32> All;
+        for (int32 i = 0; i < Vertices.Num(); ++i)
+            All.Add(i);
+        return All;
+    }
+
     // Find the leftmost bottom point
     int32 StartIndex = FindMostLeftBottom<FVector2D>(Vertices, [](FVector2D V) {return V; });
-    TArray<FVector2D> Points = { Vertices[StartIndex] };
     TArray<int32> Stack = { StartIndex };
 
     // Sort points by angle and distance
     TArray<TTuple<int32, float>> Angles;
+    Angles.Reserve(Vertices.Num());
     for (int32 i = 0; i < Vertices.Num(); ++i) {
         if (i == StartIndex) continue;
 
@@ -333,14 +407,12 @@ TArray<FVector2D> FGeoGraph2D::ComputeConvexVolume(const TArray<FVector2D>& Vert
                 break;
             }
             Stack.Pop();
-            Points.Pop();
         }
 
         Stack.Add(IndexAngle.Key);
-        Points.Add(Vertices[IndexAngle.Key]);
     }
 
-    return Points;
+    return Stack;
 }
 
 TArray<int32> FGeoGraph2D::GetNearVertexTable(
@@ -369,6 +441,90 @@ TArray<int32> FGeoGraph2D::GetNearVertexTable(
     return Result;
 }
 
+TArray<int32> FGeoGraph2D::GetNearVertexTable(const TArray<FVector>& Vertices, float Epsilon) {
+    TArray<int32> Result;
+    Result.SetNum(Vertices.Num());
+    for (int32 i = 0; i < Vertices.Num(); ++i)
+        Result[i] = i;
+    if (Epsilon <= 0.f)
+        return Result;
+
+    // 自身より前の頂点だけがグリッドに入っている状態で検索する
+    FNearPointGrid Grid(Epsilon, Vertices.Num(), true);
+    for (int32 i = 0; i < Vertices.Num(); ++i) {
+        float MinDistance = MAX_flt;
+        int32 MinIndex = i;
+        Grid.ForEachNear(Vertices[i], [&](int32 j) {
+            const float Distance = FVector::Distance(Vertices[i], Vertices[j]);
+            if (Distance >= Epsilon)
+                return;
+            // 全頂点を前から比較した場合と同じく, 距離が同じなら前の頂点を優先する
+            if (Distance < MinDistance || (Distance == MinDistance && j < MinIndex)) {
+                MinDistance = Distance;
+                MinIndex = j;
+            }
+        });
+        Result[i] = MinIndex;
+        Grid.Add(i, Vertices[i]);
+    }
+    return Result;
+}
+
+FGeoGraph2D::FEdgeChainTable::FEdgeChainTable(const TArray<TTuple<int32, int32>>& Edges)
+    : Used(false, Edges.Num())
+{
+    int32 MaxVertex = -1;
+    for (const auto& Edge : Edges) {
+        MaxVertex = FMath::Max3(MaxVertex, Edge.Get<0>(), Edge.Get<1>());
+    }
+
+    Offsets.SetNumZeroed(MaxVertex + 2);
+    for (const auto& Edge : Edges) {
+        Offsets[Edge.Get<0>() + 1]++;
+        if (Edge.Get<1>() != Edge.Get<0>())
+            Offsets[Edge.Get<1>() + 1]++;
+    }
+    for (int32 v = 0; v <= MaxVertex; ++v) {
+        Offsets[v + 1] += Offsets[v];
+    }
+
+    // 辺番号の昇順に詰めるので各頂点のリストも昇順になる
+    Cursors = TArray<int32>(Offsets.GetData(), MaxVertex + 1);
+    VertexEdges.SetNumUninitialized(Offsets.Last());
+    for (int32 i = 0; i < Edges.Num(); ++i) {
+        VertexEdges[Cursors[Edges[i].Get<0>()]++] = i;
+        if (Edges[i].Get<1>() != Edges[i].Get<0>())
+            VertexEdges[Cursors[Edges[i].Get<1>()]++] = i;
+    }
+    Cursors = TArray<int32>(Offsets.GetData(), MaxVertex + 1);
+}
+
+int32 FGeoGraph2D::FEdgeChainTable::PopFirst() {
+    while (FirstCursor < Used.Num() && Used[FirstCursor])
+        FirstCursor++;
+    if (FirstCursor >= Used.Num())
+        return -1;
+    Used[FirstCursor] = true;
+    return FirstCursor;
+}
+
+int32 FGeoGraph2D::FEdgeChainTable::PopFirst(int32 Vertex) {
+    if (Vertex < 0 || Vertex >= Cursors.Num())
+        return -1;
+
+    // 使用済みの辺は二度と使われないので、カーソルを進めるだけで良い
+    auto& Cursor = Cursors[Vertex];
+    const int32 End = Offsets[Vertex + 1];
+    while (Cursor < End && Used[VertexEdges[Cursor]])
+        Cursor++;
+    if (Cursor >= End)
+        return -1;
+
+    const int32 Edge = VertexEdges[Cursor];
+    Used[Edge] = true;
+    return Edge;
+}
+
 TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
     const TArray<FVector>& Vert,
     const TArray<int32>& Triangles,
@@ -376,6 +532,7 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
     float Epsilon) {
     // Create edge list from triangles
     TArray<TTuple<int32, int32>> Edges;
+    Edges.Reserve(Triangles.Num());
     for (int32 i = 0; i < Triangles.Num(); i += 3) {
         Edges.Add(MakeTuple(Triangles[i], Triangles[i + 1]));
         Edges.Add(MakeTuple(Triangles[i + 1], Triangles[i + 2]));
@@ -384,9 +541,10 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
 
     // Count edge occurrences
     TMap<TTuple<int32, int32>, int32> EdgeCount;
+    EdgeCount.Reserve(Edges.Num());
     for (const auto& Edge : Edges) {
         auto NormalizedEdge = Edge.Get<0>() < Edge.Get<1>() ? Edge : MakeTuple(Edge.Get<1>(), Edge.Get<0>());
-        EdgeCount.Add(NormalizedEdge, EdgeCount.FindRef(NormalizedEdge) + 1);
+        EdgeCount.FindOrAdd(NormalizedEdge)++;
     }
 
     // Find outline edges (edges that appear only once)
@@ -404,31 +562,19 @@ TArray<FVector> FGeoGraph2D::ComputeMeshOutlineVertices(
         return Result;
     }
 
+    // 現在の頂点に接続する辺のうち、配列上で最初のものを辿る
+    FEdgeChainTable Table(OutlineEdges);
     int32 CurrentVertex = OutlineEdges[0].Get<0>();
     Result.Add(Vert[CurrentVertex]);
 
-    while (OutlineEdges.Num() > 0) {
-        bool Found = false;
-        for (int32 i = 0; i < OutlineEdges.Num(); ++i) {
-            if (OutlineEdges[i].Get<0>() == CurrentVertex) {
-                CurrentVertex = OutlineEdges[i].Get<1>();
-                Result.Add(Vert[CurrentVertex]);
-                OutlineEdges.RemoveAt(i);
-                Found = true;
-                break;
-            }
-            if (OutlineEdges[i].Get<1>() == CurrentVertex) {
-                CurrentVertex = OutlineEdges[i].Get<0>();
-                Result.Add(Vert[CurrentVertex]);
-                OutlineEdges.RemoveAt(i);
-                Found = true;
-                break;
-            }
-        }
-
-        if (!Found) {
+    while (true) {
+        const int32 EdgeIndex = Table.PopFirst(CurrentVertex);
+        if (EdgeIndex < 0) {
             break;
         }
+        const auto& Edge = OutlineEdges[EdgeIndex];
+        CurrentVertex = Edge.Get<0>() == CurrentVertex ? Edge.Get<1>() : Edge.Get<0>();
+        Result.Add(Vert[CurrentVertex]);
     }
 
     return Result;
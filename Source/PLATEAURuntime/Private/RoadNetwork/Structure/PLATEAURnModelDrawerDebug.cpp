@@ -10,6 +10,12 @@
 #include "RoadNetwork/Structure/RnWay.h"
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 #include "RoadNetwork/Util/PLATEAURnEx.h"
+#include "Components/LineBatchComponent.h"
+#include "ConvexVolume.h"
+#include "SceneManagement.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
 
 
 namespace
@@ -84,6 +90,19 @@ namespace
             FPLATEAURnDebugEx::DrawDashedArrows(Vertices, bIsLoop, Color, LineLength, SpaceLength, Duration);
         }
 
+        /// <summary>
+        /// ShowPartsTypeにMaskが含まれる場合に表示される名前
+        /// 保持モードでは表示条件を付けて記録し、表示するかどうかは毎フレーム判定する
+        /// </summary>
+        void DrawLabel(ERnPartsTypeMask Mask, const FString& Text, const FVector& Location) {
+            if (const auto Buffer = FPLATEAURnDebugEx::GetCaptureBuffer()) {
+                Buffer->Labels.Add({ Text, Location, FLinearColor::White, 1.0f, static_cast<int32>(Mask) });
+                return;
+            }
+            if ((Self->ShowPartsType & static_cast<int32>(Mask)) != 0)
+                FPLATEAURnDebugEx::DrawString(Text, Location);
+        }
+
     };
 
     template<class T>
@@ -322,8 +341,7 @@ void FPLATEAURnModelDrawerDebug::Draw(URnModel* Model)
                 Work.DrawArrow(Center, Border->GetLerpPoint(0.5f), 50, FVector::UpVector, Color);
             };
 
-            if ((Work.Self->ShowPartsType & (int32)ERnPartsTypeMask::Lane) != 0)
-                FPLATEAURnDebugEx::DrawString(FString::Printf(TEXT("%s"), *Self.GetName()), Center);
+            Work.DrawLabel(ERnPartsTypeMask::Lane, Self.GetName(), Center);
 
             DrawNeighborConnection(Option.bShowPrevRoad, Self.GetPrevBorder(), FColor::Red);
             DrawNeighborConnection(Option.bShowNextRoad, Self.GetNextBorder(), FColor::Blue);
@@ -444,8 +462,7 @@ void FPLATEAURnModelDrawerDebug::Draw(URnModel* Model)
     private:
         virtual bool DrawImpl(RnModelDrawWork& Work, URnRoad& Self) override
         {
-            if ((Work.Self->ShowPartsType & (int32)ERnPartsTypeMask::Road) != 0)
-                FPLATEAURnDebugEx::DrawString(FString::Printf(TEXT("%s"), *Self.GetName()), Self.GetCentralVertex());
+            Work.DrawLabel(ERnPartsTypeMask::Road, Self.GetName(), Self.GetCentralVertex());
 
             if (Option.bCheckSliceHorizontal) {
                 FLineSegment3D Segment;
@@ -540,8 +557,7 @@ void FPLATEAURnModelDrawerDebug::Draw(URnModel* Model)
                 }
             }
 
-            if ((Work.Self->ShowPartsType & (int32)ERnPartsTypeMask::Intersection) != 0)
-                FPLATEAURnDebugEx::DrawString(FString::Printf(TEXT("%s"), *Self.GetName()), Self.GetCentralVertex());
+            Work.DrawLabel(ERnPartsTypeMask::Intersection, Self.GetName(), Self.GetCentralVertex());
             return true;
         }
     };
@@ -559,8 +575,7 @@ void FPLATEAURnModelDrawerDebug::Draw(URnModel* Model)
             Way(Option.ShowStartEdgeWay).Draw(Work, Self.GetStartEdgeWay(), Work.visibleType);
             Way(Option.ShowEndEdgeWay).Draw(Work, Self.GetEndEdgeWay(), Work.visibleType);
 
-            if ((Work.Self->ShowPartsType & (int32)ERnPartsTypeMask::SideWalk) != 0)
-                FPLATEAURnDebugEx::DrawString(FString::Printf(TEXT("%s"), *Self.GetName()), Self.GetCentralVertex());
+            Work.DrawLabel(ERnPartsTypeMask::SideWalk, Self.GetName(), Self.GetCentralVertex());
             return true;
         }
     };
@@ -595,3 +610,111 @@ void FPLATEAURnModelDrawerDebug::Draw(URnModel* Model)
     for (auto& Delay : Work.DelayExecs)
         Delay();
 }
+
+void FPLATEAURnModelDrawerDebug::DrawRetained(AActor* Owner, URnModel* Model)
+{
+    if (bVisible == false || !Owner || !Model) {
+        ClearRetained();
+        return;
+    }
+
+    if (bRetainedDirty || RetainedModel.Get() != Model || RetainedModelVersion != Model->GetModifiedVersion())
+        BuildRetained(Owner, Model);
+
+    // 線分はラインバッチコンポーネントとして描画されるので、ここでは名前のみ描画する
+    FConvexVolume Frustum;
+    bool bHasFrustum = false;
+    if (const auto PlayerController = Owner->GetWorld()->GetFirstPlayerController()) {
+        if (PlayerController->PlayerCameraManager) {
+            FMatrix ViewMatrix, ProjectionMatrix, ViewProjectionMatrix;
+            UGameplayStatics::GetViewProjectionMatrix(PlayerController->PlayerCameraManager->GetCameraCacheView(), ViewMatrix, ProjectionMatrix, ViewProjectionMatrix);
+            GetViewFrustumBounds(Frustum, ViewProjectionMatrix, false);
+            bHasFrustum = true;
+        }
+    }
+
+    for (const auto& Cell : RetainedCells) {
+        if (Cell.Labels.IsEmpty())
+            continue;
+        if (bHasFrustum && !Frustum.IntersectBox(Cell.Bounds.GetCenter(), Cell.Bounds.GetExtent()))
+            continue;
+        for (const auto& Label : Cell.Labels) {
+            if (Label.Mask != 0 && (ShowPartsType & Label.Mask) == 0)
+                continue;
+            FPLATEAURnDebugEx::DrawString(Label.Text, Label.Location, Label.Color, 0.0f, Label.FontScale);
+        }
+    }
+}
+
+void FPLATEAURnModelDrawerDebug::MarkDirty()
+{
+    bRetainedDirty = true;
+}
+
+void FPLATEAURnModelDrawerDebug::ClearRetained()
+{
+    for (const auto& LineBatcher : RetainedLineBatchers) {
+        if (IsValid(LineBatcher))
+            LineBatcher->DestroyComponent();
+    }
+    RetainedLineBatchers.Reset();
+    RetainedCells.Reset();
+    RetainedModel.Reset();
+    bRetainedDirty = true;
+}
+
+int32 FPLATEAURnModelDrawerDebug::GetRetainedBuildCount() const
+{
+    return RetainedBuildCount;
+}
+
+void FPLATEAURnModelDrawerDebug::BuildRetained(AActor* Owner, URnModel* Model)
+{
+    ClearRetained();
+
+    // 描画中に遅延実行で構造が変更された場合は次のフレームで作り直す
+    RetainedModel = Model;
+    RetainedModelVersion = Model->GetModifiedVersion();
+    bRetainedDirty = false;
+    ++RetainedBuildCount;
+
+    FPLATEAURnDebugDrawBuffer Buffer;
+    FPLATEAURnDebugEx::SetCaptureBuffer(&Buffer);
+    Draw(Model);
+    FPLATEAURnDebugEx::SetCaptureBuffer(nullptr);
+
+    // 格子ごとにまとめることで、レンダラーのコンポーネント単位の視錐台カリングが効くようにする
+    TMap<FIntPoint, int32> CellIndices;
+    TArray<TArray<FBatchedLine>> CellLines;
+    const auto GetCellIndex = [&](const FVector& Position) {
+        const FIntPoint Key(FMath::FloorToInt32(Position.X / RetainedCellSize), FMath::FloorToInt32(Position.Y / RetainedCellSize));
+        if (const auto Index = CellIndices.Find(Key))
+            return *Index;
+        CellLines.AddDefaulted();
+        return CellIndices.Add(Key, RetainedCells.AddDefaulted());
+    };
+
+    for (const auto& Line : Buffer.Lines) {
+        const auto Index = GetCellIndex((Line.Start + Line.End) * 0.5);
+        RetainedCells[Index].Bounds += Line.Start;
+        RetainedCells[Index].Bounds += Line.End;
+        CellLines[Index].Add(Line);
+    }
+    for (auto& Label : Buffer.Labels) {
+        const auto Index = GetCellIndex(Label.Location);
+        RetainedCells[Index].Bounds += Label.Location;
+        RetainedCells[Index].Labels.Add(MoveTemp(Label));
+    }
+
+    for (auto& Lines : CellLines) {
+        if (Lines.IsEmpty())
+            continue;
+        const auto LineBatcher = NewObject<ULineBatchComponent>(Owner, NAME_None, RF_Transient);
+        LineBatcher->bCalculateAccurateBounds = true;
+        LineBatcher->RegisterComponent();
+        // 寿命付きの線分は持たないため、線分を走査するTickは不要
+        LineBatcher->SetComponentTickEnabled(false);
+        LineBatcher->DrawLines(Lines);
+        RetainedLineBatchers.Add(LineBatcher);
+    }
+}
@@ -14,10 +14,25 @@ void APLATEAURnStructureModel::Tick(float DeltaTime)
     if (Debug.bVisible) {
         if(!Model)
             Model = GetComponentByClass<URnModel>();
+        if (Debug.bRetained) {
+            Debug.DrawRetained(this, Model);
+            return;
+        }
         Debug.Draw(Model);
     }
+    Debug.ClearRetained();
 }
 
+#if WITH_EDITOR
+void APLATEAURnStructureModel::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    // 名前の表示切替は描画時に判定するので作り直さない
+    if (PropertyChangedEvent.GetPropertyName() != GET_MEMBER_NAME_CHECKED(FPLATEAURnModelDrawerDebug, ShowPartsType))
+        Debug.MarkDirty();
+}
+#endif
+
 UE::Tasks::TTask<APLATEAURnStructureModel*> APLATEAURnStructureModel::CreateRnModelAsync(APLATEAUInstancedCityModel* TargetActor)
 {
 #if true
@@ -254,11 +254,14 @@ void URnIntersection::RemoveEdges(const TRnRef_T<URnRoadBase>& Road) {
 }
 
 void URnIntersection::RemoveEdges(const TFunction<bool(const TRnRef_T<URnIntersectionEdge>&)>& Predicate) {
+    const auto Num = Edges.Num();
     for (int32 i = Edges.Num() - 1; i >= 0; --i) {
         if (Predicate((Edges)[i])) {
             Edges.RemoveAt(i);
         }
     }
+    if (Edges.Num() != Num)
+        MarkModelModified();
 }
 
 void URnIntersection::ReplaceEdges(const TRnRef_T<URnRoadBase>& Road, const TArray<TRnRef_T<URnWay>>& NewBorders) {
@@ -277,12 +280,15 @@ int32 URnIntersection::ReplaceEdgeLink(TRnRef_T<URnWay> Border, TRnRef_T<URnRoad
             Count++;
         }
     }
+    if (Count > 0)
+        MarkModelModified();
     return Count;
 }
 
 void URnIntersection::AddEdge(const TRnRef_T<URnRoadBase>& Road, const TRnRef_T<URnWay>& Border) {
     auto NewEdge = RnNew<URnIntersectionEdge>(Road, Border);
     Edges.Add(NewEdge);
+    MarkModelModified();
 }
 
 bool URnIntersection::HasEdge(const TRnRef_T<URnRoadBase>& Road) const {
@@ -333,6 +339,7 @@ void URnIntersection::Align()
 void URnIntersection::ClearTracks()
 {
     Tracks.Empty();
+    MarkModelModified();
 }
 
 TArray<TRnRef_T<URnRoadBase>> URnIntersection::GetNeighborRoads() const {
@@ -374,6 +381,7 @@ void URnIntersection::ReplaceNeighbor(const TRnRef_T<URnRoadBase>& From, const T
             Edge->SetRoad(To);
         }
     }
+    MarkModelModified();
 }
 
 FVector URnIntersection::GetCentralVertex() const {
@@ -427,6 +435,7 @@ bool URnIntersection::TryAddOrUpdateTrack(TRnRef_T<URnTrack> track)
 
     // track追加
     Tracks.Add(track);
+    MarkModelModified();
     return true;
 }
 
@@ -585,6 +594,7 @@ void URnIntersection::SeparateContinuousBorder() {
             i++;
         }
     }
+    MarkModelModified();
 }
 
 void URnIntersection::BuildTracks()
@@ -593,3 +603,12 @@ void URnIntersection::BuildTracks()
     FRnTracksBuilder builder;
     builder.BuildTracks(this, FBuildTrackOption::Default());
 }
+
+void URnIntersection::RequestBuildTracks()
+{
+    if (auto Model = GetParentModel()) {
+        Model->RequestBuildTracks(this);
+        return;
+    }
+    BuildTracks();
+}
@@ -57,6 +57,12 @@ void URnLane::SetParent(TRnRef_T<URnRoad> InParent)
     Parent = InParent;
 }
 
+void URnLane::MarkModelModified() const
+{
+    if (Parent)
+        Parent->MarkModelModified();
+}
+
 TRnRef_T<URnWay> URnLane::GetLeftWay() const
 { return LeftWay; }
 
@@ -131,6 +137,7 @@ void URnLane::SetBorder(EPLATEAURnLaneBorderType Type, const TRnRef_T<URnWay>& B
         PrevBorder = Border;
     else
         NextBorder = Border;
+    MarkModelModified();
 }
 
 TRnRef_T<URnWay> URnLane::GetSideWay(EPLATEAURnDir Dir) const {
@@ -142,6 +149,7 @@ void URnLane::SetSideWay(EPLATEAURnDir Dir, const TRnRef_T<URnWay>& Way) {
         LeftWay = Way;
     else
         RightWay = Way;
+    MarkModelModified();
 }
 
 float URnLane::CalcWidth() const {
@@ -191,6 +199,7 @@ void URnLane::Reverse() {
     Swap(LeftWay, RightWay);
     for (auto Way : GetAllWays())
         Way->Reverse(true);
+    MarkModelModified();
 }
 
 void URnLane::AlignBorder(EPLATEAURnLaneBorderDir borderDir)
@@ -320,6 +329,7 @@ void URnLane::AlignBorder(EPLATEAURnLaneBorderType type, EPLATEAURnLaneBorderDir
     auto dir = GetBorderDir(type);
     if (dir != borderDir) {
         border->Reverse(true);
+        MarkModelModified();
     }
 }
 
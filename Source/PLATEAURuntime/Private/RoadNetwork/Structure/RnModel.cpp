@@ -8,6 +8,7 @@
 #include "RoadNetwork/Structure/RnSideWalk.h"
 #include "RoadNetwork/Structure/RnLane.h"
 #include "RoadNetwork/Structure/RnRoadGroup.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
 #include "RoadNetwork/Structure/RnWay.h"
 
 const FString& URnModel::GetFactoryVersion() const
@@ -20,11 +21,106 @@ void URnModel::SetFactoryVersion(const FString& InFactoryVersion)
     this->FactoryVersion = InFactoryVersion;
 }
 
+uint32 URnModel::GetModifiedVersion() const
+{
+    return ModifiedVersion;
+}
+
+void URnModel::MarkModified()
+{
+    ++ModifiedVersion;
+}
+
+void URnModel::BeginEditTransaction()
+{
+    ++EditTransactionDepth;
+}
+
+FRnModelEditCommitResult URnModel::CommitEditTransaction()
+{
+    FRnModelEditCommitResult Result;
+    if (EditTransactionDepth <= 0) {
+        UE_LOG(LogTemp, Warning, TEXT("CommitEditTransaction is called without BeginEditTransaction"));
+        return Result;
+    }
+
+    if (EditTransactionDepth > 1) {
+        --EditTransactionDepth;
+        return Result;
+    }
+
+    // 境界線の調整で交差点のEdgeが差し替わるため, トランザクション中のまま行いトラックの再生成対象として記録させる
+    const auto RoadGroups = MoveTemp(DeferredBorderRoadGroups);
+    DeferredBorderRoadGroups.Reset();
+    {
+        TGuardValue<bool> Guard(bAdjustingDeferredBorders, true);
+        for (auto RoadGroup : RoadGroups) {
+            if (!RoadGroup->IsValid())
+                continue;
+            RoadGroup->AdjustBorder();
+            ++Result.AdjustedRoadGroupCount;
+        }
+    }
+    EditTransactionDepth = 0;
+
+    // 記録後に削除された交差点は除く
+    TArray<URnIntersection*> TargetIntersections;
+    TargetIntersections.Reserve(DeferredTrackIntersections.Num());
+    for (auto Intersection : DeferredTrackIntersections) {
+        if (Intersection && Intersection->GetParentModel() == this)
+            TargetIntersections.Add(Intersection);
+    }
+    DeferredTrackIntersections.Reset();
+
+    if (TargetIntersections.Num() > 0) {
+        FRnTracksBuilder Builder;
+        Result.IntersectionGroupCount = Builder.BuildTracks(TargetIntersections, FBuildTrackOption::Default());
+        Result.RebuiltIntersectionCount = TargetIntersections.Num();
+    }
+
+    if (Result.AdjustedRoadGroupCount > 0 || Result.RebuiltIntersectionCount > 0)
+        MarkModified();
+    return Result;
+}
+
+bool URnModel::IsInEditTransaction() const
+{
+    return EditTransactionDepth > 0;
+}
+
+void URnModel::RequestBuildTracks(URnIntersection* Intersection)
+{
+    if (!Intersection)
+        return;
+
+    if (IsInEditTransaction()) {
+        DeferredTrackIntersections.Add(Intersection);
+        return;
+    }
+    Intersection->BuildTracks();
+    MarkModified();
+}
+
+bool URnModel::TryDeferAdjustBorder(URnRoadGroup* RoadGroup)
+{
+    if (!IsInEditTransaction() || bAdjustingDeferredBorders)
+        return false;
+
+    // 同じ道路グループは1度だけ調整する
+    const auto bExists = DeferredBorderRoadGroups.ContainsByPredicate([RoadGroup](URnRoadGroup* X) {
+        return URnRoadGroup::IsSameRoadGroup(X, RoadGroup);
+    });
+    if (!bExists)
+        DeferredBorderRoadGroups.Add(RoadGroup);
+    return true;
+}
+
 URnModel::URnModel() {
 }
 
 void URnModel::Init()
 {
+    MarkModified();
     Roads.Reset();
     Intersections.Reset();
     SideWalks.Reset();
@@ -43,35 +139,41 @@ void URnModel::AddRoadBase(const TRnRef_T<URnRoadBase>& RoadBase)
 }
 
 void URnModel::AddRoad(const TRnRef_T<URnRoad>& Road) {
+    MarkModified();
     if (!Road) return;
     Road->SetParentModel(TRnRef_T<URnModel>(this));
     Roads.AddUnique(Road);
 }
 
 void URnModel::RemoveRoad(const TRnRef_T<URnRoad>& Road) {
+    MarkModified();
     if (!Road) return;
     Road->SetParentModel(nullptr);
     Roads.Remove(Road);
 }
 
 void URnModel::AddIntersection(const TRnRef_T<URnIntersection>& Intersection) {
+    MarkModified();
     if (!Intersection) return;
     Intersection->SetParentModel(TRnRef_T<URnModel>(this));
     Intersections.AddUnique(Intersection);
 }
 
 void URnModel::RemoveIntersection(const TRnRef_T<URnIntersection>& Intersection) {
+    MarkModified();
     if (!Intersection) return;
     Intersection->SetParentModel(nullptr);
     Intersections.Remove(Intersection);
 }
 
 void URnModel::AddSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
+    MarkModified();
     if (!SideWalk) return;
     SideWalks.AddUnique(SideWalk);
 }
 
 void URnModel::RemoveSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
+    MarkModified();
     if (!SideWalk) return;
     SideWalks.Remove(SideWalk);
 }
@@ -160,6 +262,8 @@ TArray<TRnRef_T<URnSideWalk>> URnModel::GetNeighborSideWalks(const TRnRef_T<URnR
 
 void URnModel::CalibrateIntersectionBorderForAllRoad(const FRnModelCalibrateIntersectionBorderOption& Option)
 {
+    // 同じ交差点に複数の道路がマージされるため, トラックの再生成はまとめて行う
+    FRnModelEditScope EditScope(this);
     TSet<URnRoad*> Prevs;
     TSet<URnRoad*> Nexts;
 
@@ -197,6 +301,7 @@ bool URnModel::TrySliceRoadHorizontalNearByBorder(
     URnRoad*& OutPrevSideRoad,
     URnRoad*& OutCenterSideRoad,
     URnRoad*& OutNextSideRoad) {
+    MarkModified();
     OutPrevSideRoad = nullptr;
     OutNextSideRoad = nullptr;
     OutCenterSideRoad = Road;
@@ -343,6 +448,7 @@ TArray<TRnRef_T<URnRoadBase>> URnModel::GetConnectedRoadBasesRecursive(const TRn
 
 void URnModel::MergeRoadGroup()
 {
+    MarkModified();
     TSet<TRnRef_T<URnRoad>> visitedRoads;
     auto CopiedRoads = Roads;
     for(auto& road : CopiedRoads)
@@ -361,6 +467,9 @@ void URnModel::MergeRoadGroup()
 
 void URnModel::SplitLaneByWidth(float RoadWidthMeter, bool rebuildTrack, TArray<FString>& failedRoads, TFunction<bool(URnRoadGroup*)> IsLaneSplitTarget)
 {
+    MarkModified();
+    // 同じ交差点に接続する道路グループのトラックの再生成はまとめて行う
+    FRnModelEditScope EditScope(this);
     failedRoads.Reset();
     TSet<TRnRef_T<URnRoad>> visitedRoads;
     // メートルをユニットに変換
@@ -610,6 +719,7 @@ URnModel::ERoadCutResult URnModel::CanSliceRoadHorizontal(URnRoad* Road, const F
 
 URnModel::FSliceRoadHorizontalResult URnModel::SliceRoadHorizontal(URnRoad* Road, const FLineSegment3D& LineSegment)
 {
+    MarkModified();
     FSliceRoadHorizontalResult Result;
     FPLATEAURnEx::FLineCrossPointResult CrossPointResult;
     Result.Result = CanSliceRoadHorizontal(Road, LineSegment, CrossPointResult);
@@ -783,6 +893,7 @@ URnModel::FSliceRoadHorizontalResult URnModel::SliceRoadHorizontal(URnRoad* Road
 
 void URnModel::SeparateContinuousBorder()
 {
+    MarkModified();
     for(auto inter : Intersections) {
         // 連続した境界線を分離する
         inter->SeparateContinuousBorder();
@@ -792,3 +903,24 @@ void URnModel::SeparateContinuousBorder()
         road->SeparateContinuousBorder();
     }
 }
+
+FRnModelEditScope::FRnModelEditScope(URnModel* InModel)
+    : Model(InModel)
+{
+    if (Model)
+        Model->BeginEditTransaction();
+}
+
+FRnModelEditScope::~FRnModelEditScope()
+{
+    Commit();
+}
+
+FRnModelEditCommitResult FRnModelEditScope::Commit()
+{
+    if (!Model)
+        return FRnModelEditCommitResult();
+    const auto Result = Model->CommitEditTransaction();
+    Model = nullptr;
+    return Result;
+}
@@ -14,16 +14,19 @@
 void URnRoad::SetNext(TRnRef_T<URnRoadBase> InNext)
 {
     this->Next = InNext;
+    MarkModelModified();
 }
 
 void URnRoad::SetPrev(TRnRef_T<URnRoadBase> InPrev)
 {
     this->Prev = InPrev;
+    MarkModelModified();
 }
 
 void URnRoad::SetMedianLane1(TRnRef_T<URnLane> InMedianLane)
 {
     this->MedianLane = InMedianLane;
+    MarkModelModified();
 }
 
 TRnRef_T<URnRoadBase> URnRoad::GetNext() const
@@ -190,6 +193,7 @@ void URnRoad::SetMedianLane(const TRnRef_T<URnLane>& Lane) {
     if (MedianLane) {
         MedianLane->SetParent(RnFrom(this));
     }
+    MarkModelModified();
 }
 
 bool URnRoad::IsMedianLane(const TRnRef_T<const URnLane>& Lane) const {
@@ -209,6 +213,7 @@ void URnRoad::AddMainLane(TRnRef_T<URnLane> Lane)
         return;
     OnAddLane(Lane);
     MainLanes.Add(Lane);
+    MarkModelModified();
 }
 
 TRnRef_T<URnWay> URnRoad::GetMergedBorder(EPLATEAURnLaneBorderType BorderType, TOptional<EPLATEAURnDir> Dir) const
@@ -378,6 +383,7 @@ void URnRoad::ReplaceLanes(const TArray<TRnRef_T<URnLane>>& NewLanes, EPLATEAURn
         Lane->SetParent(RnFrom(this));
         MainLanes.Add(Lane);
     }
+    MarkModelModified();
 }
 
 void URnRoad::ReplaceLanes(const TArray<TRnRef_T<URnLane>>& NewLanes) {
@@ -386,11 +392,13 @@ void URnRoad::ReplaceLanes(const TArray<TRnRef_T<URnLane>>& NewLanes) {
         Lane->SetParent(RnFrom(this));
         MainLanes.Add(Lane);
     }
+    MarkModelModified();
 }
 
 void URnRoad::SetPrevNext(const TRnRef_T<URnRoadBase>& PrevRoad, const TRnRef_T<URnRoadBase>& NextRoad) {
     Prev = PrevRoad;
     Next = NextRoad;
+    MarkModelModified();
 }
 
 void URnRoad::Reverse(bool KeepOneLaneIsLeft)
@@ -418,6 +426,7 @@ void URnRoad::Reverse(bool KeepOneLaneIsLeft)
                 Sw->ReverseLaneType();
         }
     }
+    MarkModelModified();
 }
 
 TArray<URnLane*> URnRoad::GetConnectedLanes(URnWay* border)
@@ -468,11 +477,13 @@ void URnRoad::DisConnect(bool RemoveFromModel) {
     if (GetNext()) GetNext()->UnLink(RnFrom(this));
     Prev = nullptr;
     Next = nullptr;
+    MarkModelModified();
 }
 
 void URnRoad::ReplaceNeighbor(const TRnRef_T<URnRoadBase>& From, const TRnRef_T<URnRoadBase>& To) {
     if (Prev == From) Prev = To;
     if (Next == From) Next = To;
+    MarkModelModified();
 }
 
 bool URnRoad::Check() const
@@ -837,6 +848,10 @@ bool URnRoad::TryMerge2NeighborIntersection(EPLATEAURnLaneBorderType BorderType)
     Intersection->AddTargetTrans(GetTargetTrans());
     DisConnect(true);
 
+    // 既存のトラックは差し替え前の境界線を参照しているため作り直す
+    if (Intersection->GetTracks().Num() > 0)
+        Intersection->RequestBuildTracks();
+
     return true;
 }
 void URnRoad::SeparateContinuousBorder() {
@@ -901,4 +916,5 @@ void URnRoad::SeparateContinuousBorder() {
     for (URnLane* Lane : GetAllLanesWithMedian()) {
         Check(Lane);
     }
+    MarkModelModified();
 }
@@ -16,12 +16,14 @@ void URnRoadBase::AddSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
     }
     SideWalk->SetParent(TRnRef_T<URnRoadBase>(this));
     SideWalks.Add(SideWalk);
+    MarkModelModified();
 }
 
 void URnRoadBase::RemoveSideWalk(const TRnRef_T<URnSideWalk>& SideWalk) {
     if (!SideWalk) return;
     SideWalk->SetParent(nullptr);
     SideWalks.Remove(SideWalk);
+    MarkModelModified();
 }
 
 void URnRoadBase::AddTargetTran(UPLATEAUCityObjectGroup* TargetTran) {
@@ -112,3 +114,9 @@ TRnRef_T<URnModel> URnRoadBase::GetParentModel() const
 
 void URnRoadBase::SetParentModel(const TRnRef_T<URnModel>& InParentModel)
 { ParentModel = InParentModel; }
+
+void URnRoadBase::MarkModelModified() const
+{
+    if (ParentModel)
+        ParentModel->MarkModified();
+}
@@ -7,6 +7,7 @@
 #include "RoadNetwork/Structure/RnLane.h"
 #include "RoadNetwork/Structure/RnWay.h"
 #include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnModel.h"
 #include "RoadNetwork/Structure/RnPoint.h"
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 #include "RoadNetwork/Util/PLATEAURnEx.h"
@@ -439,6 +440,12 @@ bool URnRoadGroup::IsSameRoadGroup(TRnRef_T<URnRoadGroup> A, TRnRef_T<URnRoadGro
 }
 
 void URnRoadGroup::AdjustBorder() {
+    // 編集トランザクション中はコミット時にまとめて調整する
+    if (auto Model = GetParentModel()) {
+        if (Model->TryDeferAdjustBorder(this))
+            return;
+    }
+
     Align();
 
     auto Adjust = [](TRnRef_T<URnRoad> Road, EPLATEAURnLaneBorderType BorderType, TRnRef_T<URnIntersection> Inter) {
@@ -517,6 +524,10 @@ void URnRoadGroup::AdjustBorder() {
                 Lane->SetBorder(  FPLATEAURnLaneBorderTypeEx::GetOpposite(BorderType), B->ReversedWay());
             }
         }
+
+        // 既存のトラックは差し替え前の境界線を参照しているため作り直す
+        if (Inter->GetTracks().Num() > 0)
+            Inter->RequestBuildTracks();
         };
 
     Adjust((Roads)[Roads.Num() - 1], EPLATEAURnLaneBorderType::Next, NextIntersection);
@@ -570,6 +581,9 @@ void URnRoadGroup::SetLaneCountImpl(int32 Count, EPLATEAURnDir Dir, bool Rebuild
 
         (Roads)[I]->ReplaceLanes(Lanes, Dir);
     }
+
+    if (RebuildTrack)
+        RequestBuildTracks();
 }
 
 void URnRoadGroup::SetLaneCountWithoutMedian(int32 LeftCount, int32 RightCount, bool RebuildTrack) {
@@ -623,6 +637,9 @@ void URnRoadGroup::SetLaneCountWithoutMedian(int32 LeftCount, int32 RightCount,
     for (const auto& Road : Roads) {
         Road->SetMedianLane(nullptr);
     }
+
+    if (RebuildTrack)
+        RequestBuildTracks();
 }
 
 void URnRoadGroup::SetLaneCount(int32 LeftCount, int32 RightCount, bool RebuildTrack) {
@@ -633,6 +650,8 @@ void URnRoadGroup::SetLaneCount(int32 LeftCount, int32 RightCount, bool RebuildT
         return;
     }
 
+    // 左右それぞれの変更で同じ交差点のトラックを作り直さないようにまとめる
+    FRnModelEditScope EditScope(GetParentModel());
     Align();
 
     auto NowLeft = GetLeftLaneCount();
@@ -647,7 +666,7 @@ void URnRoadGroup::SetLaneCount(int32 LeftCount, int32 RightCount, bool RebuildT
     SetLaneCountWithoutMedian(LeftCount, RightCount, RebuildTrack);
 }
 
-void URnRoadGroup::SetLaneCountWithMedian(int32 LeftCount, int32 RightCount, float MedianWidthRate) {
+void URnRoadGroup::SetLaneCountWithMedian(int32 LeftCount, int32 RightCount, float MedianWidthRate, bool RebuildTrack) {
     if (!IsValid()) return;
 
     if (LeftCount <= 0 && RightCount <= 0) {
@@ -693,6 +712,24 @@ void URnRoadGroup::SetLaneCountWithMedian(int32 LeftCount, int32 RightCount, flo
         Road->ReplaceLanes(Lanes);
         Road->SetMedianLane(Median);
     }
+
+    if (RebuildTrack)
+        RequestBuildTracks();
+}
+
+TRnRef_T<URnModel> URnRoadGroup::GetParentModel() const {
+    for (const auto& Road : Roads) {
+        if (Road && Road->GetParentModel())
+            return Road->GetParentModel();
+    }
+    return nullptr;
+}
+
+void URnRoadGroup::RequestBuildTracks() const {
+    if (PrevIntersection)
+        PrevIntersection->RequestBuildTracks();
+    if (NextIntersection && NextIntersection != PrevIntersection)
+        NextIntersection->RequestBuildTracks();
 }
 
 void URnRoadGroup::SetLeftLaneCount(int32 Count, bool RebuildTrack) {
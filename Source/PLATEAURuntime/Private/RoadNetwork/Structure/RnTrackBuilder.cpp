@@ -1,4 +1,6 @@
 #include "RoadNetwork/Structure/RnTrackBuilder.h"
+#include "Algo/NoneOf.h"
+#include "Async/ParallelFor.h"
 #include "RoadNetwork/Structure/RnIntersection.h"
 
 bool FBuildTrackOption::IsBuildTarget(URnIntersection* Intersection, URnIntersectionEdge* From, URnIntersectionEdge* To) const {
@@ -39,12 +41,14 @@ FRnTracksBuilder::FRnTracksBuilder() {
 }
 
 void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTrackOption& Option) {
-    // Option が指定されていない場合は FBuildTrackOption::Default() を利用（呼び出し側で補完してもよい）
-    FBuildTrackOption Op = Option;
+    TArray<FTrackPlan> Plans;
+    PlanTracks(Intersection, Option, Plans);
+    ApplyTracks(Intersection, Option, Plans);
+}
 
-    if (Op.ClearTracks) {
-        Intersection->ClearTracks();
-    }
+void FRnTracksBuilder::PlanTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, TArray<FTrackPlan>& OutPlans) const {
+    // Option が指定されていない場合は FBuildTrackOption::Default() を利用（呼び出し側で補完してもよい）
+    const FBuildTrackOption& Op = Option;
 
     // borderEdgeGroups : Intersection 内のエッジグループから IsBorder が true のものを抽出
     auto BorderEdgeGroups = FRnIntersectionEx::CreateEdgeGroup(Intersection);
@@ -107,8 +111,7 @@ void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTr
                 int32 OutBoundIndex = FMath::Clamp(i, 0, OutBoundsLeft2Rights.Num() - 1);
                 URnIntersectionEdge* FromNeighbor = InBoundsLeft2Right[i];
                 FOutBound& OutBound = OutBoundsLeft2Rights[OutBoundIndex];
-                URnTrack* Track = MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound);
-                Intersection->TryAddOrUpdateTrack(Track);
+                OutPlans.Add(FTrackPlan(FromNeighbor, OutBound.To, OutBound.TurnType));
             }
         }
         else {
@@ -149,13 +152,67 @@ void FRnTracksBuilder::BuildTracks(URnIntersection* Intersection, const FBuildTr
 
                 URnIntersectionEdge* FromNeighbor = InBoundsLeft2Right[InBoundIndex];
                 FOutBound& OutBound = OutBoundsLeft2Rights[i];
-                URnTrack* Track = MakeTrack(Intersection, FromNeighbor, Op, &FromEg, OutBound);
-                Intersection->TryAddOrUpdateTrack(Track);
+                OutPlans.Add(FTrackPlan(FromNeighbor, OutBound.To, OutBound.TurnType));
             }
         }
     }
 }
 
+void FRnTracksBuilder::ApplyTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, const TArray<FTrackPlan>& Plans) {
+    if (Option.ClearTracks) {
+        Intersection->ClearTracks();
+    }
+
+    for (const auto& Plan : Plans) {
+        URnTrack* Track = MakeTrack(Intersection, Plan.From, Option, nullptr, FOutBound(Plan.TurnType, nullptr, Plan.To));
+        Intersection->TryAddOrUpdateTrack(Track);
+    }
+}
+
+int32 FRnTracksBuilder::BuildTracks(const TArray<URnIntersection*>& Intersections, const FBuildTrackOption& Option, bool bParallel) {
+    const auto Groups = GroupIndependentIntersections(Intersections);
+    for (const auto& Group : Groups) {
+        TArray<TArray<FTrackPlan>> Plans;
+        Plans.SetNum(Group.Num());
+        ParallelFor(Group.Num(), [&](int32 Index) {
+            Group[Index]->Align();
+            PlanTracks(Group[Index], Option, Plans[Index]);
+        }, bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+        // トラック(UObject)の生成はゲームスレッドで行う
+        for (int32 i = 0; i < Group.Num(); ++i) {
+            ApplyTracks(Group[i], Option, Plans[i]);
+        }
+    }
+    return Groups.Num();
+}
+
+TArray<TArray<URnIntersection*>> FRnTracksBuilder::GroupIndependentIntersections(const TArray<URnIntersection*>& Intersections) {
+    TArray<TArray<URnIntersection*>> Groups;
+    // グループ毎の, 含まれる交差点とその隣接道路/交差点
+    TArray<TSet<URnRoadBase*>> UsedRoads;
+    TSet<URnIntersection*> Visited;
+    for (URnIntersection* Intersection : Intersections) {
+        if (!Intersection || Visited.Contains(Intersection))
+            continue;
+        Visited.Add(Intersection);
+
+        TArray<URnRoadBase*> Keys = Intersection->GetNeighborRoads();
+        Keys.Add(Intersection);
+
+        int32 Index = UsedRoads.IndexOfByPredicate([&Keys](const TSet<URnRoadBase*>& Used) {
+            return Algo::NoneOf(Keys, [&Used](URnRoadBase* Key) { return Used.Contains(Key); });
+        });
+        if (Index == INDEX_NONE) {
+            Index = Groups.AddDefaulted();
+            UsedRoads.AddDefaulted();
+        }
+        Groups[Index].Add(Intersection);
+        UsedRoads[Index].Append(Keys);
+    }
+    return Groups;
+}
+
 URnTrack* FRnTracksBuilder::MakeTrack(URnIntersection* Intersection, URnIntersectionEdge* From, const FBuildTrackOption& Option,
     FRnIntersectionEx::FEdgeGroup* FromEg
     , const FOutBound& OutBound) {
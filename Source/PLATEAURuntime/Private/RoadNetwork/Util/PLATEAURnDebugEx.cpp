@@ -1,6 +1,19 @@
 #include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 #include "Engine/World.h"
 
+namespace {
+    FPLATEAURnDebugDrawBuffer* CaptureBuffer = nullptr;
+}
+
+void FPLATEAURnDebugEx::SetCaptureBuffer(FPLATEAURnDebugDrawBuffer* Buffer) {
+    check(IsInGameThread());
+    CaptureBuffer = Buffer;
+}
+
+FPLATEAURnDebugDrawBuffer* FPLATEAURnDebugEx::GetCaptureBuffer() {
+    return CaptureBuffer;
+}
+
 FVector FPLATEAURnDebugEx::ToVec3(const FVector2D& Self, bool bShowXZ) {
     return bShowXZ ? FVector(Self.X, 0.0f, Self.Y) : FVector(Self.X, Self.Y, 0.0f);
 }
@@ -13,6 +26,11 @@ FLinearColor FPLATEAURnDebugEx::GetDebugColor(int32 I, int32 Num, float A) {
 }
 
 void FPLATEAURnDebugEx::DrawLine(const FVector& Start, const FVector& End, const FLinearColor& Color, float Duration, float Thickness) {
+    if (CaptureBuffer) {
+        // DrawDebugLineと同じ色になるようにFColorを経由する
+        CaptureBuffer->Lines.Emplace(Start, End, FLinearColor(Color.ToFColor(true)), 0.0f, Thickness, SDPG_World);
+        return;
+    }
     DrawDebugLine(GWorld, Start, End, Color.ToFColor(true), false, Duration, 0, Thickness);
 }
 
@@ -61,6 +79,13 @@ void FPLATEAURnDebugEx::DrawLines(const TArray<FVector>& Vertices, bool bIsLoop,
 }
 
 void FPLATEAURnDebugEx::DrawSphere(const FVector& Center, float Radius, const FLinearColor& Color, float Duration) {
+    if (CaptureBuffer) {
+        // 記録時は各軸周りの円で近似する
+        DrawRegularPolygon(Center, Radius, 16, FVector::UpVector, Color, Duration);
+        DrawRegularPolygon(Center, Radius, 16, FVector::ForwardVector, Color, Duration);
+        DrawRegularPolygon(Center, Radius, 16, FVector::RightVector, Color, Duration);
+        return;
+    }
     DrawDebugSphere(GWorld, Center, Radius, 16, Color.ToFColor(true), false, Duration);
 }
 
@@ -142,5 +167,9 @@ void FPLATEAURnDebugEx::DrawRay(const FVector& Start, const FVector& Direction,
 void FPLATEAURnDebugEx::DrawString(const FString& Text, const FVector& Location, const FLinearColor& Color, float Duration,
     float FontScale)
 {
+    if (CaptureBuffer) {
+        CaptureBuffer->Labels.Add({ Text, Location, Color, FontScale, 0 });
+        return;
+    }
     DrawDebugString(GWorld, Location, Text, nullptr, Color.ToFColor(true), Duration, false, FontScale);
 }
\ No newline at end of file
@@ -21,6 +21,14 @@ namespace {
     }
 }
 
+const FName FPLATEAUComponentUtil::SharedMeshComponentTag(TEXT("PLATEAUSharedMesh"));
+
+FVector FPLATEAUComponentUtil::GetSharedMeshOffset(const UStaticMeshComponent* InComponent) {
+    if (InComponent == nullptr || !InComponent->ComponentHasTag(SharedMeshComponentTag))
+        return FVector::ZeroVector;
+    return InComponent->GetRelativeLocation();
+}
+
 FString FPLATEAUComponentUtil::MakeUniqueGmlObjectName(AActor* Actor, UClass* Class, const FString& BaseName) {
     auto Name = BaseName;
     Name.AppendChar(TEXT('_'));
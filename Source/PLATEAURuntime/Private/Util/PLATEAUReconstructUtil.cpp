@@ -3,6 +3,65 @@
 #include "Util/PLATEAUReconstructUtil.h"
 #include "Util/PLATEAUComponentUtil.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Tasks/Task.h"
+
+namespace {
+    /**
+     * @brief ハイトマップ画像の書き出しタスクを管理します。
+     * 未完了のタスク数をワーカースレッド数までに制限し、書き出し待ちの画像でメモリが膨らまないようにします。
+     */
+    class FHeightmapImageWriteQueue {
+    public:
+        void Enqueue(TUniqueFunction<void()>&& Write) {
+            const int32 MaxPendingTasks = FMath::Max(2, FTaskGraphInterface::Get().GetNumWorkerThreads());
+            while (true) {
+                UE::Tasks::FTask Oldest;
+                {
+                    FScopeLock Lock(&CriticalSection);
+                    RemoveCompletedTasks();
+                    if (PendingTasks.Num() < MaxPendingTasks) {
+                        PendingTasks.Add(UE::Tasks::Launch(TEXT("SaveHeightmapImage"), MoveTemp(Write)));
+                        return;
+                    }
+                    Oldest = PendingTasks[0];
+                }
+                Oldest.Wait();
+            }
+        }
+
+        void Flush() {
+            TArray<UE::Tasks::FTask> Tasks;
+            {
+                FScopeLock Lock(&CriticalSection);
+                Tasks = PendingTasks;
+            }
+            UE::Tasks::Wait(Tasks);
+
+            FScopeLock Lock(&CriticalSection);
+            RemoveCompletedTasks();
+        }
+
+    private:
+        void RemoveCompletedTasks() {
+            PendingTasks.RemoveAll([](const UE::Tasks::FTask& Task) {
+                return Task.IsCompleted();
+            });
+        }
+
+        FCriticalSection CriticalSection;
+        TArray<UE::Tasks::FTask> PendingTasks;
+    };
+
+    FHeightmapImageWriteQueue& GetHeightmapImageWriteQueue() {
+        static FHeightmapImageWriteQueue Queue;
+        return Queue;
+    }
+
+    FString GetHeightmapImagePath(const FString& FileName, const int32 Width, const int32 Height, const TCHAR* Extension) {
+        return FString::Format(*FString(TEXT("{0}PLATEAU/{1}_{2}_{3}.{4}")), { FPaths::ProjectContentDir(), FileName, Width, Height, Extension });
+    }
+}
 
 TMap<FString, FPLATEAUCityObject> FPLATEAUReconstructUtil::CreateMapFromCityObjectGroups(const TArray<UPLATEAUCityObjectGroup*> TargetCityObjectGroups) {
     TMap<FString, FPLATEAUCityObject> OutCityObjMap;
@@ -38,17 +97,40 @@ TMap<FString, FPLATEAUCityObject> FPLATEAUReconstructUtil::CreateMapFromCityObje
 void FPLATEAUReconstructUtil::SaveHeightmapImage(EPLATEAULandscapeHeightmapImageOutput OutputParam, FString FileName, int32 Width, int32 Height, uint16_t* Data) {
     // Heightmap Image Output 
     if (OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG || OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG_RAW) {
-        FString PngSavePath = FString::Format(*FString(TEXT("{0}PLATEAU/{1}_{2}_{3}.png")), { FPaths::ProjectContentDir(), FileName, Width, Height });
+        FString PngSavePath = GetHeightmapImagePath(FileName, Width, Height, TEXT("png"));
         plateau::heightMapGenerator::HeightmapGenerator::savePngFile(TCHAR_TO_ANSI(*PngSavePath), Width, Height, Data);
         UE_LOG(LogTemp, Log, TEXT("height map png saved: %s"), *PngSavePath);
     }
     if (OutputParam == EPLATEAULandscapeHeightmapImageOutput::RAW || OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG_RAW) {
-        FString RawSavePath = FString::Format(*FString(TEXT("{0}PLATEAU/{1}_{2}_{3}.raw")), { FPaths::ProjectContentDir(), FileName, Width, Height });
+        FString RawSavePath = GetHeightmapImagePath(FileName, Width, Height, TEXT("raw"));
         plateau::heightMapGenerator::HeightmapGenerator::saveRawFile(TCHAR_TO_ANSI(*RawSavePath), Width, Height, Data);
         UE_LOG(LogTemp, Log, TEXT("height map raw saved: %s"), *RawSavePath);
     }
 }
 
+void FPLATEAUReconstructUtil::SaveHeightmapImageAsync(EPLATEAULandscapeHeightmapImageOutput OutputParam, const FString& FileName, int32 Width, int32 Height, const TSharedPtr<const std::vector<uint16_t>>& Data) {
+    if (!Data.IsValid())
+        return;
+
+    // PNGのエンコードはRAWの書き出しより重いので、別タスクにして並行させる
+    if (OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG || OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG_RAW) {
+        GetHeightmapImageWriteQueue().Enqueue([PngSavePath = GetHeightmapImagePath(FileName, Width, Height, TEXT("png")), Width, Height, Data] {
+            plateau::heightMapGenerator::HeightmapGenerator::savePngFile(TCHAR_TO_ANSI(*PngSavePath), Width, Height, const_cast<uint16_t*>(Data->data()));
+            UE_LOG(LogTemp, Log, TEXT("height map png saved: %s"), *PngSavePath);
+        });
+    }
+    if (OutputParam == EPLATEAULandscapeHeightmapImageOutput::RAW || OutputParam == EPLATEAULandscapeHeightmapImageOutput::PNG_RAW) {
+        GetHeightmapImageWriteQueue().Enqueue([RawSavePath = GetHeightmapImagePath(FileName, Width, Height, TEXT("raw")), Width, Height, Data] {
+            plateau::heightMapGenerator::HeightmapGenerator::saveRawFile(TCHAR_TO_ANSI(*RawSavePath), Width, Height, const_cast<uint16_t*>(Data->data()));
+            UE_LOG(LogTemp, Log, TEXT("height map raw saved: %s"), *RawSavePath);
+        });
+    }
+}
+
+void FPLATEAUReconstructUtil::FlushHeightmapImages() {
+    GetHeightmapImageWriteQueue().Flush();
+}
+
 plateau::polygonMesh::MeshGranularity FPLATEAUReconstructUtil::ConvertGranularityToMeshGranularity(const ConvertGranularity ConvertGranularity) {
     if (ConvertGranularity == plateau::granularityConvert::ConvertGranularity::MaterialInPrimary)
         return plateau::polygonMesh::MeshGranularity::PerAtomicFeatureObject;
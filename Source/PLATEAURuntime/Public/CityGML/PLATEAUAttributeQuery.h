@@ -0,0 +1,75 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PLATEAUAttributeValue.h"
+
+struct FPLATEAUCityObject;
+
+/**
+ * @brief "a/b/c" 形式の属性キーを事前に解析した検索クエリです。
+ * UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey と同じ結果を返しますが、
+ * キーの分割とハッシュ計算は構築時に一度だけ行います。多数の地物に同じキーで問い合わせる場合に使用します。
+ */
+class PLATEAURUNTIME_API FPLATEAUAttributeQuery {
+public:
+    explicit FPLATEAUAttributeQuery(const FString& Key);
+
+    /**
+     * @brief キーに該当する属性値を返します。該当しない場合はnullptrを返します
+     */
+    const FPLATEAUAttributeValue* Find(const FPLATEAUAttributeMap& AttributeMap) const;
+
+    /**
+     * @brief 各地物とその直下の子の属性値をまとめて取得します。
+     * OutValuesには 地物, その子... の順に値が追加され、該当しない地物はnullptrになります。
+     */
+    void FindInRootAndChildren(TArrayView<const FPLATEAUCityObject> CityObjects, TArray<const FPLATEAUAttributeValue*>& OutValues) const;
+
+private:
+    struct FSegment {
+        FString Key;
+        uint32 Hash;
+    };
+
+    TArray<FSegment> Segments;
+    //キーを使い切った後の階層で検索するキー(GetAttributesByKeyでは空文字になる)
+    FSegment EmptySegment;
+};
+
+/**
+ * @brief FPLATEAUAttributeQueryで取得した属性値に対する条件です
+ */
+class PLATEAURUNTIME_API FPLATEAUAttributePredicate {
+public:
+    /**
+     * @brief 文字列表現が一致する (大文字小文字を区別します)
+     */
+    static FPLATEAUAttributePredicate Equal(const FString& Value);
+
+    /**
+     * @brief 数値(Double, Measure, Integer, Boolean)が Min 以上 Max 以下
+     */
+    static FPLATEAUAttributePredicate InRange(const double Min, const double Max);
+
+    bool Evaluate(const FPLATEAUAttributeValue* Value) const;
+
+    /**
+     * @brief Valuesをまとめて評価し、OutResultsの同じインデックスに結果を設定します。nullptrは一致しない扱いです
+     */
+    void EvaluateBatch(TArrayView<const FPLATEAUAttributeValue* const> Values, TBitArray<>& OutResults) const;
+
+private:
+    enum class EOperator : uint8 {
+        Equal,
+        InRange
+    };
+
+    FPLATEAUAttributePredicate() = default;
+
+    EOperator Operator = EOperator::Equal;
+    FString StringValue;
+    double Min = 0;
+    double Max = 0;
+};
@@ -5,8 +5,10 @@
 #include "CoreMinimal.h"
 
 #include "PLATEAUCityModel.h"
+#include "PLATEAUCityModelIndex.h"
 #include "PLATEAUInstancedCityModel.h"
 #include "Kismet/BlueprintAsyncActionBase.h"
+#include "GenericPlatform/GenericPlatformFile.h"
 
 #include "PLATEAUCityGmlProxy.generated.h"
 
@@ -33,11 +35,44 @@ public:
     UPROPERTY(BlueprintAssignable)
         FOnLoadGmlFailed Failed;
 
+    /**
+     * @brief GMLをパースしてCityModelを返します。
+     * CityModel自体はキャッシュに保持されず、呼び出し側が保持している間のみ再利用されます。
+     */
     static std::shared_ptr<const citygml::CityModel> Load(const FPLATEAUCityObjectInfo& GmlInfo);
 
+    /**
+     * @brief 地物ID, 地物型, 属性情報のみのインデックスを返します。
+     * インデックスはGMLのパス, 更新日時, ファイルサイズをキーとしてLRUキャッシュに保持され、
+     * キャッシュにある間はGMLをパースしません。
+     */
+    static TSharedPtr<const FPLATEAUCityModelIndex> LoadIndex(const FPLATEAUCityObjectInfo& GmlInfo);
+
+    /**
+     * @brief インデックスキャッシュのメモリ上限(バイト)を設定します。上限を超えた場合は古いものから破棄されます。
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+        static void SetCacheBudget(const int64 BudgetBytes);
+
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+        static void ClearCache();
+
+    /**
+     * @brief インデックスキャッシュが現在使用しているおおよそのメモリ量(バイト)
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+        static int64 GetCacheAllocatedSize();
+
+    /**
+     * @brief これまでにGMLをパースした回数
+     */
+    static int32 GetParseCount();
+
 private:
     const UObject* WorldContextObject;
     FPLATEAUCityObjectInfo GmlInfo;
 
-    static TMap<FString, FPLATEAUCityModel> CityModelCache;
+    static FString GetFullGmlPath(const FPLATEAUCityObjectInfo& GmlInfo);
+    // パース済みのCityModelをキャッシュに登録し、キャッシュ上のインデックスを返す
+    static TSharedPtr<const FPLATEAUCityModelIndex> AddToCache(const FString& FullGmlPath, const FFileStatData& StatData, const std::shared_ptr<const citygml::CityModel>& CityModelData);
 };
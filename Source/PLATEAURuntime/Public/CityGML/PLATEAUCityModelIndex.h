@@ -0,0 +1,49 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PLATEAUAttributeValue.h"
+#include <citygml/cityobject.h>
+
+namespace citygml {
+    class CityModel;
+}
+
+/**
+ * @brief 地物1つ分の属性情報です。形状は保持しません。
+ */
+struct PLATEAURUNTIME_API FPLATEAUCityModelIndexEntry {
+    citygml::CityObject::CityObjectsType Type = citygml::CityObject::CityObjectsType::COT_GenericCityObject;
+    FPLATEAUAttributeMap Attributes;
+};
+
+/**
+ * @brief CityModelから地物ID, 地物型, 属性情報のみを抜き出したインデックスです。
+ * libcitygmlのCityModel全体を保持せずに属性の検索やフィルタリングを行うために使用します。
+ */
+class PLATEAURUNTIME_API FPLATEAUCityModelIndex {
+public:
+    explicit FPLATEAUCityModelIndex(const citygml::CityModel& CityModel);
+
+    const FPLATEAUCityModelIndexEntry* Find(const FString& GmlID) const {
+        return Entries.Find(GmlID);
+    }
+
+    int32 Num() const {
+        return Entries.Num();
+    }
+
+    /**
+     * @brief インデックスが使用するおおよそのメモリ量(バイト)
+     */
+    SIZE_T GetAllocatedSize() const {
+        return AllocatedSize;
+    }
+
+private:
+    void AddRecursive(const citygml::CityObject& CityObject);
+
+    TMap<FString, FPLATEAUCityModelIndexEntry> Entries;
+    SIZE_T AllocatedSize = 0;
+};
@@ -79,6 +79,10 @@ struct FPLATEAUCityObjectIndex {
     bool operator==(const FPLATEAUCityObjectIndex& Other) const {
         return PrimaryIndex == Other.PrimaryIndex && AtomicIndex == Other.AtomicIndex;
     }
+
+    friend uint32 GetTypeHash(const FPLATEAUCityObjectIndex& Index) {
+        return HashCombine(::GetTypeHash(Index.PrimaryIndex), ::GetTypeHash(Index.AtomicIndex));
+    }
 };
 
 USTRUCT(BlueprintType, Category = "PLATEAU|CityGML")
@@ -0,0 +1,213 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Async/Future.h"
+#include "PLATEAUGeometry.h"
+#include <memory>
+#include "PLATEAUCityModelStreamingComponent.generated.h"
+
+class UPLATEAUImportSettings;
+class UTexture2D;
+
+namespace plateau::dataset {
+    class DatasetSource;
+}
+
+/**
+ * @brief ストリーミングの距離毎の最大LODです。
+ */
+USTRUCT(BlueprintType)
+struct PLATEAURUNTIME_API FPLATEAUStreamingLodSetting {
+    GENERATED_BODY()
+
+public:
+    FPLATEAUStreamingLodSetting() = default;
+    FPLATEAUStreamingLodSetting(const float InDistance, const int InMaxLod)
+        : Distance(InDistance)
+        , MaxLod(InMaxLod) {
+    }
+
+    /**
+     * @brief 視点からタイルまでの水平距離(cm)がこの値以下のタイルを読み込みます。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        float Distance = 50000.0f;
+
+    /**
+     * @brief 読み込むLODの上限です。インポート設定のMinLod, MaxLodの範囲に制限されます。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        int MaxLod = 4;
+};
+
+/**
+ * @brief ストリーミングで読み込んだテクスチャです。複数のタイルから参照される場合は共有します。
+ */
+USTRUCT()
+struct FPLATEAUStreamedTexture {
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(Transient)
+        TObjectPtr<UTexture2D> Texture;
+
+    int64 Bytes = 0;
+
+    // 参照しているタイル数
+    int32 RefCount = 0;
+};
+
+/**
+ * @brief データセットをメッシュコード単位のタイルに分割し、視点からの距離に応じて読込・破棄します。
+ * インポートと同じ抽出処理(FPLATEAUExtractedModelCache, FPLATEAUMeshLoader)を利用し、パッケージビルドでも動作します。
+ * タイルはオーナーアクタのルートコンポーネント以下に作成されます。
+ */
+UCLASS(ClassGroup = (PLATEAU), meta = (BlueprintSpawnableComponent))
+class PLATEAURUNTIME_API UPLATEAUCityModelStreamingComponent : public UActorComponent {
+    GENERATED_BODY()
+
+public:
+    UPLATEAUCityModelStreamingComponent();
+
+    /**
+     * @brief ローカルのデータセットのパスです。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        FString Source;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        FPLATEAUGeoReference GeoReference;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        UPLATEAUImportSettings* ImportSettings;
+
+    /**
+     * @brief タイルとするメッシュコードの次数(3~5)です。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU", meta = (ClampMin = 3, ClampMax = 5))
+        int TileMeshCodeLevel = 4;
+
+    /**
+     * @brief 距離毎の最大LODです。最も遠いDistanceより遠いタイルは破棄されます。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        TArray<FPLATEAUStreamingLodSetting> LodSettings;
+
+    /**
+     * @brief タイルをより粗いLODに切り替える、または破棄する際に距離に加える余裕(cm)です。境界付近での読込・破棄の繰り返しを防ぎます。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        float HysteresisDistance = 5000.0f;
+
+    /**
+     * @brief 読み込んだタイルのメッシュ, テクスチャ, 属性情報の合計の上限(MB)です。0以下の場合は無制限です。
+     * 上限を超える場合は遠いタイルから破棄し、破棄しても収まらない場合はそれ以上読み込みません。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        float MemoryBudgetMB = 1024.0f;
+
+    /**
+     * @brief プレイヤーカメラの位置を視点として利用するかどうかです。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        bool bUsePlayerCameras = true;
+
+    /**
+     * @brief 視点として利用するアクタです。
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
+        TArray<TObjectPtr<AActor>> ViewpointActors;
+
+    /**
+     * @brief 視点の位置に応じてタイルの読込・破棄を行います。TickComponentから呼ばれますが、任意の視点で呼ぶこともできます。
+     */
+    UFUNCTION(BlueprintCallable, Category = "PLATEAU")
+        void UpdateStreaming(const TArray<FVector>& Viewpoints);
+
+    /**
+     * @brief 読み込んだ全てのタイルを破棄します。読込中のタイルはキャンセルされます。
+     */
+    UFUNCTION(BlueprintCallable, Category = "PLATEAU")
+        void UnloadAll();
+
+    /**
+     * @brief 読み込んだタイルのメッシュ, テクスチャ, 属性情報の合計(バイト)です。
+     */
+    int64 GetUsedMemoryBytes() const;
+
+    int64 GetMemoryBudgetBytes() const;
+
+    int32 GetLoadedTileCount() const;
+
+    TArray<FString> GetLoadedTileMeshCodes() const;
+
+    /**
+     * @brief 読込中のタイルがあるかどうかを返します。
+     */
+    bool IsLoading() const;
+
+    /**
+     * @brief タイルのメッシュコードです。UpdateStreamingの初回呼び出し時にデータセットから作成されます。
+     */
+    TArray<FString> GetTileMeshCodes() const;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+    friend class FPLATEAUMeshLoaderForStreaming;
+
+    struct FTile {
+        FString MeshCode;
+        FBox Bounds;
+        // 直近のUpdateStreamingでの最寄りの視点からの水平距離
+        double Distance = 0;
+        int32 LoadedLodIndex = INDEX_NONE;
+        TWeakObjectPtr<USceneComponent> Root;
+        // メッシュと属性情報のサイズ(テクスチャは共有されるため含まない)
+        int64 Bytes = 0;
+        TSet<FString> TexturePaths;
+        // Key: LodIndex, Value: 前回読み込んだ際のBytes。予算の見積もりに利用します
+        TMap<int32, int64> KnownBytes;
+    };
+
+    struct FLoadResult {
+        TSet<FString> TexturePaths;
+    };
+
+    struct FPendingLoad {
+        int32 TileIndex = INDEX_NONE;
+        int32 LodIndex = INDEX_NONE;
+        TWeakObjectPtr<USceneComponent> Root;
+        TSharedPtr<TAtomic<bool>> bCanceled;
+        TSharedPtr<FLoadResult> Result;
+        TFuture<void> Future;
+    };
+
+    TArray<FTile> Tiles;
+    bool bTilesInitialized = false;
+    std::shared_ptr<plateau::dataset::DatasetSource> DatasetSource;
+    TUniquePtr<FPendingLoad> PendingLoad;
+
+    // Key: テクスチャのパス
+    UPROPERTY(Transient)
+        TMap<FString, FPLATEAUStreamedTexture> StreamedTextures;
+
+    bool InitializeTiles();
+    int32 GetDesiredLodIndex(const FTile& Tile) const;
+    int64 EstimateTileBytes(const FTile& Tile, const int32 LodIndex) const;
+    void StartLoad(const int32 TileIndex, const int32 LodIndex);
+    void FinishLoad();
+    void UnloadTile(FTile& Tile);
+    void RemoveUnreferencedTextures();
+    bool EvictFarthestTile(const double MinDistance, const int32 ExcludeTileIndex);
+    USceneComponent* CreateTileComponent(USceneComponent& Parent, const FString& Name) const;
+    UTexture2D* LoadTexture(const FString& TexturePath, FLoadResult& Result);
+};
@@ -9,6 +9,7 @@
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 #include "PLATEAUComponentInterface.h"
+#include "PLATEAUCityObjectSpatialIndex.h"
 #include "CityGML/Serialization/PLATEAUNativeCityObjectSerialization.h"
 #include "CityGML/Serialization/PLATEAUCityObjectSerialization.h"
 #include "CityGML/Serialization/PLATEAUCityObjectDeserialization.h"
@@ -94,6 +95,12 @@ public:
      */
     void SerializeCityObject(const FPLATEAUCityObject& InCityObject, const FString InOutsideParent = "", const TArray<FString> InOutsideChildren = {});
 
+    /**
+     * @brief シリアライズ済みの地物情報を設定します
+     * @param InSerializedCityObjects 抽出済みメッシュキャッシュ等に保存されたJson
+     */
+    void SetSerializedCityObjects(const FString& InSerializedCityObjects, const plateau::polygonMesh::MeshGranularity& Granularity);
+
     /**
      * @brief MeshGranularity取得Getter
      */
@@ -118,6 +125,39 @@ public:
     UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
     TArray<FPLATEAUCityObject> GetAllRootCityObjects();
 
+    /**
+     * @brief メッシュ三角形のBVHを構築します。
+     * 各Query関数は未構築の場合に自動で構築するため、事前に構築しておきたい場合のみ呼び出してください。
+     * @return 構築に成功した場合true
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+    bool BuildSpatialIndex();
+
+    /**
+     * @brief 構築済みのBVHを破棄し、次のQuery時に再構築させます。
+     * StaticMeshを差し替えずに形状を変更した場合に呼び出してください。
+     */
+    void InvalidateSpatialIndex();
+
+    /**
+     * @brief ワールド座標のレイと最も手前で交差するCityObjectを物理のUV情報を使わずに取得します
+     * @param bPrimary trueの場合は主要地物、falseの場合は最小地物を返します
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+    bool QueryCityObjectByRay(const FVector& Origin, const FVector& Direction, const double MaxDistance, const bool bPrimary, FPLATEAUCityObject& OutCityObject, FVector& OutHitLocation);
+
+    /**
+     * @brief ワールド座標の点からTolerance以内で最も近いCityObjectを取得します
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+    bool QueryCityObjectByPoint(const FVector& Point, const double Tolerance, const bool bPrimary, FPLATEAUCityObject& OutCityObject);
+
+    /**
+     * @brief ワールド座標のボックスと交差するCityObjectを取得します
+     */
+    UFUNCTION(BlueprintCallable, meta = (Category = "PLATEAU|CityGML"))
+    TArray<FPLATEAUCityObject> QueryCityObjectsInBox(const FBox& Box, const bool bPrimary);
+
     UPROPERTY(BlueprintReadWrite, Category = "PLATEAU")
     FString SerializedCityObjects;
 
@@ -135,6 +175,15 @@ public:
 
 private:
     TArray<FPLATEAUCityObject> RootCityObjects;
+    // Key: CityObjectIndex, Value: RootCityObjectsの(Rootのインデックス, Childrenのインデックス)。Rootの場合Childrenのインデックスは-1
+    TMap<FPLATEAUCityObjectIndex, TPair<int32, int32>> CityObjectIndexMap;
+    FPLATEAUCityObjectSpatialIndex SpatialIndex;
+    // SpatialIndex構築時のStaticMesh。メッシュが差し替えられた場合は再構築する
+    TWeakObjectPtr<const UStaticMesh> SpatialIndexMesh;
+
+    bool EnsureSpatialIndex();
+    const FPLATEAUCityObject* FindCityObjectByIndex(const FPLATEAUCityObjectIndex& Index);
+    const FPLATEAUCityObject* FindCityObjectByTriangle(const int32 TriangleIndex, const bool bPrimary);
     void SetMeshGranularity(const plateau::polygonMesh::MeshGranularity Granularity);
 
     FPLATEAUNativeCityObjectSerialization CityModelSerializer;
@@ -0,0 +1,82 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CityGML/PLATEAUCityObject.h"
+
+class UStaticMesh;
+
+/**
+ * @brief UPLATEAUCityObjectGroupのメッシュ三角形に対するBVHです。
+ * 三角形毎にUV4から得られるCityObjectIndexを保持し、物理のUV情報を経由せずにレイ・点・ボックスからCityObjectIndexを解決します。
+ * 座標は全てコンポーネントのローカル空間です。
+ */
+class PLATEAURUNTIME_API FPLATEAUCityObjectSpatialIndex {
+public:
+    /**
+     * @brief StaticMeshのLOD0から構築します。CityObjectIndexはUVChannelのUVから取得します。
+     * @return 三角形が1つ以上取得できればtrue
+     */
+    bool Build(const UStaticMesh* StaticMesh, const int32 UVChannel = 3);
+
+    /**
+     * @brief 頂点・インデックス・三角形毎のCityObjectIndexから構築します。
+     * @param TriangleCityObjectIndices 三角形数と同じ要素数である必要があります
+     */
+    bool Build(const TArray<FVector3f>& Positions, const TArray<uint32>& Indices, const TArray<FPLATEAUCityObjectIndex>& TriangleCityObjectIndices);
+
+    void Reset();
+
+    bool IsValid() const {
+        return 0 < Nodes.Num();
+    }
+
+    int32 GetNumTriangles() const {
+        return TriangleCityObjectIndices.Num();
+    }
+
+    const FPLATEAUCityObjectIndex& GetCityObjectIndex(const int32 TriangleIndex) const {
+        return TriangleCityObjectIndices[TriangleIndex];
+    }
+
+    /**
+     * @brief 最も手前でヒットした三角形を返します
+     * @param OutTriangleIndex ヒットした三角形のインデックス
+     * @param OutDistance Origin からヒット位置までの距離(Directionは正規化されている前提)
+     */
+    bool Raycast(const FVector& Origin, const FVector& Direction, const double MaxDistance, int32& OutTriangleIndex, double& OutDistance) const;
+
+    /**
+     * @brief Pointから Tolerance 以内で最も近い三角形を返します
+     */
+    bool FindNearestTriangle(const FVector& Point, const double Tolerance, int32& OutTriangleIndex, double& OutDistance) const;
+
+    /**
+     * @brief 三角形のバウンディングボックスがBoxと交差する三角形のCityObjectIndexを重複なしで返します
+     */
+    TArray<FPLATEAUCityObjectIndex> FindCityObjectIndicesInBox(const FBox& Box) const;
+
+private:
+    struct FNode {
+        FBox3f Bounds;
+        // 葉の場合は三角形の開始位置、内部ノードの場合は右の子ノードのインデックス
+        int32 Offset = 0;
+        // 葉の場合は三角形数、内部ノードの場合は0
+        int32 Count = 0;
+
+        bool IsLeaf() const {
+            return 0 < Count;
+        }
+    };
+
+    int32 BuildRecursive(const int32 Begin, const int32 End, TArray<int32>& Order, const TArray<FBox3f>& TriangleBounds, const TArray<FVector3f>& Centroids);
+
+    bool RaycastTriangle(const int32 TriangleIndex, const FVector3f& Origin, const FVector3f& Direction, float& OutT) const;
+
+    TArray<FNode> Nodes;
+    // BVH順に並べた三角形の頂点座標(三角形毎に3つ)
+    TArray<FVector3f> TriangleVertices;
+    // BVH順に並べた三角形毎のCityObjectIndex
+    TArray<FPLATEAUCityObjectIndex> TriangleCityObjectIndices;
+};
@@ -23,7 +23,12 @@ namespace citygml {
     class CityModel;
 }
 
+namespace plateau::dataset {
+    class DatasetSource;
+}
+
 class FPLATEAUMeshLoader;
+struct FPLATEAUExtractedModel;
 enum class MeshGranularity;
 struct FLoadInputData {
     plateau::polygonMesh::MeshExtractOptions ExtractOptions;
@@ -31,6 +36,9 @@ struct FLoadInputData {
     FString GmlPath;
     bool bIncludeAttrInfo;
     UMaterialInterface* FallbackMaterial;
+    // 平行移動を除いて同一形状のメッシュを共有するかどうか
+    bool bEnableMeshInstancing = false;
+    plateau::dataset::PredefinedCityModelPackage Package = plateau::dataset::PredefinedCityModelPackage::None;
 };
 
 UENUM(BlueprintType)
@@ -74,6 +82,26 @@ public:
     UPROPERTY(EditAnywhere, Category = "PLATEAU")
         TArray<FString> FailedGmls;
 
+    /**
+     * @brief 同時に処理中のGMLについて予約された見積もりメモリ量の最大値(バイト)です。
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+        int64 PeakReservedMemoryBytes = 0;
+
+    /**
+     * @brief インポート中に観測したプロセスの物理メモリ使用量の最大値(バイト)です。
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+        int64 PeakUsedPhysicalMemoryBytes = 0;
+
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+        int PeakConcurrentGmlCount = 0;
+
+    /**
+     * @brief メモリ予算の不足により処理の開始を待機したGML数です。
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+        int DeferredGmlCount = 0;
 };
 
 UCLASS()
@@ -108,6 +136,19 @@ public:
     UPROPERTY(EditAnywhere, Category = "PLATEAU")
         ECityModelLoadingPhase Phase;
 
+    /**
+     * @brief 同時に処理中のGMLのメモリ使用量の見積もりの合計の上限(MB)です。0以下の場合は無制限です。
+     * 見積もりはGMLのファイルサイズ, パッケージ, 抽出設定から求めます。上限を超えるGMLでも他に処理中のGMLが無ければ処理します。
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU")
+        float MemoryBudgetMB = 8192.0f;
+
+    /**
+     * @brief 同時に処理するGML数の上限です。
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU", meta = (ClampMin = 1))
+        int MaxConcurrentGmlCount = 8;
+
     UPROPERTY(BlueprintAssignable, Category = "PLATEAU")
         FImportGmlFilesDelegate ImportGmlFilesDelegate;
 
@@ -134,6 +175,18 @@ public:
     UFUNCTION(BlueprintCallable, Category = "PLATEAU")
         void Cancel();
 
+    /**
+     * @brief インポート設定に従い、指定したメッシュコード範囲のGML毎の読込設定を作成します。
+     */
+    static TArray<FLoadInputData> PrepareLoadInputData(
+        const UPLATEAUImportSettings* ImportSettings, const plateau::dataset::DatasetSource& DatasetSource,
+        const TArray<FString>& MeshCodes, FPLATEAUGeoReference& GeoReference);
+
+    /**
+     * @brief GMLをパースしてメッシュを抽出します。抽出済みメッシュキャッシュにヒットした場合はパースと抽出を省略します。
+     * @return GMLのパースに失敗した場合はfalse
+     */
+    static bool ExtractModel(const FString& GmlPath, const FLoadInputData& LoadInputData, FPLATEAUExtractedModel& OutExtractedModel);
 
 
 protected:
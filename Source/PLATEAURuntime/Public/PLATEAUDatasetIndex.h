@@ -0,0 +1,53 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <plateau/dataset/city_model_package.h>
+
+/**
+ * @brief ローカルのデータセットに含まれるGMLファイルの索引です。
+ * udx以下を走査してGMLのパス, パッケージ, メッシュコード, サイズ, 更新日時を記録し、
+ * メッシュコードとパッケージによる絞り込みをメモリ上で行えるようにします。
+ *
+ * 索引は Intermediate/PLATEAU/DatasetIndex 以下に保存され、次回以降はディレクトリの更新日時が変わったディレクトリのみ再走査します。
+ * ファイルの追加/削除/名前変更で更新されるディレクトリの更新日時を基準とするため、既存ファイルの上書きは検出しません。
+ */
+class PLATEAURUNTIME_API FPLATEAUDatasetIndex {
+public:
+    struct FEntry {
+        FString GmlPath;
+        plateau::dataset::PredefinedCityModelPackage Package = plateau::dataset::PredefinedCityModelPackage::None;
+        FString MeshCode;
+        int64 FileSize = 0;
+        FDateTime ModificationTime;
+    };
+
+    /**
+     * @brief データセットの索引を取得します。未作成の場合は作成し、作成済みの場合は変更のあったディレクトリのみ再走査します。
+     * スレッドセーフです。
+     * @param SourcePath データセットのルートフォルダ(udxフォルダを含むフォルダ)のパス
+     * @param OutRescannedDirectoryCount 再走査したディレクトリ数
+     * @return udxフォルダが存在しない場合はnullptr
+     */
+    static TSharedPtr<const FPLATEAUDatasetIndex, ESPMode::ThreadSafe> FindOrBuild(const FString& SourcePath, int32* OutRescannedDirectoryCount = nullptr);
+
+    /**
+     * @brief MeshCodesのいずれかと範囲が重なる地域メッシュのGMLのうち、パッケージがPackagesに含まれるもののパスをパスの昇順で返します。
+     * Packagesはフラグの集合として扱います。
+     */
+    TArray<FString> FindGmlFiles(const TArray<FString>& MeshCodes, const plateau::dataset::PredefinedCityModelPackage Packages) const;
+
+    const TArray<FEntry>& GetEntries() const;
+
+    /**
+     * @brief 保存済みの索引とメモリ上の索引を全て削除します。
+     */
+    static void ClearCache();
+
+    static FString GetCacheDirectory();
+
+private:
+    // メッシュコード, パスの昇順
+    TArray<FEntry> Entries;
+};
@@ -0,0 +1,63 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+
+struct FLoadInputData;
+
+namespace citygml {
+    class CityModel;
+}
+
+namespace plateau::polygonMesh {
+    class Model;
+}
+
+/**
+ * @brief MeshExtractorで抽出したModelと、各ノードのシリアライズ済み地物情報です。
+ * SerializedCityObjects のキーはノードパス(FPLATEAUGmlUtil::GetNodePathString)です。
+ */
+struct PLATEAURUNTIME_API FPLATEAUExtractedModel {
+    std::shared_ptr<plateau::polygonMesh::Model> Model;
+    TMap<FString, FString> SerializedCityObjects;
+};
+
+/**
+ * @brief 抽出済みメッシュのディスクキャッシュです。
+ * GMLの内容, GMLが参照するコードリストの内容, 抽出設定からキーを作成し、ヒットした場合はGMLのパースとメッシュ抽出を省略できます。
+ * キャッシュは Intermediate/PLATEAU/ExtractedModelCache 以下に保存されます。
+ */
+class PLATEAURUNTIME_API FPLATEAUExtractedModelCache {
+public:
+    /**
+     * @brief キャッシュキーを作成します。GMLが読めない場合は空文字を返します。
+     */
+    static FString MakeKey(const FString& GmlPath, const FLoadInputData& LoadInputData);
+
+    /**
+     * @brief キャッシュを読み込みます。参照しているテクスチャが存在しない場合はミスとして扱います。
+     */
+    static bool Load(const FString& Key, FPLATEAUExtractedModel& OutExtractedModel);
+
+    /**
+     * @brief 抽出済みModelの各ノードについて、FPLATEAUMeshLoaderが作成するコンポーネントと同じ地物情報をシリアライズします。
+     */
+    static void SerializeCityObjects(const plateau::polygonMesh::Model& Model, const std::shared_ptr<const citygml::CityModel> CityModel,
+        const FLoadInputData& LoadInputData, TMap<FString, FString>& OutSerializedCityObjects);
+
+    static bool Save(const FString& Key, const FPLATEAUExtractedModel& ExtractedModel);
+
+    static bool IsEnabled();
+    static void SetEnabled(const bool bInEnabled);
+
+    /**
+     * @brief キャッシュ全体のディスク使用量の上限(バイト)を設定します。上限を超えた場合は最終アクセスが古いものから削除されます。
+     */
+    static void SetCacheBudget(const int64 BudgetBytes);
+
+    static void ClearCache();
+
+    static FString GetCacheDirectory();
+};
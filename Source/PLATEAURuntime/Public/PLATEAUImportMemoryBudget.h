@@ -0,0 +1,88 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FLoadInputData;
+
+/**
+ * @brief インポート中のメモリ使用量の統計です。
+ */
+struct PLATEAURUNTIME_API FPLATEAUImportMemoryStats {
+    // 同時に予約された見積もりメモリ量の最大値(バイト)
+    int64 PeakReservedBytes = 0;
+    // 同時に処理されたGML数の最大値
+    int32 PeakConcurrentGmlCount = 0;
+    // インポート中に観測したプロセスの物理メモリ使用量の最大値(バイト)
+    int64 PeakUsedPhysicalBytes = 0;
+    // 予算不足で待機した回数
+    int32 DeferredCount = 0;
+};
+
+/**
+ * @brief GML毎のメモリ使用量の見積もりに基づいて、インポート処理の開始を制御します。
+ * 予約中の見積もりの合計が予算を超える場合は新たなGMLの処理を開始せず、処理中のGMLが予約を解放するまで待機させます。
+ * ただし処理中のGMLが無い場合は、予算を超えるGMLでも単独で処理を開始します。
+ * スレッドセーフです。
+ */
+class PLATEAURUNTIME_API FPLATEAUImportMemoryBudget {
+public:
+    /**
+     * @brief GML毎のメモリ使用量の見積もりです。
+     * ParseBytesはパース結果(citygml::CityModel)の分で、メッシュ抽出後に解放されます。
+     * MeshBytesは抽出結果, テクスチャ, FMeshDescriptionの分で、ワールドへの読込完了まで保持されます。
+     */
+    struct FEstimate {
+        int64 ParseBytes = 0;
+        int64 MeshBytes = 0;
+
+        int64 GetTotalBytes() const {
+            return ParseBytes + MeshBytes;
+        }
+    };
+
+    /**
+     * @param InBudgetBytes 0以下の場合は無制限
+     * @param InMaxConcurrentCount 同時に処理するGML数の上限です。0以下の場合は無制限
+     */
+    FPLATEAUImportMemoryBudget(const int64 InBudgetBytes, const int32 InMaxConcurrentCount);
+
+    /**
+     * @brief GMLのファイルサイズ, パッケージ, 抽出設定からメモリ使用量を見積もります。
+     * @param FileSize GMLのファイルサイズ(バイト)。サーバーからのインポート等でサイズが不明な場合は負値
+     */
+    static FEstimate Estimate(const int64 FileSize, const FLoadInputData& LoadInputData);
+
+    /**
+     * @brief 予算内であれば見積もり分を予約してtrueを返します。
+     */
+    bool TryAcquire(const FEstimate& Estimate);
+
+    /**
+     * @brief メッシュ抽出後にパース結果の分の予約を解放します。
+     */
+    void ReleaseParse(const FEstimate& Estimate);
+
+    /**
+     * @brief 残りの予約を解放します。ReleaseParseを呼んでいない場合はパース結果の分も解放します。
+     */
+    void Release(const FEstimate& Estimate, const bool bParseReleased);
+
+    int64 GetReservedBytes() const;
+    int32 GetActiveCount() const;
+    int64 GetBudgetBytes() const;
+    FPLATEAUImportMemoryStats GetStats() const;
+
+private:
+    const int64 BudgetBytes;
+    const int32 MaxConcurrentCount;
+
+    mutable FCriticalSection Section;
+    int64 ReservedBytes = 0;
+    int32 ActiveCount = 0;
+    bool bLastAcquireFailed = false;
+    FPLATEAUImportMemoryStats Stats;
+
+    void UpdatePhysicalPeak();
+};
@@ -101,6 +101,13 @@ public:
     UPROPERTY(EditAnywhere, Category = "Import Settings")
         bool bSetCollider = true;
 
+    /*
+    * @brief 平行移動を除いて同一形状の地物(街路樹や都市設備など)で1つのStaticMeshを共有します。
+    * 共有されたメッシュの頂点はコンポーネントの位置を原点とするローカル座標になります。
+    */
+    UPROPERTY(EditAnywhere, Category = "Import Settings")
+        bool bEnableMeshInstancing = false;
+
     UPROPERTY(EditAnywhere, Category = "Import Settings")
         EPLATEAUMeshGranularity MeshGranularity = EPLATEAUMeshGranularity::PerPrimaryFeatureObject;
 
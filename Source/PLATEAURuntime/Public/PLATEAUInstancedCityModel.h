@@ -17,6 +17,7 @@
 struct FPLATEAUCityObject;
 class FPLATEAUModelReconstruct;
 class FPLATEAUModelClassification;
+struct FPLATEAUTextureAtlasResult;
 struct FPLATEAUMinMaxLod {
     int MinLod = 0;
     int MaxLod = 0;
@@ -142,6 +143,22 @@ public:
     APLATEAUInstancedCityModel* FilterByFeatureTypes(const citygml::CityObject::CityObjectsType InCityObjectType);
     APLATEAUInstancedCityModel* FilterByFeatureTypesLegacy(const citygml::CityObject::CityObjectsType InCityObjectType); //属性情報がない場合Modelを取得して判定
 
+    /**
+     * @brief FilterByLods, FilterByFeatureTypesを続けて実行した場合と同じ結果を、表示状態の変化するコンポーネントのみ更新することで反映します。
+     * @return thisを返します。
+     */
+    APLATEAUInstancedCityModel* FilterByLodsAndFeatureTypes(const plateau::dataset::PredefinedCityModelPackage InPackage, const TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod>& PackageToLodRangeMap, const bool bOnlyMaxLod, const citygml::CityObject::CityObjectsType InCityObjectType);
+
+    /**
+     * @brief フィルタリング用のインデックスを構築します。インポート完了時に呼ばれます。
+     */
+    void BuildFilteringIndex();
+
+    /**
+     * @brief コンポーネント構成が変化した際にフィルタリング用のインデックスを破棄します。
+     */
+    void InvalidateFilteringIndex();
+
     /**
      * @brief 3D都市モデル内に含まれるLodを取得します。
      * @param InPackage 検索対象のパッケージ。フラグによって複数指定可能です。
@@ -179,6 +196,13 @@ public:
      */
 	UE::Tasks::FTask CreateLandscape(const TArray<USceneComponent*>& TargetComponents, FPLATEAULandscapeParam Param, bool bDestroyOriginal);
 
+    /**
+     * @brief 全てのコンポーネントのテクスチャをGMLをまたいでアトラスにまとめ、同一となったマテリアルを共有します。エディタでのみ動作します。
+     * @param AtlasSize アトラスの一辺のピクセル数
+     * @return マテリアル, テクスチャ, セクション数の変化
+     */
+    FPLATEAUTextureAtlasResult AtlasTextures(const int32 AtlasSize = 4096);
+
 protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
@@ -198,6 +222,11 @@ protected:
      */
     UE::Tasks::TTask<TArray<USceneComponent*>> ClassifyTask(FPLATEAUModelClassification& ModelClassification, const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, const EPLATEAUMeshGranularity ReconstructType, bool bDestroyOriginal);
 
+    /**
+     * @brief 地物単位を指定済みのModelClassificationでマテリアル分けを行います。マテリアルの書き換えのみで済むコンポーネントは再生成しません
+     */
+    TArray<USceneComponent*> ClassifyWithGranularity(FPLATEAUModelClassification& ModelClassification, const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, bool bDestroyOriginal);
+
     /**
      * @brief 特定パッケージを地形に合わせて高さ合わせ
      */
@@ -215,4 +244,10 @@ public:
 private:
     TAtomic<bool> bIsFiltering;
     TArray<FPLATEAUCityObject> RootCityObjects;
+    TSharedPtr<class FPLATEAUModelFilteringIndex> FilteringIndex;
+
+    /**
+     * @brief 最新のフィルタリング用インデックスを返します。未構築または古い場合は再構築します。
+     */
+    const FPLATEAUModelFilteringIndex& GetFilteringIndex();
 };
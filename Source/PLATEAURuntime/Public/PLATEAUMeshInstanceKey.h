@@ -0,0 +1,41 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace plateau::polygonMesh {
+    class Mesh;
+}
+
+/**
+ * @brief 平行移動を除いて同一のメッシュを判定するためのキーです。
+ * 頂点座標はバウンディングボックスの最小点を原点として量子化し、インデックス, UV, サブメッシュのマテリアル情報とあわせて比較します。
+ */
+struct PLATEAURUNTIME_API FPLATEAUMeshInstanceKey {
+public:
+    FPLATEAUMeshInstanceKey() = default;
+    explicit FPLATEAUMeshInstanceKey(const plateau::polygonMesh::Mesh& InMesh);
+
+    /**
+     * @brief 頂点座標の原点です。共有するメッシュはこの点を原点とするローカル座標で作成されます。
+     */
+    FVector Origin = FVector::ZeroVector;
+
+    bool IsValid() const {
+        return !Signature.IsEmpty();
+    }
+
+    // Originは比較に含めません
+    bool operator==(const FPLATEAUMeshInstanceKey& Other) const {
+        return Hash == Other.Hash && Signature == Other.Signature;
+    }
+
+    friend uint32 GetTypeHash(const FPLATEAUMeshInstanceKey& Key) {
+        return Key.Hash;
+    }
+
+private:
+    TArray<int64> Signature;
+    uint32 Hash = 0;
+};
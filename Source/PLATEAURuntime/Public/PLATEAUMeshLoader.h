@@ -6,12 +6,14 @@
 #include <citygml/material.h>
 #include "MeshTypes.h"
 #include "PLATEAUCachedMaterialArray.h"
+#include "PLATEAUMeshInstanceKey.h"
 #include <plateau/polygon_mesh/mesh.h>
 #include "StaticMeshAttributes.h"
 #include "Materials/MaterialInterface.h"
 #include "Engine/StaticMesh.h"
 
 struct FPLATEAUCityObject;
+struct FPLATEAUExtractedModel;
 struct FLoadInputData;
 class UPLATEAUCityObjectGroup;
 class FStaticMeshAttributes;
@@ -88,6 +90,14 @@ public:
         const std::shared_ptr<const citygml::CityModel> CityModel,
         TAtomic<bool>* bCanceled);
 
+    // CityModelの代わりにシリアライズ済みの地物情報を使用してロードします
+    void LoadModel(
+        AActor* ModelActor,
+        USceneComponent* ParentComponent,
+        const FPLATEAUExtractedModel& ExtractedModel,
+        const FLoadInputData& LoadInputData,
+        TAtomic<bool>* bCanceled);
+
     //前回のロードで作成されたComponentのリストを返します
     TArray<USceneComponent*> GetLastCreatedComponents();
 
@@ -114,6 +124,15 @@ protected:
     // 前回のLoadModel, ReloadComponentFromNode実行時に作成されたComponentを保持しておきます
     TArray<USceneComponent*> LastCreatedComponents;
 
+    // LoadModel実行中のみ有効。キャンセルされたかどうか
+    TAtomic<bool>* CancelFlag = nullptr;
+
+    // LoadModel(FPLATEAUExtractedModel)実行中のみ有効。Key: ノードパス, Value: シリアライズ済みの地物情報
+    const TMap<FString, FString>* SerializedCityObjects = nullptr;
+
+    // FLoadInputData::bEnableMeshInstancing有効時に、平行移動を除いて同一形状のメッシュを使い回せるように覚えておきます
+    TMap<FPLATEAUMeshInstanceKey, UStaticMesh*> SharedStaticMeshes;
+
     virtual UStaticMeshComponent* CreateStaticMeshComponent(
         AActor& Actor,
         USceneComponent& ParentComponent,
@@ -121,6 +140,16 @@ protected:
         const FLoadInputData& LoadInputData,
         const std::shared_ptr<const citygml::CityModel> CityModel,
         FNodeHierarchy NodeHier);
+    // 作成済みのStaticMeshを共有するComponentを作成します
+    UStaticMeshComponent* CreateSharedStaticMeshComponent(
+        AActor& Actor,
+        USceneComponent& ParentComponent,
+        const plateau::polygonMesh::Mesh& InMesh,
+        const FLoadInputData& LoadInputData,
+        const std::shared_ptr<const citygml::CityModel> CityModel,
+        FNodeHierarchy NodeHier,
+        UStaticMesh* SharedStaticMesh,
+        const FVector& Origin);
     USceneComponent* LoadNode(
         USceneComponent* ParentComponent,
         const plateau::polygonMesh::Node& Node,
@@ -138,6 +167,12 @@ protected:
     virtual void ModifyMeshDescription(FMeshDescription& MeshDescription);
     //既存のTextureを上書きするか
     virtual bool OverwriteTexture();
+    //SubMeshのテクスチャを読み込みます
+    virtual UTexture2D* LoadTexture(const FString& TexturePath);
+    //ゲームスレッドでの処理を中断するか。LoadModelのキャンセル時にtrueを返します(ゲームスレッドから呼び出されます)
+    virtual bool IsLoadAborted() const;
+    //StaticMeshをアセット用のビルドを行わずMeshDescriptionから直接ビルドするか。ランタイムでは常に直接ビルドします
+    virtual bool UseRuntimeMeshBuild() const;
 
     virtual void ComputeNormals(FStaticMeshAttributes& Attributes, bool InvertNormal);
     virtual bool ConvertMesh(const plateau::polygonMesh::Mesh& InMesh, FMeshDescription& OutMeshDescription,
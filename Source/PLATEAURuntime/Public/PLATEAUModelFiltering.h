@@ -31,6 +31,69 @@ public:
 
     void FilterByFeatureTypes(const TArray<TObjectPtr<USceneComponent>>& GmlComponents, const citygml::CityObject::CityObjectsType InCityObjectType);
 
+    /**
+     * @brief FPLATEAUModelFilteringIndexを用いて、FilterByLods, FilterByFeatureTypesを1回の反映で実行します。
+     * 表示状態、コリジョン設定は変化するコンポーネントに対してのみ変更されます。
+     * @param InCityObjectType 可視化する地物タイプ。COT_Allの場合は地物タイプでのフィルタリングを行いません。
+     * @return 表示状態を変更したコンポーネント数
+     */
+    int32 FilterByIndex(const class FPLATEAUModelFilteringIndex& Index, const plateau::dataset::PredefinedCityModelPackage InPackage, const TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod>& PackageToLodRangeMap, const bool bOnlyMaxLod, const citygml::CityObject::CityObjectsType InCityObjectType);
+
+    /**
+     * @brief FPLATEAUModelFilteringIndexを用いて、現在の表示状態に対して地物タイプでのフィルタリングを行います。
+     * @return 表示状態を変更したコンポーネント数
+     */
+    int32 FilterByFeatureTypesByIndex(const FPLATEAUModelFilteringIndex& Index, const citygml::CityObject::CityObjectsType InCityObjectType);
+
     void FilterByFeatureTypesLegacyCacheCityGml(const TArray<TObjectPtr<USceneComponent>>& GmlComponents, const citygml::CityObject::CityObjectsType InCityObjectType, const FString DatasetName);
     void FilterByFeatureTypesLegacyMain(const TArray<TObjectPtr<USceneComponent>>& GmlComponents, const citygml::CityObject::CityObjectsType InCityObjectType, const FString DatasetName);
 };
+
+/**
+ * @brief フィルタリング用に、パッケージ×LOD×地物タイプから対象コンポーネントを引けるようにした事前計算結果です。
+ * コンポーネント名のパース、地物IDの集合の構築、CityObjectのデシリアライズを構築時に1度だけ行います。
+ */
+class PLATEAURUNTIME_API FPLATEAUModelFilteringIndex {
+public:
+    /**
+     * @brief GMLファイルComponentの一覧から構築します。ゲームスレッドで呼び出してください。
+     */
+    void Build(const TArray<TObjectPtr<USceneComponent>>& GmlComponents);
+
+    /**
+     * @brief 構築後にコンポーネントが追加・削除されていないかを返します。
+     */
+    bool IsUpToDate(const TArray<TObjectPtr<USceneComponent>>& GmlComponents) const;
+
+    int32 NumEntries() const {
+        return Entries.Num();
+    }
+
+private:
+    friend class FPLATEAUModelFiltering;
+
+    struct FGml {
+        plateau::dataset::PredefinedCityModelPackage Package;
+        TWeakObjectPtr<USceneComponent> Component;
+    };
+
+    // LODコンポーネント直下の地物コンポーネント
+    struct FFeature {
+        int32 GmlIndex;
+        int32 Lod;
+        // 同じGML内で同名の地物が存在するLODのビットマスク
+        uint32 SameNameLodMask;
+    };
+
+    // 地物コンポーネントとその子孫コンポーネント
+    struct FEntry {
+        TWeakObjectPtr<USceneComponent> Component;
+        int32 FeatureIndex;
+        // 地物タイプでのフィルタリング対象の場合はcitygml::CityObject::CityObjectsTypeの値、対象外の場合は0
+        uint64 CityObjectType;
+    };
+
+    TArray<FGml> Gmls;
+    TArray<FFeature> Features;
+    TArray<FEntry> Entries;
+};
@@ -8,5 +8,16 @@
 class PLATEAURUNTIME_API FPLATEAUTextureLoader {
 public:
     static UTexture2D* Load(const FString& TexturePath, bool OverwriteTextre);
-    static UTexture2D* LoadTransient(const FString& TexturePath);
+    /**
+     * @brief アセットとして保存せずにテクスチャを読み込みます。OutMip0Bytesにはテクスチャのピクセルデータのサイズを返します。
+     */
+    static UTexture2D* LoadTransient(const FString& TexturePath, int64* OutMip0Bytes = nullptr);
+
+#if WITH_EDITOR
+    /**
+     * @brief BGRA8のピクセルデータからテクスチャアセットを作成し、/Game/PLATEAU/Textures 以下に保存します。同名のアセットがある場合は末尾に番号を付けた名前で作成し、既存のアセットは上書きしません。
+     * 3Dファイルエクスポート用に、ピクセルデータはSourceDirectory以下にPNGとしても書き出し、ソースファイルとして記録します。
+     */
+    static UTexture2D* CreateTextureAsset(const FString& TextureName, const int32 Width, const int32 Height, const TArray64<uint8>& BGRA8Data, const FString& SourceDirectory);
+#endif
 };
@@ -102,6 +102,7 @@ public:
     FPLATEAUMeshLoaderForHeightmap();
     FPLATEAUMeshLoaderForHeightmap(const bool InbAutomationTest);
 
+    //メッシュを持つノードごとにハイトマップを生成します。各ノードの生成は並列に実行されます
     TArray<HeightmapCreationResult> CreateHeightMap(
         AActor* ModelActor,
         const std::shared_ptr<plateau::polygonMesh::Model> Model, FPLATEAULandscapeParam Param);
@@ -111,12 +112,12 @@ public:
 
 protected:
 
+    //メッシュを持つノードを走査順に収集します
     void LoadNodeRecursiveForHeightMap(
-        const plateau::polygonMesh::Node& InNode,
-        AActor& InActor, FPLATEAULandscapeParam Param, TArray<HeightmapCreationResult> &Results);
+        const plateau::polygonMesh::Node& InNode, TArray<const plateau::polygonMesh::Node*>& OutTargetNodes);
     void LoadNodeForHeightMap(
-        const plateau::polygonMesh::Node& Node,
-        AActor& Actor, FPLATEAULandscapeParam Param, TArray<HeightmapCreationResult> &Results);
+        const plateau::polygonMesh::Node& InNode, TArray<const plateau::polygonMesh::Node*>& OutTargetNodes);
+    //ノード単位のハイトマップ生成です。CreateHeightMapから並列に呼ばれるため、メンバの状態を変更しないでください
     HeightmapCreationResult CreateHeightMapFromMesh(
         const plateau::polygonMesh::Mesh& InMesh,
         const FString NodeName,
@@ -40,16 +40,35 @@ public:
     TArray<UPLATEAUCityObjectGroup*> GetTargetCityObjectsForAlignLand();
 
     void SetResults(const TArray<HeightmapCreationResult> Results, const FPLATEAULandscapeParam Param);
-    TArray<USceneComponent*> Align(const TArray<UPLATEAUCityObjectGroup*> TargetCityObjects);
+
+    /**
+     * @brief TargetCityObjectsの高さを地形に合わせます。モデルを経由してコンポーネントを作り直し、作成したコンポーネントを返します。
+     * @param bAllowInPlace trueの場合、細分化が不要なメッシュ(全ての辺がMaxEdgeLength以下)は既存のStaticMeshの頂点をその場で動かし、
+     * 頂点が動いたメッシュのみ再ビルドします(元の形状は残りません)。
+     */
+    TArray<USceneComponent*> Align(const TArray<UPLATEAUCityObjectGroup*> TargetCityObjects, bool bAllowInPlace = false);
+
+    /**
+     * @brief 直前のAlignでモデル経由で作り直した(元のコンポーネントが不要になった)対象を返します。
+     */
+    const TArray<UPLATEAUCityObjectGroup*>& GetReloadedCityObjects() const {
+        return ReloadedCityObjects;
+    }
+
     TArray<HeightmapCreationResult> UpdateHeightMapForLod3Road(TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects);
 
 protected:
     std::shared_ptr<plateau::polygonMesh::Model> CreateModelFromTargets(TArray<UPLATEAUCityObjectGroup*> TargetCityObjects);
+    /**
+     * @brief 細分化が不要なメッシュをその場で高さ合わせし、モデル経由で処理する必要がある対象を返します。
+     */
+    TArray<UPLATEAUCityObjectGroup*> AlignInPlace(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects);
     plateau::heightMapAligner::HeightMapFrame CreateAlignData(const TSharedPtr<std::vector<uint16_t>> HeightData, const TVec3d Min, const TVec3d Max, const FString NodeName, const FPLATEAULandscapeParam Param);
 
 private:
     plateau::heightMapAligner::HeightMapAligner heightmapAligner;
     TArray<HeightmapCreationResult> HeightmapCreationResults;
     FPLATEAULandscapeParam LandscapeParam;
+    TArray<UPLATEAUCityObjectGroup*> ReloadedCityObjects;
 };
 
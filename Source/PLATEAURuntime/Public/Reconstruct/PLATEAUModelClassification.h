@@ -11,7 +11,28 @@ class PLATEAURUNTIME_API FPLATEAUModelClassification : public FPLATEAUModelRecon
 public:
     virtual void SetConvertGranularity(const ConvertGranularity Granularity) = 0;
 
+    /**
+     * @brief 地物単位の変更が不要で、コンポーネント内の地物が全て同じマテリアルに分類される場合は、
+     * Modelを経由せずにコンポーネントのマテリアルのみを書き換えます。
+     * @param TargetCityObjects 対象コンポーネント
+     * @param OutRemainingTargets マテリアルの書き換えだけでは分類できず、再生成が必要なコンポーネント
+     * @return マテリアルを書き換えたコンポーネント
+     */
+    TArray<USceneComponent*> ClassifyInPlace(const TArray<UPLATEAUCityObjectGroup*>& TargetCityObjects, TArray<UPLATEAUCityObjectGroup*>& OutRemainingTargets);
+
 protected:
     //設定がない場合のマテリアル
     UMaterialInterface* DefaultMaterial;
+
+    /**
+     * @brief 地物自身の情報から分類先のマテリアルを返します。分類対象外の場合はnullptrを返します。
+     * 複数のマテリアルに該当する場合はbOutAmbiguousをtrueにします。
+     */
+    virtual UMaterialInterface* FindClassificationMaterial(const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) const = 0;
+
+    /**
+     * @brief CityObjectsの分類先マテリアルをまとめて求め、OutMaterials/OutAmbiguousの同じインデックスに設定します。
+     * 既定では地物ごとにFindClassificationMaterialを呼び出します。
+     */
+    virtual void FindClassificationMaterials(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<UMaterialInterface*>& OutMaterials, TBitArray<>& OutAmbiguous) const;
 };
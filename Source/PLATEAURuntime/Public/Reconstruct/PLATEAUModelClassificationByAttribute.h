@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Reconstruct/PLATEAUModelClassification.h"
+#include "CityGML/PLATEAUAttributeQuery.h"
 #include <plateau/material_adjust/material_adjuster_by_attr.h>
 
 /**
@@ -21,8 +22,26 @@ public:
     void ComposeCachedMaterialFromTarget(const TArray<UPLATEAUCityObjectGroup*>& Target) override;
 
 protected:
+    UMaterialInterface* FindClassificationMaterial(const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) const override;
+    void FindClassificationMaterials(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<UMaterialInterface*>& OutMaterials, TBitArray<>& OutAmbiguous) const override;
+
+    /**
+     * @brief CityObjectsの属性値をまとめて評価し、該当するClassificationPatternsのインデックスをOutPatternIndicesに設定します。該当しない場合はINDEX_NONEです
+     */
+    void FindClassificationPatterns(TArrayView<const FPLATEAUCityObject* const> CityObjects, TArray<int32>& OutPatternIndices) const;
+
+    //属性値ごとの分類条件
+    struct FClassificationPattern {
+        FString Value;
+        FPLATEAUAttributePredicate Predicate;
+        UMaterialInterface* Material;
+    };
 
     FString ClassificationAttributeKey;
+    //ClassificationAttributeKeyを解析済みのクエリ
+    FPLATEAUAttributeQuery ClassificationAttributeQuery;
     TMap<FString, UMaterialInterface*> ClassificationMaterials;
+    //ClassificationMaterialsのうちマテリアルが設定されているもの
+    TArray<FClassificationPattern> ClassificationPatterns;
 };
 
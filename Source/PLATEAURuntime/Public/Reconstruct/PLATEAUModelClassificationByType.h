@@ -20,6 +20,7 @@ public:
     void ComposeCachedMaterialFromTarget(const TArray<UPLATEAUCityObjectGroup*>& Target) override;
 
 protected:
+    UMaterialInterface* FindClassificationMaterial(const FPLATEAUCityObject& CityObject, bool& bOutAmbiguous) const override;
 
     TMap<EPLATEAUCityObjectsType, UMaterialInterface*> ClassificationMaterials;
 };
@@ -22,8 +22,12 @@ public:
 
     TArray<HeightmapCreationResult> CreateHeightMap(std::shared_ptr<plateau::polygonMesh::Model> Model, FPLATEAULandscapeParam Param);
 
+    /**
+     * @brief ハイトマップからLandscapeを生成します
+     * @param HeightData ハイトマップの高さデータ。Landscapeのインポートバッファへ直接書き込まれます
+     */
     ALandscape* CreateLandScape(UWorld* World, const int32 NumSubsections, const int32 SubsectionSizeQuads, const int32 ComponentCountX, const int32 ComponentCountY, const int32 SizeX, const int32 SizeY,
-        const TVec3d Min, const TVec3d Max, const TVec2f MinUV, const TVec2f MaxUV, const FString TexturePath, TArray<uint16> HeightData, const FString ActorName);
+        const TVec3d Min, const TVec3d Max, const TVec2f MinUV, const TVec2f MaxUV, const FString TexturePath, TConstArrayView<uint16> HeightData, const FString ActorName);
 
     //LandscapeのReference Componentを元のDemの階層に生成します
     void CreateLandScapeReference(ALandscape* Landscape, AActor* Actor, const FString ActorName);
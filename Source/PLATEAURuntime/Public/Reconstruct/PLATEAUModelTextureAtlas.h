@@ -0,0 +1,66 @@
+// Copyright 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APLATEAUInstancedCityModel;
+class UMaterialInterface;
+class UStaticMesh;
+class UStaticMeshComponent;
+class UTexture2D;
+
+/**
+ * @brief テクスチャアトラス化の結果です。各値はアクター内のコンポーネントが参照しているものの数です。
+ */
+struct PLATEAURUNTIME_API FPLATEAUTextureAtlasResult {
+    int32 MaterialCountBefore = 0;
+    int32 MaterialCountAfter = 0;
+    int32 TextureCountBefore = 0;
+    int32 TextureCountAfter = 0;
+    // コンポーネント毎のセクション数(描画コール数)の合計
+    int32 SectionCountBefore = 0;
+    int32 SectionCountAfter = 0;
+    int32 AtlasCount = 0;
+    // アトラスにまとめたテクスチャ数
+    int32 AtlasedTextureCount = 0;
+
+    FString ToString() const;
+};
+
+/**
+ * @brief インポート済みの3D都市モデルについて、GMLをまたいでテクスチャをアトラスにまとめ、UVを書き換えます。
+ * アトラス化後に同一となったマテリアルは共有し、同一マテリアルのセクションは結合します。
+ * MeshDescriptionを書き換えるため、エディタでのみ動作します。
+ *
+ * 以下のテクスチャはアトラスに含めません。
+ * - UVが0~1の範囲外となる(繰り返し貼られる)もの
+ * - 8bit BGRA以外のソースを持つもの、アトラスサイズより大きいもの
+ */
+class PLATEAURUNTIME_API FPLATEAUModelTextureAtlas {
+public:
+    FPLATEAUModelTextureAtlas(APLATEAUInstancedCityModel* Actor);
+
+    /**
+     * @brief アトラスの一辺のピクセル数です。
+     */
+    int32 AtlasSize = 4096;
+
+    /**
+     * @brief アトラス内の各テクスチャの周囲に設けるピクセル数です。ミップマップでの隣接テクスチャとのにじみを抑えます。
+     */
+    int32 Padding = 4;
+
+    /**
+     * @brief アトラス化とマテリアルの統合を行います。ゲームスレッドから呼ぶ必要があります。
+     */
+    FPLATEAUTextureAtlasResult Execute();
+
+    /**
+     * @brief 作成したアトラスのテクスチャアセット名の接頭辞です。
+     */
+    static const FString AtlasTexturePrefix;
+
+private:
+    APLATEAUInstancedCityModel* CityModelActor;
+};
@@ -14,12 +14,16 @@ class URnPoint;
 struct FAttributeDataHelper;
 
 USTRUCT(BlueprintType)
-struct FSubDividedCityObjectSubMesh {
+struct PLATEAURUNTIME_API FSubDividedCityObjectSubMesh {
     GENERATED_BODY()
 public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
     TArray<int32> Triangles;
 
+    /**
+     * @brief 頂点を共有する三角形同士を連結成分として分離します。
+     * 連結成分は最小の三角形番号順に並び、成分内の三角形は深さ優先で辿った順になります。
+     */
     TArray<FSubDividedCityObjectSubMesh> Separate() const;
     TArray<TArray<int32>> CreateOutlineIndices() const;
     FSubDividedCityObjectSubMesh DeepCopy() const;
@@ -35,7 +39,15 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PLATEAU")
     TArray<FSubDividedCityObjectSubMesh> SubMeshes;
 
+    /**
+     * @brief 座標が完全に一致する頂点を結合し, 縮退した三角形と重複した三角形を削除します。
+     * 頂点は最初に出現した順に, 三角形は元の順番のまま(インデックスは昇順にソート)出力されます。
+     */
     void VertexReduction();
+
+    /**
+     * @brief 各サブメッシュを連結成分毎に分離します。サブメッシュ間は並列に処理されます。
+     */
     void Separate();
     FSubDividedCityObjectMesh DeepCopy() const;
 };
@@ -78,11 +90,22 @@ public:
 
     static ERRoadTypeMask GetRoadTypeFromCityObject(const FPLATEAUCityObject& CityObject);
 
+    /**
+     * @brief Objects及びその子孫が持つ全メッシュを並列にVertexReductionします。
+     */
+    static void VertexReductionMeshes(const TArray<TSharedPtr<FSubDividedCityObject>>& Objects);
+
     FSubDividedCityObject()
     : CityObject()
     , SelfRoadType()
     {}
 
     FSubDividedCityObject(UPLATEAUCityObjectGroup* Co, const plateau::polygonMesh::Model& PlateauModel, TMap<FString, FPLATEAUCityObject>& CityObj);
-    FSubDividedCityObject(UPLATEAUCityObjectGroup* Co, const plateau::polygonMesh::Node& PlateauNode, TMap<FString, FPLATEAUCityObject>& CityObj, ERRoadTypeMask ParentTypeMask);
+    /**
+     * @param bVertexReduction falseの場合はメッシュのVertexReductionを行いません(後でVertexReductionMeshesでまとめて行う場合)
+     */
+    FSubDividedCityObject(UPLATEAUCityObjectGroup* Co, const plateau::polygonMesh::Node& PlateauNode, TMap<FString, FPLATEAUCityObject>& CityObj, ERRoadTypeMask ParentTypeMask, bool bVertexReduction = true);
+
+private:
+    static void CollectAllMeshes(FSubDividedCityObject& Obj, TArray<FSubDividedCityObjectMesh*>& OutMeshes);
 };
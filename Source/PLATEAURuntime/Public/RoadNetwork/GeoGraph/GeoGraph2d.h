@@ -60,11 +60,56 @@ public:
 
     static TArray<FVector2D> ComputeConvexVolume(const TArray<FVector2D>& Vertices);
 
+    /**
+     * @brief 凸包を構成する点のVertices上のインデックスを返します。
+     */
+    static TArray<int32> ComputeConvexVolumeIndices(const TArray<FVector2D>& Vertices);
+
+    /**
+     * @brief 各頂点について, それより前にある頂点のうちCalcDistanceがEpsilon未満で最も近いもののインデックスを返します(無い場合は自身)。
+     * 任意の距離関数を受け付けるため全頂点同士を比較します。ユークリッド距離の場合は下のオーバーロードを使用してください。
+     */
     static TArray<int32> GetNearVertexTable(
         const TArray<FVector>& Vertices,
         TFunction<float(const FVector&, const FVector&)> CalcDistance,
         float Epsilon = 0.1f);
 
+    /**
+     * @brief FVector::Distanceを距離とするGetNearVertexTableです。
+     * Epsilon四方のグリッドで近傍の頂点のみを比較します。結果は全頂点を比較した場合と同じです。
+     */
+    static TArray<int32> GetNearVertexTable(
+        const TArray<FVector>& Vertices,
+        float Epsilon = 0.1f);
+
+    /**
+     * @brief 辺の列に対して、頂点に接続している未使用の辺を辺番号の昇順で取り出すための表です。
+     * 取り出した辺は使用済みになります。輪郭線をつなげる処理を辺の数に対して線形時間で行うために使用します。
+     */
+    class PLATEAURUNTIME_API FEdgeChainTable {
+    public:
+        explicit FEdgeChainTable(const TArray<TTuple<int32, int32>>& Edges);
+
+        /**
+         * @brief 未使用の辺のうち番号が最小のものを取り出します。無い場合は-1を返します。
+         */
+        int32 PopFirst();
+
+        /**
+         * @brief Vertexに接続する未使用の辺のうち番号が最小のものを取り出します。無い場合は-1を返します。
+         */
+        int32 PopFirst(int32 Vertex);
+
+    private:
+        // VertexEdges[Offsets[v] ~ Offsets[v + 1]) が頂点vに接続する辺番号(昇順)
+        TArray<int32> Offsets;
+        TArray<int32> VertexEdges;
+        // 頂点毎の, これより前は全て使用済みとなる位置
+        TArray<int32> Cursors;
+        TBitArray<> Used;
+        int32 FirstCursor = 0;
+    };
+
     static TArray<FVector> ComputeMeshOutlineVertices(
         const TArray<FVector>& Vert,
         const TArray<int32>& Triangles,
@@ -188,68 +233,17 @@ TArray<T> FGeoGraph2D::ComputeConvexVolume(
         return Vertices;
     }
 
-    auto ToVec2 = [&](const T& A) -> FVector2D
-    {
-        return FAxisPlaneEx::GetTangent(ToVec3(A), Plane);
-    };
-
-    auto IsLastClockwise = [&](const TArray<T>& List)
-    {
-        if (List.Num() <= 2) {
-            return true;
-        }
-        const FVector2D& V1 = ToVec2(List[List.Num() - 1]);
-        const FVector2D& V2 = ToVec2(List[List.Num() - 2]);
-        const FVector2D& V3 = ToVec2(List[List.Num() - 3]);
-
-        const FVector2D D1 = V1 - V2;
-        const FVector2D D2 = V2 - V3;
-
-        // Cross product in 2D
-        float Cross = D1.X * D2.Y - D1.Y * D2.X;
-        return Cross > 0;
-    };
-
-    // Find the leftmost bottom point
-    int32 StartIndex = FindMostLeftBottom<T>(Vertices, ToVec2);
-    TArray<T> Points = { Vertices[StartIndex] };
-    TArray<int32> Stack = { StartIndex };
-
-    // Sort points by angle and distance
-    TArray<TTuple<int32, float>> Angles;
-    for (int32 i = 0; i < Vertices.Num(); ++i) {
-        if (i == StartIndex) continue;
-
-        FVector2D Diff = ToVec2(Vertices[i]) - ToVec2(Vertices[StartIndex]);
-        float Angle = FMath::Atan2(Diff.Y, Diff.X);
-        Angles.Add(MakeTuple(i, Angle));
+    // 2D座標は一度だけ計算し, 凸包はインデックスで求める
+    TArray<FVector2D> Points2D;
+    Points2D.Reserve(Vertices.Num());
+    for (const auto& V : Vertices) {
+        Points2D.Add(FAxisPlaneEx::GetTangent(ToVec3(V), Plane));
     }
 
-    Angles.Sort([](const TTuple<int32, float>& A, const TTuple<int32, float>& B) {
-        return A.Value < B.Value;
-        });
-
-    // Graham scan
-    for (const auto& IndexAngle : Angles) {
-        while (Stack.Num() >= 2) {
-            FVector2D P1 = ToVec2(Vertices[Stack[Stack.Num() - 2]]);
-            FVector2D P2 = ToVec2(Vertices[Stack.Last()]);
-            FVector2D P3 = ToVec2(Vertices[IndexAngle.Key]);
-
-            FVector2D V1 = P2 - P1;
-            FVector2D V2 = P3 - P2;
-
-            if (Cross(V1, V2) > 0) {
-                break;
-            }
-            Stack.Pop();
-            Points.Pop();
-        }
-
-        Stack.Add(IndexAngle.Key);
-        Points.Add(Vertices[IndexAngle.Key]);
+    TArray<T> Points;
+    for (const auto Index : ComputeConvexVolumeIndices(Points2D)) {
+        Points.Add(Vertices[Index]);
     }
-
     return Points;
 }
 
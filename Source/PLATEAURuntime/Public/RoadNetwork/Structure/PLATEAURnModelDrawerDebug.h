@@ -5,9 +5,11 @@
 #include "RnWay.h"
 #include "GameFramework/Actor.h"
 #include "RoadNetwork/PLATEAURnDef.h"
+#include "RoadNetwork/Util/PLATEAURnDebugEx.h"
 #include "PLATEAURnModelDrawerDebug.generated.h"
 
 class URnModel;
+class ULineBatchComponent;
 
 UENUM(Meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
 enum class ERnPartsTypeMask : uint8 {
@@ -293,5 +295,59 @@ public:
     UPROPERTY(EditAnywhere, Category = "PLATEAU|Debug")
     TArray<FString> ShowTargetNames;
 
+    /**
+     * @brief 描画内容を道路構造や設定が変わった時だけ作成し、ラインバッチコンポーネントとして保持します
+     * 無効の場合は毎フレーム全体を描画します
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU|Debug")
+    bool bRetained = true;
+
+    /**
+     * @brief 保持モードで線分をまとめる格子の大きさ. 格子ごとに視錐台カリングされます
+     */
+    UPROPERTY(EditAnywhere, Category = "PLATEAU|Debug", Meta = (EditCondition = "bRetained", ClampMin = "100.0"))
+    float RetainedCellSize = 20000.0f;
+
+    /**
+     * @brief Modelの全体を即時描画します
+     */
     void Draw(URnModel* Model);
+
+    /**
+     * @brief 保持モードで描画します. Modelか設定が変更されていた場合のみ描画内容を作り直します
+     * @param Owner 線分を保持するコンポーネントの所有者
+     */
+    void DrawRetained(AActor* Owner, URnModel* Model);
+
+    /**
+     * @brief 保持している描画内容を次の描画で作り直します. 設定を変更した場合に呼び出してください
+     */
+    void MarkDirty();
+
+    /**
+     * @brief 保持している描画内容を破棄します
+     */
+    void ClearRetained();
+
+    /**
+     * @brief 保持モードの描画内容を作成した回数を返します
+     */
+    int32 GetRetainedBuildCount() const;
+
+private:
+    struct FRetainedCell {
+        FBox Bounds = FBox(ForceInit);
+        TArray<FPLATEAURnDebugDrawBuffer::FLabel> Labels;
+    };
+
+    void BuildRetained(AActor* Owner, URnModel* Model);
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<ULineBatchComponent>> RetainedLineBatchers;
+
+    TArray<FRetainedCell> RetainedCells;
+    TWeakObjectPtr<URnModel> RetainedModel;
+    uint32 RetainedModelVersion = 0;
+    bool bRetainedDirty = true;
+    int32 RetainedBuildCount = 0;
 };
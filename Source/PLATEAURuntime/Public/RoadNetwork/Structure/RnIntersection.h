@@ -280,6 +280,9 @@ public:
 
     void BuildTracks();
 
+    // トラックを再生成する. 所属するURnModelが編集トランザクション中の場合はコミットまで遅延する
+    void RequestBuildTracks();
+
 private:
 
     // 交差点の外形情報
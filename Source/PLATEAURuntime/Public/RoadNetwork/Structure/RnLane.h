@@ -8,7 +8,7 @@
 
 class URnRoad;
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnLane : public UObject
+class PLATEAURUNTIME_API URnLane : public UObject
 {
 private:
     GENERATED_BODY()
@@ -146,6 +146,9 @@ private:
 
 
     TArray<TRnRef_T<URnRoadBase>> GetConnectedRoads(TRnRef_T<URnWay> Border);
+
+    // 親道路が所属するRnModelに変更を記録する
+    void MarkModelModified() const;
 private:
     // 親リンク
     UPROPERTY(VisibleAnywhere, Category = "PLATEAU")
@@ -12,7 +12,7 @@
 
 #include "RnLineString.generated.h"
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnLineString : public UObject
+class PLATEAURUNTIME_API URnLineString : public UObject
 {
     GENERATED_BODY()
 public:
@@ -36,14 +36,50 @@ public:
 
 };
 
+// 編集トランザクションのコミット結果
+struct FRnModelEditCommitResult
+{
+    // 境界線を調整した道路グループ数
+    int32 AdjustedRoadGroupCount = 0;
+
+    // トラックを再生成した交差点数
+    int32 RebuiltIntersectionCount = 0;
+
+    // トラック再生成で並列実行の単位となった交差点グループ数
+    int32 IntersectionGroupCount = 0;
+};
+
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnModel : public UPLATEAUSceneComponent
+class PLATEAURUNTIME_API URnModel : public UPLATEAUSceneComponent
 {
 public:
     const FString& GetFactoryVersion() const;
 
     void SetFactoryVersion(const FString& InFactoryVersion);
 
+    // 構造が変更されるたびに増加する番号. デバッグ描画のキャッシュ判定などに使う
+    uint32 GetModifiedVersion() const;
+
+    // 構造を変更したことを通知する. 道路/レーン/交差点の編集では自動で呼ばれるので, Wayや頂点を直接変更した場合に呼び出す
+    void MarkModified();
+
+    // 編集トランザクションを開始する.
+    // コミットまでの間, レーン数変更などに伴う交差点のトラック再生成と道路グループの境界線調整は記録のみ行い,
+    // コミット時に重複を除いてまとめて実行する. 入れ子にでき, 最も外側のコミットで反映される
+    void BeginEditTransaction();
+
+    // 編集トランザクションを終了する. 最も外側の場合は記録した境界線調整とトラック再生成を行う
+    FRnModelEditCommitResult CommitEditTransaction();
+
+    // 編集トランザクション中かどうか
+    bool IsInEditTransaction() const;
+
+    // 交差点のトラックを再生成する. 編集トランザクション中はコミットまで遅延する
+    void RequestBuildTracks(URnIntersection* Intersection);
+
+    // 道路グループの境界線調整を編集トランザクションのコミットまで遅延する. 遅延しない場合はfalseを返す
+    bool TryDeferAdjustBorder(URnRoadGroup* RoadGroup);
+
 private:
     GENERATED_BODY()
 
@@ -190,6 +226,23 @@ private:
     // 自動生成で作成されたときのバージョン
     FString FactoryVersion;
 
+    // 構造の変更番号
+    uint32 ModifiedVersion = 0;
+
+    // 編集トランザクションの入れ子の深さ
+    int32 EditTransactionDepth = 0;
+
+    // 記録した境界線調整を実行中かどうか
+    bool bAdjustingDeferredBorders = false;
+
+    // コミット時にトラックを再生成する交差点
+    UPROPERTY(Transient)
+    TSet<URnIntersection*> DeferredTrackIntersections;
+
+    // コミット時に境界線を調整する道路グループ
+    UPROPERTY(Transient)
+    TArray<URnRoadGroup*> DeferredBorderRoadGroups;
+
     // 道路リスト
     UPROPERTY(VisibleAnywhere, Category = "PLATEAU")
     TArray<URnRoad*> Roads;
@@ -203,3 +256,20 @@ private:
     TArray<URnSideWalk*> SideWalks;
 
 };
+
+// スコープ内をURnModelの編集トランザクションとし, スコープを抜けるときにコミットする. Modelがnullptrの場合は何もしない
+class PLATEAURUNTIME_API FRnModelEditScope
+{
+public:
+    explicit FRnModelEditScope(URnModel* InModel);
+    ~FRnModelEditScope();
+
+    // スコープを抜ける前にコミットして結果を返す. 以降スコープを抜けてもコミットしない
+    FRnModelEditCommitResult Commit();
+
+    FRnModelEditScope(const FRnModelEditScope&) = delete;
+    FRnModelEditScope& operator=(const FRnModelEditScope&) = delete;
+
+private:
+    URnModel* Model;
+};
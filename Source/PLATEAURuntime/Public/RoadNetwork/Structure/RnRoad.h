@@ -11,7 +11,7 @@ class URnIntersection;
 class UPLATEAUCityObjectGroup;
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnRoad : public URnRoadBase {
+class PLATEAURUNTIME_API URnRoad : public URnRoadBase {
 private:
     GENERATED_BODY()
 public:
@@ -16,7 +16,7 @@ class URnRoad;
 class URnIntersection;
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnRoadBase : public UObject
+class PLATEAURUNTIME_API URnRoadBase : public UObject
 {
     GENERATED_BODY()
 public:
@@ -77,6 +77,9 @@ public:
     TRnRef_T<URnModel> GetParentModel() const;
     void SetParentModel(const TRnRef_T<URnModel>& InParentModel);
 
+    // 所属するRnModelに変更を記録する(デバッグ表示の再構築などに使われる)
+    void MarkModelModified() const;
+
     // 構造的に正しいかどうかチェック
     virtual bool Check() const
     {
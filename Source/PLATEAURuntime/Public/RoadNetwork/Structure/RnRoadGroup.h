@@ -15,7 +15,7 @@ class URnLane;
 class URnLineString;
 
 UCLASS(ClassGroup = (Custom), BlueprintType, Blueprintable, meta = (BlueprintSpawnableComponent))
-class URnRoadGroup : public UObject
+class PLATEAURUNTIME_API URnRoadGroup : public UObject
 {
     GENERATED_BODY()
 public:
@@ -76,7 +76,7 @@ public:
     // 複数のRoadsを1つのRoadにまとめる
     bool MergeRoads();
 
-    // 交差点との境界線の角度を調整する
+    // 交差点との境界線の角度を調整する. 所属するURnModelが編集トランザクション中の場合はコミットまで遅延する
     void AdjustBorder();
 
     // Static Methods
@@ -125,7 +125,11 @@ public:
     }
 
 private:
+    // 所属するURnModelを取得
+    TRnRef_T<URnModel> GetParentModel() const;
 
+    // 両端の交差点のトラックを再生成する. 編集トランザクション中はコミットまで遅延する
+    void RequestBuildTracks() const;
 
     TMap<TRnRef_T<URnRoad>, TArray<TRnRef_T<URnLane>>> SplitLane(
         int32 Num,
@@ -152,7 +156,7 @@ public:
     void SetLaneCount(EPLATEAURnDir Dir, int32 Count, bool RebuildTrack = true);
 
     // 中央分離帯を考慮したレーン分割
-    void SetLaneCountWithMedian(int32 LeftCount, int32 RightCount, float MedianWidthRate);
+    void SetLaneCountWithMedian(int32 LeftCount, int32 RightCount, float MedianWidthRate, bool RebuildTrack = true);
 
 public:
     // 開始ノード
@@ -93,6 +93,17 @@ public:
         }
     };
 
+    // 生成するトラックの入口/出口
+    struct FTrackPlan {
+        URnIntersectionEdge* From;
+        URnIntersectionEdge* To;
+        ERnTurnType TurnType;
+
+        FTrackPlan(URnIntersectionEdge* InFrom, URnIntersectionEdge* InTo, ERnTurnType InTurnType)
+            : From(InFrom), To(InTo), TurnType(InTurnType) {
+        }
+    };
+
     // デフォルトコンストラクタ
     FRnTracksBuilder();
 
@@ -103,6 +114,34 @@ public:
      */
     void BuildTracks(URnIntersection* Intersection, const FBuildTrackOption& Option);
 
+    /**
+     * 生成するトラックの入口/出口を計算する. UObjectを生成しないため、隣接していない交差点同士であれば並列に呼び出せる
+     * @param Intersection  対象交差点（URnIntersection）
+     * @param Option        オプション
+     * @param OutPlans      生成するトラックの入口/出口
+     */
+    void PlanTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, TArray<FTrackPlan>& OutPlans) const;
+
+    /**
+     * PlanTracksの結果からトラックを生成して交差点に設定する. ゲームスレッドから呼び出す
+     */
+    void ApplyTracks(URnIntersection* Intersection, const FBuildTrackOption& Option, const TArray<FTrackPlan>& Plans);
+
+    /**
+     * 複数の交差点のトラックを再生成する. 互いに影響しない交差点同士のPlanTracksは並列に実行する
+     * @param Intersections 対象交差点. 重複は除かれる
+     * @param Option        オプション
+     * @param bParallel     falseの場合はすべてゲームスレッドで実行する
+     * @return 並列実行の単位となった交差点グループ数
+     */
+    int32 BuildTracks(const TArray<URnIntersection*>& Intersections, const FBuildTrackOption& Option, bool bParallel = true);
+
+    /**
+     * 同時にトラックを計算できる交差点ごとにグループ分けする.
+     * 隣接する交差点同士や同じ道路に接続する交差点同士は境界線を共有するため、別のグループになる
+     */
+    static TArray<TArray<URnIntersection*>> GroupIndependentIntersections(const TArray<URnIntersection*>& Intersections);
+
     /**
      * from/to をつなぐトラックを生成する
      */
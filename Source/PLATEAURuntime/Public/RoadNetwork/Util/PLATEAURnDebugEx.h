@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "DrawDebugHelpers.h"
+#include "Components/LineBatchComponent.h"
 #include "PLATEAURnDebugEx.generated.h"
 
 USTRUCT()
@@ -16,9 +17,34 @@ struct PLATEAURUNTIME_API FPLATEAURnDrawOption
     FLinearColor Color = FLinearColor::White;
 };
 
+/**
+ * @brief FPLATEAURnDebugExの描画内容を即時描画せずに記録するバッファ
+ */
+struct PLATEAURUNTIME_API FPLATEAURnDebugDrawBuffer
+{
+    struct FLabel
+    {
+        FString Text;
+        FVector Location;
+        FLinearColor Color;
+        float FontScale;
+        // 表示条件のビットマスク. 0の場合は常に表示する
+        int32 Mask;
+    };
+
+    TArray<FBatchedLine> Lines;
+    TArray<FLabel> Labels;
+};
+
 struct PLATEAURUNTIME_API FPLATEAURnDebugEx
 {
 public:
+    /**
+     * @brief 以降の描画をBufferへ記録します. nullptrを指定すると即時描画に戻ります. ゲームスレッドからのみ呼び出してください
+     */
+    static void SetCaptureBuffer(FPLATEAURnDebugDrawBuffer* Buffer);
+    static FPLATEAURnDebugDrawBuffer* GetCaptureBuffer();
+
     static FVector ToVec3(const FVector2D& Self, bool bShowXZ);
     static FLinearColor GetDebugColor(int32 I, int32 Num = 8, float A = 1.0f);
     static void DrawLine(const FVector& Start, const FVector& End, const FLinearColor& Color = FLinearColor::White, float Duration = 0.0f, float Thickness = 0.0f);
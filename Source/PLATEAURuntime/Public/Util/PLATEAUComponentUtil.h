@@ -12,6 +12,17 @@ public:
     // ユニーク化後は{元の名前}__{数値}
     static FString MakeUniqueGmlObjectName(AActor* Actor, UClass* Class, const FString& BaseName);
 
+    /**
+     * @brief 同一形状のメッシュを共有するComponentに付与されるタグです。
+     * メッシュの頂点はComponentの相対位置を原点とするローカル座標になります。
+     */
+    static const FName SharedMeshComponentTag;
+
+    /**
+     * @brief メッシュの頂点座標をモデルの座標に変換するためのオフセットを取得します。メッシュを共有していない場合はゼロを返します。
+     */
+    static FVector GetSharedMeshOffset(const UStaticMeshComponent* InComponent);
+
     /**
      * @brief Componentのユニーク化されていない元の名前を取得します。
      * コンポーネント名の末尾に"__{数値}"が存在する場合、ユニーク化の際に追加されたものとみなし、"__"以降を削除します。
@@ -24,6 +24,18 @@ public:
      */
     static void SaveHeightmapImage(EPLATEAULandscapeHeightmapImageOutput OutputParam, FString FileName, int32 Width, int32 Height, uint16_t* Data);
 
+    /**
+     * @brief 16bitグレイスケールの画像をバックグラウンドで保存します。
+     * PNG, RAWはそれぞれ別タスクで書き出され、未完了の書き出し数が上限に達している場合は空きができるまで待機します。
+     * Dataは書き出し完了まで保持されるため、呼び出し後に内容を変更しないでください。
+     */
+    static void SaveHeightmapImageAsync(EPLATEAULandscapeHeightmapImageOutput OutputParam, const FString& FileName, int32 Width, int32 Height, const TSharedPtr<const std::vector<uint16_t>>& Data);
+
+    /**
+     * @brief SaveHeightmapImageAsyncで開始した書き出しが全て完了するまで待機します
+     */
+    static void FlushHeightmapImages();
+
     /**
      * @brief EPLATEAUMeshGranularityをplateau::polygonMesh::MeshGranularityに変換します
      */
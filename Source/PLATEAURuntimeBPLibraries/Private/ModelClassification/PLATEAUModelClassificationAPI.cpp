@@ -3,6 +3,7 @@
 
 #include "ModelClassification/PLATEAUModelClassificationAPI.h"
 #include "CityGML/PLATEAUCityObject.h"
+#include "CityGML/PLATEAUAttributeQuery.h"
 #include "Component/PLATEAUCityObjectGroup.h"
 #include "PLATEAURuntime/Public/PLATEAUInstancedCityModel.h"
 #include "Algo/Sort.h"
@@ -59,22 +60,15 @@ namespace {
         return UniqueKeys;
     }
 
-    TSet<FString> GetAllAttrStringValuesByKeyInComponent(USceneComponent* Component, FString Key) {
+    TSet<FString> GetAllAttrStringValuesByKeyInComponent(USceneComponent* Component, const FPLATEAUAttributeQuery& Query) {
         TSet<FString> Values;
         if (Component->IsA(UPLATEAUCityObjectGroup::StaticClass()) && Component->IsVisible()) {
             auto CompCityObj = StaticCast<UPLATEAUCityObjectGroup*>(Component);
-            for (const auto CityObj : CompCityObj->GetAllRootCityObjects()) {
-                const auto& Attrs = UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey(Key, CityObj.Attributes);
-                for (const auto Attr : Attrs) {
-                    Values.Add(Attr.StringValue);
-                }
-
-                for (const auto Child : CityObj.Children) {
-                    const auto& ChildAttrs = UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey(Key, Child.Attributes);
-                    for (const auto Attr : ChildAttrs) {
-                        Values.Add(Attr.StringValue);
-                    }
-                }
+            TArray<const FPLATEAUAttributeValue*> Attrs;
+            Query.FindInRootAndChildren(CompCityObj->GetAllRootCityObjects(), Attrs);
+            for (const auto Attr : Attrs) {
+                if (Attr != nullptr)
+                    Values.Add(Attr->StringValue);
             }
         }
         return Values;
@@ -99,20 +93,19 @@ TSet<FString> UPLATEAUModelClassificationAPI::SearchAttributeKeys(const TArray<U
 
 TSet<FString> UPLATEAUModelClassificationAPI::SearchAttributeStringValuesFromKey(const TArray<USceneComponent*> TargetComponents, FString Key) {
 
-    TArray<FString> Keys;
-    Key.ParseIntoArray(Keys, TEXT("/"));
+    const FPLATEAUAttributeQuery Query(Key);
 
     TSet<FString> StringValues;
     for (const auto comp : TargetComponents) {
         if (comp->IsA(UActorComponent::StaticClass()) || comp->IsA(UStaticMeshComponent::StaticClass()) && comp->IsVisible()) {
             if (comp->IsA(UPLATEAUCityObjectGroup::StaticClass()) && comp->IsVisible()) {
-                StringValues.Append(GetAllAttrStringValuesByKeyInComponent(comp, Key));
+                StringValues.Append(GetAllAttrStringValuesByKeyInComponent(comp, Query));
             }
 
             TArray<USceneComponent*> children;
             comp->GetChildrenComponents(true, children);
             for (const auto child : children) {
-                StringValues.Append(GetAllAttrStringValuesByKeyInComponent(child, Key));
+                StringValues.Append(GetAllAttrStringValuesByKeyInComponent(child, Query));
             }
         }
     }
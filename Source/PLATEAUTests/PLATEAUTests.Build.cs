@@ -30,6 +30,7 @@ public class PLATEAUTests : ModuleRules {
                 "UnrealEd",
                 "MeshDescription",
                 "StaticMeshDescription",
+                "Json",
             });
 
 		DynamicallyLoadedModuleNames.AddRange(
@@ -0,0 +1,75 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "AttrInfo/PLATEAUAttrInfoOutlineCache.h"
+#include "Tests/AutomationCommon.h"
+
+
+namespace FPLATEAUTest_AttrInfo_OutlineCache_Local {
+    /**
+     * @brief UV4のXに地物インデックスを持つ、1x1の正方形(三角形2つ)を並べたメッシュ情報を作成
+     */
+    FPLATEAUAttrInfoMeshData CreateMeshData(const int32 SquareCount) {
+        FPLATEAUAttrInfoMeshData MeshData;
+        for (int32 i = 0; i < SquareCount; ++i) {
+            const double OffsetX = i * 2.0;
+            const double Z = i * 5.0;
+            const int32 BaseIndex = MeshData.VertPositions.Num();
+            MeshData.VertPositions.Append({
+                FVector(OffsetX, 0, Z), FVector(OffsetX + 1, 0, Z), FVector(OffsetX + 1, 1, Z + 1), FVector(OffsetX, 1, Z + 1) });
+            for (int32 j = 0; j < 4; ++j) {
+                MeshData.VertUVs.Emplace(i + 0.5, 0.5);
+                MeshData.PolygonVertices.Emplace(FVertexID(BaseIndex + j), MeshData.VertPositions[BaseIndex + j]);
+                // 重複する頂点
+                MeshData.PolygonVertices.Emplace(FVertexID(BaseIndex + j), MeshData.VertPositions[BaseIndex + j]);
+            }
+            MeshData.IndexBuffer.Append({ BaseIndex, BaseIndex + 1, BaseIndex + 2, BaseIndex, BaseIndex + 2, BaseIndex + 3 });
+        }
+        MeshData.NumTriangles = MeshData.IndexBuffer.Num() / 3;
+        return MeshData;
+    }
+}
+
+/// <summary>
+/// 地物ごとの外形線が内部エッジを含まず、結ばれる順に並んでいること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_AttrInfo_OutlineCache, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.AttrInfo.OutlineCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_AttrInfo_OutlineCache::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_AttrInfo_OutlineCache_Local;
+    InitializeTest("AttrInfo.OutlineCache");
+
+    const auto Cache = FPLATEAUAttrInfoComponentCache::Build(CreateMeshData(2));
+    TestEqual("Outline count", Cache->Outlines.Num(), 2);
+    TestEqual("Perimeter vertices", Cache->PerimeterVertices.Num(), 8);
+    for (int32 i = 1; i < Cache->PerimeterVertices.Num(); ++i) {
+        TestTrue("Perimeter vertices are sorted", Cache->PerimeterVertices[i - 1].VertexID < Cache->PerimeterVertices[i].VertexID);
+    }
+    TestEqual("Mesh MinZ", Cache->MeshBounds.MinZ, 0);
+    TestEqual("Mesh MaxZ", Cache->MeshBounds.MaxZ, 6);
+    TestTrue("Missing outline", Cache->FindOutline(FVector2D(5.5, 0.5)) == nullptr);
+
+    for (int32 i = 0; i < 2; ++i) {
+        const auto Outline = Cache->FindOutline(FVector2D(i + 0.25, 0.75));
+        if (Outline == nullptr) {
+            AddError(FString::Printf(TEXT("Outline %d == nullptr"), i));
+            continue;
+        }
+
+        // 対角線(内部エッジ)は含まない
+        const auto& Edges = Outline->PerimeterEdges;
+        TestEqual("Perimeter edge count", Edges.Num(), 4);
+        for (int32 j = 0; j < Edges.Num(); ++j) {
+            TestEqual("Edges are chained", Edges[j].VertexPos1, Edges[(j + 1) % Edges.Num()].VertexPos0);
+            TestFalse("Diagonal edge", FMath::IsNearlyEqual(FVector::Dist(Edges[j].VertexPos0, Edges[j].VertexPos1), FMath::Sqrt(3.0)));
+        }
+
+        TestEqual("MinZ", Outline->Bounds.MinZ, i * 5);
+        TestEqual("MaxZ", Outline->Bounds.MaxZ, i * 5 + 1);
+        TestTrue("RectLength", FMath::IsNearlyEqual(Outline->Bounds.RectLengthX * Outline->Bounds.RectLengthY, 1.0f, 1e-3f));
+        TestTrue("RectCenter", FVector::Dist2D(Outline->Bounds.RectCenter, FVector(i * 2.0 + 0.5, 0.5, 0)) < 1e-3);
+    }
+
+    FinishTest(true, "");
+    return true;
+}
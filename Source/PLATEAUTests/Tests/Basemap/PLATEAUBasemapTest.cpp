@@ -0,0 +1,112 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "PLATEAUBasemap.h"
+#include "PLATEAURuntime.h"
+#include "Tests/AutomationCommon.h"
+#include <plateau/basemap/vector_tile_downloader.h>
+
+
+namespace FPLATEAUTest_Basemap_TileCache_Local {
+    constexpr int32 TileCount = 4;
+
+    TArray<FPLATEAUTileCoordinate> CreateTileCoordinates(const int32 ColumnOffset, const int32 Count) {
+        TArray<FPLATEAUTileCoordinate> TileCoordinates;
+        for (int32 i = 0; i < Count; ++i) {
+            TileCoordinates.Add({ 1000 + ColumnOffset + i, 2000, 15 });
+        }
+        return TileCoordinates;
+    }
+
+    /**
+     * @brief タイル画像を事前に配置し、ダウンロードせずに読み込めるようにする
+     */
+    bool SeedTiles(const FString& TileDirectory, const TArray<FPLATEAUTileCoordinate>& TileCoordinates) {
+        const FString SourcePath = FPLATEAURuntimeModule::GetContentDir() + TEXT("/round-button.png");
+        for (const auto& TileCoordinate : TileCoordinates) {
+            const FString TexturePath = UTF8_TO_TCHAR(VectorTileDownloader::calcDestinationPath(TileCoordinate.ToNativeData(), TCHAR_TO_UTF8(*TileDirectory), ".png").u8string().c_str());
+            if (IFileManager::Get().Copy(*TexturePath, *SourcePath) != COPY_OK)
+                return false;
+        }
+        return true;
+    }
+
+    bool IsLoading(const FPLATEAUBasemap& Basemap, const TArray<FPLATEAUTileCoordinate>& TileCoordinates) {
+        for (const auto& TileCoordinate : TileCoordinates) {
+            if (Basemap.GetTileLoadPhase(TileCoordinate) == EVectorTileLoadingPhase::Loading)
+                return true;
+        }
+        return false;
+    }
+}
+
+/// <summary>
+/// 事前に配置したタイル画像を読み込み、画面外のタイルが上限を超えた分から破棄されること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Basemap_TileCache, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Basemap.TileCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_Basemap_TileCache::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_Basemap_TileCache_Local;
+    InitializeTest("Basemap.TileCache");
+
+    FPLATEAUBasemapSettings Settings;
+    Settings.TileDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir() / TEXT("PLATEAUTest/Basemap"));
+    Settings.MaxConcurrentLoads = 2;
+    Settings.MaxCachedTiles = TileCount;
+    Settings.bAllowDownload = false;
+    IFileManager::Get().DeleteDirectory(*Settings.TileDirectory, false, true);
+
+    const auto FirstTiles = CreateTileCoordinates(0, TileCount);
+    const auto SecondTiles = CreateTileCoordinates(TileCount, TileCount);
+    if (!SeedTiles(Settings.TileDirectory, FirstTiles) || !SeedTiles(Settings.TileDirectory, SecondTiles)) {
+        AddError("Failed to seed tiles");
+        return false;
+    }
+
+    const auto Basemap = MakeShared<FPLATEAUBasemap>(FPLATEAUGeoReference(), nullptr, Settings);
+    Basemap->UpdateTiles(FirstTiles, 0);
+    TestEqual("Loading tiles", Basemap->GetNumCachedTiles(), TileCount);
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Basemap, FirstTiles, SecondTiles] {
+        if (IsLoading(*Basemap, FirstTiles))
+            return false;
+
+        for (const auto& TileCoordinate : FirstTiles) {
+            TestTrue("First tiles are loaded", Basemap->GetTileLoadPhase(TileCoordinate) == EVectorTileLoadingPhase::FullyLoaded);
+        }
+
+        // 画面外になったタイルは上限を超えた分だけ破棄される
+        Basemap->UpdateTiles(SecondTiles, 0);
+        TestEqual("Cached tiles are bounded", Basemap->GetNumCachedTiles(), TileCount);
+        for (const auto& TileCoordinate : FirstTiles) {
+            TestTrue("First tiles are evicted", Basemap->GetTileLoadPhase(TileCoordinate) == EVectorTileLoadingPhase::Idle);
+        }
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Basemap, SecondTiles] {
+        if (IsLoading(*Basemap, SecondTiles))
+            return false;
+
+        for (const auto& TileCoordinate : SecondTiles) {
+            TestTrue("Second tiles are loaded", Basemap->GetTileLoadPhase(TileCoordinate) == EVectorTileLoadingPhase::FullyLoaded);
+        }
+
+        // ダウンロードが無効な場合、存在しないタイルは失敗扱い
+        const auto MissingTiles = CreateTileCoordinates(TileCount * 2, 1);
+        auto VisibleTiles = SecondTiles;
+        VisibleTiles.Append(MissingTiles);
+        Basemap->UpdateTiles(VisibleTiles, 0);
+        ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Basemap, MissingTiles] {
+            if (IsLoading(*Basemap, MissingTiles))
+                return false;
+
+            TestTrue("Missing tile", Basemap->GetTileLoadPhase(MissingTiles[0]) == EVectorTileLoadingPhase::Failed);
+            FinishTest(true, "");
+            return true;
+        }));
+        return true;
+    }));
+
+    return true;
+}
@@ -0,0 +1,187 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "FileHelpers.h"
+#include "../PLATEAUAutomationTestBase.h"
+#include "PLATEAUBenchmarkUtil.h"
+#include "PLATEAUCityModelLoader.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "PLATEAUExportSettings.h"
+#include "Export/PLATEAUExportModelAPI.h"
+#include "RoadNetwork/Factory/RoadNetworkFactory.h"
+#include "RoadNetwork/Structure/PLATEAURnStructureModel.h"
+#include "Util/PLATEAUComponentUtil.h"
+#include "Kismet/GameplayStatics.h"
+#include "Tests/AutomationCommon.h"
+
+
+namespace FPLATEAUTest_Benchmark_Pipeline_Local {
+    // ベースラインに対してこの倍率を超えて遅くなった段階を警告します
+    constexpr double RegressionThreshold = 1.5;
+
+    struct FState {
+        PLATEAUBenchmarkUtil::FBenchmarkReport Report{ TEXT("Pipeline") };
+        APLATEAUCityModelLoader* Loader = nullptr;
+        APLATEAUInstancedCityModel* ModelActor = nullptr;
+    };
+
+    TMap<int64, FPackageInfoSettings> CreatePackageInfoSettings() {
+        TMap<int64, FPackageInfoSettings> PackageInfoSettingsData;
+        for (const auto Package : { plateau::dataset::PredefinedCityModelPackage::Building, plateau::dataset::PredefinedCityModelPackage::Road }) {
+            const auto DefaultMat = UPLATEAUImportAreaSelectBtn::GetDefaultFallbackMaterial(static_cast<int64>(Package));
+            const FPackageInfoSettings PackageInfoSettings(true, true, true, true, EPLATEAUTexturePackingResolution::H4096W4096, 0, 4, 1, DefaultMat, false, "", 7);
+            PackageInfoSettingsData.Add(static_cast<int64>(Package), PackageInfoSettings);
+        }
+        return PackageInfoSettingsData;
+    }
+}
+
+/// <summary>
+/// 合成データセットに対する インポート => 分割 => エクスポート => 道路ネットワーク生成 の計測
+/// -nullrhi での実行を想定しています。結果は Saved/PLATEAUBenchmark/Pipeline.json に出力されます。
+/// -PLATEAUBenchmarkScale=N で規模を、-PLATEAUBenchmarkBaseline=<json> で比較対象のレポートを指定できます。
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Benchmark_Pipeline, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Benchmark.Pipeline", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_Benchmark_Pipeline::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_Benchmark_Pipeline_Local;
+    InitializeTest("Benchmark.Pipeline");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    if (!FParse::Param(FCommandLine::Get(), TEXT("nullrhi")))
+        AddWarning("Benchmark is not running with -nullrhi; results are not comparable with headless runs.");
+
+    const auto State = MakeShared<FState>();
+    const auto Settings = PLATEAUBenchmarkUtil::FSyntheticDatasetSettings::FromCommandLine();
+    State->Report.SetSetting(TEXT("RoadGridCount"), Settings.RoadGridCount);
+    State->Report.SetSetting(TEXT("BuildingCount"), Settings.GetBuildingCount());
+    State->Report.SetSetting(TEXT("TextureCount"), Settings.TextureCount);
+    State->Report.SetSetting(TEXT("TextureSize"), Settings.TextureSize);
+
+    const FString DatasetDir = FPaths::ProjectIntermediateDir() / TEXT("PLATEAUBenchmark/Dataset");
+    State->Report.BeginStage(TEXT("GenerateDataset"));
+    if (!PLATEAUBenchmarkUtil::CreateSyntheticDataset(DatasetDir, Settings)) {
+        AddError("Failed to CreateSyntheticDataset");
+        return false;
+    }
+    State->Report.EndStage({ { TEXT("Buildings"), Settings.GetBuildingCount() } });
+
+    constexpr int ZoneId = 9;
+    const FVector ReferencePoint = FVector(-472281.96875, 5131018, 0);
+    constexpr int64 PackageMask = static_cast<int64>(plateau::dataset::PredefinedCityModelPackage::Building) | static_cast<int64>(plateau::dataset::PredefinedCityModelPackage::Road);
+    State->Loader = GetLocalCityModelLoader(ZoneId, ReferencePoint, PackageMask, DatasetDir, CreatePackageInfoSettings());
+    if (State->Loader == nullptr) {
+        AddError("Loader is nullptr");
+        return false;
+    }
+
+    // インポート
+    State->Report.BeginStage(TEXT("Load"));
+    State->Loader->LoadAsync(true);
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        if (State->Loader->Phase != ECityModelLoadingPhase::Cancelling && State->Loader->Phase != ECityModelLoadingPhase::Finished)
+            return false;
+
+        TArray<AActor*> CityModelActors;
+        UGameplayStatics::GetAllActorsOfClass(State->Loader->GetWorld(), APLATEAUInstancedCityModel::StaticClass(), CityModelActors);
+        if (CityModelActors.Num() <= 0) {
+            State->Report.EndStage();
+            AddError("CityModelActors.Num() <= 0");
+            return true;
+        }
+        State->ModelActor = Cast<APLATEAUInstancedCityModel>(CityModelActors[0]);
+        State->Report.EndStage(PLATEAUBenchmarkUtil::CountMeshes(*State->ModelActor));
+        return true;
+    }));
+
+    // 主要地物 => 最小地物 分割
+    ADD_LATENT_AUTOMATION_COMMAND(FThreadedAutomationLatentCommand([this, State] {
+        if (State->ModelActor == nullptr)
+            return;
+
+        // 道路ネットワーク生成の入力を変えないよう建物のみ対象にする
+        auto TargetComponents = FPLATEAUComponentUtil::ConvertArrayToSceneComponentArray(
+            State->ModelActor->GetComponentsByClass(UPLATEAUCityObjectGroup::StaticClass()));
+        TargetComponents.RemoveAll([](const USceneComponent* Component) {
+            return !Component->GetName().StartsWith(TEXT("bldg_"));
+        });
+        State->Report.BeginStage(TEXT("Reconstruct"));
+        auto Task = State->ModelActor->ReconstructModel(TargetComponents, EPLATEAUMeshGranularity::PerAtomicFeatureObject, false);
+        Task.Wait();
+        auto Counts = PLATEAUBenchmarkUtil::CountMeshes(*State->ModelActor);
+        Counts.Add(TEXT("CreatedComponents"), Task.GetResult().Num());
+        State->Report.EndStage(Counts);
+    }));
+
+    // エクスポート
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        if (State->ModelActor == nullptr)
+            return true;
+
+        const FString ExportDir = FPaths::ProjectIntermediateDir() / TEXT("PLATEAUBenchmark/Export");
+        if (FPaths::DirectoryExists(ExportDir))
+            FFileManagerGeneric::Get().DeleteDirectory(*ExportDir, true, true);
+        FFileManagerGeneric::Get().MakeDirectory(*ExportDir, true);
+
+        FPLATEAUMeshExportOptions Options;
+        Options.FileFormat = EMeshFileFormat::FBX;
+        Options.bExportAsBinary = true;
+        Options.bExportHiddenObjects = false;
+        Options.bExportTexture = true;
+        Options.TransformType = EMeshTransformType::Local;
+        Options.CoordinateSystem = ECoordinateSystem::ENU;
+
+        State->Report.BeginStage(TEXT("Export"));
+        UPLATEAUExportModelAPI::ExportModel(State->ModelActor, ExportDir, Options);
+        TArray<FString> ExportedFiles;
+        FFileManagerGeneric::Get().FindFilesRecursive(ExportedFiles, *ExportDir, TEXT("*"), true, false);
+        int64 ExportedBytes = 0;
+        for (const auto& File : ExportedFiles)
+            ExportedBytes += FFileManagerGeneric::Get().FileSize(*File);
+        State->Report.EndStage({ { TEXT("Files"), ExportedFiles.Num() }, { TEXT("Bytes"), ExportedBytes } });
+        return true;
+    }));
+
+    // 道路ネットワーク生成
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        if (State->ModelActor == nullptr)
+            return true;
+
+        const auto RnActor = State->ModelActor->GetWorld()->SpawnActor<APLATEAURnStructureModel>();
+        State->Report.BeginStage(TEXT("RoadNetwork"));
+        FRoadNetworkFactoryEx::CreateRnModel(RnActor->Factory, State->ModelActor, RnActor);
+        TMap<FString, int64> Counts;
+        if (RnActor->Model != nullptr) {
+            Counts.Add(TEXT("Roads"), RnActor->Model->GetRoads().Num());
+            Counts.Add(TEXT("Intersections"), RnActor->Model->GetIntersections().Num());
+        }
+        State->Report.EndStage(Counts);
+        TestTrue("RoadNetwork is created", RnActor->Model != nullptr);
+        return true;
+    }));
+
+    // レポート出力
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        for (const auto& Stage : State->Report.GetStages()) {
+            AddInfo(FString::Printf(TEXT("%s: %.3f s, peak %.1f MB"), *Stage.Name, Stage.Seconds, Stage.PeakUsedPhysical / (1024.0 * 1024.0)));
+        }
+
+        FString ReportPath;
+        if (!State->Report.Save(ReportPath)) {
+            FinishTest(false, "Failed to save report");
+            return true;
+        }
+        AddInfo(FString::Printf(TEXT("Report: %s"), *ReportPath));
+
+        TArray<FString> Regressions;
+        if (State->Report.CompareWithBaseline(RegressionThreshold, Regressions)) {
+            for (const auto& Regression : Regressions)
+                AddWarning(FString::Printf(TEXT("Regression %s"), *Regression));
+        }
+
+        FinishTest(State->ModelActor != nullptr, "ModelActor == nullptr");
+        return true;
+    }));
+
+    return true;
+}
@@ -0,0 +1,442 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+#include "HAL/FileManagerGeneric.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/Thread.h"
+#include "Misc/FileHelper.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "ImageUtils.h"
+#include "UObject/UObjectArray.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+
+//ベンチマーク用共通処理
+namespace PLATEAUBenchmarkUtil {
+
+    /**
+     * @brief 合成CityGMLデータセットの規模
+     * 道路は RoadGridCount x RoadGridCount の街区を囲む格子状に生成し、各街区に BuildingsPerBlockSide x BuildingsPerBlockSide の建物を配置します。
+     */
+    struct FSyntheticDatasetSettings {
+        int32 RoadGridCount = 4;
+        int32 BuildingsPerBlockSide = 4;
+        int32 TextureCount = 8;
+        int32 TextureSize = 256;
+        // データセット全体の一辺(m)
+        double AreaSize = 800.0;
+        double RoadWidth = 12.0;
+        int32 RandomSeed = 0;
+
+        int32 GetBuildingCount() const {
+            return FMath::Square(RoadGridCount * BuildingsPerBlockSide);
+        }
+
+        /**
+         * @brief コマンドライン引数 -PLATEAUBenchmarkScale=N で規模を変更します
+         */
+        static FSyntheticDatasetSettings FromCommandLine() {
+            FSyntheticDatasetSettings Settings;
+            int32 Scale = 1;
+            if (FParse::Value(FCommandLine::Get(), TEXT("PLATEAUBenchmarkScale="), Scale) && 1 < Scale) {
+                Settings.RoadGridCount *= Scale;
+            }
+            return Settings;
+        }
+    };
+
+    namespace Detail {
+        // 3次メッシュ 53392642 の範囲内に収まる原点
+        constexpr double OriginLatitude = 35.5340;
+        constexpr double OriginLongitude = 139.7760;
+        constexpr double MetersPerDegreeLatitude = 110946.0;
+        constexpr double MetersPerDegreeLongitude = 90600.0;
+        constexpr double GroundHeight = 3.0;
+
+        const TCHAR* CityModelHeader = TEXT(
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<core:CityModel xmlns:core=\"http://www.opengis.net/citygml/2.0\" xmlns:gml=\"http://www.opengis.net/gml\" "
+            "xmlns:bldg=\"http://www.opengis.net/citygml/building/2.0\" xmlns:tran=\"http://www.opengis.net/citygml/transportation/2.0\" "
+            "xmlns:app=\"http://www.opengis.net/citygml/appearance/2.0\" xmlns:gen=\"http://www.opengis.net/citygml/generics/2.0\" "
+            "xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n");
+
+        FString ToPos(const FVector& Position) {
+            return FString::Printf(TEXT("%.9f %.9f %.3f"),
+                OriginLatitude + Position.Y / MetersPerDegreeLatitude,
+                OriginLongitude + Position.X / MetersPerDegreeLongitude,
+                Position.Z);
+        }
+
+        void AppendEnvelope(FString& Out, const FSyntheticDatasetSettings& Settings, const double MaxHeight) {
+            Out += TEXT("<gml:boundedBy><gml:Envelope srsName=\"http://www.opengis.net/def/crs/EPSG/0/6697\" srsDimension=\"3\">");
+            Out += TEXT("<gml:lowerCorner>") + ToPos(FVector(0, 0, 0)) + TEXT("</gml:lowerCorner>");
+            Out += TEXT("<gml:upperCorner>") + ToPos(FVector(Settings.AreaSize, Settings.AreaSize, MaxHeight)) + TEXT("</gml:upperCorner>");
+            Out += TEXT("</gml:Envelope></gml:boundedBy>\n");
+        }
+
+        void AppendPolygon(FString& Out, const FString& PolygonId, const TArray<FVector>& Ring) {
+            Out += FString::Printf(TEXT("<gml:surfaceMember><gml:Polygon gml:id=\"%s\"><gml:exterior><gml:LinearRing gml:id=\"%s_ring\"><gml:posList>"), *PolygonId, *PolygonId);
+            for (const auto& Position : Ring) {
+                Out += ToPos(Position) + TEXT(" ");
+            }
+            Out += ToPos(Ring[0]);
+            Out += TEXT("</gml:posList></gml:LinearRing></gml:exterior></gml:Polygon></gml:surfaceMember>\n");
+        }
+
+        /**
+         * @brief ParameterizedTextureのtarget要素を追加します。UVは四角形の四隅です。
+         */
+        void AppendTextureTarget(FString& Out, const FString& PolygonId) {
+            Out += FString::Printf(TEXT("<app:target uri=\"#%s\"><app:TexCoordList><app:textureCoordinates ring=\"#%s_ring\">0 0 1 0 1 1 0 1 0 0</app:textureCoordinates></app:TexCoordList></app:target>\n"), *PolygonId, *PolygonId);
+        }
+
+        bool SaveTexture(const FString& Path, const int32 Size, const int32 Seed) {
+            FRandomStream Random(Seed);
+            const FColor Base(Random.RandRange(64, 255), Random.RandRange(64, 255), Random.RandRange(64, 255));
+            TArray<FColor> Pixels;
+            Pixels.SetNumUninitialized(Size * Size);
+            for (int32 Y = 0; Y < Size; ++Y) {
+                for (int32 X = 0; X < Size; ++X) {
+                    // 窓を模した格子模様
+                    const bool bWindow = (X / 16 + Y / 16) % 2 == 0;
+                    Pixels[Y * Size + X] = bWindow ? Base : FColor(Base.R / 2, Base.G / 2, Base.B / 2);
+                }
+            }
+            TArray64<uint8> Png;
+            FImageUtils::PNGCompressImageArray(Size, Size, Pixels, Png);
+            return FFileHelper::SaveArrayToFile(Png, *Path);
+        }
+
+        FString CreateBuildingGml(const FSyntheticDatasetSettings& Settings, const FString& AppearanceDirName) {
+            FRandomStream Random(Settings.RandomSeed);
+            const double BlockSize = Settings.AreaSize / Settings.RoadGridCount;
+            const double Margin = Settings.RoadWidth * 0.5 + 4.0;
+            const double CellSize = (BlockSize - Margin * 2) / Settings.BuildingsPerBlockSide;
+
+            FString Members;
+            // テクスチャ毎のtarget要素
+            TArray<FString> TextureTargets;
+            TextureTargets.SetNum(Settings.TextureCount);
+            double MaxHeight = GroundHeight;
+
+            int32 BuildingIndex = 0;
+            for (int32 BlockY = 0; BlockY < Settings.RoadGridCount; ++BlockY) {
+                for (int32 BlockX = 0; BlockX < Settings.RoadGridCount; ++BlockX) {
+                    for (int32 CellY = 0; CellY < Settings.BuildingsPerBlockSide; ++CellY) {
+                        for (int32 CellX = 0; CellX < Settings.BuildingsPerBlockSide; ++CellX, ++BuildingIndex) {
+                            const double X0 = BlockX * BlockSize + Margin + CellX * CellSize + CellSize * 0.2;
+                            const double Y0 = BlockY * BlockSize + Margin + CellY * CellSize + CellSize * 0.2;
+                            const double X1 = X0 + CellSize * 0.6;
+                            const double Y1 = Y0 + CellSize * 0.6;
+                            const double Z0 = GroundHeight;
+                            const double Z1 = GroundHeight + Random.FRandRange(6.0, 60.0);
+                            MaxHeight = FMath::Max(MaxHeight, Z1);
+
+                            const FVector Bottom[4] = { FVector(X0, Y0, Z0), FVector(X1, Y0, Z0), FVector(X1, Y1, Z0), FVector(X0, Y1, Z0) };
+                            const FVector Top[4] = { FVector(X0, Y0, Z1), FVector(X1, Y0, Z1), FVector(X1, Y1, Z1), FVector(X0, Y1, Z1) };
+                            const FString Id = FString::Printf(TEXT("bldg_%08d"), BuildingIndex);
+
+                            Members += FString::Printf(TEXT("<core:cityObjectMember><bldg:Building gml:id=\"%s\">\n"), *Id);
+                            Members += FString::Printf(TEXT("<gen:stringAttribute name=\"建物ID\"><gen:value>13111-bldg-%d</gen:value></gen:stringAttribute>\n"), BuildingIndex);
+                            Members += FString::Printf(TEXT("<bldg:measuredHeight uom=\"m\">%.1f</bldg:measuredHeight>\n"), Z1 - Z0);
+
+                            // LOD1
+                            Members += TEXT("<bldg:lod1Solid><gml:Solid><gml:exterior><gml:CompositeSurface>\n");
+                            AppendPolygon(Members, Id + TEXT("_lod1_bottom"), { Bottom[0], Bottom[3], Bottom[2], Bottom[1] });
+                            AppendPolygon(Members, Id + TEXT("_lod1_top"), { Top[0], Top[1], Top[2], Top[3] });
+                            for (int32 i = 0; i < 4; ++i) {
+                                const int32 j = (i + 1) % 4;
+                                AppendPolygon(Members, FString::Printf(TEXT("%s_lod1_wall%d"), *Id, i), { Bottom[i], Bottom[j], Top[j], Top[i] });
+                            }
+                            Members += TEXT("</gml:CompositeSurface></gml:exterior></gml:Solid></bldg:lod1Solid>\n");
+
+                            // LOD2 (テクスチャ付きの境界面)
+                            const int32 TextureIndex = BuildingIndex % Settings.TextureCount;
+                            for (int32 i = 0; i < 4; ++i) {
+                                const int32 j = (i + 1) % 4;
+                                const FString PolygonId = FString::Printf(TEXT("%s_wall%d"), *Id, i);
+                                Members += FString::Printf(TEXT("<bldg:boundedBy><bldg:WallSurface gml:id=\"%s_ws%d\"><bldg:lod2MultiSurface><gml:MultiSurface>\n"), *Id, i);
+                                AppendPolygon(Members, PolygonId, { Bottom[i], Bottom[j], Top[j], Top[i] });
+                                Members += TEXT("</gml:MultiSurface></bldg:lod2MultiSurface></bldg:WallSurface></bldg:boundedBy>\n");
+                                AppendTextureTarget(TextureTargets[TextureIndex], PolygonId);
+                            }
+                            const FString RoofId = Id + TEXT("_roof");
+                            Members += FString::Printf(TEXT("<bldg:boundedBy><bldg:RoofSurface gml:id=\"%s_rs\"><bldg:lod2MultiSurface><gml:MultiSurface>\n"), *Id);
+                            AppendPolygon(Members, RoofId, { Top[0], Top[1], Top[2], Top[3] });
+                            Members += TEXT("</gml:MultiSurface></bldg:lod2MultiSurface></bldg:RoofSurface></bldg:boundedBy>\n");
+                            AppendTextureTarget(TextureTargets[TextureIndex], RoofId);
+                            Members += FString::Printf(TEXT("<bldg:boundedBy><bldg:GroundSurface gml:id=\"%s_gs\"><bldg:lod2MultiSurface><gml:MultiSurface>\n"), *Id);
+                            AppendPolygon(Members, Id + TEXT("_ground"), { Bottom[0], Bottom[3], Bottom[2], Bottom[1] });
+                            Members += TEXT("</gml:MultiSurface></bldg:lod2MultiSurface></bldg:GroundSurface></bldg:boundedBy>\n");
+
+                            Members += TEXT("</bldg:Building></core:cityObjectMember>\n");
+                        }
+                    }
+                }
+            }
+
+            FString Gml = CityModelHeader;
+            AppendEnvelope(Gml, Settings, MaxHeight);
+            Gml += Members;
+            Gml += TEXT("<app:appearanceMember><app:Appearance><app:theme>rgbTexture</app:theme>\n");
+            for (int32 i = 0; i < Settings.TextureCount; ++i) {
+                Gml += FString::Printf(TEXT("<app:surfaceDataMember><app:ParameterizedTexture><app:imageURI>%s/tex_%d.png</app:imageURI><app:mimeType>image/png</app:mimeType>\n"), *AppearanceDirName, i);
+                Gml += TextureTargets[i];
+                Gml += TEXT("</app:ParameterizedTexture></app:surfaceDataMember>\n");
+            }
+            Gml += TEXT("</app:Appearance></app:appearanceMember>\n");
+            Gml += TEXT("</core:CityModel>\n");
+            return Gml;
+        }
+
+        FString CreateRoadGml(const FSyntheticDatasetSettings& Settings) {
+            const double BlockSize = Settings.AreaSize / Settings.RoadGridCount;
+            const double HalfWidth = Settings.RoadWidth * 0.5;
+            FString Members;
+            int32 RoadIndex = 0;
+
+            const auto AppendRoad = [&](const double X0, const double Y0, const double X1, const double Y1) {
+                const FString Id = FString::Printf(TEXT("tran_%08d"), RoadIndex++);
+                Members += FString::Printf(TEXT("<core:cityObjectMember><tran:Road gml:id=\"%s\"><tran:lod1MultiSurface><gml:MultiSurface>\n"), *Id);
+                AppendPolygon(Members, Id + TEXT("_poly"), {
+                    FVector(X0, Y0, GroundHeight), FVector(X1, Y0, GroundHeight), FVector(X1, Y1, GroundHeight), FVector(X0, Y1, GroundHeight) });
+                Members += TEXT("</gml:MultiSurface></tran:lod1MultiSurface></tran:Road></core:cityObjectMember>\n");
+            };
+
+            // 交差点と交差点間の道路は辺を共有させる
+            for (int32 Y = 0; Y <= Settings.RoadGridCount; ++Y) {
+                for (int32 X = 0; X <= Settings.RoadGridCount; ++X) {
+                    const double CX = X * BlockSize;
+                    const double CY = Y * BlockSize;
+                    AppendRoad(CX - HalfWidth, CY - HalfWidth, CX + HalfWidth, CY + HalfWidth);
+                    if (X < Settings.RoadGridCount)
+                        AppendRoad(CX + HalfWidth, CY - HalfWidth, CX + BlockSize - HalfWidth, CY + HalfWidth);
+                    if (Y < Settings.RoadGridCount)
+                        AppendRoad(CX - HalfWidth, CY + HalfWidth, CX + HalfWidth, CY + BlockSize - HalfWidth);
+                }
+            }
+
+            FString Gml = CityModelHeader;
+            AppendEnvelope(Gml, Settings, GroundHeight);
+            Gml += Members;
+            Gml += TEXT("</core:CityModel>\n");
+            return Gml;
+        }
+    }
+
+    /**
+     * @brief RootDir以下にudx/bldg, udx/tranの合成データセットを生成します。メッシュコードは53392642固定です。
+     */
+    bool CreateSyntheticDataset(const FString& RootDir, const FSyntheticDatasetSettings& Settings) {
+        auto& FileManager = FFileManagerGeneric::Get();
+        if (FPaths::DirectoryExists(RootDir) && !FileManager.DeleteDirectory(*RootDir, true, true))
+            return false;
+
+        const FString BldgDir = RootDir / TEXT("udx/bldg");
+        const FString AppearanceDirName = TEXT("53392642_bldg_6697_appearance");
+        const FString TranDir = RootDir / TEXT("udx/tran");
+        if (!FileManager.MakeDirectory(*(BldgDir / AppearanceDirName), true) || !FileManager.MakeDirectory(*TranDir, true))
+            return false;
+
+        for (int32 i = 0; i < Settings.TextureCount; ++i) {
+            if (!Detail::SaveTexture(BldgDir / AppearanceDirName / FString::Printf(TEXT("tex_%d.png"), i), Settings.TextureSize, Settings.RandomSeed + i))
+                return false;
+        }
+
+        return FFileHelper::SaveStringToFile(Detail::CreateBuildingGml(Settings, AppearanceDirName), *(BldgDir / TEXT("53392642_bldg_6697_op.gml")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)
+            && FFileHelper::SaveStringToFile(Detail::CreateRoadGml(Settings), *(TranDir / TEXT("53392642_tran_6697_op.gml")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+    }
+
+    /**
+     * @brief 計測中の物理メモリ使用量の最大値を別スレッドでサンプリングします
+     */
+    class FMemorySampler {
+    public:
+        FMemorySampler() {
+            PeakUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+            Thread = MakeUnique<FThread>(TEXT("PLATEAUBenchmarkMemorySampler"), [this] {
+                while (!bStop) {
+                    const uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+                    uint64 Current = PeakUsedPhysical;
+                    while (Current < UsedPhysical && !PeakUsedPhysical.compare_exchange_weak(Current, UsedPhysical)) {}
+                    FPlatformProcess::Sleep(0.005f);
+                }
+            });
+        }
+
+        ~FMemorySampler() {
+            Stop();
+        }
+
+        uint64 Stop() {
+            if (Thread.IsValid()) {
+                bStop = true;
+                Thread->Join();
+                Thread.Reset();
+            }
+            return PeakUsedPhysical;
+        }
+
+    private:
+        TUniquePtr<FThread> Thread;
+        std::atomic<bool> bStop = false;
+        std::atomic<uint64> PeakUsedPhysical = 0;
+    };
+
+    /**
+     * @brief 段階毎の計測結果をまとめ、JSONとして出力します
+     */
+    class FBenchmarkReport {
+    public:
+        struct FStage {
+            FString Name;
+            double Seconds = 0;
+            uint64 PeakUsedPhysical = 0;
+            int64 UsedPhysicalDelta = 0;
+            TMap<FString, int64> Counts;
+        };
+
+        explicit FBenchmarkReport(const FString& InName)
+            : Name(InName) {
+        }
+
+        void SetSetting(const FString& Key, const int64 Value) {
+            Settings.Add(Key, Value);
+        }
+
+        void BeginStage(const FString& StageName) {
+            check(!Sampler.IsValid());
+            Stages.AddDefaulted_GetRef().Name = StageName;
+            StageUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+            Sampler = MakeUnique<FMemorySampler>();
+            StageStart = FPlatformTime::Seconds();
+        }
+
+        FStage& EndStage(const TMap<FString, int64>& Counts = {}) {
+            check(Sampler.IsValid());
+            auto& Stage = Stages.Last();
+            Stage.Seconds = FPlatformTime::Seconds() - StageStart;
+            Stage.PeakUsedPhysical = Sampler->Stop();
+            Stage.UsedPhysicalDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(StageUsedPhysical);
+            Stage.Counts = Counts;
+            Stage.Counts.Add(TEXT("UObjects"), GUObjectArray.GetObjectArrayNumMinusAvailable());
+            Sampler.Reset();
+            return Stage;
+        }
+
+        const TArray<FStage>& GetStages() const {
+            return Stages;
+        }
+
+        FString ToJsonString() const {
+            const auto Root = MakeShared<FJsonObject>();
+            Root->SetStringField(TEXT("name"), Name);
+            Root->SetStringField(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+            Root->SetStringField(TEXT("platform"), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+            Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+            Root->SetBoolField(TEXT("nullRHI"), FParse::Param(FCommandLine::Get(), TEXT("nullrhi")));
+
+            const auto SettingsObject = MakeShared<FJsonObject>();
+            for (const auto& [Key, Value] : Settings)
+                SettingsObject->SetNumberField(Key, Value);
+            Root->SetObjectField(TEXT("settings"), SettingsObject);
+
+            TArray<TSharedPtr<FJsonValue>> StageValues;
+            for (const auto& Stage : Stages) {
+                const auto StageObject = MakeShared<FJsonObject>();
+                StageObject->SetStringField(TEXT("name"), Stage.Name);
+                StageObject->SetNumberField(TEXT("seconds"), Stage.Seconds);
+                StageObject->SetNumberField(TEXT("peakUsedPhysical"), Stage.PeakUsedPhysical);
+                StageObject->SetNumberField(TEXT("usedPhysicalDelta"), Stage.UsedPhysicalDelta);
+                const auto CountsObject = MakeShared<FJsonObject>();
+                for (const auto& [Key, Value] : Stage.Counts)
+                    CountsObject->SetNumberField(Key, Value);
+                StageObject->SetObjectField(TEXT("counts"), CountsObject);
+                StageValues.Add(MakeShared<FJsonValueObject>(StageObject));
+            }
+            Root->SetArrayField(TEXT("stages"), StageValues);
+
+            FString Json;
+            const auto Writer = TJsonWriterFactory<>::Create(&Json);
+            FJsonSerializer::Serialize(Root, Writer);
+            return Json;
+        }
+
+        /**
+         * @brief -PLATEAUBenchmarkReportDir= で指定されたディレクトリ(既定は Saved/PLATEAUBenchmark)に <Name>.json として保存します
+         */
+        bool Save(FString& OutPath) const {
+            FString ReportDir = FPaths::ProjectSavedDir() / TEXT("PLATEAUBenchmark");
+            FParse::Value(FCommandLine::Get(), TEXT("PLATEAUBenchmarkReportDir="), ReportDir);
+            OutPath = ReportDir / Name + TEXT(".json");
+            return FFileHelper::SaveStringToFile(ToJsonString(), *OutPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+        }
+
+        /**
+         * @brief -PLATEAUBenchmarkBaseline= で指定された以前のレポートと比較し、所要時間が Threshold 倍を超えた段階を返します
+         * @return ベースラインが指定され、読み込めた場合はtrue
+         */
+        bool CompareWithBaseline(const double Threshold, TArray<FString>& OutRegressions) const {
+            FString BaselinePath;
+            if (!FParse::Value(FCommandLine::Get(), TEXT("PLATEAUBenchmarkBaseline="), BaselinePath))
+                return false;
+
+            FString Json;
+            TSharedPtr<FJsonObject> Baseline;
+            if (!FFileHelper::LoadFileToString(Json, *BaselinePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Baseline) || !Baseline.IsValid())
+                return false;
+
+            for (const auto& StageValue : Baseline->GetArrayField(TEXT("stages"))) {
+                const auto& BaselineStage = StageValue->AsObject();
+                const auto StageName = BaselineStage->GetStringField(TEXT("name"));
+                const auto BaselineSeconds = BaselineStage->GetNumberField(TEXT("seconds"));
+                const auto Stage = Stages.FindByPredicate([&StageName](const FStage& Item) {
+                    return Item.Name == StageName;
+                });
+                if (Stage != nullptr && BaselineSeconds * Threshold < Stage->Seconds) {
+                    OutRegressions.Add(FString::Printf(TEXT("%s: %.3f s -> %.3f s"), *StageName, BaselineSeconds, Stage->Seconds));
+                }
+            }
+            return true;
+        }
+
+    private:
+        FString Name;
+        TMap<FString, int64> Settings;
+        TArray<FStage> Stages;
+        TUniquePtr<FMemorySampler> Sampler;
+        uint64 StageUsedPhysical = 0;
+        double StageStart = 0;
+    };
+
+    /**
+     * @brief Actor配下のUPLATEAUCityObjectGroupの数と頂点数・三角形数を集計します
+     */
+    TMap<FString, int64> CountMeshes(const AActor& Actor) {
+        TArray<UPLATEAUCityObjectGroup*> Components;
+        Actor.GetComponents(Components);
+        int64 Vertices = 0;
+        int64 Triangles = 0;
+        for (const auto& Component : Components) {
+            const auto StaticMesh = Component->GetStaticMesh();
+            if (StaticMesh == nullptr || StaticMesh->GetRenderData() == nullptr || StaticMesh->GetRenderData()->LODResources.Num() == 0)
+                continue;
+            const auto& LODResource = StaticMesh->GetRenderData()->LODResources[0];
+            Vertices += LODResource.GetNumVertices();
+            Triangles += LODResource.GetNumTriangles();
+        }
+        TMap<FString, int64> Counts;
+        Counts.Add(TEXT("CityObjectGroups"), Components.Num());
+        Counts.Add(TEXT("Vertices"), Vertices);
+        Counts.Add(TEXT("Triangles"), Triangles);
+        return Counts;
+    }
+}
@@ -0,0 +1,219 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "CityGML/PLATEAUAttributeQuery.h"
+#include "CityGML/PLATEAUCityObject.h"
+#include "Tests/AutomationCommon.h"
+
+
+namespace FPLATEAUTest_CityGML_AttributeQuery_Local {
+    // 変更前の UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey
+    TArray<FPLATEAUAttributeValue> GetAttributesByKeyReference(const FString& Key, const FPLATEAUAttributeMap& AttributeMap) {
+        TArray<FString> Keys;
+        int32 Length = Key.ParseIntoArray(Keys, TEXT("/"), false);
+        FString FirstKey = Length > 0 ? Keys[0] : "";
+        TArray<FPLATEAUAttributeValue> Values;
+        if (AttributeMap.AttributeMap.Contains(FirstKey)) {
+            const auto& attr = AttributeMap.AttributeMap[FirstKey];
+            if (attr.Type != EPLATEAUAttributeType::AttributeSets) {
+                Values.Add(attr);
+            }
+            else {
+                Keys.RemoveSingle(FirstKey);
+                FString NewKey = FString::Join<TArray<FString>>(Keys, TEXT("/"));
+                const auto& ChildAttr = attr.Attributes.Get();
+                return GetAttributesByKeyReference(NewKey, *ChildAttr);
+            }
+        }
+        return Values;
+    }
+
+    FPLATEAUAttributeValue MakeValue(const EPLATEAUAttributeType Type, const FString& Value) {
+        FPLATEAUAttributeValue AttributeValue;
+        AttributeValue.Type = Type;
+        AttributeValue.SetValue(Type, Value);
+        return AttributeValue;
+    }
+
+    FPLATEAUAttributeValue MakeSet(const TMap<FString, FPLATEAUAttributeValue>& Values) {
+        FPLATEAUAttributeValue AttributeValue;
+        AttributeValue.Type = EPLATEAUAttributeType::AttributeSets;
+        AttributeValue.Attributes = MakeShared<FPLATEAUAttributeMap>(Values);
+        return AttributeValue;
+    }
+
+    FPLATEAUAttributeMap CreateAttributeMap(const int32 Seed) {
+        FPLATEAUAttributeMap AttributeMap;
+        AttributeMap.AttributeMap.Add(TEXT("bldg:measuredheight"), MakeValue(EPLATEAUAttributeType::Measure, FString::SanitizeFloat(10.0 + Seed % 50)));
+        AttributeMap.AttributeMap.Add(TEXT("bldg:usage"), MakeValue(EPLATEAUAttributeType::String, FString::Printf(TEXT("usage%d"), Seed % 7)));
+        AttributeMap.AttributeMap.Add(TEXT("bldg:storeysAboveGround"), MakeValue(EPLATEAUAttributeType::Integer, FString::FromInt(Seed % 12)));
+        AttributeMap.AttributeMap.Add(TEXT("uro:buildingDetailAttribute"), MakeSet({
+            { TEXT("uro:surveyYear"), MakeValue(EPLATEAUAttributeType::String, FString::FromInt(2000 + Seed % 20)) },
+            { TEXT("uro:floodingRisk"), MakeSet({
+                { TEXT("uro:rank"), MakeValue(EPLATEAUAttributeType::String, FString::Printf(TEXT("rank%d"), Seed % 3)) },
+                { TEXT(""), MakeValue(EPLATEAUAttributeType::String, TEXT("empty")) }
+            }) }
+        }));
+        return AttributeMap;
+    }
+
+    bool IsSame(const FPLATEAUAttributeValue* Actual, const TArray<FPLATEAUAttributeValue>& Expected) {
+        if (Expected.Num() == 0)
+            return Actual == nullptr;
+        return Actual != nullptr && Expected.Num() == 1 && Actual->Type == Expected[0].Type && Actual->StringValue == Expected[0].StringValue;
+    }
+
+    const TArray<FString> Keys {
+        TEXT("bldg:measuredheight"),
+        TEXT("BLDG:MEASUREDHEIGHT"),
+        TEXT("bldg:usage"),
+        TEXT("bldg:unknown"),
+        TEXT("uro:buildingDetailAttribute"),
+        TEXT("uro:buildingDetailAttribute/uro:surveyYear"),
+        TEXT("uro:buildingDetailAttribute/uro:floodingRisk/uro:rank"),
+        TEXT("uro:buildingDetailAttribute/uro:floodingRisk"),
+        TEXT("uro:buildingDetailAttribute/uro:floodingRisk/"),
+        TEXT("uro:buildingDetailAttribute//uro:rank"),
+        TEXT("bldg:usage/extra"),
+        TEXT("/bldg:usage"),
+        TEXT(""),
+    };
+}
+
+/// <summary>
+/// 解析済みクエリが GetAttributesByKey と同じ値を返すこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityGML_AttributeQuery_Find, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityGML.AttributeQuery.Find", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityGML_AttributeQuery_Find::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_CityGML_AttributeQuery_Local;
+    InitializeTest("CityGML.AttributeQuery.Find");
+
+    for (int32 Seed = 0; Seed < 20; ++Seed) {
+        const auto AttributeMap = CreateAttributeMap(Seed);
+        for (const auto& Key : Keys) {
+            const auto Expected = GetAttributesByKeyReference(Key, AttributeMap);
+            TestTrue(FString::Printf(TEXT("Query [%s]"), *Key), IsSame(FPLATEAUAttributeQuery(Key).Find(AttributeMap), Expected));
+
+            const auto Actual = UPLATEAUAttributeValueBlueprintLibrary::GetAttributesByKey(Key, AttributeMap);
+            TestTrue(FString::Printf(TEXT("GetAttributesByKey [%s]"), *Key), IsSame(Actual.Num() > 0 ? &Actual[0] : nullptr, Expected));
+        }
+    }
+
+    // 地物と子をまとめて取得
+    TArray<FPLATEAUCityObject> CityObjects;
+    for (int32 i = 0; i < 3; ++i) {
+        FPLATEAUCityObject CityObject;
+        CityObject.Attributes = CreateAttributeMap(i);
+        for (int32 j = 0; j < i; ++j) {
+            FPLATEAUCityObject Child;
+            Child.Attributes = CreateAttributeMap(i * 10 + j);
+            CityObject.Children.Add(Child);
+        }
+        CityObjects.Add(CityObject);
+    }
+    const FPLATEAUAttributeQuery Query(TEXT("bldg:usage"));
+    TArray<const FPLATEAUAttributeValue*> Values;
+    Query.FindInRootAndChildren(CityObjects, Values);
+    TestEqual("Batch count", Values.Num(), 6);
+    int32 Index = 0;
+    for (const auto& CityObject : CityObjects) {
+        TestTrue("Batch root", IsSame(Values[Index++], GetAttributesByKeyReference(TEXT("bldg:usage"), CityObject.Attributes)));
+        for (const auto& Child : CityObject.Children)
+            TestTrue("Batch child", IsSame(Values[Index++], GetAttributesByKeyReference(TEXT("bldg:usage"), Child.Attributes)));
+    }
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// 一致・範囲条件の一括評価が個別評価と一致すること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityGML_AttributeQuery_Predicate, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityGML.AttributeQuery.Predicate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityGML_AttributeQuery_Predicate::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_CityGML_AttributeQuery_Local;
+    InitializeTest("CityGML.AttributeQuery.Predicate");
+
+    TArray<FPLATEAUAttributeMap> AttributeMaps;
+    for (int32 Seed = 0; Seed < 200; ++Seed)
+        AttributeMaps.Add(CreateAttributeMap(Seed));
+
+    const auto Check = [&](const FString& Key, const FPLATEAUAttributePredicate& Predicate, const TFunction<bool(const FPLATEAUAttributeValue&)>& Expected) {
+        const FPLATEAUAttributeQuery Query(Key);
+        TArray<const FPLATEAUAttributeValue*> Values;
+        for (const auto& AttributeMap : AttributeMaps)
+            Values.Add(Query.Find(AttributeMap));
+
+        TBitArray<> Results;
+        Predicate.EvaluateBatch(Values, Results);
+        TestEqual("Result count", Results.Num(), Values.Num());
+        int32 MatchCount = 0;
+        for (int32 i = 0; i < Values.Num(); ++i) {
+            const bool bExpected = Values[i] != nullptr && Expected(*Values[i]);
+            TestEqual(FString::Printf(TEXT("Evaluate [%s] %d"), *Key, i), Predicate.Evaluate(Values[i]), bExpected);
+            TestEqual(FString::Printf(TEXT("EvaluateBatch [%s] %d"), *Key, i), static_cast<bool>(Results[i]), bExpected);
+            MatchCount += bExpected ? 1 : 0;
+        }
+        TestTrue(FString::Printf(TEXT("Has match [%s]"), *Key), 0 < MatchCount);
+    };
+
+    Check(TEXT("bldg:usage"), FPLATEAUAttributePredicate::Equal(TEXT("usage3")), [](const FPLATEAUAttributeValue& Value) {
+        return Value.StringValue == TEXT("usage3") && Value.StringValue.Equals(TEXT("usage3"), ESearchCase::CaseSensitive);
+    });
+    Check(TEXT("bldg:measuredheight"), FPLATEAUAttributePredicate::InRange(20.0, 35.5), [](const FPLATEAUAttributeValue& Value) {
+        return 20.0 <= Value.DoubleValue && Value.DoubleValue <= 35.5;
+    });
+    Check(TEXT("bldg:storeysAboveGround"), FPLATEAUAttributePredicate::InRange(3, 5), [](const FPLATEAUAttributeValue& Value) {
+        return 3 <= Value.IntValue && Value.IntValue <= 5;
+    });
+
+    // 文字列型は範囲条件に一致しない
+    TBitArray<> Results;
+    const FPLATEAUAttributeQuery Query(TEXT("bldg:usage"));
+    TArray<const FPLATEAUAttributeValue*> Values { Query.Find(AttributeMaps[0]), nullptr };
+    FPLATEAUAttributePredicate::InRange(-1e300, 1e300).EvaluateBatch(Values, Results);
+    TestFalse("String is not in range", Results[0]);
+    TestFalse("nullptr is not in range", Results[1]);
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// 属性キー検索の計測 (GetAttributesByKey の変更前実装との比較)
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Benchmark_AttributeQuery, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Benchmark.AttributeQuery", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_Benchmark_AttributeQuery::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_CityGML_AttributeQuery_Local;
+    InitializeTest("Benchmark.AttributeQuery");
+
+    constexpr int32 CityObjectCount = 100000;
+    TArray<FPLATEAUAttributeMap> AttributeMaps;
+    AttributeMaps.Reserve(CityObjectCount);
+    for (int32 i = 0; i < CityObjectCount; ++i)
+        AttributeMaps.Add(CreateAttributeMap(i));
+
+    const FString Key = TEXT("uro:buildingDetailAttribute/uro:floodingRisk/uro:rank");
+
+    int32 ReferenceCount = 0;
+    double StartTime = FPlatformTime::Seconds();
+    for (const auto& AttributeMap : AttributeMaps)
+        ReferenceCount += GetAttributesByKeyReference(Key, AttributeMap).Num();
+    const double ReferenceSeconds = FPlatformTime::Seconds() - StartTime;
+
+    int32 QueryCount = 0;
+    StartTime = FPlatformTime::Seconds();
+    const FPLATEAUAttributeQuery Query(Key);
+    for (const auto& AttributeMap : AttributeMaps)
+        QueryCount += Query.Find(AttributeMap) != nullptr ? 1 : 0;
+    const double QuerySeconds = FPlatformTime::Seconds() - StartTime;
+
+    TestEqual("Same result count", QueryCount, ReferenceCount);
+    AddInfo(FString::Printf(TEXT("%d objects: GetAttributesByKey(before) %.3f s, FPLATEAUAttributeQuery %.3f s"), CityObjectCount, ReferenceSeconds, QuerySeconds));
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,77 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "../PLATEAUAutomationTestUtil.h"
+#include "Tests/AutomationCommon.h"
+#include <CityGML/PLATEAUCityGmlProxy.h>
+
+
+/// <summary>
+/// 属性インデックスのキャッシュ
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityGml_ProxyCache, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityGML.ProxyCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityGml_ProxyCache::RunTest(const FString& Parameters) {
+    InitializeTest("CityGML.ProxyCache");
+    UPLATEAUCityGmlProxy::ClearCache();
+
+    FPLATEAUCityObjectInfo GmlInfo;
+    GmlInfo.DatasetName = "data";
+    GmlInfo.GmlName = "53392642_bldg_6697_op2.gml";
+
+    const auto CityModel = UPLATEAUCityGmlProxy::Load(GmlInfo);
+    if (CityModel == nullptr) {
+        AddError("CityModel == nullptr");
+        return false;
+    }
+
+    const auto Index = UPLATEAUCityGmlProxy::LoadIndex(GmlInfo);
+    TestTrue("Index is valid", Index.IsValid());
+    TestTrue("Index is cached", Index == UPLATEAUCityGmlProxy::LoadIndex(GmlInfo));
+    TestTrue("CityModel is reused while referenced", CityModel == UPLATEAUCityGmlProxy::Load(GmlInfo));
+    TestTrue("Cache size", 0 < UPLATEAUCityGmlProxy::GetCacheAllocatedSize());
+
+    const auto& RootCityObject = CityModel->getRootCityObject(0);
+    const auto Entry = Index->Find(UTF8_TO_TCHAR(RootCityObject.getId().c_str()));
+    TestTrue("Entry exists", Entry != nullptr);
+    if (Entry != nullptr) {
+        TestTrue("Entry type", Entry->Type == RootCityObject.getType());
+        TestEqual("Entry attribute size", Entry->Attributes.AttributeMap.Num(), static_cast<int32>(RootCityObject.getAttributes().size()));
+    }
+
+    UPLATEAUCityGmlProxy::ClearCache();
+    TestEqual("Cache cleared", UPLATEAUCityGmlProxy::GetCacheAllocatedSize(), static_cast<int64>(0));
+    TestTrue("Index is rebuilt after clear", Index != UPLATEAUCityGmlProxy::LoadIndex(GmlInfo));
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// CityModelを保持していなくても、キャッシュ済みのインデックスはGMLを再パースせずに返されること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityGml_ProxyCache_IndexWithoutReparse, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityGML.ProxyCache.IndexWithoutReparse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityGml_ProxyCache_IndexWithoutReparse::RunTest(const FString& Parameters) {
+    InitializeTest("CityGML.ProxyCache.IndexWithoutReparse");
+    UPLATEAUCityGmlProxy::ClearCache();
+
+    FPLATEAUCityObjectInfo GmlInfo;
+    GmlInfo.DatasetName = "data";
+    GmlInfo.GmlName = "53392642_bldg_6697_op2.gml";
+
+    const auto ParseCountBefore = UPLATEAUCityGmlProxy::GetParseCount();
+    const auto Index = UPLATEAUCityGmlProxy::LoadIndex(GmlInfo);
+    if (!Index.IsValid()) {
+        AddError("Index == nullptr");
+        return false;
+    }
+    TestEqual("Parsed on first load", UPLATEAUCityGmlProxy::GetParseCount(), ParseCountBefore + 1);
+
+    TestTrue("Index is cached", Index == UPLATEAUCityGmlProxy::LoadIndex(GmlInfo));
+    TestEqual("Not parsed again", UPLATEAUCityGmlProxy::GetParseCount(), ParseCountBefore + 1);
+
+    UPLATEAUCityGmlProxy::ClearCache();
+    FinishTest(true, "");
+    return true;
+}
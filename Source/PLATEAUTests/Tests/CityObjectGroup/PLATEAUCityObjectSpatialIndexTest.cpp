@@ -0,0 +1,110 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "Tests/AutomationCommon.h"
+#include "Component/PLATEAUCityObjectSpatialIndex.h"
+
+
+namespace FPLATEAUTest_CityObjectGroup_SpatialIndex_Local {
+    // 224 x 224 x 2 = 100,352 三角形
+    constexpr int32 GridSize = 224;
+    constexpr float CellSize = 100.0f;
+
+    /**
+     * @brief 起伏のある格子メッシュを生成します。CityObjectIndexは(行, 列)
+     */
+    void CreateGridMesh(TArray<FVector3f>& Positions, TArray<uint32>& Indices, TArray<FPLATEAUCityObjectIndex>& TriangleCityObjectIndices) {
+        for (int32 Y = 0; Y <= GridSize; ++Y) {
+            for (int32 X = 0; X <= GridSize; ++X) {
+                Positions.Add(FVector3f(X * CellSize, Y * CellSize, FMath::Sin(X * 0.1f) * FMath::Cos(Y * 0.1f) * 500.0f));
+            }
+        }
+        for (int32 Y = 0; Y < GridSize; ++Y) {
+            for (int32 X = 0; X < GridSize; ++X) {
+                const uint32 V0 = Y * (GridSize + 1) + X;
+                const uint32 V1 = V0 + 1;
+                const uint32 V2 = V0 + GridSize + 1;
+                const uint32 V3 = V2 + 1;
+                Indices.Append({ V0, V2, V1, V1, V2, V3 });
+                TriangleCityObjectIndices.Add(FPLATEAUCityObjectIndex(Y, X));
+                TriangleCityObjectIndices.Add(FPLATEAUCityObjectIndex(Y, X));
+            }
+        }
+    }
+
+    bool RaycastBruteForce(const TArray<FVector3f>& Positions, const TArray<uint32>& Indices, const FVector& Origin, const FVector& Direction, int32& OutTriangleIndex) {
+        double ClosestT = UE_BIG_NUMBER;
+        OutTriangleIndex = INDEX_NONE;
+        for (int32 i = 0; i < Indices.Num() / 3; ++i) {
+            const FVector P0(Positions[Indices[i * 3]]);
+            const FVector P1(Positions[Indices[i * 3 + 1]]);
+            const FVector P2(Positions[Indices[i * 3 + 2]]);
+            FVector HitLocation, HitNormal;
+            if (FMath::SegmentTriangleIntersection(Origin, Origin + Direction * 1e6, P0, P1, P2, HitLocation, HitNormal)) {
+                const double T = FVector::Distance(Origin, HitLocation);
+                if (T < ClosestT) {
+                    ClosestT = T;
+                    OutTriangleIndex = i;
+                }
+            }
+        }
+        return OutTriangleIndex != INDEX_NONE;
+    }
+}
+
+/// <summary>
+/// 10万三角形の格子メッシュでのBVHの結果確認とクエリ性能の計測
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityObjectGroup_SpatialIndex, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityObjectGroup.SpatialIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityObjectGroup_SpatialIndex::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_CityObjectGroup_SpatialIndex_Local;
+    InitializeTest("CityObjectGroup.SpatialIndex");
+
+    TArray<FVector3f> Positions;
+    TArray<uint32> Indices;
+    TArray<FPLATEAUCityObjectIndex> TriangleCityObjectIndices;
+    CreateGridMesh(Positions, Indices, TriangleCityObjectIndices);
+
+    FPLATEAUCityObjectSpatialIndex SpatialIndex;
+    const double BuildStart = FPlatformTime::Seconds();
+    TestTrue("Build", SpatialIndex.Build(Positions, Indices, TriangleCityObjectIndices));
+    AddInfo(FString::Printf(TEXT("Build %d triangles: %.2f ms"), SpatialIndex.GetNumTriangles(), (FPlatformTime::Seconds() - BuildStart) * 1000.0));
+
+    // 総当たりとの一致確認
+    FRandomStream Random(0);
+    const FVector Down(0, 0, -1);
+    for (int32 i = 0; i < 32; ++i) {
+        const FVector Origin(Random.FRandRange(0, GridSize * CellSize), Random.FRandRange(0, GridSize * CellSize), 10000);
+        int32 ExpectedTriangle, ActualTriangle;
+        double Distance;
+        TestTrue("Brute force hit", RaycastBruteForce(Positions, Indices, Origin, Down, ExpectedTriangle));
+        TestTrue("BVH hit", SpatialIndex.Raycast(Origin, Down, 1e6, ActualTriangle, Distance));
+        TestTrue("Raycast CityObjectIndex", SpatialIndex.GetCityObjectIndex(ActualTriangle) == TriangleCityObjectIndices[ExpectedTriangle]);
+    }
+
+    int32 TriangleIndex;
+    double Distance;
+    TestTrue("Point", SpatialIndex.FindNearestTriangle(FVector(CellSize * 10.5, CellSize * 20.5, Positions[20 * (GridSize + 1) + 10].Z), 1000.0, TriangleIndex, Distance));
+    TestTrue("Point CityObjectIndex", SpatialIndex.GetCityObjectIndex(TriangleIndex) == FPLATEAUCityObjectIndex(20, 10));
+    TestFalse("Point out of tolerance", SpatialIndex.FindNearestTriangle(FVector(-10000, -10000, 0), 1.0, TriangleIndex, Distance));
+
+    const auto BoxIndices = SpatialIndex.FindCityObjectIndicesInBox(FBox(FVector(CellSize * 0.25, CellSize * 0.25, -1000), FVector(CellSize * 1.75, CellSize * 0.75, 1000)));
+    TestEqual("Box CityObjectIndex count", BoxIndices.Num(), 2);
+
+    // スループット計測
+    constexpr int32 QueryCount = 100000;
+    int32 HitCount = 0;
+    const double QueryStart = FPlatformTime::Seconds();
+    for (int32 i = 0; i < QueryCount; ++i) {
+        const FVector Origin(Random.FRandRange(0, GridSize * CellSize), Random.FRandRange(0, GridSize * CellSize), 10000);
+        if (SpatialIndex.Raycast(Origin, Down, 1e6, TriangleIndex, Distance))
+            HitCount++;
+    }
+    const double QuerySeconds = FPlatformTime::Seconds() - QueryStart;
+    TestEqual("All rays hit", HitCount, QueryCount);
+    AddInfo(FString::Printf(TEXT("Raycast: %.0f queries/sec"), QueryCount / FMath::Max(QuerySeconds, UE_SMALL_NUMBER)));
+
+    FinishTest(true, "");
+    return true;
+}
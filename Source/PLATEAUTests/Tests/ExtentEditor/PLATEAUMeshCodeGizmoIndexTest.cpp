@@ -0,0 +1,69 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "PLATEAUEditor/Public/ExtentEditor/PLATEAUMeshCodeGizmoIndex.h"
+
+
+namespace FPLATEAUTest_MeshCodeGizmoIndex_Query_Local {
+    TArray<int32> QueryBruteForce(const TArray<FBox2D>& Bounds, const FBox2D& Box) {
+        TArray<int32> Result;
+        for (int32 i = 0; i < Bounds.Num(); ++i) {
+            if (Bounds[i].Min.X <= Box.Max.X && Box.Min.X <= Bounds[i].Max.X &&
+                Bounds[i].Min.Y <= Box.Max.Y && Box.Min.Y <= Bounds[i].Max.Y)
+                Result.Add(i);
+        }
+        return Result;
+    }
+}
+
+/// <summary>
+/// メッシュコードギズモのインデックス検索結果が全件走査と一致すること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MeshCodeGizmoIndex_Query, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.MeshCodeGizmoIndex.Query", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MeshCodeGizmoIndex_Query::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_MeshCodeGizmoIndex_Query_Local;
+    InitializeTest("MeshCodeGizmoIndex.Query");
+
+    // 3次メッシュ相当の格子と、それより大きい2次メッシュ相当の範囲を混在させる
+    TArray<FBox2D> Bounds;
+    for (int32 Y = 0; Y < 40; ++Y) {
+        for (int32 X = 0; X < 40; ++X) {
+            const FVector2D Min(X * 1000.0, Y * 1000.0);
+            Bounds.Emplace(Min, Min + FVector2D(1000.0, 1000.0));
+        }
+    }
+    for (int32 Y = 0; Y < 5; ++Y) {
+        for (int32 X = 0; X < 5; ++X) {
+            const FVector2D Min(X * 8000.0, Y * 8000.0);
+            Bounds.Emplace(Min, Min + FVector2D(8000.0, 8000.0));
+        }
+    }
+
+    FPLATEAUMeshCodeGizmoIndex Index;
+    TArray<int32> Actual;
+    Index.Query(FBox2D(FVector2D::ZeroVector, FVector2D(1000.0, 1000.0)), Actual);
+    TestEqual("Empty index", Actual.Num(), 0);
+
+    Index.Build(Bounds);
+    TestEqual("Num", Index.Num(), Bounds.Num());
+
+    FRandomStream Random(12345);
+    for (int32 i = 0; i < 200; ++i) {
+        const FVector2D Center(Random.FRandRange(-5000.0, 45000.0), Random.FRandRange(-5000.0, 45000.0));
+        const FVector2D Extent(Random.FRandRange(0.0, 10000.0), Random.FRandRange(0.0, 10000.0));
+        const FBox2D Box(Center - Extent, Center + Extent);
+        Index.Query(Box, Actual);
+        if (Actual != QueryBruteForce(Bounds, Box)) {
+            AddError(FString::Printf(TEXT("Query mismatch: %s"), *Box.ToString()));
+            break;
+        }
+    }
+
+    // 範囲外
+    Index.Query(FBox2D(FVector2D(-3000.0, -3000.0), FVector2D(-2000.0, -2000.0)), Actual);
+    TestEqual("Outside", Actual.Num(), 0);
+
+    FinishTest(true, "");
+    return true;
+}
@@ -31,6 +31,7 @@ class FPLATEAUAutomationTestBase : public FAutomationTestBase {
         return FFileHelper::SaveStringToFile(Text, *(DirectoryPath + "/" + FPaths::GetBaseFilename(Path) + ".txt"));
     }
 
+protected:
     static APLATEAUCityModelLoader* GetLocalCityModelLoader(const int ZoneId, const FVector& ReferencePoint, const int64 PackageMask, const FString& SourcePath, const TMap<int64, FPackageInfoSettings>& PackageInfoSettingsData) {
         const auto& ExtentEditor = IPLATEAUEditorModule::Get().GetExtentEditor();
         ExtentEditor->SetImportFromServer(false);
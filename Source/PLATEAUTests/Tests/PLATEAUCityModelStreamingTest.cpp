@@ -0,0 +1,185 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUAutomationTestBase.h"
+#include "Benchmark/PLATEAUBenchmarkUtil.h"
+#include "Component/PLATEAUCityModelStreamingComponent.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "StaticMeshResources.h"
+#include "Tests/AutomationCommon.h"
+
+
+namespace FPLATEAUTest_CityModelStreaming_Local {
+    constexpr int32 PathStepCount = 12;
+
+    struct FState {
+        UPLATEAUCityModelStreamingComponent* Streaming = nullptr;
+        TArray<FVector> Path;
+        int32 StepIndex = 0;
+        int64 FullBytes = 0;
+        int32 FullTileCount = 0;
+        int32 MaxLoadedTileCount = 0;
+        TArray<FString> FirstLoadedTiles;
+        bool bBudgetExceeded = false;
+    };
+
+    FVector ProjectSyntheticPosition(FPLATEAUGeoReference& GeoReference, const double X, const double Y) {
+        using namespace PLATEAUBenchmarkUtil::Detail;
+        const plateau::geometry::GeoCoordinate Coordinate(
+            OriginLatitude + Y / MetersPerDegreeLatitude,
+            OriginLongitude + X / MetersPerDegreeLongitude,
+            GroundHeight);
+        return UPLATEAUGeoReferenceBlueprintLibrary::Project(GeoReference, FPLATEAUGeoCoordinate(Coordinate));
+    }
+
+    /**
+     * @brief 読込中であれば読込を進め、読込が無くなった場合はtrueを返します。
+     */
+    bool StepUntilIdle(FState& State, const FVector& Viewpoint) {
+        State.Streaming->UpdateStreaming({ Viewpoint });
+        return !State.Streaming->IsLoading();
+    }
+}
+
+/// <summary>
+/// 合成データセットを経路に沿ってストリーミングし、タイルの読込・破棄が行われ、メモリ予算を超えないこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_CityModelStreaming_Path, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.CityModelStreaming.Path", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_CityModelStreaming_Path::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_CityModelStreaming_Local;
+    InitializeTest("CityModelStreaming.Path");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    PLATEAUBenchmarkUtil::FSyntheticDatasetSettings Settings;
+    const FString DatasetDir = FPaths::ProjectIntermediateDir() / TEXT("PLATEAUTest/StreamingDataset");
+    if (!PLATEAUBenchmarkUtil::CreateSyntheticDataset(DatasetDir, Settings)) {
+        AddError("Failed to CreateSyntheticDataset");
+        return false;
+    }
+
+    // インポート設定はインポート時と同じものを利用する
+    constexpr int ZoneId = 9;
+    const FVector ReferencePoint = FVector(-472281.96875, 5131018, 0);
+    constexpr int64 PackageMask = static_cast<int64>(plateau::dataset::PredefinedCityModelPackage::Building);
+    const auto DefaultMat = UPLATEAUImportAreaSelectBtn::GetDefaultFallbackMaterial(PackageMask);
+    TMap<int64, FPackageInfoSettings> PackageInfoSettingsData;
+    PackageInfoSettingsData.Add(PackageMask, FPackageInfoSettings(true, true, true, true, EPLATEAUTexturePackingResolution::H4096W4096, 0, 4, 1, DefaultMat, false, "", 7));
+    const auto Loader = GetLocalCityModelLoader(ZoneId, ReferencePoint, PackageMask, DatasetDir, PackageInfoSettingsData);
+    if (Loader == nullptr) {
+        AddError("Loader is nullptr");
+        return false;
+    }
+
+    const auto ModelActor = Loader->GetWorld()->SpawnActor<APLATEAUInstancedCityModel>();
+    const auto State = MakeShared<FState>();
+    State->Streaming = NewObject<UPLATEAUCityModelStreamingComponent>(ModelActor);
+    State->Streaming->Source = DatasetDir;
+    State->Streaming->GeoReference = Loader->GeoReference;
+    State->Streaming->ImportSettings = Loader->ImportSettings;
+    State->Streaming->TileMeshCodeLevel = 5;
+    State->Streaming->HysteresisDistance = 0;
+    State->Streaming->bUsePlayerCameras = false;
+    State->Streaming->LodSettings = { FPLATEAUStreamingLodSetting(1e8f, 2) };
+    State->Streaming->MemoryBudgetMB = 0;
+    State->Streaming->RegisterComponent();
+
+    // 合成データセットの対角線を経路とする
+    for (int32 i = 0; i <= PathStepCount; ++i) {
+        const double T = static_cast<double>(i) / PathStepCount;
+        State->Path.Add(ProjectSyntheticPosition(State->Streaming->GeoReference, Settings.AreaSize * T, Settings.AreaSize * T));
+    }
+
+    // 予算無しで全タイルを読み込み、全体のサイズを計測する
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        if (!StepUntilIdle(*State, State->Path[PathStepCount / 2]))
+            return false;
+
+        State->FullBytes = State->Streaming->GetUsedMemoryBytes();
+        State->FullTileCount = State->Streaming->GetLoadedTileCount();
+        TestTrue("Tiles are created", 1 < State->Streaming->GetTileMeshCodes().Num());
+        TestEqual("All tiles are loaded", State->FullTileCount, State->Streaming->GetTileMeshCodes().Num());
+        TestTrue("Memory is counted", 0 < State->FullBytes);
+
+        // エディタでもランタイムと同じくMeshDescriptionから直接ビルドされる
+        TArray<UStaticMeshComponent*> StaticMeshComponents;
+        State->Streaming->GetOwner()->GetComponents(StaticMeshComponents);
+        TestTrue("Meshes are loaded", 0 < StaticMeshComponents.Num());
+        for (const auto StaticMeshComponent : StaticMeshComponents) {
+            const auto StaticMesh = StaticMeshComponent->GetStaticMesh();
+            if (!TestTrue("Mesh is set", StaticMesh != nullptr))
+                continue;
+            TestTrue("Mesh is built", StaticMesh->GetRenderData() != nullptr && StaticMesh->GetRenderData()->IsInitialized());
+            TestTrue("Mesh is built from mesh description", StaticMesh->bAllowCPUAccess);
+        }
+
+        State->Streaming->UnloadAll();
+        TestEqual("Unloaded tiles", State->Streaming->GetLoadedTileCount(), 0);
+        TestEqual("Unloaded memory", State->Streaming->GetUsedMemoryBytes(), static_cast<int64>(0));
+        TArray<UPLATEAUCityObjectGroup*> CityObjectGroups;
+        State->Streaming->GetOwner()->GetComponents(CityObjectGroups);
+        TestEqual("Components are destroyed", CityObjectGroups.Num(), 0);
+
+        // 予算を全体の半分、読込範囲を300mとして経路を移動する
+        State->Streaming->MemoryBudgetMB = State->FullBytes / 2.0 / (1024.0 * 1024.0);
+        State->Streaming->LodSettings = { FPLATEAUStreamingLodSetting(30000.0f, 2) };
+
+        // 読込開始直後に破棄する
+        State->Streaming->UpdateStreaming({ State->Path[0] });
+        TestTrue("Loading is started", State->Streaming->IsLoading());
+        State->Streaming->UnloadAll();
+        return true;
+    }));
+
+    // キャンセルされた読込はコンポーネントを残さずに終了する
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        State->Streaming->UnloadAll();
+        if (State->Streaming->IsLoading())
+            return false;
+
+        TestEqual("Canceled tile is not loaded", State->Streaming->GetLoadedTileCount(), 0);
+        TArray<UPLATEAUCityObjectGroup*> CityObjectGroups;
+        State->Streaming->GetOwner()->GetComponents(CityObjectGroups);
+        TestEqual("Components of canceled tile are destroyed", CityObjectGroups.Num(), 0);
+        return true;
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        const bool bIdle = StepUntilIdle(*State, State->Path[State->StepIndex]);
+
+        const int32 LoadedTileCount = State->Streaming->GetLoadedTileCount();
+        State->MaxLoadedTileCount = FMath::Max(State->MaxLoadedTileCount, LoadedTileCount);
+        if (State->Streaming->GetMemoryBudgetBytes() < State->Streaming->GetUsedMemoryBytes() && 1 < LoadedTileCount) {
+            State->bBudgetExceeded = true;
+            AddError(FString::Printf(TEXT("Budget exceeded at step %d: %lld > %lld"), State->StepIndex,
+                State->Streaming->GetUsedMemoryBytes(), State->Streaming->GetMemoryBudgetBytes()));
+        }
+
+        if (!bIdle)
+            return false;
+
+        if (State->StepIndex == 0)
+            State->FirstLoadedTiles = State->Streaming->GetLoadedTileMeshCodes();
+        return ++State->StepIndex >= State->Path.Num();
+    }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        TestTrue("Tiles are loaded at start", 0 < State->FirstLoadedTiles.Num());
+        TestTrue("Not all tiles are loaded at once", State->MaxLoadedTileCount < State->FullTileCount);
+
+        const auto LastLoadedTiles = State->Streaming->GetLoadedTileMeshCodes();
+        TestTrue("Tiles are loaded at end", 0 < LastLoadedTiles.Num());
+        bool bStartTileUnloaded = false;
+        for (const auto& MeshCode : State->FirstLoadedTiles) {
+            bStartTileUnloaded |= !LastLoadedTiles.Contains(MeshCode);
+        }
+        TestTrue("Tiles near the start are unloaded", bStartTileUnloaded);
+
+        State->Streaming->UnloadAll();
+        FinishTest(!State->bBudgetExceeded, "Budget exceeded");
+        return true;
+    }));
+
+    return true;
+}
@@ -0,0 +1,66 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUAutomationTestBase.h"
+#include "PLATEAUDatasetIndex.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace FPLATEAUTest_DatasetIndex_Local {
+    void CreateEmptyFile(const FString& Path) {
+        FFileHelper::SaveStringToFile(TEXT(""), *Path);
+    }
+}
+
+/// <summary>
+/// 索引の作成後は変更のあったディレクトリのみ再走査され、メッシュコードとパッケージでGMLが絞り込まれること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_DatasetIndex_FindGmlFiles, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.DatasetIndex.FindGmlFiles", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_DatasetIndex_FindGmlFiles::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_DatasetIndex_Local;
+    using plateau::dataset::PredefinedCityModelPackage;
+    InitializeTest("DatasetIndex.FindGmlFiles");
+    FPLATEAUDatasetIndex::ClearCache();
+
+    const auto SourcePath = FPaths::ConvertRelativePathToFull(FPaths::ProjectIntermediateDir()) / TEXT("PLATEAUTest/DatasetIndex");
+    IFileManager::Get().DeleteDirectory(*SourcePath, false, true);
+    const auto BldgPath = SourcePath / TEXT("udx/bldg");
+    const auto DemPath = SourcePath / TEXT("udx/dem");
+    CreateEmptyFile(BldgPath / TEXT("53392546_bldg_6697_op.gml"));
+    CreateEmptyFile(BldgPath / TEXT("53392547_bldg_6697_op.gml"));
+    CreateEmptyFile(DemPath / TEXT("533925_dem_6697_op.gml"));
+
+    // udx, bldg, demを走査する
+    int32 RescannedCount = 0;
+    auto Index = FPLATEAUDatasetIndex::FindOrBuild(SourcePath, &RescannedCount);
+    if (!Index) {
+        AddError("Index == nullptr");
+        return false;
+    }
+    TestEqual("Rescanned directories on build", RescannedCount, 3);
+    TestEqual("Entry count", Index->GetEntries().Num(), 3);
+
+    FPLATEAUDatasetIndex::FindOrBuild(SourcePath, &RescannedCount);
+    TestEqual("Rescanned directories without change", RescannedCount, 0);
+
+    // 上位の地域メッシュのGMLも含まれる
+    const auto GmlFiles = Index->FindGmlFiles({ TEXT("53392546") }, PredefinedCityModelPackage::Building | PredefinedCityModelPackage::Relief);
+    TestTrue("Found gml files", GmlFiles == TArray<FString>{ BldgPath / TEXT("53392546_bldg_6697_op.gml"), DemPath / TEXT("533925_dem_6697_op.gml") });
+    TestEqual("Filtered by package", Index->FindGmlFiles({ TEXT("53392546") }, PredefinedCityModelPackage::Building).Num(), 1);
+
+    // ディレクトリの更新日時が変わるよう時間を空けてファイルを追加する
+    FPlatformProcess::Sleep(1.1f);
+    const auto AddedGmlPath = BldgPath / TEXT("53392556_bldg_6697_op.gml");
+    CreateEmptyFile(AddedGmlPath);
+    Index = FPLATEAUDatasetIndex::FindOrBuild(SourcePath, &RescannedCount);
+    TestEqual("Rescanned directories after adding file", RescannedCount, 1);
+    TestTrue("Added gml file is found", Index->FindGmlFiles({ TEXT("53392556") }, PredefinedCityModelPackage::Building) == TArray<FString>{ AddedGmlPath });
+
+    IFileManager::Get().DeleteDirectory(*SourcePath, false, true);
+    FPLATEAUDatasetIndex::ClearCache();
+
+    FinishTest(true, "");
+    return true;
+}
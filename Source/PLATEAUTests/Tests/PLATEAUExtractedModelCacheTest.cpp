@@ -0,0 +1,114 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUAutomationTestBase.h"
+#include "Tests/AutomationCommon.h"
+#include "PLATEAUExtractedModelCache.h"
+#include "PLATEAUCityModelLoader.h"
+#include "HAL/FileManager.h"
+#include <citygml/citygml.h>
+#include <plateau/polygon_mesh/mesh_extractor.h>
+#include <plateau/polygon_mesh/model.h>
+#include <plateau/polygon_mesh/mesh.h>
+
+
+namespace FPLATEAUTest_ExtractedModelCache_Local {
+    void CollectMeshes(const plateau::polygonMesh::Model& Model, TArray<const plateau::polygonMesh::Mesh*>& OutMeshes) {
+        TArray<const plateau::polygonMesh::Node*> Stack;
+        for (size_t i = 0; i < Model.getRootNodeCount(); ++i)
+            Stack.Add(&Model.getRootNodeAt(i));
+        while (0 < Stack.Num()) {
+            const auto Node = Stack.Pop();
+            if (Node->getMesh() != nullptr)
+                OutMeshes.Add(Node->getMesh());
+            for (size_t i = 0; i < Node->getChildCount(); ++i)
+                Stack.Add(&Node->getChildAt(i));
+        }
+    }
+}
+
+/// <summary>
+/// 抽出済みメッシュキャッシュの保存・読込で形状と属性が一致すること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_ExtractedModelCache_RoundTrip, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.ExtractedModelCache.RoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_ExtractedModelCache_RoundTrip::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_ExtractedModelCache_Local;
+    InitializeTest("ExtractedModelCache.RoundTrip");
+    FPLATEAUExtractedModelCache::ClearCache();
+
+    const FString GmlPath = FPLATEAURuntimeModule::GetContentDir().Append("/TestData/data/udx/bldg/53392642_bldg_6697_op2.gml");
+    citygml::ParserParams ParserParams;
+    ParserParams.tesselate = true;
+    const auto CityModel = citygml::load(TCHAR_TO_UTF8(*GmlPath), ParserParams);
+    if (CityModel == nullptr) {
+        AddError("CityModel == nullptr");
+        return false;
+    }
+
+    FLoadInputData InputData;
+    InputData.ExtractOptions.mesh_granularity = plateau::polygonMesh::MeshGranularity::PerPrimaryFeatureObject;
+    InputData.ExtractOptions.max_lod = 2;
+    InputData.ExtractOptions.min_lod = 0;
+    InputData.ExtractOptions.unit_scale = 0.01f;
+    InputData.ExtractOptions.exclude_city_object_outside_extent = false;
+    InputData.bIncludeAttrInfo = true;
+    InputData.FallbackMaterial = nullptr;
+
+    const auto Key = FPLATEAUExtractedModelCache::MakeKey(GmlPath, InputData);
+    TestFalse("Key", Key.IsEmpty());
+    TestEqual("Key is stable", FPLATEAUExtractedModelCache::MakeKey(GmlPath, InputData), Key);
+    auto OtherInputData = InputData;
+    OtherInputData.ExtractOptions.max_lod = 1;
+    TestNotEqual("Key depends on options", FPLATEAUExtractedModelCache::MakeKey(GmlPath, OtherInputData), Key);
+
+    FPLATEAUExtractedModel Expected;
+    TestFalse("Miss before save", FPLATEAUExtractedModelCache::Load(Key, Expected));
+    Expected.Model = plateau::polygonMesh::MeshExtractor::extract(*CityModel, InputData.ExtractOptions);
+    FPLATEAUExtractedModelCache::SerializeCityObjects(*Expected.Model, CityModel, InputData, Expected.SerializedCityObjects);
+    TestTrue("Save", FPLATEAUExtractedModelCache::Save(Key, Expected));
+
+    FPLATEAUExtractedModel Actual;
+    TestTrue("Hit after save", FPLATEAUExtractedModelCache::Load(Key, Actual));
+    if (Actual.Model == nullptr)
+        return false;
+
+    TestEqual("Root node count", Actual.Model->getRootNodeCount(), Expected.Model->getRootNodeCount());
+    TestTrue("Serialized city objects", Actual.SerializedCityObjects.OrderIndependentCompareEqual(Expected.SerializedCityObjects));
+
+    TArray<const plateau::polygonMesh::Mesh*> ExpectedMeshes, ActualMeshes;
+    CollectMeshes(*Expected.Model, ExpectedMeshes);
+    CollectMeshes(*Actual.Model, ActualMeshes);
+    TestEqual("Mesh count", ActualMeshes.Num(), ExpectedMeshes.Num());
+    for (int32 i = 0; i < FMath::Min(ActualMeshes.Num(), ExpectedMeshes.Num()); ++i) {
+        TestTrue("Vertices", ActualMeshes[i]->getVertices().size() == ExpectedMeshes[i]->getVertices().size());
+        TestTrue("Indices", ActualMeshes[i]->getIndices() == ExpectedMeshes[i]->getIndices());
+        TestTrue("UV4", ActualMeshes[i]->getUV4().size() == ExpectedMeshes[i]->getUV4().size());
+        TestTrue("SubMeshes", ActualMeshes[i]->getSubMeshes().size() == ExpectedMeshes[i]->getSubMeshes().size());
+        TestTrue("CityObjectList", ActualMeshes[i]->getCityObjectList() == ExpectedMeshes[i]->getCityObjectList());
+    }
+
+    FPLATEAUExtractedModelCache::SetEnabled(false);
+    TestFalse("Disabled", FPLATEAUExtractedModelCache::Load(Key, Actual));
+    FPLATEAUExtractedModelCache::SetEnabled(true);
+
+    FPLATEAUExtractedModelCache::ClearCache();
+    TestFalse("Miss after clear", FPLATEAUExtractedModelCache::Load(Key, Actual));
+
+    // 上限を超えた場合は最終アクセスが古いものから削除される
+    TestTrue("Save before trim", FPLATEAUExtractedModelCache::Save(Key, Expected));
+    const auto CacheFileSize = IFileManager::Get().FileSize(*(FPLATEAUExtractedModelCache::GetCacheDirectory() / Key.Left(2) / Key + TEXT(".bin")));
+    TestTrue("Cache file size", 0 < CacheFileSize);
+    FPLATEAUExtractedModelCache::SetCacheBudget(CacheFileSize * 3 / 2);
+    TestTrue("Kept within budget", FPLATEAUExtractedModelCache::Load(Key, Actual));
+    // 更新日時が変わるよう時間を空ける
+    FPlatformProcess::Sleep(1.1f);
+    const auto OtherKey = FPLATEAUExtractedModelCache::MakeKey(GmlPath, OtherInputData);
+    TestTrue("Save over budget", FPLATEAUExtractedModelCache::Save(OtherKey, Expected));
+    TestFalse("Older cache is trimmed", FPLATEAUExtractedModelCache::Load(Key, Actual));
+    TestTrue("Newer cache is kept", FPLATEAUExtractedModelCache::Load(OtherKey, Actual));
+    FPLATEAUExtractedModelCache::SetCacheBudget(4LL * 1024 * 1024 * 1024);
+    FPLATEAUExtractedModelCache::ClearCache();
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,95 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUAutomationTestBase.h"
+#include "PLATEAUImportMemoryBudget.h"
+
+
+namespace FPLATEAUTest_ImportMemoryBudget_Local {
+    FLoadInputData CreateLoadInputData(const plateau::dataset::PredefinedCityModelPackage Package, const unsigned MaxLod, const bool bTexture) {
+        FLoadInputData LoadInputData;
+        LoadInputData.Package = Package;
+        LoadInputData.ExtractOptions.max_lod = MaxLod;
+        LoadInputData.ExtractOptions.export_appearance = bTexture;
+        LoadInputData.ExtractOptions.attach_map_tile = false;
+        return LoadInputData;
+    }
+}
+
+/// <summary>
+/// 見積もりがファイルサイズ, LOD, テクスチャに応じて増えること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_ImportMemoryBudget_Estimate, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.ImportMemoryBudget.Estimate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_ImportMemoryBudget_Estimate::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_ImportMemoryBudget_Local;
+    using plateau::dataset::PredefinedCityModelPackage;
+    InitializeTest("ImportMemoryBudget.Estimate");
+
+    constexpr int64 FileSize = 10 * 1024 * 1024;
+    const auto Lod2 = FPLATEAUImportMemoryBudget::Estimate(FileSize, CreateLoadInputData(PredefinedCityModelPackage::Building, 2, false));
+    TestTrue("Parse bytes is larger than file", FileSize < Lod2.ParseBytes);
+    TestTrue("Mesh bytes is positive", 0 < Lod2.MeshBytes);
+
+    const auto Large = FPLATEAUImportMemoryBudget::Estimate(FileSize * 4, CreateLoadInputData(PredefinedCityModelPackage::Building, 2, false));
+    TestEqual("Estimate scales with file size", Large.GetTotalBytes(), Lod2.GetTotalBytes() * 4);
+
+    const auto Lod3 = FPLATEAUImportMemoryBudget::Estimate(FileSize, CreateLoadInputData(PredefinedCityModelPackage::Building, 3, false));
+    TestTrue("LOD3 is larger", Lod2.MeshBytes < Lod3.MeshBytes);
+
+    const auto Textured = FPLATEAUImportMemoryBudget::Estimate(FileSize, CreateLoadInputData(PredefinedCityModelPackage::Building, 2, true));
+    TestTrue("Texture is larger", Lod2.MeshBytes < Textured.MeshBytes);
+
+    const auto Unknown = FPLATEAUImportMemoryBudget::Estimate(-1, CreateLoadInputData(PredefinedCityModelPackage::Building, 2, false));
+    TestTrue("Unknown size is estimated", 0 < Unknown.GetTotalBytes());
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// 予算内でのみ処理を開始し、パース結果の解放で次のGMLを開始できること。予算を超えるGMLも単独では開始できること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_ImportMemoryBudget_Admission, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.ImportMemoryBudget.Admission", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_ImportMemoryBudget_Admission::RunTest(const FString& Parameters) {
+    InitializeTest("ImportMemoryBudget.Admission");
+
+    FPLATEAUImportMemoryBudget::FEstimate Small;
+    Small.ParseBytes = 60;
+    Small.MeshBytes = 20;
+    FPLATEAUImportMemoryBudget::FEstimate Large;
+    Large.ParseBytes = 300;
+    Large.MeshBytes = 100;
+
+    FPLATEAUImportMemoryBudget Budget(100, 8);
+    TestTrue("Oversized gml is admitted alone", Budget.TryAcquire(Large));
+    TestFalse("Nothing is admitted while oversized gml is active", Budget.TryAcquire(Small));
+    Budget.Release(Large, false);
+    TestEqual("Released", Budget.GetReservedBytes(), static_cast<int64>(0));
+
+    TestTrue("Small gml is admitted", Budget.TryAcquire(Small));
+    TestFalse("Second small gml exceeds budget", Budget.TryAcquire(Small));
+    Budget.ReleaseParse(Small);
+    TestEqual("Parse bytes are released", Budget.GetReservedBytes(), Small.MeshBytes);
+    TestTrue("Second small gml is admitted after parse release", Budget.TryAcquire(Small));
+    TestEqual("Active count", Budget.GetActiveCount(), 2);
+    Budget.Release(Small, true);
+    Budget.Release(Small, false);
+    TestEqual("All released", Budget.GetReservedBytes(), static_cast<int64>(0));
+    TestEqual("No active gml", Budget.GetActiveCount(), 0);
+
+    const auto Stats = Budget.GetStats();
+    TestEqual("Peak reserved", Stats.PeakReservedBytes, Large.GetTotalBytes());
+    TestEqual("Peak concurrency", Stats.PeakConcurrentGmlCount, 2);
+    TestEqual("Deferred count", Stats.DeferredCount, 2);
+    TestTrue("Physical memory is sampled", 0 < Stats.PeakUsedPhysicalBytes);
+
+    // 件数の上限
+    FPLATEAUImportMemoryBudget CountLimited(0, 2);
+    TestTrue("First", CountLimited.TryAcquire(Small));
+    TestTrue("Second", CountLimited.TryAcquire(Small));
+    TestFalse("Third exceeds count", CountLimited.TryAcquire(Small));
+
+    FinishTest(true, "");
+    return true;
+}
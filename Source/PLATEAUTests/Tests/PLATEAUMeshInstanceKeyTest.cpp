@@ -0,0 +1,59 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "PLATEAUAutomationTestBase.h"
+#include "PLATEAUMeshInstanceKey.h"
+#include <plateau/polygon_mesh/mesh.h>
+
+
+namespace FPLATEAUTest_MeshInstanceKey_Local {
+    std::shared_ptr<plateau::polygonMesh::Mesh> CreateQuad(const TVec3d& Offset, const std::string& TexturePath) {
+        std::vector<TVec3d> Vertices = {
+            TVec3d(0, 0, 0) + Offset,
+            TVec3d(100, 0, 0) + Offset,
+            TVec3d(100, 100, 0) + Offset,
+            TVec3d(0, 100, 0) + Offset,
+        };
+        const auto Mesh = std::make_shared<plateau::polygonMesh::Mesh>();
+        Mesh->addVerticesList(Vertices);
+        Mesh->addIndicesList({ 0, 1, 2, 0, 2, 3 }, 0, false);
+        Mesh->addUV1({ TVec2f(0, 0), TVec2f(1, 0), TVec2f(1, 1), TVec2f(0, 1) }, Vertices.size());
+        Mesh->addUV4WithSameVal(TVec2f(0, 0), Vertices.size());
+        Mesh->addSubMesh(TexturePath, nullptr, 0, 5, 0);
+        return Mesh;
+    }
+}
+
+/// <summary>
+/// 平行移動のみ異なるメッシュが同じキーとなり、形状やテクスチャが異なるメッシュは別のキーとなること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MeshInstanceKey_Translation, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.MeshInstanceKey.Translation", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MeshInstanceKey_Translation::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_MeshInstanceKey_Local;
+    InitializeTest("MeshInstanceKey.Translation");
+
+    const auto Mesh = CreateQuad(TVec3d(0, 0, 0), "a.png");
+    const FPLATEAUMeshInstanceKey Key(*Mesh);
+    TestTrue("Key is valid", Key.IsValid());
+    TestFalse("Empty mesh key is invalid", FPLATEAUMeshInstanceKey(plateau::polygonMesh::Mesh()).IsValid());
+
+    const FPLATEAUMeshInstanceKey TranslatedKey(*CreateQuad(TVec3d(1000, -2000, 30), "a.png"));
+    TestTrue("Translated mesh has same key", Key == TranslatedKey);
+    TestEqual("Translated mesh hash", GetTypeHash(TranslatedKey), GetTypeHash(Key));
+    TestEqual("Origin", TranslatedKey.Origin, FVector(1000, -2000, 30));
+
+    const FPLATEAUMeshInstanceKey TextureKey(*CreateQuad(TVec3d(0, 0, 0), "b.png"));
+    TestFalse("Different texture has different key", Key == TextureKey);
+
+    const auto ModifiedMesh = CreateQuad(TVec3d(0, 0, 0), "a.png");
+    ModifiedMesh->getVertices()[2].z += 1.0;
+    TestFalse("Different shape has different key", Key == FPLATEAUMeshInstanceKey(*ModifiedMesh));
+
+    TMap<FPLATEAUMeshInstanceKey, int32> Map;
+    Map.Add(Key, 1);
+    TestTrue("Map lookup by translated key", Map.Contains(TranslatedKey));
+    TestFalse("Map lookup by different key", Map.Contains(TextureKey));
+
+    FinishTest(true, "");
+    return true;
+}
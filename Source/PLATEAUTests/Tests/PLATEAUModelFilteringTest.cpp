@@ -10,7 +10,7 @@
 
 namespace FPLATEAUTest_Filter_ModelFiltering_Local {
 
-    AActor* CreateComponentHierarchy(UWorld& World) {
+    AActor* CreateComponentHierarchy(UWorld& World, const FString& GmlName = TEXT("0000_op")) {
         //Component
         FActorSpawnParameters SpawnParam;
         const auto& Actor = World.SpawnActor<AActor>(SpawnParam);
@@ -18,7 +18,7 @@ namespace FPLATEAUTest_Filter_ModelFiltering_Local {
         const auto& SceneRoot = NewObject<UPLATEAUSceneComponent>(Actor,
             USceneComponent::GetDefaultSceneRootVariableName());
         const auto& CompRoot = NewObject<UPLATEAUSceneComponent>(Actor,
-            FName(TEXT("0000_op")));
+            FName(GmlName));
         const auto& CompLod = NewObject<UPLATEAUSceneComponent>(Actor,
             FName(TEXT("Lod0")));
         const auto& CompObj = NewObject<UPLATEAUCityObjectGroup>(Actor,
@@ -106,5 +106,29 @@ bool FPLATEAUTest_Filter_ModelFiltering::RunTest(const FString& Parameters) {
         }
     }
 
+    //FilterByIndex
+    {
+        AActor* IndexActor = FPLATEAUTest_Filter_ModelFiltering_Local::CreateComponentHierarchy(*GetWorld(), TEXT("53392642_bldg_6697_op"));
+        const auto& GmlComponents = IndexActor->GetRootComponent()->GetAttachChildren();
+        FPLATEAUModelFilteringIndex Index;
+        Index.Build(GmlComponents);
+        TestEqual("Index entries", Index.NumEntries(), 3);
+        TestTrue("Index is up to date", Index.IsUpToDate(GmlComponents));
+
+        TMap<plateau::dataset::PredefinedCityModelPackage, FPLATEAUMinMaxLod> LodRangeMap;
+        LodRangeMap.Add(plateau::dataset::PredefinedCityModelPackage::Building, { 2, 2 });
+        const auto ChangedCount = Filter.FilterByIndex(Index, plateau::dataset::PredefinedCityModelPackage::Building, LodRangeMap, true, citygml::CityObject::CityObjectsType::COT_All);
+        TestTrue("Changed components", 0 < ChangedCount);
+
+        for (const auto& LodComponent : GmlComponents[0]->GetAttachChildren()) {
+            const bool bExpectedVisible = LodComponent->GetName() == "Lod2";
+            for (const auto& Obj : LodComponent->GetAttachChildren())
+                TestEqual("Visibility by index", Obj->IsVisible(), bExpectedVisible);
+        }
+
+        // 同じ条件での再適用では何も変更されない
+        TestEqual("No change on reapply", Filter.FilterByIndex(Index, plateau::dataset::PredefinedCityModelPackage::Building, LodRangeMap, true, citygml::CityObject::CityObjectsType::COT_All), 0);
+    }
+
     return true;
 }
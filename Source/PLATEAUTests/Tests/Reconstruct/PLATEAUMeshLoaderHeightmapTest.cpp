@@ -10,6 +10,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "Tests/AutomationCommon.h"
 #include <PLATEAURuntime.h>
+#include <plateau/height_map_generator/heightmap_generator.h>
 
 /// <summary>
 /// Landscape/Heightmap 用 MeshLoader (PLATEAUMeshLoaderForHeightmap) Test
@@ -60,3 +61,82 @@ bool FPLATEAUTest_MeshLoader_Heightmap::RunTest(const FString& Parameters) {
     
     return true;
 }
+
+namespace FPLATEAUTest_MeshLoader_Heightmap_MultiNode_Local {
+    // 起伏の異なるDemメッシュを作成します
+    void CreateDemMesh(plateau::polygonMesh::Mesh& Mesh, const int32 Seed) {
+        constexpr int32 GridSize = 16;
+        std::vector<TVec3d> Vertices;
+        std::vector<unsigned int> Indices;
+        plateau::polygonMesh::UV UV1;
+        for (int32 Y = 0; Y <= GridSize; ++Y) {
+            for (int32 X = 0; X <= GridSize; ++X) {
+                const double Height = 10.0 * FMath::Sin(X * 0.4 + Seed) + 5.0 * FMath::Cos(Y * 0.3 * (Seed + 1));
+                Vertices.emplace_back(X * 10.0 + Seed * 50.0, Height, Y * 10.0);
+                UV1.emplace_back(0, 0);
+            }
+        }
+        for (int32 Y = 0; Y < GridSize; ++Y) {
+            for (int32 X = 0; X < GridSize; ++X) {
+                const unsigned int V0 = Y * (GridSize + 1) + X;
+                const unsigned int V1 = V0 + 1;
+                const unsigned int V2 = V0 + GridSize + 1;
+                const unsigned int V3 = V2 + 1;
+                Indices.insert(Indices.end(), { V0, V2, V1, V1, V2, V3 });
+            }
+        }
+        Mesh.addIndicesList(Indices, 0, false);
+        Mesh.addVerticesList(Vertices);
+        Mesh.addSubMesh("", nullptr, 0, Indices.size() - 1, 0);
+        Mesh.addUV1(UV1, Vertices.size());
+        Mesh.addUV4WithSameVal(TVec2f(0, 1), Vertices.size());
+    }
+}
+
+/// <summary>
+/// 複数のDemノードを並列に処理した結果が、ノードごとに逐次生成した結果と一致すること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_MeshLoader_Heightmap_MultiNode, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Reconstruct.MeshLoader.PLATEAUMeshLoaderForHeightmap.MultiNode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_MeshLoader_Heightmap_MultiNode::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_MeshLoader_Heightmap_MultiNode_Local;
+    InitializeTest("MeshLoader.PLATEAUMeshLoaderForHeightmap.MultiNode");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    constexpr int32 NodeCount = 6;
+    std::shared_ptr<plateau::polygonMesh::Model> Model = plateau::polygonMesh::Model::createModel();
+    auto& NodeOP = Model->addEmptyNode(TCHAR_TO_UTF8(*PLATEAUAutomationTestUtil::LandscapeFixtures::TEST_DEM_OP_NAME));
+    auto& NodeLod = NodeOP.addEmptyChildNode(TCHAR_TO_UTF8(*PLATEAUAutomationTestUtil::Fixtures::TEST_LOD_NAME));
+    for (int32 i = 0; i < NodeCount; ++i) {
+        auto Mesh = std::make_unique<plateau::polygonMesh::Mesh>();
+        CreateDemMesh(*Mesh, i);
+        auto& NodeObj = NodeLod.addEmptyChildNode(TCHAR_TO_UTF8(*FString::Printf(TEXT("dem_%d"), i)));
+        NodeObj.setMesh(std::move(Mesh));
+    }
+    Model->assignNodeHierarchy();
+
+    const auto& Actor = PLATEAUAutomationTestUtil::LandscapeFixtures::CreateActor(*GetWorld());
+    const auto Param = PLATEAUAutomationTestUtil::LandscapeFixtures::CreateLandscapeParam();
+
+    FPLATEAUMeshLoaderForHeightmap MeshLoader;
+    const auto Results = MeshLoader.CreateHeightMap(Actor, Model, Param);
+
+    TestEqual("Results Num", Results.Num(), NodeCount);
+    for (int32 i = 0; i < FMath::Min(Results.Num(), NodeCount); ++i) {
+        const auto& Node = NodeLod.getChildAt(i);
+        TestEqual("NodeName", Results[i].NodeName, FString(UTF8_TO_TCHAR(Node.getName().c_str())));
+
+        plateau::heightMapGenerator::HeightmapGenerator Generator;
+        TVec3d ExtMin, ExtMax;
+        TVec2f UVMin, UVMax;
+        const auto Expected = Generator.generateFromMesh(*Node.getMesh(), Param.TextureWidth, Param.TextureHeight, TVec2d(Param.Offset.X, Param.Offset.Y),
+            plateau::geometry::CoordinateSystem::ESU, Param.FillEdges, Param.ApplyBlurFilter, ExtMin, ExtMax, UVMin, UVMax);
+        TestTrue("Heightmap data", *Results[i].Data == Expected);
+        TestTrue("Extent", Results[i].Min == ExtMin && Results[i].Max == ExtMax);
+        TestTrue("UV", Results[i].MinUV == UVMin && Results[i].MaxUV == UVMax);
+    }
+
+    FinishTest(true, "");
+    return true;
+}
@@ -194,3 +194,68 @@ bool FPLATEAUTest_Reconstruct_ModelClassification_Attr::RunTest(const FString& P
 
     return true;
 }
+
+/// <summary>
+/// マテリアル分けテスト(Attr, 元コンポーネント削除)
+/// 地物単位が変わらない場合は、コンポーネントを再生成せずにマテリアルのみ書き換えること
+/// umap使用
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Reconstruct_ModelClassification_Attr_InPlace, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Reconstruct.Classification.Static.ClassificationByAttrInPlace", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_Reconstruct_ModelClassification_Attr_InPlace::RunTest(const FString& Parameters) {
+    InitializeTest("Classification.Static.ClassificationByAttrInPlace");
+    if (!OpenMap("SampleBldg"))
+        AddError("Failed to OpenMap");
+
+    ADD_LATENT_AUTOMATION_COMMAND(FEngineWaitLatentCommand(1.0f)); //Map読込待機
+
+    TArray<AActor*> FoundActors;
+    UGameplayStatics::GetAllActorsWithTag(GetWorld(), "ModelActor", FoundActors);
+
+    if (FoundActors.Num() <= 0) {
+        AddError(TEXT("0 < FoundActors.Num()"));
+        return false;
+    }
+
+    APLATEAUInstancedCityModel* ModelActor = (APLATEAUInstancedCityModel*)FoundActors[0];
+
+    ADD_LATENT_AUTOMATION_COMMAND(FThreadedAutomationLatentCommand([&, ModelActor] {
+
+        const auto& TargetComponents = FPLATEAUComponentUtil::ConvertArrayToSceneComponentArray(ModelActor->GetComponentsByTag(UPLATEAUCityObjectGroup::StaticClass(), "TargetComponentAttr"));
+
+        FString AttrKey = FPLATEAUTest_Reconstruct_ModelClassification_Local::AttrKey;
+        TMap<FString, UMaterialInterface*> MaterialMap = FPLATEAUTest_Reconstruct_ModelClassification_Local::CreateMaterialMapForAttr();
+        auto Task = ModelActor->ClassifyModel(TargetComponents, AttrKey, MaterialMap, EPLATEAUMeshGranularity::PerPrimaryFeatureObject, true);
+        Task.Wait();
+
+        const auto ResultComponents = Task.GetResult();
+        UMaterialInterface* AttrMat1 = *MaterialMap.Find(FPLATEAUTest_Reconstruct_ModelClassification_Local::AttrValue1);
+        UMaterialInterface* AttrMat2 = *MaterialMap.Find(FPLATEAUTest_Reconstruct_ModelClassification_Local::AttrValue2);
+
+        ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([&, this, TargetComponents, ResultComponents, AttrMat1, AttrMat2] {
+
+            int32 InPlaceCount = 0;
+            TSet<UMaterialInterface*> ResultMaterials;
+            for (auto ResultComp : ResultComponents) {
+                UPLATEAUCityObjectGroup* ResultAsCOG = StaticCast<UPLATEAUCityObjectGroup*>(ResultComp);
+                if (ResultAsCOG->GetStaticMesh() == nullptr)
+                    return false;
+
+                if (TargetComponents.Contains(ResultComp)) {
+                    InPlaceCount++;
+                    TestTrue("In-place component is visible", ResultComp->IsVisible());
+                }
+                ResultMaterials.Add(ResultAsCOG->GetMaterial(0));
+            }
+
+            AddInfo("InPlace: " + FString::FromInt(InPlaceCount) + " / " + FString::FromInt(ResultComponents.Num()));
+            TestTrue("Classified in place", InPlaceCount > 0);
+            TestTrue("Material has Attr1", ResultMaterials.Contains(AttrMat1));
+            TestTrue("Material has Attr2", ResultMaterials.Contains(AttrMat2));
+            return true;
+            }));
+
+        }));
+
+    return true;
+}
@@ -87,3 +87,180 @@ bool FPLATEAUTest_Reconstruct_ModelLandscapeAlign::RunTest(const FString& Parame
 
     return true;
 }
+
+namespace FPLATEAUTest_Reconstruct_ModelLandscapeAlignInPlace_Local {
+    const TArray<FName> TargetTags = { "FldComponent", "LsldComponent" };
+    // 再構築経由とその場での高さ合わせで許容する高さの差
+    constexpr double HeightTolerance = 1.0;
+
+    struct FAlignState {
+        // 元のコンポーネント名毎の再構築経由で高さ合わせしたメッシュの範囲
+        TMap<FString, FBox> ReloadedBounds;
+        // 元のコンポーネント名毎の高さ合わせ前のコンポーネントとメッシュの範囲
+        TMap<FString, TWeakObjectPtr<USceneComponent>> Originals;
+        TMap<FString, FBox> OriginalBounds;
+        // 開き直したマップのモデル
+        TWeakObjectPtr<APLATEAUInstancedCityModel> ModelActor;
+    };
+
+    APLATEAUInstancedCityModel* FindModelActor(UWorld* World) {
+        TArray<AActor*> FoundActors;
+        UGameplayStatics::GetAllActorsWithTag(World, "ModelActor", FoundActors);
+        return FoundActors.Num() > 0 ? (APLATEAUInstancedCityModel*)FoundActors[0] : nullptr;
+    }
+
+    FBox GetMeshBounds(USceneComponent* Component) {
+        const auto StaticMeshComponent = Cast<UStaticMeshComponent>(Component);
+        if (StaticMeshComponent == nullptr || StaticMeshComponent->GetStaticMesh() == nullptr)
+            return FBox(ForceInit);
+        return StaticMeshComponent->GetStaticMesh()->GetBoundingBox();
+    }
+
+    TArray<USceneComponent*> GetTargetComponents(APLATEAUInstancedCityModel* ModelActor) {
+        TArray<USceneComponent*> Components;
+        for (const auto& Tag : TargetTags) {
+            for (const auto Component : ModelActor->GetComponentsByTag(UPLATEAUCityObjectGroup::StaticClass(), Tag))
+                Components.Add((USceneComponent*)Component);
+        }
+        return Components;
+    }
+
+    TArray<USceneComponent*> FindByOriginalName(USceneComponent* Parent, const FString& OriginalName) {
+        TArray<USceneComponent*> Children;
+        Parent->GetChildrenComponents(false, Children);
+        return Children.FilterByPredicate([&](USceneComponent* Item) {
+            return IsValid(Item) && FPLATEAUComponentUtil::GetOriginalComponentName(Item) == OriginalName;
+            });
+    }
+
+    ULandscapeLoadEventListener* CreateListener(FPLATEAUAutomationTestBase* TestBase, APLATEAUInstancedCityModel* ModelActor) {
+        ULandscapeLoadEventListener* Listener = NewObject<ULandscapeLoadEventListener>();
+        Listener->AddToRoot();
+        Listener->TestBase = TestBase;
+        FScriptDelegate Delegate;
+        Delegate.BindUFunction(Listener, FName(TEXT("OnLandscapeLoaded")));
+        ModelActor->OnLandscapeCreationFinished.Add(Delegate);
+        return Listener;
+    }
+}
+
+/// <summary>
+/// 元の形状を残さない場合の高さ合わせテスト
+/// 細分化が不要なコンポーネントはその場で高さ合わせされ、作り直されたものと合わせてコンポーネントが重複しないこと
+/// その場で高さ合わせされたメッシュの高さが、元の形状を残して再構築経由で高さ合わせした場合と一致すること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Reconstruct_ModelLandscapeAlignInPlace, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Reconstruct.Terrain.ModelLandscapeAlignInPlace", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_Reconstruct_ModelLandscapeAlignInPlace::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_Reconstruct_ModelLandscapeAlignInPlace_Local;
+    InitializeTest("ModelLandscapeAlignInPlace");
+    if (!OpenMap("SampleLand"))
+        AddError("Failed to OpenMap");
+
+    ADD_LATENT_AUTOMATION_COMMAND(FEngineWaitLatentCommand(1.0f)); //Map読込待機
+
+    APLATEAUInstancedCityModel* ModelActor = FindModelActor(GetWorld());
+    if (ModelActor == nullptr) {
+        AddError(TEXT("0 < FoundActors.Num()"));
+        return false;
+    }
+    if (GetTargetComponents(ModelActor).Num() <= 0) {
+        AddError(TEXT("0 < TargetComponents.Num()"));
+        return false;
+    }
+
+    const auto State = MakeShared<FAlignState>();
+    const FPLATEAULandscapeParam Param = PLATEAUAutomationTestUtil::LandscapeFixtures::CreateLandscapeParam();
+
+    // 元の形状を残して再構築経由で高さ合わせし、基準とする
+    ADD_LATENT_AUTOMATION_COMMAND(FThreadedAutomationLatentCommand([this, ModelActor, Param, State] {
+        const auto Originals = GetTargetComponents(ModelActor);
+        UPLATEAUCityObjectGroup* DemComponent = ModelActor->FindComponentByTag<UPLATEAUCityObjectGroup>("DemComponent");
+        const auto Listener = CreateListener(this, ModelActor);
+        ModelActor->CreateLandscape({ DemComponent }, Param, false);
+
+        ADD_LATENT_AUTOMATION_COMMAND(FEngineWaitLatentCommand(1.0f));
+
+        ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Originals, Listener, State] {
+            if (!Listener->OnCalled)
+                return false;
+            Listener->RemoveFromRoot();
+
+            for (const auto Original : Originals) {
+                const auto OriginalName = FPLATEAUComponentUtil::GetOriginalComponentName(Original);
+                for (const auto Reloaded : FindByOriginalName(Original->GetAttachParent(), OriginalName)) {
+                    if (Reloaded != Original)
+                        State->ReloadedBounds.Add(OriginalName, GetMeshBounds(Reloaded));
+                }
+            }
+            TestTrue("Reloaded components are found", State->ReloadedBounds.Num() > 0);
+            return true;
+            }));
+    }));
+
+    // マップを開き直し、元の形状を残さずに高さ合わせする
+    ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State] {
+        if (!OpenMap("SampleLand"))
+            AddError("Failed to OpenMap");
+        State->ModelActor = FindModelActor(GetWorld());
+        if (!State->ModelActor.IsValid()) {
+            AddError(TEXT("0 < FoundActors.Num()"));
+            return true;
+        }
+
+        for (const auto Original : GetTargetComponents(State->ModelActor.Get())) {
+            const auto OriginalName = FPLATEAUComponentUtil::GetOriginalComponentName(Original);
+            State->Originals.Add(OriginalName, Original);
+            State->OriginalBounds.Add(OriginalName, GetMeshBounds(Original));
+        }
+        return true;
+        }));
+
+    ADD_LATENT_AUTOMATION_COMMAND(FThreadedAutomationLatentCommand([this, Param, State] {
+        APLATEAUInstancedCityModel* ModelActor = State->ModelActor.Get();
+        if (ModelActor == nullptr)
+            return;
+        UPLATEAUCityObjectGroup* DemComponent = ModelActor->FindComponentByTag<UPLATEAUCityObjectGroup>("DemComponent");
+        const auto Listener = CreateListener(this, ModelActor);
+        ModelActor->CreateLandscape({ DemComponent }, Param, true);
+
+        ADD_LATENT_AUTOMATION_COMMAND(FEngineWaitLatentCommand(1.0f));
+
+        ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Listener, State] {
+            if (!Listener->OnCalled)
+                return false;
+            Listener->RemoveFromRoot();
+
+            int32 InPlaceCount = 0;
+            for (const auto& Pair : State->Originals) {
+                const auto Original = Pair.Value.Get();
+                if (Original == nullptr)
+                    continue;
+                const auto Found = FindByOriginalName(Original->GetAttachParent(), Pair.Key);
+                TestEqual(FString::Printf(TEXT("%s is not duplicated"), *Pair.Key), Found.Num(), 1);
+
+                // 同じコンポーネントが残っている場合はその場で高さ合わせされている
+                if (Found.Num() != 1 || Found[0] != Original)
+                    continue;
+                ++InPlaceCount;
+                const auto Bounds = GetMeshBounds(Original);
+                const auto& OriginalBounds = State->OriginalBounds[Pair.Key];
+                TestTrue(FString::Printf(TEXT("Heights of %s are changed"), *Pair.Key),
+                    !FMath::IsNearlyEqual(Bounds.Min.Z, OriginalBounds.Min.Z, HeightTolerance) || !FMath::IsNearlyEqual(Bounds.Max.Z, OriginalBounds.Max.Z, HeightTolerance));
+                if (const auto ReloadedBounds = State->ReloadedBounds.Find(Pair.Key)) {
+                    TestEqual(FString::Printf(TEXT("Min height of %s"), *Pair.Key), Bounds.Min.Z, ReloadedBounds->Min.Z, HeightTolerance);
+                    TestEqual(FString::Printf(TEXT("Max height of %s"), *Pair.Key), Bounds.Max.Z, ReloadedBounds->Max.Z, HeightTolerance);
+                }
+                else {
+                    AddError(FString::Printf(TEXT("Reloaded bounds of %s are not found"), *Pair.Key));
+                }
+            }
+            TestTrue("Some components are aligned in place", InPlaceCount > 0);
+
+            AddInfo("Finish Test");
+            return true;
+            }));
+    }));
+
+    return true;
+}
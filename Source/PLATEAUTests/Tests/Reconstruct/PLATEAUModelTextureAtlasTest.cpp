@@ -0,0 +1,195 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "Reconstruct/PLATEAUModelTextureAtlas.h"
+#include "PLATEAUInstancedCityModel.h"
+#include "PLATEAUTextureLoader.h"
+#include "PLATEAUMeshExporter.h"
+#include "PLATEAUExportSettings.h"
+#include "Component/PLATEAUCityObjectGroup.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+
+namespace FPLATEAUTest_Reconstruct_ModelTextureAtlas_Local {
+    constexpr int32 TextureSize = 16;
+
+    UTexture2D* CreateTexture(const FColor& Color) {
+        const auto Texture = NewObject<UTexture2D>(GetTransientPackage(), NAME_None, RF_Transient);
+        TArray<FColor> Pixels;
+        Pixels.Init(Color, TextureSize * TextureSize);
+        Texture->Source.Init(TextureSize, TextureSize, 1, 1, ETextureSourceFormat::TSF_BGRA8, reinterpret_cast<const uint8*>(Pixels.GetData()));
+        return Texture;
+    }
+
+    UMaterialInstanceDynamic* CreateMaterial(AActor* Actor, UTexture2D* Texture) {
+        const auto SourceMaterialPath = TEXT("/PLATEAU-SDK-for-Unreal/Materials/PLATEAUX3DMaterial");
+        UMaterial* Base = Cast<UMaterial>(StaticLoadObject(UMaterial::StaticClass(), nullptr, SourceMaterialPath));
+        const auto Material = UMaterialInstanceDynamic::Create(Base, Actor);
+        Material->SetTextureParameterValue("Texture", Texture);
+        return Material;
+    }
+
+    /**
+     * @brief PolygonGroup毎に1枚の四角形を持つStaticMeshを作成します。UVは0~UVScaleです。
+     */
+    UStaticMesh* CreateStaticMesh(AActor* Actor, const FName Name, const TArray<UMaterialInterface*>& Materials, const float UVScale) {
+        const auto StaticMesh = NewObject<UStaticMesh>(Actor, Name);
+        StaticMesh->AddSourceModel();
+        FMeshDescription* MeshDescription = StaticMesh->CreateMeshDescription(0);
+        FStaticMeshAttributes Attributes(*MeshDescription);
+        const auto Positions = Attributes.GetVertexPositions();
+        const auto Normals = Attributes.GetVertexInstanceNormals();
+        const auto UVs = Attributes.GetVertexInstanceUVs();
+
+        for (int32 i = 0; i < Materials.Num(); ++i) {
+            const FPolygonGroupID PolygonGroupID = MeshDescription->CreatePolygonGroup();
+            const FVector2f Corners[] = { FVector2f(0, 0), FVector2f(0, 1), FVector2f(1, 1), FVector2f(1, 0) };
+            TArray<FVertexInstanceID> VertexInstanceIDs;
+            for (const auto& Corner : Corners) {
+                const FVertexID VertexID = MeshDescription->CreateVertex();
+                Positions[VertexID] = FVector3f(Corner.X * 100 + i * 200, Corner.Y * 100, 0);
+                const FVertexInstanceID VertexInstanceID = MeshDescription->CreateVertexInstance(VertexID);
+                Normals[VertexInstanceID] = FVector3f(0, 0, 1);
+                UVs.Set(VertexInstanceID, 0, Corner * UVScale);
+                VertexInstanceIDs.Add(VertexInstanceID);
+            }
+            MeshDescription->CreatePolygon(PolygonGroupID, VertexInstanceIDs);
+            StaticMesh->AddMaterial(Materials[i]);
+        }
+        StaticMesh->CommitMeshDescription(0);
+        StaticMesh->Build(true);
+        return StaticMesh;
+    }
+
+    UPLATEAUCityObjectGroup* CreateComponent(AActor* Actor, UStaticMesh* StaticMesh) {
+        const auto Component = NewObject<UPLATEAUCityObjectGroup>(Actor);
+        Component->SetStaticMesh(StaticMesh);
+        Actor->AddInstanceComponent(Component);
+        Component->RegisterComponent();
+        Component->AttachToComponent(Actor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+        return Component;
+    }
+
+    FBox2f GetUVBounds(const UStaticMesh* StaticMesh) {
+        const FMeshDescription& MeshDescription = *StaticMesh->GetMeshDescription(0);
+        const auto UVs = FStaticMeshConstAttributes(MeshDescription).GetVertexInstanceUVs();
+        FBox2f Bounds(ForceInit);
+        for (const FVertexInstanceID VertexInstanceID : MeshDescription.VertexInstances().GetElementIDs())
+            Bounds += UVs.Get(VertexInstanceID, 0);
+        return Bounds;
+    }
+
+    // テストで作成したテクスチャのアセットと画像ファイルを削除する
+    void DeleteTextureAsset(UTexture2D* Texture) {
+        if (Texture == nullptr)
+            return;
+        const auto SourceFilePath = Texture->GetPackage()->GetLoadedPath().GetLocalFullPath();
+        const auto PackageFileName = FPackageName::LongPackageNameToFilename(Texture->GetPackage()->GetName(), FPackageName::GetAssetPackageExtension());
+        Texture->ClearFlags(RF_Public | RF_Standalone);
+        IFileManager::Get().Delete(*PackageFileName, false, true, true);
+        IFileManager::Get().Delete(*SourceFilePath, false, true, true);
+    }
+}
+
+/// <summary>
+/// GMLをまたいだテクスチャがアトラスにまとめられ、同一となったマテリアルが共有・セクションが結合されること
+/// 繰り返し貼られるテクスチャはアトラスに含まれないこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Reconstruct_ModelTextureAtlas, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Reconstruct.TextureAtlas", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_Reconstruct_ModelTextureAtlas::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_Reconstruct_ModelTextureAtlas_Local;
+    InitializeTest("Reconstruct.TextureAtlas");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    const auto ModelActor = GetWorld()->SpawnActor<APLATEAUInstancedCityModel>();
+    const auto Root = NewObject<USceneComponent>(ModelActor, USceneComponent::GetDefaultSceneRootVariableName());
+    ModelActor->SetRootComponent(Root);
+    Root->RegisterComponent();
+
+    const auto Red = CreateTexture(FColor::Red);
+    const auto Green = CreateTexture(FColor::Green);
+    const auto Blue = CreateTexture(FColor::Blue);
+
+    // 別GMLのメッシュを想定し、同じテクスチャでも別のマテリアルとする
+    const auto MeshA = CreateStaticMesh(ModelActor, "MeshA", { CreateMaterial(ModelActor, Red), CreateMaterial(ModelActor, Green) }, 1.0f);
+    const auto MeshB = CreateStaticMesh(ModelActor, "MeshB", { CreateMaterial(ModelActor, Red) }, 1.0f);
+    const auto MeshTiled = CreateStaticMesh(ModelActor, "MeshTiled", { CreateMaterial(ModelActor, Blue) }, 2.0f);
+    const auto ComponentA = CreateComponent(ModelActor, MeshA);
+    const auto ComponentB = CreateComponent(ModelActor, MeshB);
+    const auto ComponentTiled = CreateComponent(ModelActor, MeshTiled);
+
+    FPLATEAUModelTextureAtlas TextureAtlas(ModelActor);
+    TextureAtlas.AtlasSize = 64;
+    TextureAtlas.Padding = 2;
+    const auto Result = TextureAtlas.Execute();
+    AddInfo(Result.ToString());
+
+    TestEqual("MaterialCountBefore", Result.MaterialCountBefore, 4);
+    TestEqual("TextureCountBefore", Result.TextureCountBefore, 3);
+    TestEqual("SectionCountBefore", Result.SectionCountBefore, 4);
+    TestEqual("AtlasCount", Result.AtlasCount, 1);
+    TestEqual("AtlasedTextureCount", Result.AtlasedTextureCount, 2);
+    // アトラス化したマテリアル1つと繰り返しテクスチャのマテリアル
+    TestEqual("MaterialCountAfter", Result.MaterialCountAfter, 2);
+    TestEqual("TextureCountAfter", Result.TextureCountAfter, 2);
+    TestEqual("SectionCountAfter", Result.SectionCountAfter, 3);
+
+    TestEqual("Sections of MeshA are merged", MeshA->GetNumSections(0), 1);
+    TestTrue("Material is shared", ComponentA->GetMaterial(0) == ComponentB->GetMaterial(0));
+    TestTrue("Tiled material is kept", ComponentTiled->GetMaterial(0) != ComponentA->GetMaterial(0));
+
+    UTexture* AtlasTexture = nullptr;
+    ComponentA->GetMaterial(0)->GetTextureParameterValue(FHashedMaterialParameterInfo("Texture"), AtlasTexture, true);
+    TestTrue("Atlas texture is set", AtlasTexture != nullptr && AtlasTexture->GetName().StartsWith(FPLATEAUModelTextureAtlas::AtlasTexturePrefix));
+
+    // 2枚のテクスチャがアトラス内の別の領域となる
+    const auto BoundsA = GetUVBounds(MeshA);
+    const auto BoundsB = GetUVBounds(MeshB);
+    TestTrue("UVs of MeshA are in atlas", BoundsA.Min.X >= 0 && BoundsA.Min.Y >= 0 && BoundsA.Max.X <= 1 && BoundsA.Max.Y <= 1);
+    TestTrue("UVs of MeshB are a part of atlas", BoundsB.GetSize().X < 0.5f);
+    TestTrue("UVs of MeshA span two textures", BoundsB.GetSize().X < BoundsA.GetSize().X);
+    TestEqual("Tiled UVs are kept", GetUVBounds(MeshTiled).Max.X, 2.0f);
+
+    // アトラス化後もエクスポート時にテクスチャが参照できる
+    FPLATEAUMeshExporter MeshExporter;
+    FPLATEAUMeshExportOptions ExportOptions;
+    ExportOptions.bExportHiddenObjects = false;
+    ExportOptions.bExportTexture = true;
+    ExportOptions.TransformType = EMeshTransformType::Local;
+    ExportOptions.CoordinateSystem = ECoordinateSystem::ESU;
+    const auto ExportedModel = MeshExporter.CreateModelFromComponents(ModelActor, { ComponentA, ComponentB }, ExportOptions);
+    int32 ExportedSubMeshCount = 0;
+    for (const auto& Mesh : ExportedModel->getAllMeshes()) {
+        for (const auto& SubMesh : Mesh->getSubMeshes()) {
+            const FString TexturePath = UTF8_TO_TCHAR(SubMesh.getTexturePath().c_str());
+            TestTrue(FString::Printf(TEXT("Exported texture exists: %s"), *TexturePath), !TexturePath.IsEmpty() && FPaths::FileExists(TexturePath));
+            ++ExportedSubMeshCount;
+        }
+    }
+    TestEqual("Exported sub meshes", ExportedSubMeshCount, 2);
+
+    // 同名のテクスチャアセットを作成しても既存のアトラスは上書きされない
+    const auto AtlasTexture2D = Cast<UTexture2D>(AtlasTexture);
+    if (AtlasTexture2D != nullptr) {
+        const auto AtlasWidth = AtlasTexture2D->Source.GetSizeX();
+        TArray64<uint8> Pixels;
+        Pixels.SetNumZeroed(4 * 4 * 4);
+        const auto SourceDirectory = FPaths::GetPath(AtlasTexture2D->GetPackage()->GetLoadedPath().GetLocalFullPath());
+        const auto SameNameTexture = FPLATEAUTextureLoader::CreateTextureAsset(AtlasTexture2D->GetName(), 4, 4, Pixels, SourceDirectory);
+        TestTrue("Texture with same name is a new asset", SameNameTexture != nullptr && SameNameTexture != AtlasTexture2D);
+        TestTrue("Texture name is unique", SameNameTexture != nullptr && SameNameTexture->GetPathName() != AtlasTexture2D->GetPathName());
+        TestEqual("Atlas texture is kept", AtlasTexture2D->Source.GetSizeX(), AtlasWidth);
+
+        DeleteTextureAsset(SameNameTexture);
+        DeleteTextureAsset(AtlasTexture2D);
+    }
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,312 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "../Benchmark/PLATEAUBenchmarkUtil.h"
+#include "RoadNetwork/CityObject/SubDividedCityObject.h"
+#include "RoadNetwork/GeoGraph/GeoGraph2d.h"
+
+
+namespace FPLATEAUTest_GeoGraph2D_Local {
+    /**
+     * @brief Size x Size のグリッドから Holes のセルを抜いたメッシュの三角形配列を作成します。
+     */
+    TArray<int32> CreateGridTriangles(const int32 Size, const TSet<FIntPoint>& Holes, const int32 VertexOffset = 0) {
+        TArray<int32> Triangles;
+        const int32 Row = Size + 1;
+        for (int32 y = 0; y < Size; ++y) {
+            for (int32 x = 0; x < Size; ++x) {
+                if (Holes.Contains(FIntPoint(x, y)))
+                    continue;
+                const int32 V00 = VertexOffset + y * Row + x;
+                const int32 V01 = V00 + 1;
+                const int32 V10 = V00 + Row;
+                const int32 V11 = V10 + 1;
+                Triangles.Append({ V00, V10, V01, V01, V10, V11 });
+            }
+        }
+        return Triangles;
+    }
+
+    TArray<FVector> CreateGridVertices(const int32 Size, const int32 Count) {
+        TArray<FVector> Vertices;
+        for (int32 i = 0; i < Count; ++i)
+            Vertices.Add(FVector(i % (Size + 1), i / (Size + 1), i / ((Size + 1) * (Size + 1))));
+        return Vertices;
+    }
+
+    void ShuffleTriangles(TArray<int32>& Triangles, const int32 Seed) {
+        FRandomStream Random(Seed);
+        for (int32 i = Triangles.Num() / 3 - 1; i > 0; --i) {
+            const int32 j = Random.RandRange(0, i);
+            for (int32 k = 0; k < 3; ++k)
+                Triangles.Swap(i * 3 + k, j * 3 + k);
+        }
+    }
+
+    /**
+     * @brief 辺配列を毎回先頭から検索する輪郭線作成(比較用)
+     */
+    TArray<TArray<int32>> CreateOutlineIndicesBruteForce(const TArray<int32>& Triangles) {
+        TArray<TArray<int32>> Result;
+        TMap<TTuple<int32, int32>, int32> Edge2Triangle;
+        for (int32 i = 0; i < Triangles.Num(); i += 3) {
+            for (int32 x = 0; x < 3; ++x) {
+                int32 A = Triangles[i + x];
+                int32 B = Triangles[i + (x + 1) % 3];
+                if (A < B)
+                    Swap(A, B);
+                const auto E = MakeTuple(A, B);
+                if (Edge2Triangle.Contains(E) == false)
+                    Edge2Triangle.Add(E, i / 3);
+                else if (Edge2Triangle[E] != i / 3)
+                    Edge2Triangle[E] = -1;
+            }
+        }
+        TArray<TTuple<int32, int32>> OutlineEdges;
+        for (auto& E : Edge2Triangle) {
+            if (E.Value >= 0)
+                OutlineEdges.Add(E.Key);
+        }
+        while (OutlineEdges.Num() > 0) {
+            const auto Edge = OutlineEdges[0];
+            OutlineEdges.RemoveAt(0);
+            auto Indices = TArray<int32>{ Edge.Key, Edge.Value };
+            while (OutlineEdges.Num() > 0) {
+                const auto V0 = Indices[0];
+                const auto LastV = Indices.Last();
+                const auto Index = OutlineEdges.IndexOfByPredicate([LastV](const TTuple<int32, int32>& E) { return E.Key == LastV || E.Value == LastV; });
+                if (Index < 0)
+                    break;
+                const auto E = OutlineEdges[Index];
+                OutlineEdges.RemoveAt(Index);
+                if (E.Key == V0 || E.Value == V0)
+                    break;
+                Indices.Add(E.Key == LastV ? E.Value : E.Key);
+            }
+            Result.Add(Indices);
+        }
+        return Result;
+    }
+
+    TArray<FVector> ComputeMeshOutlineVerticesBruteForce(const TArray<FVector>& Vert, const TArray<int32>& Triangles) {
+        TArray<TTuple<int32, int32>> Edges;
+        for (int32 i = 0; i < Triangles.Num(); i += 3) {
+            Edges.Add(MakeTuple(Triangles[i], Triangles[i + 1]));
+            Edges.Add(MakeTuple(Triangles[i + 1], Triangles[i + 2]));
+            Edges.Add(MakeTuple(Triangles[i + 2], Triangles[i]));
+        }
+        auto Normalize = [](const TTuple<int32, int32>& E) {
+            return E.Get<0>() < E.Get<1>() ? E : MakeTuple(E.Get<1>(), E.Get<0>());
+        };
+        TMap<TTuple<int32, int32>, int32> EdgeCount;
+        for (const auto& Edge : Edges)
+            EdgeCount.FindOrAdd(Normalize(Edge))++;
+        TArray<TTuple<int32, int32>> OutlineEdges;
+        for (const auto& Edge : Edges) {
+            if (EdgeCount[Normalize(Edge)] == 1)
+                OutlineEdges.Add(Edge);
+        }
+        TArray<FVector> Result;
+        if (OutlineEdges.Num() == 0)
+            return Result;
+        int32 CurrentVertex = OutlineEdges[0].Get<0>();
+        Result.Add(Vert[CurrentVertex]);
+        while (OutlineEdges.Num() > 0) {
+            bool Found = false;
+            for (int32 i = 0; i < OutlineEdges.Num(); ++i) {
+                if (OutlineEdges[i].Get<0>() == CurrentVertex || OutlineEdges[i].Get<1>() == CurrentVertex) {
+                    CurrentVertex = OutlineEdges[i].Get<0>() == CurrentVertex ? OutlineEdges[i].Get<1>() : OutlineEdges[i].Get<0>();
+                    Result.Add(Vert[CurrentVertex]);
+                    OutlineEdges.RemoveAt(i);
+                    Found = true;
+                    break;
+                }
+            }
+            if (!Found)
+                break;
+        }
+        return Result;
+    }
+
+    /**
+     * @brief Count個の頂点を, Epsilon程度の揺らぎを持つクラスタとして平面上に配置します。凸包上にも多数の点が来るよう円周上にも配置します。
+     */
+    TArray<FVector> CreateClusteredVertices(const int32 Count, const float Epsilon, const int32 Seed) {
+        FRandomStream Random(Seed);
+        TArray<FVector> Vertices;
+        Vertices.Reserve(Count);
+        const float Radius = FMath::Sqrt(static_cast<float>(Count)) * Epsilon * 4.f;
+        while (Vertices.Num() < Count) {
+            FVector Center;
+            if (Random.FRand() < 0.2f) {
+                const float Angle = Random.FRandRange(0.f, 2.f * PI);
+                Center = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Radius;
+            }
+            else {
+                Center = FVector(Random.FRandRange(-Radius, Radius), Random.FRandRange(-Radius, Radius), Random.FRandRange(-Epsilon, Epsilon)) * 0.7f;
+            }
+            const int32 ClusterSize = Random.RandRange(1, 4);
+            for (int32 i = 0; i < ClusterSize && Vertices.Num() < Count; ++i)
+                Vertices.Add(Center + Random.GetUnitVector() * Random.FRandRange(0.f, Epsilon * 1.5f));
+        }
+        // 2D座標が同じで高さだけ異なる頂点
+        for (int32 i = 0; i < Count / 10; ++i) {
+            const auto& V = Vertices[Random.RandRange(0, Vertices.Num() - 1)];
+            Vertices.Add(FVector(V.X, V.Y, V.Z + 1.f));
+        }
+        return Vertices;
+    }
+
+    /**
+     * @brief 凸包の各点を全頂点の走査で元の頂点に戻す(比較用)
+     */
+    TArray<FVector> ComputeConvexVolumeBruteForce(const TArray<FVector>& Vertices, TFunction<FVector2D(const FVector&)> ToVec2) {
+        TArray<FVector2D> Points2D;
+        for (const auto& V : Vertices)
+            Points2D.Add(ToVec2(V));
+        TArray<FVector> Result;
+        for (const auto& Point2D : FGeoGraph2D::ComputeConvexVolume(Points2D)) {
+            for (const auto& Vertex : Vertices) {
+                if (FVector2D::Distance(ToVec2(Vertex), Point2D) < FGeoGraph2D::Eps) {
+                    Result.Add(Vertex);
+                    break;
+                }
+            }
+        }
+        return Result;
+    }
+
+    FVector2D ToXY(const FVector& V) {
+        return FVector2D(V.X, V.Y);
+    }
+
+    float CalcDistance(const FVector& A, const FVector& B) {
+        return FVector::Distance(A, B);
+    }
+}
+
+/// <summary>
+/// 輪郭線の抽出が辺配列を毎回検索していた時と同じ結果を返すこと
+/// 複数ループ(穴あき・複数の島)と、頂点のみで接するピンチ頂点を含む
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_Outline, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.GeoGraph2D.Outline", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_GeoGraph2D_Outline::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_GeoGraph2D_Local;
+    InitializeTest("GeoGraph2D.Outline");
+
+    constexpr int32 Size = 16;
+    TArray<TTuple<FString, TArray<int32>>> Cases;
+    Cases.Add(MakeTuple(FString(TEXT("Grid")), CreateGridTriangles(Size, {})));
+    Cases.Add(MakeTuple(FString(TEXT("Holes")), CreateGridTriangles(Size, { FIntPoint(3, 3), FIntPoint(8, 4), FIntPoint(9, 4), FIntPoint(12, 12) })));
+    // (4,4)と(5,5)の間の穴は頂点を共有するピンチ頂点になる
+    Cases.Add(MakeTuple(FString(TEXT("Pinch")), CreateGridTriangles(Size, { FIntPoint(4, 4), FIntPoint(5, 5) })));
+    {
+        auto Islands = CreateGridTriangles(Size, { FIntPoint(2, 2) });
+        Islands.Append(CreateGridTriangles(4, {}, (Size + 1) * (Size + 1)));
+        Cases.Add(MakeTuple(FString(TEXT("Islands")), Islands));
+    }
+    // 2つの三角形が1頂点だけで接する
+    Cases.Add(MakeTuple(FString(TEXT("Bowtie")), TArray<int32>{ 0, 1, 2, 2, 3, 4 }));
+
+    for (const int32 Seed : { 0, 1, 2 }) {
+        for (const auto& [Name, SourceTriangles] : Cases) {
+            auto Triangles = SourceTriangles;
+            if (Seed != 0)
+                ShuffleTriangles(Triangles, Seed);
+
+            FSubDividedCityObjectSubMesh SubMesh;
+            SubMesh.Triangles = Triangles;
+            const auto Actual = SubMesh.CreateOutlineIndices();
+            const auto Expected = CreateOutlineIndicesBruteForce(Triangles);
+            TestTrue(FString::Printf(TEXT("CreateOutlineIndices %s (Seed %d)"), *Name, Seed), Actual == Expected);
+
+            int32 MaxIndex = 0;
+            for (const auto Index : Triangles)
+                MaxIndex = FMath::Max(MaxIndex, Index);
+            const auto Vertices = CreateGridVertices(Size, MaxIndex + 1);
+            const auto ActualVertices = FGeoGraph2D::ComputeMeshOutlineVertices(Vertices, Triangles, [](const FVector& V) { return FVector2D(V.X, V.Y); });
+            const auto ExpectedVertices = ComputeMeshOutlineVerticesBruteForce(Vertices, Triangles);
+            TestTrue(FString::Printf(TEXT("ComputeMeshOutlineVertices %s (Seed %d)"), *Name, Seed), ActualVertices == ExpectedVertices);
+        }
+    }
+
+    FSubDividedCityObjectSubMesh Holes;
+    Holes.Triangles = CreateGridTriangles(Size, { FIntPoint(3, 3), FIntPoint(12, 12) });
+    TestEqual("Loop count", Holes.CreateOutlineIndices().Num(), 3);
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// グリッドを使ったGetNearVertexTable・インデックスを保持する凸包が従来の総当たりと同じ結果を返すこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_NearVertexAndConvex, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.GeoGraph2D.NearVertexAndConvex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_GeoGraph2D_NearVertexAndConvex::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_GeoGraph2D_Local;
+    InitializeTest("GeoGraph2D.NearVertexAndConvex");
+
+    constexpr float Epsilon = 0.1f;
+    for (const int32 Seed : { 1, 2, 3 }) {
+        const auto Vertices = CreateClusteredVertices(3000, Epsilon, Seed);
+        const auto Expected = FGeoGraph2D::GetNearVertexTable(Vertices, CalcDistance, Epsilon);
+        const auto Actual = FGeoGraph2D::GetNearVertexTable(Vertices, Epsilon);
+        TestTrue(FString::Printf(TEXT("GetNearVertexTable (Seed %d)"), Seed), Actual == Expected);
+
+        const auto ExpectedHull = ComputeConvexVolumeBruteForce(Vertices, ToXY);
+        const auto ActualHull = FGeoGraph2D::ComputeConvexVolume(Vertices, ToXY);
+        TestTrue(FString::Printf(TEXT("ComputeConvexVolume (Seed %d)"), Seed), ActualHull == ExpectedHull);
+    }
+
+    // 同じ位置の頂点は前の頂点にまとめられる
+    const TArray<FVector> Same = { FVector(0, 0, 0), FVector(1, 0, 0), FVector(0, 0, 0), FVector(1, 0, 0.05f) };
+    TestTrue("Same position", FGeoGraph2D::GetNearVertexTable(Same, Epsilon) == TArray<int32>({ 0, 1, 0, 1 }));
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// 100k頂点に対するGetNearVertexTable・ComputeConvexVolumeの計測
+/// 結果は Saved/PLATEAUBenchmark/GeoGraph2D.json に出力されます。
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_GeoGraph2D_Benchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Benchmark.GeoGraph2D", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_GeoGraph2D_Benchmark::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_GeoGraph2D_Local;
+    InitializeTest("Benchmark.GeoGraph2D");
+
+    constexpr float Epsilon = 0.1f;
+    PLATEAUBenchmarkUtil::FBenchmarkReport Report(TEXT("GeoGraph2D"));
+    for (const int32 VertexCount : { 1000, 10000, 100000 }) {
+        const auto Vertices = CreateClusteredVertices(VertexCount, Epsilon, VertexCount);
+
+        Report.BeginStage(FString::Printf(TEXT("NearVertexTableBruteForce%d"), VertexCount));
+        const auto Expected = FGeoGraph2D::GetNearVertexTable(Vertices, CalcDistance, Epsilon);
+        Report.EndStage({ { TEXT("Vertices"), Vertices.Num() } });
+        Report.BeginStage(FString::Printf(TEXT("NearVertexTable%d"), VertexCount));
+        const auto Actual = FGeoGraph2D::GetNearVertexTable(Vertices, Epsilon);
+        Report.EndStage({ { TEXT("Vertices"), Vertices.Num() } });
+        TestTrue(FString::Printf(TEXT("GetNearVertexTable unchanged (%d)"), VertexCount), Actual == Expected);
+
+        Report.BeginStage(FString::Printf(TEXT("ConvexVolumeBruteForce%d"), VertexCount));
+        const auto ExpectedHull = ComputeConvexVolumeBruteForce(Vertices, ToXY);
+        Report.EndStage({ { TEXT("HullVertices"), ExpectedHull.Num() } });
+        Report.BeginStage(FString::Printf(TEXT("ConvexVolume%d"), VertexCount));
+        const auto ActualHull = FGeoGraph2D::ComputeConvexVolume(Vertices, ToXY);
+        Report.EndStage({ { TEXT("HullVertices"), ActualHull.Num() } });
+        TestTrue(FString::Printf(TEXT("ComputeConvexVolume unchanged (%d)"), VertexCount), ActualHull == ExpectedHull);
+    }
+
+    for (const auto& Stage : Report.GetStages()) {
+        AddInfo(FString::Printf(TEXT("%s: %.4f s"), *Stage.Name, Stage.Seconds));
+    }
+    FString ReportPath;
+    if (Report.Save(ReportPath))
+        AddInfo(FString::Printf(TEXT("Report: %s"), *ReportPath));
+
+    FinishTest(true, "");
+    return true;
+}
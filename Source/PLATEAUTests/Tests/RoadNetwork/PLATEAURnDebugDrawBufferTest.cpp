@@ -0,0 +1,43 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/Util/PLATEAURnDebugEx.h"
+
+
+/// <summary>
+/// 記録先が設定されている間はデバッグ描画が記録され、解除後は記録されないこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnDebugDrawBuffer_Capture, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RnDebugDrawBuffer.Capture", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnDebugDrawBuffer_Capture::RunTest(const FString& Parameters) {
+    InitializeTest("RnDebugDrawBuffer.Capture");
+
+    FPLATEAURnDebugDrawBuffer Buffer;
+    FPLATEAURnDebugEx::SetCaptureBuffer(&Buffer);
+    TestTrue("Capturing", FPLATEAURnDebugEx::GetCaptureBuffer() == &Buffer);
+
+    FPLATEAURnDebugEx::DrawLine(FVector::ZeroVector, FVector(100, 0, 0), FLinearColor::Red);
+    // 本体と矢じりの2本
+    FPLATEAURnDebugEx::DrawArrow(FVector::ZeroVector, FVector(0, 100, 0), FLinearColor::Blue);
+    FPLATEAURnDebugEx::DrawLines({ FVector(0, 0, 0), FVector(100, 0, 0), FVector(100, 100, 0) }, true);
+    FPLATEAURnDebugEx::DrawString(TEXT("Label"), FVector(50, 50, 0));
+    FPLATEAURnDebugEx::SetCaptureBuffer(nullptr);
+
+    TestEqual("Lines", Buffer.Lines.Num(), 1 + 3 + 3);
+    TestEqual("Labels", Buffer.Labels.Num(), 1);
+    if (Buffer.Lines.Num() > 0) {
+        TestEqual("Line start", Buffer.Lines[0].Start, FVector::ZeroVector);
+        TestEqual("Line end", Buffer.Lines[0].End, FVector(100, 0, 0));
+        TestEqual("Line color", Buffer.Lines[0].Color, FLinearColor(FLinearColor::Red.ToFColor(true)));
+    }
+    if (Buffer.Labels.Num() > 0) {
+        TestEqual("Label text", Buffer.Labels[0].Text, FString(TEXT("Label")));
+        TestEqual("Label mask", Buffer.Labels[0].Mask, 0);
+    }
+
+    FPLATEAURnDebugEx::DrawLine(FVector::ZeroVector, FVector(100, 0, 0));
+    TestEqual("Not captured after reset", Buffer.Lines.Num(), 1 + 3 + 3);
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,58 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "PLATEAURnTestUtil.h"
+#include "RoadNetwork/Structure/PLATEAURnModelDrawerDebug.h"
+
+
+/// <summary>
+/// 保持モードの描画内容は道路構造を変更した場合のみ作り直されること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModelDrawerDebug_RebuildOnModify, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RnModelDrawerDebug.RebuildOnModify", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModelDrawerDebug_RebuildOnModify::RunTest(const FString& Parameters) {
+    InitializeTest("RnModelDrawerDebug.RebuildOnModify");
+    if (!OpenNewMap())
+        AddError("Failed to OpenNewMap");
+
+    const auto Owner = GetWorld()->SpawnActor<AActor>();
+    const auto Model = URnModel::Create();
+    const auto Prev = URnIntersection::Create();
+    const auto Next = URnIntersection::Create();
+    Model->AddIntersection(Prev);
+    Model->AddIntersection(Next);
+    const auto Road = PLATEAURnTestUtil::CreateStraightRoad(Model, Prev, Next, 0, 5000);
+
+    FPLATEAURnModelDrawerDebug Drawer;
+    Drawer.bVisible = true;
+    Drawer.DrawRetained(Owner, Model);
+    TestEqual("Built on first draw", Drawer.GetRetainedBuildCount(), 1);
+    Drawer.DrawRetained(Owner, Model);
+    TestEqual("Kept without modification", Drawer.GetRetainedBuildCount(), 1);
+
+    // レーンの直接編集
+    auto Version = Model->GetModifiedVersion();
+    Road->GetMainLanes()[0]->Reverse();
+    TestTrue("Lane edit is recorded", Model->GetModifiedVersion() != Version);
+    Drawer.DrawRetained(Owner, Model);
+    TestEqual("Rebuilt after lane edit", Drawer.GetRetainedBuildCount(), 2);
+
+    // 道路の直接編集
+    Version = Model->GetModifiedVersion();
+    Road->SetPrevNext(Next, Prev);
+    TestTrue("Road edit is recorded", Model->GetModifiedVersion() != Version);
+    Drawer.DrawRetained(Owner, Model);
+    TestEqual("Rebuilt after road edit", Drawer.GetRetainedBuildCount(), 3);
+
+    // 交差点の直接編集
+    Version = Model->GetModifiedVersion();
+    Next->RemoveEdges(Road);
+    TestTrue("Intersection edit is recorded", Model->GetModifiedVersion() != Version);
+    Drawer.DrawRetained(Owner, Model);
+    TestEqual("Rebuilt after intersection edit", Drawer.GetRetainedBuildCount(), 4);
+
+    Drawer.ClearRetained();
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,66 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "PLATEAURnTestUtil.h"
+#include "RoadNetwork/Structure/RnRoadGroup.h"
+
+
+/// <summary>
+/// 編集トランザクション中のレーン数変更ではトラックが再生成されず、
+/// コミット時に影響を受けた交差点ごとに1回ずつ再生成されること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnModel_EditTransaction, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RnModel.EditTransaction", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnModel_EditTransaction::RunTest(const FString& Parameters) {
+    InitializeTest("RnModel.EditTransaction");
+
+    // A - R0 - B - R1 - C. 交差点Bを2つの道路グループが共有する
+    const auto Model = URnModel::Create();
+    const auto A = URnIntersection::Create();
+    const auto B = URnIntersection::Create();
+    const auto C = URnIntersection::Create();
+    for (const auto Intersection : { A, B, C })
+        Model->AddIntersection(Intersection);
+    const auto R0 = PLATEAURnTestUtil::CreateStraightRoad(Model, A, B, 0, 5000);
+    const auto R1 = PLATEAURnTestUtil::CreateStraightRoad(Model, B, C, 6000, 11000);
+    const auto G0 = RnNew<URnRoadGroup>(A, B, TArray<URnRoad*>{ R0 });
+    const auto G1 = RnNew<URnRoadGroup>(B, C, TArray<URnRoad*>{ R1 });
+
+    FRnModelEditCommitResult Result;
+    {
+        FRnModelEditScope EditScope(Model);
+        G0->SetLaneCount(2, 0);
+        G1->SetLaneCount(2, 0);
+        G1->SetLaneCount(3, 0);
+        TestTrue("In transaction", Model->IsInEditTransaction());
+        TestEqual("Tracks are deferred", B->GetTracks().Num(), 0);
+        Result = EditScope.Commit();
+    }
+    TestFalse("Transaction is closed", Model->IsInEditTransaction());
+
+    TestEqual("Left lane count of G0", G0->GetLeftLaneCount(), 2);
+    TestEqual("Left lane count of G1", G1->GetLeftLaneCount(), 3);
+    // A, B, Cがそれぞれ1回ずつ
+    TestEqual("RebuiltIntersectionCount", Result.RebuiltIntersectionCount, 3);
+    // AとCは独立, BはA, Cと道路を共有する
+    TestEqual("IntersectionGroupCount", Result.IntersectionGroupCount, 2);
+    TestEqual("AdjustedRoadGroupCount", Result.AdjustedRoadGroupCount, 0);
+
+    // 入れ子のトランザクションは最も外側のコミットで反映される
+    {
+        FRnModelEditScope Outer(Model);
+        FRnModelEditCommitResult InnerResult;
+        {
+            FRnModelEditScope Inner(Model);
+            G0->SetLaneCount(1, 0);
+            InnerResult = Inner.Commit();
+        }
+        TestEqual("Inner commit does not rebuild", InnerResult.RebuiltIntersectionCount, 0);
+        TestTrue("Still in transaction", Model->IsInEditTransaction());
+        Result = Outer.Commit();
+    }
+    TestEqual("RebuiltIntersectionCount of nested transaction", Result.RebuiltIntersectionCount, 2);
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,40 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#pragma once
+#include "CoreMinimal.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnLane.h"
+#include "RoadNetwork/Structure/RnLineString.h"
+#include "RoadNetwork/Structure/RnModel.h"
+#include "RoadNetwork/Structure/RnPoint.h"
+#include "RoadNetwork/Structure/RnRoad.h"
+#include "RoadNetwork/Structure/RnWay.h"
+
+//道路ネットワークのテスト用共通処理
+namespace PLATEAURnTestUtil {
+
+    /// <summary>
+    /// X軸方向にStartXからEndXまで伸びる幅Widthの1車線道路を作成し、Prev/Nextの交差点と接続してModelに追加する
+    /// </summary>
+    inline URnRoad* CreateStraightRoad(URnModel* Model, URnIntersection* Prev, URnIntersection* Next, const float StartX, const float EndX, const float Width = 600.0f) {
+        const auto L0 = RnNew<URnPoint>(FVector(StartX, -Width * 0.5f, 0));
+        const auto L1 = RnNew<URnPoint>(FVector(EndX, -Width * 0.5f, 0));
+        const auto R0 = RnNew<URnPoint>(FVector(StartX, Width * 0.5f, 0));
+        const auto R1 = RnNew<URnPoint>(FVector(EndX, Width * 0.5f, 0));
+
+        const auto LeftWay = RnNew<URnWay>(URnLineString::Create(TArray<URnPoint*>{ L0, L1 }));
+        const auto RightWay = RnNew<URnWay>(URnLineString::Create(TArray<URnPoint*>{ R0, R1 }));
+        const auto PrevBorder = RnNew<URnWay>(URnLineString::Create(TArray<URnPoint*>{ L0, R0 }));
+        const auto NextBorder = RnNew<URnWay>(URnLineString::Create(TArray<URnPoint*>{ L1, R1 }));
+
+        const auto Road = URnRoad::Create();
+        Road->AddMainLane(RnNew<URnLane>(LeftWay, RightWay, PrevBorder, NextBorder));
+        Road->SetPrevNext(Prev, Next);
+        if (Prev)
+            Prev->AddEdge(Road, PrevBorder);
+        if (Next)
+            Next->AddEdge(Road, NextBorder);
+        Model->AddRoad(Road);
+        return Road;
+    }
+}
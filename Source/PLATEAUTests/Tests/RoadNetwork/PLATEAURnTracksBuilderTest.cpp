@@ -0,0 +1,38 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/Structure/RnIntersection.h"
+#include "RoadNetwork/Structure/RnTrackBuilder.h"
+
+
+/// <summary>
+/// 隣接する交差点同士が別のグループとなり、重複とnullptrが除かれること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_RnTracksBuilder_GroupIndependentIntersections, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RnTracksBuilder.GroupIndependentIntersections", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_RnTracksBuilder_GroupIndependentIntersections::RunTest(const FString& Parameters) {
+    InitializeTest("RnTracksBuilder.GroupIndependentIntersections");
+
+    // I0-I1, I2-I3がそれぞれ隣接する
+    const auto I0 = URnIntersection::Create();
+    const auto I1 = URnIntersection::Create();
+    const auto I2 = URnIntersection::Create();
+    const auto I3 = URnIntersection::Create();
+    I0->AddEdge(I1, nullptr);
+    I1->AddEdge(I0, nullptr);
+    I2->AddEdge(I3, nullptr);
+    I3->AddEdge(I2, nullptr);
+
+    const auto Groups = FRnTracksBuilder::GroupIndependentIntersections({ I0, I1, nullptr, I2, I3, I0 });
+    TestEqual("Group count", Groups.Num(), 2);
+    if (Groups.Num() == 2) {
+        TestTrue("First group", Groups[0] == TArray<URnIntersection*>{ I0, I2 });
+        TestTrue("Second group", Groups[1] == TArray<URnIntersection*>{ I1, I3 });
+    }
+
+    const auto Single = FRnTracksBuilder::GroupIndependentIntersections({ I0, I2 });
+    TestEqual("Independent intersections are in one group", Single.Num(), 1);
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,175 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "../Benchmark/PLATEAUBenchmarkUtil.h"
+#include "RoadNetwork/CityObject/SubDividedCityObject.h"
+
+
+namespace FPLATEAUTest_SubDividedCityObject_Separate_Local {
+    /**
+     * @brief 道路を模した、StripCount本の互いに離れた帯状メッシュ(幅WidthQuads, 長さLengthQuads)を作成します。
+     * 三角形の並びはSeedでシャッフルされます。
+     */
+    FSubDividedCityObjectSubMesh CreateRoadStrips(const int32 StripCount, const int32 WidthQuads, const int32 LengthQuads, const int32 Seed) {
+        TArray<FIntVector> Tris;
+        int32 VertexOffset = 0;
+        for (int32 s = 0; s < StripCount; ++s) {
+            const int32 Row = WidthQuads + 1;
+            for (int32 l = 0; l < LengthQuads; ++l) {
+                for (int32 w = 0; w < WidthQuads; ++w) {
+                    const int32 V00 = VertexOffset + l * Row + w;
+                    const int32 V01 = V00 + 1;
+                    const int32 V10 = V00 + Row;
+                    const int32 V11 = V10 + 1;
+                    Tris.Add(FIntVector(V00, V10, V01));
+                    Tris.Add(FIntVector(V01, V10, V11));
+                }
+            }
+            VertexOffset += Row * (LengthQuads + 1);
+        }
+
+        FRandomStream Random(Seed);
+        for (int32 i = Tris.Num() - 1; i > 0; --i) {
+            Tris.Swap(i, Random.RandRange(0, i));
+        }
+
+        FSubDividedCityObjectSubMesh Result;
+        Result.Triangles.Reserve(Tris.Num() * 3);
+        for (const auto& T : Tris) {
+            Result.Triangles.Add(T.X);
+            Result.Triangles.Add(T.Y);
+            Result.Triangles.Add(T.Z);
+        }
+        return Result;
+    }
+
+    FSubDividedCityObjectSubMesh CreateRoadStrips(const int32 TriangleCount, const int32 Seed) {
+        constexpr int32 StripCount = 8;
+        constexpr int32 WidthQuads = 4;
+        const int32 LengthQuads = FMath::Max(1, TriangleCount / (StripCount * WidthQuads * 2));
+        return CreateRoadStrips(StripCount, WidthQuads, LengthQuads, Seed);
+    }
+
+    /**
+     * @brief 全三角形を走査する総当たりの分離(比較用)
+     */
+    TArray<FSubDividedCityObjectSubMesh> SeparateBruteForce(const FSubDividedCityObjectSubMesh& SubMesh) {
+        const auto& Triangles = SubMesh.Triangles;
+        TArray<FSubDividedCityObjectSubMesh> Result;
+        TArray<bool> Used;
+        Used.SetNum(Triangles.Num() / 3);
+        for (int32 i = 0; i < Used.Num(); ++i) {
+            if (Used[i]) continue;
+            FSubDividedCityObjectSubMesh NewMesh;
+            TArray<int32> Stack = { i };
+            while (Stack.Num() > 0) {
+                const int32 Current = Stack.Pop();
+                if (Used[Current]) continue;
+                Used[Current] = true;
+                for (int32 j = 0; j < 3; ++j)
+                    NewMesh.Triangles.Add(Triangles[Current * 3 + j]);
+                for (int32 j = 0; j < Used.Num(); ++j) {
+                    if (Used[j]) continue;
+                    bool IsConnected = false;
+                    for (int32 k = 0; k < 3 && !IsConnected; ++k) {
+                        for (int32 l = 0; l < 3 && !IsConnected; ++l) {
+                            IsConnected = Triangles[Current * 3 + k] == Triangles[j * 3 + l];
+                        }
+                    }
+                    if (IsConnected)
+                        Stack.Add(j);
+                }
+            }
+            Result.Add(NewMesh);
+        }
+        return Result;
+    }
+
+    bool IsSame(const TArray<FSubDividedCityObjectSubMesh>& A, const TArray<FSubDividedCityObjectSubMesh>& B) {
+        if (A.Num() != B.Num())
+            return false;
+        for (int32 i = 0; i < A.Num(); ++i) {
+            if (A[i].Triangles != B[i].Triangles)
+                return false;
+        }
+        return true;
+    }
+}
+
+/// <summary>
+/// FSubDividedCityObjectSubMesh::Separateが総当たり版と同じ成分・同じ順番を返すこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_SubDividedCityObject_Separate, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.SubDividedCityObject.Separate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_SubDividedCityObject_Separate::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_SubDividedCityObject_Separate_Local;
+    InitializeTest("SubDividedCityObject.Separate");
+
+    TestEqual("Empty", FSubDividedCityObjectSubMesh().Separate().Num(), 0);
+
+    // 頂点のみで接する三角形も同じ成分になる
+    FSubDividedCityObjectSubMesh Touching;
+    Touching.Triangles = { 0, 1, 2, 5, 6, 7, 2, 3, 4 };
+    const auto TouchingResult = Touching.Separate();
+    TestTrue("Touching", IsSame(TouchingResult, SeparateBruteForce(Touching)));
+    TestEqual("Touching component count", TouchingResult.Num(), 2);
+
+    for (const int32 Seed : { 1, 2, 3 }) {
+        const auto SubMesh = CreateRoadStrips(1000 * Seed, Seed);
+        const auto Actual = SubMesh.Separate();
+        TestEqual(FString::Printf(TEXT("Component count (Seed %d)"), Seed), Actual.Num(), 8);
+        TestTrue(FString::Printf(TEXT("Same as brute force (Seed %d)"), Seed), IsSame(Actual, SeparateBruteForce(SubMesh)));
+    }
+
+    // メッシュ単位の分離はサブメッシュの順番を保つ
+    FSubDividedCityObjectMesh Mesh;
+    TArray<FSubDividedCityObjectSubMesh> Expected;
+    for (const int32 Seed : { 4, 5, 6, 7 }) {
+        Mesh.SubMeshes.Add(CreateRoadStrips(500, Seed));
+        Expected.Append(SeparateBruteForce(Mesh.SubMeshes.Last()));
+    }
+    Mesh.Separate();
+    TestTrue("Mesh separate", IsSame(Mesh.SubMeshes, Expected));
+
+    FinishTest(true, "");
+    return true;
+}
+
+/// <summary>
+/// 道路メッシュ 1k ~ 500k 三角形に対するSeparateの計測
+/// 結果は Saved/PLATEAUBenchmark/SubDividedCityObjectSeparate.json に出力されます。
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_SubDividedCityObject_SeparateBenchmark, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Benchmark.SubDividedCityObjectSeparate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPLATEAUTest_SubDividedCityObject_SeparateBenchmark::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_SubDividedCityObject_Separate_Local;
+    InitializeTest("Benchmark.SubDividedCityObjectSeparate");
+
+    PLATEAUBenchmarkUtil::FBenchmarkReport Report(TEXT("SubDividedCityObjectSeparate"));
+    for (const int32 TriangleCount : { 1000, 10000, 100000, 500000 }) {
+        const auto SubMesh = CreateRoadStrips(TriangleCount, TriangleCount);
+        Report.BeginStage(FString::Printf(TEXT("Separate%d"), TriangleCount));
+        const auto Result = SubMesh.Separate();
+        Report.EndStage({ { TEXT("Triangles"), SubMesh.Triangles.Num() / 3 }, { TEXT("Components"), Result.Num() } });
+        TestEqual(FString::Printf(TEXT("Component count (%d)"), TriangleCount), Result.Num(), 8);
+    }
+
+    // 複数サブメッシュの並列分離
+    FSubDividedCityObjectMesh Mesh;
+    for (int32 i = 0; i < 64; ++i)
+        Mesh.SubMeshes.Add(CreateRoadStrips(10000, i));
+    const int32 SubMeshCount = Mesh.SubMeshes.Num();
+    Report.BeginStage(TEXT("MeshSeparate"));
+    Mesh.Separate();
+    Report.EndStage({ { TEXT("SubMeshes"), SubMeshCount } });
+
+    for (const auto& Stage : Report.GetStages()) {
+        AddInfo(FString::Printf(TEXT("%s: %.4f s"), *Stage.Name, Stage.Seconds));
+    }
+    FString ReportPath;
+    if (Report.Save(ReportPath))
+        AddInfo(FString::Printf(TEXT("Report: %s"), *ReportPath));
+
+    FinishTest(true, "");
+    return true;
+}
@@ -0,0 +1,120 @@
+// Copyright © 2023 Ministry of Land, Infrastructure and Transport
+
+#include "../PLATEAUAutomationTestBase.h"
+#include "RoadNetwork/CityObject/SubDividedCityObject.h"
+
+
+namespace FPLATEAUTest_SubDividedCityObject_VertexReduction_Local {
+    /**
+     * @brief 重複頂点・縮退三角形・重複三角形を含むメッシュを作成します。
+     */
+    FSubDividedCityObjectMesh CreateMesh(const int32 GridSize, const int32 SubMeshCount, const int32 Seed) {
+        FRandomStream Random(Seed);
+        FSubDividedCityObjectMesh Mesh;
+        for (int32 s = 0; s < SubMeshCount; ++s) {
+            auto& SubMesh = Mesh.SubMeshes.AddDefaulted_GetRef();
+            for (int32 y = 0; y < GridSize; ++y) {
+                for (int32 x = 0; x < GridSize; ++x) {
+                    // セル毎に頂点を複製するので隣接セルとは座標が一致する
+                    const int32 Base = Mesh.Vertices.Num();
+                    Mesh.Vertices.Add(FVector(x, y, s));
+                    Mesh.Vertices.Add(FVector(x + 1, y, s));
+                    Mesh.Vertices.Add(FVector(x, y + 1, s));
+                    Mesh.Vertices.Add(FVector(x + 1, y + 1, s));
+                    SubMesh.Triangles.Append({ Base, Base + 2, Base + 1, Base + 1, Base + 2, Base + 3 });
+                    const float R = Random.FRand();
+                    if (R < 0.05f) {
+                        // 縮退
+                        SubMesh.Triangles.Append({ Base, Base, Base + 1 });
+                    }
+                    else if (R < 0.1f) {
+                        // 向きの違う重複
+                        SubMesh.Triangles.Append({ Base + 1, Base, Base + 2 });
+                    }
+                }
+            }
+        }
+        return Mesh;
+    }
+
+    /**
+     * @brief TMap/TSetによる頂点結合(比較用)
+     */
+    void VertexReductionReference(FSubDividedCityObjectMesh& Mesh) {
+        TMap<FVector, int32> VertexMap;
+        for (const auto& Vertex : Mesh.Vertices) {
+            if (VertexMap.Contains(Vertex) == false)
+                VertexMap.Add(Vertex, VertexMap.Num());
+        }
+        for (auto& SubMesh : Mesh.SubMeshes) {
+            TSet<TTuple<int32, int32, int32>> NewTriangles;
+            for (int32 i = 0; i < SubMesh.Triangles.Num(); i += 3) {
+                TArray<int32> Ind = {
+                    VertexMap[Mesh.Vertices[SubMesh.Triangles[i]]],
+                    VertexMap[Mesh.Vertices[SubMesh.Triangles[i + 1]]],
+                    VertexMap[Mesh.Vertices[SubMesh.Triangles[i + 2]]] };
+                if (Ind[0] == Ind[1] || Ind[1] == Ind[2] || Ind[2] == Ind[0])
+                    continue;
+                Ind.Sort();
+                NewTriangles.Add(MakeTuple(Ind[0], Ind[1], Ind[2]));
+            }
+            SubMesh.Triangles.Empty();
+            for (const auto& T : NewTriangles)
+                SubMesh.Triangles.Append({ T.Get<0>(), T.Get<1>(), T.Get<2>() });
+        }
+        TArray<FVector> NewVertices;
+        NewVertices.SetNum(VertexMap.Num());
+        for (const auto& P : VertexMap)
+            NewVertices[P.Value] = P.Key;
+        Mesh.Vertices = NewVertices;
+    }
+
+    bool IsSame(const FSubDividedCityObjectMesh& A, const FSubDividedCityObjectMesh& B) {
+        if (A.Vertices != B.Vertices || A.SubMeshes.Num() != B.SubMeshes.Num())
+            return false;
+        for (int32 i = 0; i < A.SubMeshes.Num(); ++i) {
+            if (A.SubMeshes[i].Triangles != B.SubMeshes[i].Triangles)
+                return false;
+        }
+        return true;
+    }
+}
+
+/// <summary>
+/// VertexReductionが従来のTMap/TSet版と同じ頂点・三角形を同じ順番で返すこと
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_SubDividedCityObject_VertexReduction, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.RoadNetwork.SubDividedCityObject.VertexReduction", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_SubDividedCityObject_VertexReduction::RunTest(const FString& Parameters) {
+    using namespace FPLATEAUTest_SubDividedCityObject_VertexReduction_Local;
+    InitializeTest("SubDividedCityObject.VertexReduction");
+
+    for (const int32 Seed : { 1, 2, 3 }) {
+        auto Actual = CreateMesh(32, 3, Seed);
+        auto Expected = Actual;
+        Actual.VertexReduction();
+        VertexReductionReference(Expected);
+        TestTrue(FString::Printf(TEXT("Same as reference (Seed %d)"), Seed), IsSame(Actual, Expected));
+        TestEqual(FString::Printf(TEXT("Vertex count (Seed %d)"), Seed), Actual.Vertices.Num(), 33 * 33 * 3);
+        TestEqual(FString::Printf(TEXT("Triangle count (Seed %d)"), Seed), Actual.SubMeshes[0].Triangles.Num(), 32 * 32 * 2 * 3);
+    }
+
+    // 複数オブジェクト・子を並列に処理しても単体と同じ結果になる
+    auto Expected = CreateMesh(16, 2, 4);
+    TArray<TSharedPtr<FSubDividedCityObject>> Objects;
+    for (int32 i = 0; i < 8; ++i) {
+        auto Obj = MakeShared<FSubDividedCityObject>();
+        Obj->Meshes.Add(Expected);
+        Obj->Children.AddDefaulted_GetRef().Meshes.Add(Expected);
+        Objects.Add(Obj);
+    }
+    Expected.VertexReduction();
+    FSubDividedCityObject::VertexReductionMeshes(Objects);
+    bool bAllSame = true;
+    for (const auto& Obj : Objects)
+        bAllSame &= IsSame(Obj->Meshes[0], Expected) && IsSame(Obj->Children[0].Meshes[0], Expected);
+    TestTrue("VertexReductionMeshes", bAllSame);
+
+    FinishTest(true, "");
+    return true;
+}
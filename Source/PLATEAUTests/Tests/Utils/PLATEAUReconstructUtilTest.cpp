@@ -46,3 +46,47 @@ bool FPLATEAUTest_Util_Reconstruct_Util::RunTest(const FString& Parameters) {
 
     return true;
 }
+
+/// <summary>
+/// 非同期で書き出したハイトマップ画像が、同期書き出しと同じ内容になること
+/// </summary>
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FPLATEAUTest_Util_Reconstruct_Util_HeightmapImage, FPLATEAUAutomationTestBase, "PLATEAUTest.FPLATEAUTest.Util.ReconstructUtil.HeightmapImage", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPLATEAUTest_Util_Reconstruct_Util_HeightmapImage::RunTest(const FString& Parameters) {
+    InitializeTest("ReconstructUtil.HeightmapImage");
+
+    constexpr int32 Width = 257;
+    constexpr int32 Height = 129;
+    constexpr int32 ImageCount = 8;
+    IFileManager::Get().MakeDirectory(*(FPaths::ProjectContentDir() / TEXT("PLATEAU")), true);
+
+    TArray<TSharedPtr<std::vector<uint16_t>>> Images;
+    for (int32 i = 0; i < ImageCount; ++i) {
+        auto Data = MakeShared<std::vector<uint16_t>>(Width * Height);
+        for (int32 j = 0; j < Width * Height; ++j)
+            (*Data)[j] = static_cast<uint16_t>((j * 37 + i * 1009) & 0xFFFF);
+        Images.Add(Data);
+        FPLATEAUReconstructUtil::SaveHeightmapImageAsync(EPLATEAULandscapeHeightmapImageOutput::PNG_RAW, FString::Printf(TEXT("HM_TEST_ASYNC_%d"), i), Width, Height, Data);
+    }
+    FPLATEAUReconstructUtil::FlushHeightmapImages();
+
+    for (int32 i = 0; i < ImageCount; ++i) {
+        const FString SyncName = FString::Printf(TEXT("HM_TEST_SYNC_%d"), i);
+        const FString AsyncName = FString::Printf(TEXT("HM_TEST_ASYNC_%d"), i);
+        FPLATEAUReconstructUtil::SaveHeightmapImage(EPLATEAULandscapeHeightmapImageOutput::PNG_RAW, SyncName, Width, Height, Images[i]->data());
+
+        for (const auto Extension : { TEXT("png"), TEXT("raw") }) {
+            const FString SyncPath = FString::Printf(TEXT("%sPLATEAU/%s_%d_%d.%s"), *FPaths::ProjectContentDir(), *SyncName, Width, Height, Extension);
+            const FString AsyncPath = FString::Printf(TEXT("%sPLATEAU/%s_%d_%d.%s"), *FPaths::ProjectContentDir(), *AsyncName, Width, Height, Extension);
+            TArray<uint8> SyncBytes, AsyncBytes;
+            TestTrue("Sync file exists", FFileHelper::LoadFileToArray(SyncBytes, *SyncPath));
+            TestTrue("Async file exists", FFileHelper::LoadFileToArray(AsyncBytes, *AsyncPath));
+            TestTrue(FString::Printf(TEXT("Same content %s"), Extension), SyncBytes == AsyncBytes);
+            IFileManager::Get().Delete(*SyncPath);
+            IFileManager::Get().Delete(*AsyncPath);
+        }
+    }
+
+    FinishTest(true, "");
+    return true;
+}